@@ -0,0 +1,84 @@
+#include "alloc_counter.hpp"
+#include "util/stats/alloc_stats.hpp"
+#include "util/stats/memory.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace karmac::bench {
+#ifdef KARMAC_ALLOC_STATS
+    //The instrumented build already replaces the global operator new, reuse its totals
+    AllocationCount get_allocation_count() noexcept {
+        const auto statistics = alloc_stats::get_total_statistics();
+        return { statistics.allocations, statistics.bytes };
+    }
+#else
+    static std::atomic<uint64_t> _allocations = 0;
+    static std::atomic<uint64_t> _allocated_bytes = 0;
+
+    static void* allocate(size_t size) {
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        _allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+        if(auto* p = std::malloc(size == 0 ? 1 : size)) {
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    AllocationCount get_allocation_count() noexcept {
+        return { _allocations.load(std::memory_order_relaxed), _allocated_bytes.load(std::memory_order_relaxed) };
+    }
+#endif
+
+    RssMeasurement::RssMeasurement() noexcept
+        : _start(stats::reset_peak_rss() ? stats::get_current_rss() : stats::get_peak_rss()) {}
+
+    uint64_t RssMeasurement::get_growth() const noexcept {
+        const auto peak = stats::get_peak_rss();
+        return peak > _start ? peak - _start : 0;
+    }
+}
+
+#ifndef KARMAC_ALLOC_STATS
+void* operator new(size_t size) {
+    return karmac::bench::allocate(size);
+}
+
+void* operator new[](size_t size) {
+    return karmac::bench::allocate(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return karmac::bench::allocate(size);
+    } catch(...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return karmac::bench::allocate(size);
+    } catch(...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    std::free(p);
+}
+#endif
\ No newline at end of file
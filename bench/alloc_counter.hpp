@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+namespace karmac::bench {
+    struct AllocationCount {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    //Totals of all allocations made through the global operator new since program start
+    [[nodiscard]] AllocationCount get_allocation_count() noexcept;
+
+    //Peak resident set size reached since construction above the size at construction. Where the peak of the process
+    //can't be reset, only growth beyond its previous peak is seen.
+    class RssMeasurement final {
+    private:
+        uint64_t _start;
+
+    public:
+        RssMeasurement() noexcept;
+
+        [[nodiscard]] uint64_t get_growth() const noexcept;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "benchmark.hpp"
+#include "alloc_counter.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+#include <chrono>
+#include <string>
+
+namespace karmac::bench {
+    static volatile uint64_t _sink = 0;
+
+    std::vector<BenchmarkResult> BenchmarkSuite::run(const BenchmarkOptions& options) const {
+        std::vector<BenchmarkResult> results;
+
+        for(const auto& benchmark : _benchmarks) {
+            if(!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+
+            const RssMeasurement rss;
+
+            //Warm up caches and the allocator
+            _sink = _sink + benchmark.body();
+
+            BenchmarkResult result;
+            result.name = benchmark.name;
+
+            const auto allocations_before = get_allocation_count();
+            const auto start = std::chrono::steady_clock::now();
+
+            do {
+                result.tokens += benchmark.body();
+                result.bytes += benchmark.bytes;
+                ++result.iterations;
+
+                result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            } while(result.seconds < options.min_time);
+
+            const auto allocations_after = get_allocation_count();
+            result.allocations = allocations_after.allocations - allocations_before.allocations;
+            result.allocated_bytes = allocations_after.bytes - allocations_before.bytes;
+            result.rss_growth = rss.get_growth();
+
+            results.push_back(result);
+            print_results({ result });
+        }
+
+        return results;
+    }
+
+    //A dash in place of the rate of a benchmark that doesn't have the unit
+    static std::string format_rate(double value, bool valid, size_t width, int precision) {
+        return valid ? fmt::format("{:>{}.{}f}", value, width, precision) : fmt::format("{:>{}}", "-", width);
+    }
+
+    //JSON null for rates the benchmark doesn't have
+    static std::string format_json_rate(double value, bool valid) {
+        return valid ? fmt::format("{}", value) : "null";
+    }
+
+    void print_results(const std::vector<BenchmarkResult>& results) {
+        for(const auto& result : results) {
+            const auto has_bytes = result.bytes != 0;
+            const auto has_tokens = result.tokens != 0;
+            fmt::print("{:<36} {} MB/s {} Mtok/s {} ns/tok {} alloc/tok {:>9.1f} MB rss\n", result.name,
+                       format_rate(result.get_bytes_per_second() / 1e6, has_bytes, 10, 2), format_rate(result.get_tokens_per_second() / 1e6, has_tokens, 10, 2),
+                       format_rate(result.get_ns_per_token(), has_tokens, 9, 2), format_rate(result.get_allocations_per_token(), has_tokens, 8, 3),
+                       static_cast<double>(result.rss_growth) / 1e6);
+        }
+    }
+
+    void write_json(const std::vector<BenchmarkResult>& results, const std::string& path) {
+        auto output = fmt::output_file(path);
+
+#ifdef NDEBUG
+        const auto optimized = true;
+#else
+        const auto optimized = false;
+#endif
+        output.print("{{\n  \"version\": \"{}\",\n  \"optimized\": {},\n  \"benchmarks\": [", KARMAC_VERSION, optimized);
+
+        for(size_t i = 0; i < results.size(); i++) {
+            const auto& result = results[i];
+            output.print("{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"bytes\": {}, \"tokens\": {}, \"seconds\": {}, "
+                         "\"bytes_per_second\": {}, \"tokens_per_second\": {}, \"ns_per_token\": {}, "
+                         "\"allocations\": {}, \"allocated_bytes\": {}, \"allocations_per_token\": {}, \"rss_growth_bytes\": {}}}",
+                         i == 0 ? "" : ",", result.name, result.iterations, result.bytes, result.tokens, result.seconds,
+                         format_json_rate(result.get_bytes_per_second(), result.bytes != 0), format_json_rate(result.get_tokens_per_second(), result.tokens != 0),
+                         format_json_rate(result.get_ns_per_token(), result.tokens != 0), result.allocations, result.allocated_bytes,
+                         format_json_rate(result.get_allocations_per_token(), result.tokens != 0), result.rss_growth);
+        }
+
+        output.print("\n  ]\n}}\n");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac::bench {
+    struct BenchmarkOptions {
+        std::string filter;
+        double min_time = 0.5;
+    };
+
+    struct BenchmarkResult {
+        std::string name;
+        uint64_t iterations = 0;
+        uint64_t bytes = 0;
+        uint64_t tokens = 0;
+        double seconds = 0.0;
+        uint64_t allocations = 0;
+        uint64_t allocated_bytes = 0;
+        //Peak resident set size during the benchmark above the one at its start
+        uint64_t rss_growth = 0;
+
+        //Rates of benchmarks without bytes or tokens are left out of the results
+        [[nodiscard]] inline double get_bytes_per_second() const noexcept {
+            return bytes == 0 ? 0.0 : static_cast<double>(bytes) / seconds;
+        }
+
+        [[nodiscard]] inline double get_tokens_per_second() const noexcept {
+            return tokens == 0 ? 0.0 : static_cast<double>(tokens) / seconds;
+        }
+
+        [[nodiscard]] inline double get_ns_per_token() const noexcept {
+            return tokens == 0 ? 0.0 : seconds * 1e9 / static_cast<double>(tokens);
+        }
+
+        [[nodiscard]] inline double get_allocations_per_token() const noexcept {
+            return tokens == 0 ? 0.0 : static_cast<double>(allocations) / static_cast<double>(tokens);
+        }
+    };
+
+    //The body processes `bytes` bytes per call and returns the number of tokens (or other units) it produced, 0 bytes
+    //for benchmarks that don't process source text
+    struct Benchmark {
+        std::string name;
+        uint64_t bytes;
+        std::function<uint64_t()> body;
+    };
+
+    class BenchmarkSuite final {
+    private:
+        std::vector<Benchmark> _benchmarks;
+
+    public:
+        inline void add(std::string name, uint64_t bytes, std::function<uint64_t()> body) {
+            _benchmarks.push_back({ std::move(name), bytes, std::move(body) });
+        }
+
+        [[nodiscard]] std::vector<BenchmarkResult> run(const BenchmarkOptions& options) const;
+    };
+
+    void print_results(const std::vector<BenchmarkResult>& results);
+    void write_json(const std::vector<BenchmarkResult>& results, const std::string& path);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "checker_benchmarks.hpp"
+#include "staged_input.hpp"
+
+#include <corpus/generator.hpp>
+#include <fmt/format.h>
+#include <memory>
+
+namespace karmac::bench {
+    //Every run checks the same tree
+    static size_t check(StagedInput& input) {
+        input.checker.check(input.tree, input.resolver);
+        return input.tree.get_node_count();
+    }
+
+    void register_checker_benchmarks(BenchmarkSuite& suite) {
+        //Code without errors, so the runs measure what valid programs cost
+        corpus::GeneratorOptions options;
+        options.typed = true;
+
+        for(const auto size : { 16 * 1024, 1024 * 1024, 16 * 1024 * 1024 }) {
+            auto input = std::make_shared<StagedInput>(corpus::Generator(options).generate(size), Stage::Resolve);
+
+            //Reported per AST node
+            suite.add(fmt::format("check/code/{}k", size / 1024), input->text.size(), [input] {
+                return static_cast<uint64_t>(check(*input));
+            });
+        }
+    }
+}
\ No newline at end of file
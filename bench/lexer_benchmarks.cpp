@@ -0,0 +1,144 @@
+#include "lexer_benchmarks.hpp"
+
+#include <corpus/generator.hpp>
+#include <tokenize/tokenizer.hpp>
+#include <tokenize/tokenizer_pool.hpp>
+#include <util/text/character.hpp>
+#include <util/text/text_iterator.hpp>
+#include <util/text/utf8/utf8.hpp>
+#include <fmt/format.h>
+#include <memory>
+
+namespace karmac::bench {
+    static constexpr size_t _MICRO_SIZE = 256 * 1024;
+
+    static std::string generate_soup(const corpus::TokenMix& mix, uint32_t non_ascii, uint64_t seed) {
+        corpus::GeneratorOptions options;
+        options.seed = seed;
+        options.mix = mix;
+        options.non_ascii = non_ascii;
+        options.soup = true;
+
+        return corpus::Generator(options).generate(_MICRO_SIZE);
+    }
+
+    static std::string generate_code(uint64_t size) {
+        return corpus::Generator(corpus::GeneratorOptions()).generate(size);
+    }
+
+    static uint64_t tokenize(const std::string& text) {
+        const Tokenizer tokenizer(text);
+        return tokenizer.get_tokens().size();
+    }
+
+    static void add_lexer_benchmark(BenchmarkSuite& suite, const std::string& name, std::string text) {
+        auto shared_text = std::make_shared<std::string>(std::move(text));
+        const auto bytes = shared_text->size();
+
+        suite.add(name, bytes, [shared_text] {
+            return tokenize(*shared_text);
+        });
+    }
+
+    //Types a char into an identifier in the middle of the text and deletes it again, every run relexes both edits
+    struct RelexInput {
+        std::string text;
+        Tokenizer tokenizer;
+        size_t offset = 0;
+        //Tokens replaced since the last reset, they keep their arena memory until then
+        size_t replaced_tokens = 0;
+
+        explicit RelexInput(std::string source) : text(std::move(source)), tokenizer(text) {
+            const auto& tokens = tokenizer.get_tokens();
+            auto index = tokens.size() / 2;
+            while(index < tokens.size() && tokens[index]->get_type() != TokenType::Identifier) {
+                ++index;
+            }
+            offset = tokens[index]->get_location().offset + 1;
+        }
+
+        inline uint64_t relex() {
+            text.insert(offset, 1, 'x');
+            replaced_tokens += tokenizer.relex(text, TextEdit(offset, 0, 1)).removed_tokens;
+            text.erase(offset, 1);
+            replaced_tokens += tokenizer.relex(text, TextEdit(offset, 1, 0)).removed_tokens;
+
+            //Releasing the replaced tokens once there are as many as live ones keeps the memory bounded, and costs
+            //about one tokenized token per replaced one
+            if(replaced_tokens > tokenizer.get_tokens().size()) {
+                tokenizer.reset(text);
+                replaced_tokens = 0;
+            }
+            return 2;
+        }
+    };
+
+    void register_lexer_benchmarks(BenchmarkSuite& suite) {
+        auto utf8_text = std::make_shared<std::string>(generate_soup({ .identifiers = 0, .keywords = 0, .numbers = 0, .strings = 1, .operators = 0, .comments = 0, .whitespace = 0 }, 100, 1));
+        suite.add("utf8/decode", utf8_text->size(), [utf8_text] {
+            const auto* p = utf8_text->data();
+            const auto* end = p + utf8_text->size();
+
+            uint64_t characters = 0;
+            uint64_t checksum = 0;
+            while(p < end) {
+                size_t len;
+                checksum += utf8::to_unicode(p, len);
+                p += len;
+                ++characters;
+            }
+
+            return characters + (checksum & 1);
+        });
+
+        const corpus::TokenMix whitespace_mix = { .identifiers = 1, .keywords = 0, .numbers = 0, .strings = 0, .operators = 0, .comments = 0, .whitespace = 8 };
+        auto whitespace_text = std::make_shared<std::string>(generate_soup(whitespace_mix, 0, 2));
+        suite.add("text_iterator/whitespace", whitespace_text->size(), [whitespace_text] {
+            TextIterator iterator(whitespace_text->data());
+
+            uint64_t runs = 0;
+            while(iterator.has_chars()) {
+                while(character::is_whitespace(*iterator)) {
+                    ++iterator;
+                }
+                ++iterator;
+                ++runs;
+            }
+
+            return runs;
+        });
+
+        add_lexer_benchmark(suite, "lex/whitespace", *whitespace_text);
+        add_lexer_benchmark(suite, "lex/identifiers", generate_soup({ .identifiers = 1, .keywords = 0, .numbers = 0, .strings = 0, .operators = 0, .comments = 0, .whitespace = 0 }, 5, 3));
+        add_lexer_benchmark(suite, "lex/keywords", generate_soup({ .identifiers = 0, .keywords = 1, .numbers = 0, .strings = 0, .operators = 0, .comments = 0, .whitespace = 0 }, 0, 4));
+        add_lexer_benchmark(suite, "lex/numbers", generate_soup({ .identifiers = 0, .keywords = 0, .numbers = 1, .strings = 0, .operators = 0, .comments = 0, .whitespace = 0 }, 0, 5));
+        add_lexer_benchmark(suite, "lex/strings", generate_soup({ .identifiers = 0, .keywords = 0, .numbers = 0, .strings = 1, .operators = 0, .comments = 0, .whitespace = 0 }, 20, 6));
+        add_lexer_benchmark(suite, "lex/operators", generate_soup({ .identifiers = 0, .keywords = 0, .numbers = 0, .strings = 0, .operators = 1, .comments = 0, .whitespace = 0 }, 0, 7));
+        add_lexer_benchmark(suite, "lex/comments", generate_soup({ .identifiers = 0, .keywords = 0, .numbers = 0, .strings = 0, .operators = 0, .comments = 1, .whitespace = 0 }, 5, 8));
+
+        for(const auto size : { 16 * 1024, 1024 * 1024, 16 * 1024 * 1024 }) {
+            add_lexer_benchmark(suite, fmt::format("lex/code/{}k", size / 1024), generate_code(size));
+        }
+
+        //Reported per edit. Only the edited tokens are tokenized again, but the locations of all tokens behind the
+        //edit are moved, which the larger text shows
+        for(const auto size : { 16 * 1024, 1024 * 1024 }) {
+            auto input = std::make_shared<RelexInput>(generate_code(size));
+            suite.add(fmt::format("lex/relex/{}k", size / 1024), 0, [input] {
+                return input->relex();
+            });
+        }
+
+        //Same as lex/code/16k, but with a pooled tokenizer that keeps its buffers between runs
+        auto reuse_text = std::make_shared<std::string>(generate_code(16 * 1024));
+        suite.add("lex/code/16k/reused", reuse_text->size(), [reuse_text] {
+            auto tokenizer = TokenizerPool::acquire();
+            tokenizer->reset(*reuse_text);
+            return static_cast<uint64_t>(tokenizer->get_tokens().size());
+        });
+    }
+
+    void register_file_benchmark(BenchmarkSuite& suite, const std::string& name, std::string text) {
+        add_lexer_benchmark(suite, fmt::format("lex/file/{}", name), std::move(text));
+    }
+}
\ No newline at end of file
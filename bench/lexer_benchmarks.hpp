@@ -0,0 +1,8 @@
+#pragma once
+
+#include "benchmark.hpp"
+
+namespace karmac::bench {
+    void register_lexer_benchmarks(BenchmarkSuite& suite);
+    void register_file_benchmark(BenchmarkSuite& suite, const std::string& name, std::string text);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "benchmark.hpp"
+#include "checker_benchmarks.hpp"
+#include "lexer_benchmarks.hpp"
+#include "parser_benchmarks.hpp"
+#include "resolver_benchmarks.hpp"
+#include "vm_benchmarks.hpp"
+
+#include <fmt/format.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace karmac::bench;
+
+static std::string read_string_from_file(const std::string& file_path) {
+    const std::ifstream input_stream(file_path, std::ios_base::binary);
+
+    if(input_stream.fail()) {
+        throw std::runtime_error(fmt::format("Failed to open {}", file_path));
+    }
+
+    std::stringstream buffer;
+    buffer << input_stream.rdbuf();
+
+    return buffer.str();
+}
+
+static void print_usage() {
+    fmt::print("usage: karmac_bench [--filter=<substring>] [--min-time=<seconds>] [--json=<file>] [--corpus=<file>]...\n");
+}
+
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    BenchmarkSuite suite;
+    std::string json_path;
+
+    try {
+        register_lexer_benchmarks(suite);
+        register_parser_benchmarks(suite);
+        register_resolver_benchmarks(suite);
+        register_checker_benchmarks(suite);
+        register_vm_benchmarks(suite);
+
+        for(auto i = 1; i < argc; i++) {
+            const std::string_view argument(argv[i]);
+
+            if(argument.starts_with("--filter=")) {
+                options.filter = argument.substr(std::string_view("--filter=").size());
+            } else if(argument.starts_with("--min-time=")) {
+                options.min_time = std::stod(std::string(argument.substr(std::string_view("--min-time=").size())));
+            } else if(argument.starts_with("--json=")) {
+                json_path = argument.substr(std::string_view("--json=").size());
+            } else if(argument.starts_with("--corpus=")) {
+                const std::string path(argument.substr(std::string_view("--corpus=").size()));
+                register_file_benchmark(suite, std::filesystem::path(path).filename().string(), read_string_from_file(path));
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 2;
+            }
+        }
+
+#ifndef NDEBUG
+        fmt::print(stderr, "warning: karmac_bench was built without optimizations\n");
+#endif
+
+        const auto results = suite.run(options);
+
+        if(!json_path.empty()) {
+            write_json(results, json_path);
+        }
+    } catch(const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
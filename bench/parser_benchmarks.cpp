@@ -0,0 +1,61 @@
+#include "parser_benchmarks.hpp"
+#include "staged_input.hpp"
+
+#include <corpus/generator.hpp>
+#include <parse/parser.hpp>
+#include <fmt/format.h>
+#include <memory>
+
+namespace karmac::bench {
+    //Every run parses the same tokens into the same tree
+    static size_t parse(StagedInput& input) {
+        Parser(input.tokenizer.get_tokens(), input.tree).parse();
+        return input.tree.get_node_count();
+    }
+
+    //Skips the function bodies
+    static size_t parse_outline(StagedInput& input) {
+        Parser(input.tokenizer.get_tokens(), input.tree, SourceLocation(), input.tokenizer.get_blocks()).parse();
+        return input.tree.get_node_count();
+    }
+
+    static size_t parse_parallel(StagedInput& input, ThreadPool& pool) {
+        Parser(input.tokenizer.get_tokens(), input.tree, SourceLocation(), input.tokenizer.get_blocks()).parse(pool);
+        return input.tree.get_node_count();
+    }
+
+    void register_parser_benchmarks(BenchmarkSuite& suite) {
+        for(const auto size : { 16 * 1024, 1024 * 1024, 16 * 1024 * 1024 }) {
+            auto input = std::make_shared<StagedInput>(corpus::Generator(corpus::GeneratorOptions()).generate(size), Stage::Tokenize);
+            const auto bytes = input->text.size();
+
+            //Reported per token
+            suite.add(fmt::format("parse/code/{}k", size / 1024), bytes, [input] {
+                static_cast<void>(parse(*input));
+                return static_cast<uint64_t>(input->tokenizer.get_tokens().size());
+            });
+
+            //Same work, reported per AST node
+            suite.add(fmt::format("parse/code/{}k/nodes", size / 1024), bytes, [input] {
+                return static_cast<uint64_t>(parse(*input));
+            });
+
+            //Reported per token of the whole input, most of which is skipped
+            suite.add(fmt::format("parse/outline/{}k", size / 1024), bytes, [input] {
+                static_cast<void>(parse_outline(*input));
+                return static_cast<uint64_t>(input->tokenizer.get_tokens().size());
+            });
+
+            //Scaling of a single large file over the thread count
+            if(size >= 1024 * 1024) {
+                for(const size_t threads : { 1, 2, 4, 8 }) {
+                    auto pool = std::make_shared<ThreadPool>(threads);
+                    suite.add(fmt::format("parse/parallel/{}k/{}t", size / 1024, threads), bytes, [input, pool] {
+                        static_cast<void>(parse_parallel(*input, *pool));
+                        return static_cast<uint64_t>(input->tokenizer.get_tokens().size());
+                    });
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
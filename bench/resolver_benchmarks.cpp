@@ -0,0 +1,29 @@
+#include "resolver_benchmarks.hpp"
+#include "staged_input.hpp"
+
+#include <corpus/generator.hpp>
+#include <fmt/format.h>
+#include <memory>
+
+namespace karmac::bench {
+    //Every run resolves the same tree
+    static size_t resolve(StagedInput& input) {
+        input.resolver.resolve(input.tree, input.tokenizer.get_identifiers().size());
+        return input.tree.get_node_count();
+    }
+
+    void register_resolver_benchmarks(BenchmarkSuite& suite) {
+        //Code without errors, so the runs measure what valid programs cost
+        corpus::GeneratorOptions options;
+        options.typed = true;
+
+        for(const auto size : { 16 * 1024, 1024 * 1024, 16 * 1024 * 1024 }) {
+            auto input = std::make_shared<StagedInput>(corpus::Generator(options).generate(size), Stage::Parse);
+
+            //Reported per AST node
+            suite.add(fmt::format("resolve/code/{}k", size / 1024), input->text.size(), [input] {
+                return static_cast<uint64_t>(resolve(*input));
+            });
+        }
+    }
+}
\ No newline at end of file
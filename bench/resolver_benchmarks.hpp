@@ -0,0 +1,7 @@
+#pragma once
+
+#include "benchmark.hpp"
+
+namespace karmac::bench {
+    void register_resolver_benchmarks(BenchmarkSuite& suite);
+}
\ No newline at end of file
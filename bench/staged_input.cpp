@@ -0,0 +1,31 @@
+#include "staged_input.hpp"
+
+#include <parse/parser.hpp>
+#include <stdexcept>
+
+namespace karmac::bench {
+    StagedInput::StagedInput(std::string source, Stage stage) : text(std::move(source)), tokenizer(text) {
+        auto errors = !tokenizer.get_errors().empty();
+
+        if(!errors && stage >= Stage::Parse) {
+            Parser parser(tokenizer.get_tokens(), tree);
+            parser.parse();
+            errors = !parser.get_errors().empty();
+        }
+        if(!errors && stage >= Stage::Resolve) {
+            resolver.resolve(tree, tokenizer.get_identifiers().size());
+            errors = resolver.get_error_count() != 0;
+        }
+        if(!errors && stage >= Stage::Check) {
+            checker.check(tree, resolver);
+            errors = checker.get_error_count() != 0;
+        }
+        if(errors) {
+            throw std::runtime_error("Benchmark input has errors");
+        }
+
+        if(stage >= Stage::Compile) {
+            compiler.compile(tree, resolver, checker);
+        }
+    }
+}
\ No newline at end of file
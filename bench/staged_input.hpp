@@ -0,0 +1,33 @@
+#pragma once
+
+#include <bytecode/compiler.hpp>
+#include <check/type_checker.hpp>
+#include <parse/ast/tree.hpp>
+#include <resolve/resolver.hpp>
+#include <tokenize/tokenizer.hpp>
+#include <string>
+
+namespace karmac::bench {
+    //Phases of the pipeline, in the order they run
+    enum class Stage {
+        Tokenize,
+        Parse,
+        Resolve,
+        Check,
+        Compile
+    };
+
+    //Runs the pipeline over a source up to and including `stage` once, outside of the measurement. The benchmarks of
+    //the next phase run it again and again on the same output.
+    struct StagedInput {
+        std::string text;
+        Tokenizer tokenizer;
+        ast::Tree tree;
+        Resolver resolver;
+        TypeChecker checker;
+        bytecode::Compiler compiler;
+
+        //Throws if a phase that ran reports errors, the benchmarks measure what valid programs cost
+        StagedInput(std::string source, Stage stage);
+    };
+}
\ No newline at end of file
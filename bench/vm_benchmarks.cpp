@@ -0,0 +1,107 @@
+#include "vm_benchmarks.hpp"
+#include "staged_input.hpp"
+
+#include <bytecode/interpreter.hpp>
+#include <fmt/format.h>
+#include <memory>
+
+namespace karmac::bench {
+    //Every main returns the number of loop iterations or calls it made, the unit the benchmark is reported in
+    struct VmProgram {
+        const char* name;
+        const char* source;
+    };
+
+    static constexpr VmProgram _PROGRAMS[] = {
+        //A tight for loop, one add and one step per iteration
+        { "sum", R"(
+fn main() -> i64 {
+    n: i64 = 10000000;
+    s: i64 = 0;
+    for i : 0..n {
+        s += i;
+    }
+    return s == n * (n - 1) / 2 ? n : 0;
+}
+)" },
+        //Data dependent branches and u32 arithmetic
+        { "collatz", R"(
+fn main() -> u64 {
+    steps: u64 = 0;
+    for start : 1..100000u32 {
+        n := start;
+        while n != 1 {
+            if n % 2 == 0 {
+                n /= 2;
+            } else {
+                n = 3 * n + 1;
+            }
+            steps++;
+        }
+    }
+    return steps;
+}
+)" },
+        //Nested loops around a modulo loop
+        { "gcd", R"(
+fn gcd(a: i32, b: i32) -> i32 {
+    while b != 0 {
+        t := a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+fn main() -> i64 {
+    steps: i64 = 0;
+    for a : 1..400 {
+        for b : 1..400 {
+            if gcd(a, b) == 1 {
+                steps++;
+            }
+        }
+    }
+    return steps == 97035 ? 399 * 399 : 0;
+}
+)" },
+        //Calls and returns
+        { "fib", R"(
+fn fib(n: i32) -> i32 {
+    if n < 2 {
+        return n;
+    }
+    return fib(n - 1) + fib(n - 2);
+}
+fn main() -> i32 {
+    return fib(25) == 75025 ? 242785 : 0;
+}
+)" },
+        //f64 arithmetic and comparisons
+        { "float", R"(
+fn main() -> i32 {
+    x: f64 = 0.0;
+    y: f64 = 1.0;
+    i := 0;
+    while i < 5000000 {
+        x = x * 0.5 + y;
+        y = y > 0.5 ? y - 0.25 : y + 0.75;
+        i++;
+    }
+    return x > 0.0 ? i : 0;
+}
+)" }
+    };
+
+    void register_vm_benchmarks(BenchmarkSuite& suite) {
+        for(const auto& program : _PROGRAMS) {
+            auto input = std::make_shared<StagedInput>(program.source, Stage::Compile);
+            auto interpreter = std::make_shared<bytecode::Interpreter>();
+            const auto main = input->compiler.get_program().find_function("main");
+
+            //The program is compiled once, every run interprets it and doesn't process its text
+            suite.add(fmt::format("vm/{}", program.name), 0, [input, interpreter, main] {
+                return interpreter->call(input->compiler.get_program(), main, {});
+            });
+        }
+    }
+}
\ No newline at end of file
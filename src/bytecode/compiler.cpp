@@ -0,0 +1,668 @@
+#include "compiler.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace karmac::bytecode {
+    using ast::NodeIndex;
+    using ast::NodeKind;
+
+    //Bools are stored like u8
+    static ValueType to_value_type(Type type) noexcept {
+        switch(type) {
+            case Type::I8:
+                return ValueType::I8;
+            case Type::U16:
+                return ValueType::U16;
+            case Type::I16:
+                return ValueType::I16;
+            case Type::U32:
+                return ValueType::U32;
+            case Type::I32:
+                return ValueType::I32;
+            case Type::U64:
+            case Type::USize:
+                return ValueType::U64;
+            case Type::I64:
+            case Type::ISize:
+                return ValueType::I64;
+            case Type::F32:
+                return ValueType::F32;
+            case Type::F64:
+                return ValueType::F64;
+            default:
+                return ValueType::U8;
+        }
+    }
+
+    static bool is_float(ValueType type) noexcept {
+        return type == ValueType::F32 || type == ValueType::F64;
+    }
+
+    static TokenType negate_comparison(TokenType op) noexcept {
+        switch(op) {
+            case TokenType::Less:
+                return TokenType::GreaterEquals;
+            case TokenType::LessEquals:
+                return TokenType::Greater;
+            case TokenType::Greater:
+                return TokenType::LessEquals;
+            case TokenType::GreaterEquals:
+                return TokenType::Less;
+            case TokenType::Equals:
+                return TokenType::NotEquals;
+            default:
+                return TokenType::Equals;
+        }
+    }
+
+    //Greater and GreaterEquals swap their operands and use the opcode of Less and LessEquals
+    static Opcode get_comparison(TokenType op, Type type) noexcept {
+        const auto less = op == TokenType::Less || op == TokenType::Greater;
+        switch(type) {
+            case Type::F32:
+                if(op == TokenType::Equals || op == TokenType::NotEquals) {
+                    return op == TokenType::Equals ? Opcode::EqF32 : Opcode::NeF32;
+                }
+                return less ? Opcode::LtF32 : Opcode::LeF32;
+            case Type::F64:
+                if(op == TokenType::Equals || op == TokenType::NotEquals) {
+                    return op == TokenType::Equals ? Opcode::EqF64 : Opcode::NeF64;
+                }
+                return less ? Opcode::LtF64 : Opcode::LeF64;
+            default:
+                if(op == TokenType::Equals || op == TokenType::NotEquals) {
+                    return op == TokenType::Equals ? Opcode::Eq : Opcode::Ne;
+                }
+                if(type::is_signed(type)) {
+                    return less ? Opcode::LtS : Opcode::LeS;
+                }
+                return less ? Opcode::LtU : Opcode::LeU;
+        }
+    }
+
+    static Opcode get_branch(TokenType op, bool is_signed) noexcept {
+        switch(op) {
+            case TokenType::Less:
+            case TokenType::Greater:
+                return is_signed ? Opcode::BranchLtS : Opcode::BranchLtU;
+            case TokenType::LessEquals:
+            case TokenType::GreaterEquals:
+                return is_signed ? Opcode::BranchLeS : Opcode::BranchLeU;
+            case TokenType::Equals:
+                return Opcode::BranchEq;
+            default:
+                return Opcode::BranchNe;
+        }
+    }
+
+    uint16_t Compiler::allocate() {
+        if(_next_register == _NO_REGISTER) {
+            throw std::runtime_error(fmt::format("fn {} needs more than {} registers", _program.functions.back().name, _NO_REGISTER));
+        }
+
+        const auto result = _next_register++;
+        _register_count = std::max(_register_count, _next_register);
+        return result;
+    }
+
+    uint32_t Compiler::emit(Opcode op, uint16_t a, uint16_t b, uint16_t c) {
+        const auto position = get_position();
+        if(position == _MAX_CODE_SIZE) {
+            throw std::runtime_error(fmt::format("fn {} has more than {} instructions", _program.functions.back().name, _MAX_CODE_SIZE));
+        }
+
+        _program.code.push_back({ op, a, b, c });
+        return position;
+    }
+
+    void Compiler::patch(uint32_t position, uint32_t target) noexcept {
+        auto& instruction = _program.code[_program.functions.back().code_start + position];
+        switch(opcode::get_format(instruction.op)) {
+            case Format::T:
+                instruction.a = static_cast<uint16_t>(target);
+                break;
+            case Format::RT:
+                instruction.b = static_cast<uint16_t>(target);
+                break;
+            default:
+                instruction.c = static_cast<uint16_t>(target);
+                break;
+        }
+    }
+
+    void Compiler::patch(std::vector<uint32_t>& jumps, size_t start, uint32_t target) noexcept {
+        for(auto i = start; i < jumps.size(); i++) {
+            patch(jumps[i], target);
+        }
+        jumps.resize(start);
+    }
+
+    void Compiler::move(uint16_t target, uint16_t source) {
+        if(target != _NO_REGISTER && target != source) {
+            emit(Opcode::Move, target, source);
+        }
+    }
+
+    void Compiler::load(uint16_t target, Value value) {
+        const auto immediate = static_cast<int64_t>(value);
+        if(immediate >= std::numeric_limits<int16_t>::min() && immediate <= std::numeric_limits<int16_t>::max()) {
+            emit(Opcode::LoadImm, target, static_cast<uint16_t>(immediate));
+            return;
+        }
+
+        const auto index = static_cast<uint32_t>(_program.constants.size());
+        _program.constants.push_back(value);
+        emit(Opcode::LoadConst, target, static_cast<uint16_t>(index), static_cast<uint16_t>(index >> 16));
+    }
+
+    ValueType Compiler::get_value_type(NodeIndex node) const noexcept {
+        return to_value_type(_checker->get_type(node));
+    }
+
+    uint16_t Compiler::get_variable(NodeIndex node) const noexcept {
+        if(_tree->get_kind(node) != NodeKind::Identifier || _checker->is_constant(node) || _checker->get_type(node) == Type::Function) {
+            return _NO_REGISTER;
+        }
+        return static_cast<uint16_t>(_slots[_resolver->get_declaration(node)]);
+    }
+
+    void Compiler::compile(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker) {
+        _tree = &tree;
+        _resolver = &resolver;
+        _checker = &checker;
+        _program.functions.clear();
+        _program.code.clear();
+        _program.constants.clear();
+        _slots.assign(tree.get_node_count(), 0);
+        _errors.clear();
+
+        //Calls can precede the function
+        const auto functions = tree.get_children(ast::NO_NODE);
+        if(functions.size() > _MAX_CODE_SIZE) {
+            throw std::runtime_error(fmt::format("more than {} functions", _MAX_CODE_SIZE));
+        }
+        for(size_t i = 0; i < functions.size(); i++) {
+            _slots[functions[i]] = static_cast<uint32_t>(i);
+        }
+        for(const auto function : functions) {
+            compile_function(function);
+        }
+    }
+
+    void Compiler::compile_function(NodeIndex function) {
+        const auto view = _tree->get_function(function);
+        karmac_assert(_tree->get_kind(view.body) == NodeKind::Block);
+
+        _program.functions.push_back({ _tree->get_token(view.name).to_string(), static_cast<uint32_t>(_program.code.size()) });
+        _next_register = 0;
+        _register_count = 0;
+
+        for(const auto parameter : view.parameters) {
+            _slots[parameter] = allocate();
+        }
+        compile_statement(view.body);
+
+        //Reached by falling off the end of the body
+        if(_checker->get_type(function) == Type::Void) {
+            emit(Opcode::ReturnVoid);
+        } else {
+            emit(Opcode::Trap, static_cast<uint16_t>(TrapKind::MissingReturn));
+        }
+
+        auto& compiled = _program.functions.back();
+        compiled.code_size = get_position();
+        compiled.parameter_count = static_cast<uint16_t>(view.parameters.size());
+        compiled.register_count = _register_count;
+    }
+
+    void Compiler::compile_statement(NodeIndex node) {
+        //Temporaries and the variables of blocks are freed at the end of the statement
+        const auto mark = _next_register;
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Block:
+                for(const auto statement : _tree->get_children(node)) {
+                    compile_statement(statement);
+                }
+                break;
+            case NodeKind::Declaration:
+                //The variable lives until the end of the enclosing block
+                compile_declaration(node);
+                return;
+            case NodeKind::If:
+                compile_if(node);
+                break;
+            case NodeKind::While:
+                compile_while(node);
+                break;
+            case NodeKind::For:
+                compile_for(node);
+                break;
+            case NodeKind::Return:
+                if(data.lhs == ast::NO_NODE) {
+                    emit(Opcode::ReturnVoid);
+                } else {
+                    emit(Opcode::Return, compile_operand(data.lhs));
+                }
+                break;
+            case NodeKind::Break:
+                karmac_assert(_loop_depth > 0);
+                _breaks.push_back(emit(Opcode::Jump));
+                break;
+            case NodeKind::Continue:
+                karmac_assert(_loop_depth > 0);
+                _continues.push_back(emit(Opcode::Jump));
+                break;
+            default:
+                compile_expression(node, _NO_REGISTER);
+                break;
+        }
+        _next_register = mark;
+    }
+
+    void Compiler::compile_declaration(NodeIndex node) {
+        //Uses of constants load the folded value
+        if(_checker->is_constant(node)) {
+            return;
+        }
+        if(_checker->get_type(node) == Type::Function) {
+            report(node, "function values can't be stored yet");
+            return;
+        }
+
+        const auto variable = allocate();
+        _slots[node] = variable;
+
+        const auto mark = _next_register;
+        compile_expression(_tree->get_data(node).rhs, variable);
+        _next_register = mark;
+    }
+
+    void Compiler::compile_if(NodeIndex node) {
+        const auto view = _tree->get_if(node);
+        std::vector<uint32_t> jumps;
+        compile_condition(view.condition, false, jumps);
+        compile_statement(view.then);
+
+        if(view.otherwise == ast::NO_NODE) {
+            patch(jumps, 0, get_position());
+            return;
+        }
+
+        const auto end = emit(Opcode::Jump);
+        patch(jumps, 0, get_position());
+        compile_statement(view.otherwise);
+        patch(end, get_position());
+    }
+
+    void Compiler::compile_while(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        std::vector<uint32_t> exits;
+        compile_condition(data.lhs, false, exits);
+
+        const auto breaks = _breaks.size();
+        const auto continues = _continues.size();
+        const auto body = get_position();
+        _loop_depth++;
+        compile_statement(data.rhs);
+        _loop_depth--;
+
+        //The condition is repeated at the end, so every iteration takes one branch
+        const auto condition = get_position();
+        std::vector<uint32_t> repeats;
+        compile_condition(data.lhs, true, repeats);
+        patch(repeats, 0, body);
+        patch(exits, 0, get_position());
+        close_loop(breaks, continues, condition);
+    }
+
+    void Compiler::compile_for(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        const auto& bounds = _tree->get_data(data.lhs);
+        const auto is_signed = type::is_signed(_checker->get_type(node));
+
+        //The end is evaluated once, the variable counts up to it
+        const auto variable = allocate();
+        const auto end = allocate();
+        _slots[node] = variable;
+        compile_expression(bounds.lhs, variable);
+        compile_expression(bounds.rhs, end);
+
+        const auto exit = emit(is_signed ? Opcode::BranchLeS : Opcode::BranchLeU, end, variable);
+        const auto breaks = _breaks.size();
+        const auto continues = _continues.size();
+        const auto body = get_position();
+        _loop_depth++;
+        compile_statement(data.rhs);
+        _loop_depth--;
+
+        const auto step = emit(is_signed ? Opcode::ForStepS : Opcode::ForStepU, variable, end, static_cast<uint16_t>(body));
+        patch(exit, get_position());
+        close_loop(breaks, continues, step);
+    }
+
+    void Compiler::close_loop(size_t breaks, size_t continues, uint32_t continue_target) {
+        patch(_breaks, breaks, get_position());
+        patch(_continues, continues, continue_target);
+    }
+
+    void Compiler::compile_condition(NodeIndex node, bool jump_if, std::vector<uint32_t>& jumps) {
+        if(_checker->is_constant(node)) {
+            if((_checker->get_value(node) != 0) == jump_if) {
+                jumps.push_back(emit(Opcode::Jump));
+            }
+            return;
+        }
+
+        const auto mark = _next_register;
+        const auto& data = _tree->get_data(node);
+        const auto kind = _tree->get_kind(node);
+        const auto op = _tree->get_token(_tree->get_main_token(node)).get_type();
+
+        if(kind == NodeKind::Unary && op == TokenType::Not) {
+            compile_condition(data.lhs, !jump_if, jumps);
+            return;
+        }
+
+        if(kind == NodeKind::Binary && (op == TokenType::Conjunction || op == TokenType::Disjunction)) {
+            //|| jumps if either operand is true and && if either is false, otherwise the left operand skips the right one
+            if((op == TokenType::Disjunction) == jump_if) {
+                compile_condition(data.lhs, jump_if, jumps);
+                compile_condition(data.rhs, jump_if, jumps);
+            } else {
+                std::vector<uint32_t> skips;
+                compile_condition(data.lhs, !jump_if, skips);
+                compile_condition(data.rhs, jump_if, jumps);
+                patch(skips, 0, get_position());
+            }
+            return;
+        }
+
+        //Float comparisons can't be negated because of NaNs
+        const auto type = _checker->get_type(data.lhs);
+        if(kind == NodeKind::Binary && token_type::is_comparison(op) && !type::is_float(type)) {
+            const auto relation = jump_if ? op : negate_comparison(op);
+            auto a = compile_operand(data.lhs);
+            auto b = compile_operand(data.rhs);
+            if(relation == TokenType::Greater || relation == TokenType::GreaterEquals) {
+                std::swap(a, b);
+            }
+            jumps.push_back(emit(get_branch(relation, type::is_signed(type)), a, b));
+            _next_register = mark;
+            return;
+        }
+
+        const auto value = compile_operand(node);
+        jumps.push_back(emit(jump_if ? Opcode::JumpIfTrue : Opcode::JumpIfFalse, value));
+        _next_register = mark;
+    }
+
+    uint16_t Compiler::compile_operand(NodeIndex node) {
+        const auto variable = get_variable(node);
+        if(variable != _NO_REGISTER) {
+            return variable;
+        }
+
+        const auto temporary = allocate();
+        compile_expression(node, temporary);
+        return temporary;
+    }
+
+    void Compiler::compile_expression(NodeIndex node, uint16_t target) {
+        if(_checker->is_constant(node)) {
+            if(target == _NO_REGISTER) {
+                return;
+            }
+
+            auto value = _checker->get_value(node);
+            if(_checker->get_type(node) == Type::F32) {
+                value = std::bit_cast<uint32_t>(static_cast<float>(std::bit_cast<double>(value)));
+            }
+            load(target, value);
+            return;
+        }
+
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Identifier: {
+                const auto variable = get_variable(node);
+                if(variable == _NO_REGISTER) {
+                    report(node, "function values can't be compiled yet");
+                    break;
+                }
+                move(target, variable);
+                break;
+            }
+            case NodeKind::Literal:
+                //Number literals are constants
+                report(node, "string literals can't be compiled yet");
+                break;
+            case NodeKind::Unary:
+                compile_unary(node, target);
+                break;
+            case NodeKind::Postfix: {
+                const auto op = _tree->get_token(_tree->get_main_token(node)).get_type();
+                compile_increment(data.lhs, op == TokenType::Decrement, true, target);
+                break;
+            }
+            case NodeKind::Binary:
+                compile_binary(node, target);
+                break;
+            case NodeKind::Assignment:
+                compile_assignment(node, target);
+                break;
+            case NodeKind::Conditional:
+                compile_conditional(node, target);
+                break;
+            case NodeKind::Call:
+                compile_call(node, target);
+                break;
+            default:
+                report(node, fmt::format("{} expressions can't be compiled yet", ast::node_kind::get_name(_tree->get_kind(node))));
+                break;
+        }
+    }
+
+    void Compiler::compile_unary(NodeIndex node, uint16_t target) {
+        const auto op = _tree->get_token(_tree->get_main_token(node)).get_type();
+        const auto operand = _tree->get_data(node).lhs;
+        switch(op) {
+            case TokenType::Increment:
+            case TokenType::Decrement:
+                compile_increment(operand, op == TokenType::Decrement, false, target);
+                return;
+            case TokenType::Add:
+                compile_expression(operand, target);
+                return;
+            default:
+                break;
+        }
+
+        if(target == _NO_REGISTER) {
+            target = allocate();
+        }
+        const auto mark = _next_register;
+        const auto value = compile_operand(operand);
+        if(op == TokenType::Not) {
+            emit(Opcode::Not, target, value);
+        } else {
+            emit(opcode::get_typed(Opcode::NegU8, get_value_type(node)), target, value);
+        }
+        _next_register = mark;
+    }
+
+    void Compiler::compile_increment(NodeIndex operand, bool decrement, bool postfix, uint16_t target) {
+        const auto variable = get_variable(operand);
+        karmac_assert(variable != _NO_REGISTER);
+        const auto type = get_value_type(operand);
+
+        if(postfix) {
+            move(target, variable);
+        }
+
+        if(is_float(type)) {
+            const auto mark = _next_register;
+            const auto one = allocate();
+            load(one, type == ValueType::F32 ? std::bit_cast<uint32_t>(1.0f) : std::bit_cast<uint64_t>(1.0));
+            emit(opcode::get_typed(decrement ? Opcode::SubU8 : Opcode::AddU8, type), variable, variable, one);
+            _next_register = mark;
+        } else {
+            emit(opcode::get_typed(Opcode::AddImmU8, type), variable, variable, decrement ? static_cast<uint16_t>(-1) : 1);
+        }
+
+        if(!postfix) {
+            move(target, variable);
+        }
+    }
+
+    void Compiler::compile_binary(NodeIndex node, uint16_t target) {
+        const auto op = _tree->get_token(_tree->get_main_token(node)).get_type();
+        if(op == TokenType::Conjunction || op == TokenType::Disjunction) {
+            compile_logical(node, target);
+            return;
+        }
+
+        const auto& data = _tree->get_data(node);
+        if(target == _NO_REGISTER) {
+            target = allocate();
+        }
+        const auto mark = _next_register;
+
+        if(token_type::is_comparison(op)) {
+            auto a = compile_operand(data.lhs);
+            auto b = compile_operand(data.rhs);
+            if(op == TokenType::Greater || op == TokenType::GreaterEquals) {
+                std::swap(a, b);
+            }
+            emit(get_comparison(op, _checker->get_type(data.lhs)), target, a, b);
+        } else {
+            compile_arithmetic(op, get_value_type(data.lhs), target, compile_operand(data.lhs), data.rhs);
+        }
+        _next_register = mark;
+    }
+
+    void Compiler::compile_arithmetic(TokenType op, ValueType type, uint16_t target, uint16_t a, NodeIndex rhs) {
+        //Adding and subtracting small constants takes an immediate
+        if((op == TokenType::Add || op == TokenType::Sub) && !is_float(type) && _checker->is_constant(rhs)) {
+            const auto value = static_cast<int64_t>(_checker->get_value(rhs));
+            if(value > std::numeric_limits<int16_t>::min() && value <= std::numeric_limits<int16_t>::max()) {
+                const auto immediate = op == TokenType::Add ? value : -value;
+                emit(opcode::get_typed(Opcode::AddImmU8, type), target, a, static_cast<uint16_t>(immediate));
+                return;
+            }
+        }
+
+        const auto b = compile_operand(rhs);
+        auto opcode = Opcode::And;
+        switch(op) {
+            case TokenType::Add:
+                opcode = opcode::get_typed(Opcode::AddU8, type);
+                break;
+            case TokenType::Sub:
+                opcode = opcode::get_typed(Opcode::SubU8, type);
+                break;
+            case TokenType::Mul:
+                opcode = opcode::get_typed(Opcode::MulU8, type);
+                break;
+            case TokenType::Div:
+                opcode = opcode::get_typed(Opcode::DivU8, type);
+                break;
+            case TokenType::Mod:
+                opcode = opcode::get_typed(Opcode::ModU8, type);
+                break;
+            case TokenType::LeftShift:
+                opcode = opcode::get_typed(Opcode::ShlU8, type);
+                break;
+            case TokenType::RightShift:
+                opcode = opcode::get_typed(Opcode::ShrU8, type);
+                break;
+            case TokenType::And:
+                opcode = Opcode::And;
+                break;
+            case TokenType::Or:
+                opcode = Opcode::Or;
+                break;
+            case TokenType::Xor:
+                opcode = Opcode::Xor;
+                break;
+            default:
+                break;
+        }
+        emit(opcode, target, a, b);
+    }
+
+    void Compiler::compile_logical(NodeIndex node, uint16_t target) {
+        const auto& data = _tree->get_data(node);
+        const auto op = _tree->get_token(_tree->get_main_token(node)).get_type();
+
+        //Computed in a temporary, the right operand may read the target
+        const auto mark = _next_register;
+        const auto result = allocate();
+        compile_expression(data.lhs, result);
+        const auto skip = emit(op == TokenType::Conjunction ? Opcode::JumpIfFalse : Opcode::JumpIfTrue, result);
+        compile_expression(data.rhs, result);
+        patch(skip, get_position());
+        move(target, result);
+        _next_register = mark;
+    }
+
+    void Compiler::compile_assignment(NodeIndex node, uint16_t target) {
+        const auto& data = _tree->get_data(node);
+        const auto variable = get_variable(data.lhs);
+        if(variable == _NO_REGISTER) {
+            report(data.lhs, "function values can't be compiled yet");
+            return;
+        }
+
+        const auto op = token_type::get_compound_operator(_tree->get_token(_tree->get_main_token(node)).get_type());
+        if(op == TokenType::Assign) {
+            compile_expression(data.rhs, variable);
+        } else {
+            const auto mark = _next_register;
+            compile_arithmetic(op, get_value_type(data.lhs), variable, variable, data.rhs);
+            _next_register = mark;
+        }
+        move(target, variable);
+    }
+
+    void Compiler::compile_conditional(NodeIndex node, uint16_t target) {
+        const auto view = _tree->get_conditional(node);
+        if(target == _NO_REGISTER) {
+            target = allocate();
+        }
+
+        std::vector<uint32_t> jumps;
+        compile_condition(view.condition, false, jumps);
+        compile_expression(view.then, target);
+        const auto end = emit(Opcode::Jump);
+        patch(jumps, 0, get_position());
+        compile_expression(view.otherwise, target);
+        patch(end, get_position());
+    }
+
+    void Compiler::compile_call(NodeIndex node, uint16_t target) {
+        const auto view = _tree->get_call(node);
+        const auto function = _slots[_resolver->get_declaration(view.callee)];
+
+        if(target == _NO_REGISTER) {
+            target = allocate();
+        }
+
+        //The arguments become the parameters of the callee in place
+        const auto mark = _next_register;
+        const auto arguments = _next_register;
+        for(size_t i = 0; i < view.arguments.size(); i++) {
+            allocate();
+        }
+        for(size_t i = 0; i < view.arguments.size(); i++) {
+            compile_expression(view.arguments[i], static_cast<uint16_t>(arguments + i));
+        }
+
+        emit(Opcode::Call, target, static_cast<uint16_t>(function), arguments);
+        _next_register = mark;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "program.hpp"
+#include "../check/type_checker.hpp"
+#include "../parse/ast/tree.hpp"
+#include "../resolve/resolver.hpp"
+#include "../source/diagnostic.hpp"
+#include <limits>
+#include <vector>
+
+namespace karmac::bytecode {
+    //Translates a checked tree to register bytecode in one pass. Variables live in registers for their whole scope and
+    //temporaries are allocated above them like a stack, the arguments of a call are the first registers of the callee.
+    //Constant expressions become loads of their folded value. Conditions of ifs and loops compile to jumps instead of
+    //bools, integer comparisons to compare-and-branch instructions. Loops are rotated, the condition is repeated at
+    //their end, and for loops step their variable with one instruction.
+    class Compiler final {
+    private:
+        static constexpr uint16_t _NO_REGISTER = std::numeric_limits<uint16_t>::max();
+        static constexpr size_t _MAX_CODE_SIZE = std::numeric_limits<uint16_t>::max() + size_t(1);
+
+        const ast::Tree* _tree = nullptr;
+        const Resolver* _resolver = nullptr;
+        const TypeChecker* _checker = nullptr;
+        Program _program;
+
+        //Indexed by node, the register of Parameters, Declarations and Fors and the index of Functions
+        std::vector<uint32_t> _slots;
+
+        //State of the function being compiled
+        uint16_t _next_register = 0;
+        uint16_t _register_count = 0;
+        //Jumps of break and continue statements waiting for the end of their loop, the innermost loop owns the tail
+        std::vector<uint32_t> _breaks;
+        std::vector<uint32_t> _continues;
+        //Loops around the statement being compiled, the checker rejects break and continue outside of them
+        uint32_t _loop_depth = 0;
+
+        std::vector<Diagnostic> _errors;
+
+        inline void report(ast::NodeIndex node, std::string message) {
+            _errors.push_back({ _tree->get_location(node), std::move(message) });
+        }
+
+        [[nodiscard]] inline uint32_t get_position() const noexcept {
+            return static_cast<uint32_t>(_program.code.size() - _program.functions.back().code_start);
+        }
+
+        uint16_t allocate();
+        uint32_t emit(Opcode op, uint16_t a = 0, uint16_t b = 0, uint16_t c = 0);
+        //Sets the target of the jump at `position`
+        void patch(uint32_t position, uint32_t target) noexcept;
+        void patch(std::vector<uint32_t>& jumps, size_t start, uint32_t target) noexcept;
+        void move(uint16_t target, uint16_t source);
+        void load(uint16_t target, Value value);
+
+        //The value type of an expression, a declaration or a for
+        [[nodiscard]] ValueType get_value_type(ast::NodeIndex node) const noexcept;
+        //The register of a variable, _NO_REGISTER for other expressions
+        [[nodiscard]] uint16_t get_variable(ast::NodeIndex node) const noexcept;
+
+        void compile_function(ast::NodeIndex function);
+        void compile_statement(ast::NodeIndex node);
+        void compile_declaration(ast::NodeIndex node);
+        void compile_if(ast::NodeIndex node);
+        void compile_while(ast::NodeIndex node);
+        void compile_for(ast::NodeIndex node);
+        //Jumps out of the innermost loop from `breaks` and `continues` on
+        void close_loop(size_t breaks, size_t continues, uint32_t continue_target);
+
+        //Appends the jumps taken if the condition is `jump_if` to `jumps`, they have to be patched by the caller
+        void compile_condition(ast::NodeIndex node, bool jump_if, std::vector<uint32_t>& jumps);
+        //Returns the register of variables and compiles other expressions into a new temporary
+        [[nodiscard]] uint16_t compile_operand(ast::NodeIndex node);
+        //The result is discarded if `target` is _NO_REGISTER
+        void compile_expression(ast::NodeIndex node, uint16_t target);
+        void compile_unary(ast::NodeIndex node, uint16_t target);
+        void compile_increment(ast::NodeIndex operand, bool decrement, bool postfix, uint16_t target);
+        void compile_binary(ast::NodeIndex node, uint16_t target);
+        //`target` = `a` op `rhs` for arithmetic and bitwise operators, both operands have the type `type`
+        void compile_arithmetic(TokenType op, ValueType type, uint16_t target, uint16_t a, ast::NodeIndex rhs);
+        void compile_logical(ast::NodeIndex node, uint16_t target);
+        void compile_assignment(ast::NodeIndex node, uint16_t target);
+        void compile_conditional(ast::NodeIndex node, uint16_t target);
+        void compile_call(ast::NodeIndex node, uint16_t target);
+    public:
+        //Replaces the program with the one of `tree`, which has to be fully parsed and was checked without errors.
+        //Function names refer to the source text. Throws std::runtime_error if a function exceeds the limits of the
+        //bytecode, 65536 instructions and 65535 registers.
+        void compile(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker);
+
+        [[nodiscard]] inline const Program& get_program() const noexcept {
+            return _program;
+        }
+
+        //Constructs the bytecode can't express yet, in source order
+        [[nodiscard]] inline const std::vector<Diagnostic>& get_errors() const noexcept {
+            return _errors;
+        }
+    };
+}
\ No newline at end of file
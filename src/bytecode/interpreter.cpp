@@ -0,0 +1,361 @@
+#include "interpreter.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+
+//Labels as values are a GNU extension, MSVC dispatches with the switch
+#if defined(__GNUC__) && !defined(KARMAC_VM_SWITCH_DISPATCH)
+#define KARMAC_VM_COMPUTED_GOTO
+#endif
+
+#ifdef KARMAC_VM_COMPUTED_GOTO
+#define KARMAC_VM_CASE(name) op_##name:
+#define KARMAC_VM_DISPATCH() goto *labels[static_cast<size_t>(pc->op)]
+#else
+#define KARMAC_VM_CASE(name) case Opcode::name:
+#define KARMAC_VM_DISPATCH() continue
+#endif
+#define KARMAC_VM_NEXT() ++pc; KARMAC_VM_DISPATCH()
+
+#define KARMAC_VM_BINARY(name, T, function) KARMAC_VM_CASE(name) r[pc->a] = function<T>(r[pc->b], r[pc->c]); KARMAC_VM_NEXT();
+#define KARMAC_VM_DIVISION(name, T, function) \
+    KARMAC_VM_CASE(name) \
+        if(r[pc->c] == 0) { \
+            trap = TrapKind::DivisionByZero; \
+            goto trapped; \
+        } \
+        r[pc->a] = function<T>(r[pc->b], r[pc->c]); \
+        KARMAC_VM_NEXT();
+#define KARMAC_VM_UNARY(name, T, function) KARMAC_VM_CASE(name) r[pc->a] = function<T>(r[pc->b]); KARMAC_VM_NEXT();
+#define KARMAC_VM_IMMEDIATE(name, T, function) KARMAC_VM_CASE(name) r[pc->a] = function<T>(r[pc->b], pc->c); KARMAC_VM_NEXT();
+
+#define KARMAC_VM_INTEGERS(HANDLER, name, function) \
+    HANDLER(name##U8, uint8_t, function) HANDLER(name##I8, int8_t, function) \
+    HANDLER(name##U16, uint16_t, function) HANDLER(name##I16, int16_t, function) \
+    HANDLER(name##U32, uint32_t, function) HANDLER(name##I32, int32_t, function) \
+    HANDLER(name##U64, uint64_t, function) HANDLER(name##I64, int64_t, function)
+#define KARMAC_VM_FLOATS(HANDLER, name, function) HANDLER(name##F32, float, function) HANDLER(name##F64, double, function)
+
+namespace karmac::bytecode {
+    template<typename T>
+    static inline Value box(T value) noexcept {
+        if constexpr(std::is_same_v<T, float>) {
+            return std::bit_cast<uint32_t>(value);
+        } else if constexpr(std::is_same_v<T, double>) {
+            return std::bit_cast<uint64_t>(value);
+        } else if constexpr(std::is_signed_v<T>) {
+            return static_cast<Value>(static_cast<int64_t>(value));
+        } else {
+            return static_cast<Value>(value);
+        }
+    }
+
+    template<typename T>
+    static inline T unbox(Value value) noexcept {
+        if constexpr(std::is_same_v<T, float>) {
+            return std::bit_cast<float>(static_cast<uint32_t>(value));
+        } else if constexpr(std::is_same_v<T, double>) {
+            return std::bit_cast<double>(value);
+        } else {
+            return static_cast<T>(value);
+        }
+    }
+
+    //Integers are computed on the 64-bit registers, which wraps around, and truncated to their type
+    template<typename T>
+    static inline Value add(Value a, Value b) noexcept {
+        if constexpr(std::is_floating_point_v<T>) {
+            return box<T>(unbox<T>(a) + unbox<T>(b));
+        } else {
+            return box<T>(static_cast<T>(a + b));
+        }
+    }
+
+    template<typename T>
+    static inline Value subtract(Value a, Value b) noexcept {
+        if constexpr(std::is_floating_point_v<T>) {
+            return box<T>(unbox<T>(a) - unbox<T>(b));
+        } else {
+            return box<T>(static_cast<T>(a - b));
+        }
+    }
+
+    template<typename T>
+    static inline Value multiply(Value a, Value b) noexcept {
+        if constexpr(std::is_floating_point_v<T>) {
+            return box<T>(unbox<T>(a) * unbox<T>(b));
+        } else {
+            return box<T>(static_cast<T>(a * b));
+        }
+    }
+
+    //The divisor of integers isn't 0, the only quotient that overflows is the minimum divided by -1
+    template<typename T>
+    static inline Value divide(Value a, Value b) noexcept {
+        if constexpr(std::is_floating_point_v<T>) {
+            return box<T>(unbox<T>(a) / unbox<T>(b));
+        } else if constexpr(std::is_signed_v<T>) {
+            if(static_cast<int64_t>(b) == -1) {
+                return box<T>(static_cast<T>(0 - a));
+            }
+            return box<T>(static_cast<T>(static_cast<int64_t>(a) / static_cast<int64_t>(b)));
+        } else {
+            return a / b;
+        }
+    }
+
+    template<typename T>
+    static inline Value modulo(Value a, Value b) noexcept {
+        if constexpr(std::is_signed_v<T>) {
+            if(static_cast<int64_t>(b) == -1) {
+                return 0;
+            }
+            return box<T>(static_cast<T>(static_cast<int64_t>(a) % static_cast<int64_t>(b)));
+        } else {
+            return a % b;
+        }
+    }
+
+    template<typename T>
+    static inline Value shift_left(Value a, Value b) noexcept {
+        return box<T>(static_cast<T>(a << (b & (sizeof(T) * 8 - 1))));
+    }
+
+    //Signed values are extended to 64 bits, so shifting them shifts in their sign
+    template<typename T>
+    static inline Value shift_right(Value a, Value b) noexcept {
+        const auto amount = b & (sizeof(T) * 8 - 1);
+        if constexpr(std::is_signed_v<T>) {
+            return box<T>(static_cast<T>(static_cast<int64_t>(a) >> amount));
+        } else {
+            return a >> amount;
+        }
+    }
+
+    template<typename T>
+    static inline Value add_immediate(Value a, uint16_t immediate) noexcept {
+        return box<T>(static_cast<T>(a + static_cast<Value>(static_cast<int16_t>(immediate))));
+    }
+
+    template<typename T>
+    static inline Value negate(Value a) noexcept {
+        if constexpr(std::is_floating_point_v<T>) {
+            return box<T>(-unbox<T>(a));
+        } else {
+            return box<T>(static_cast<T>(0 - a));
+        }
+    }
+
+    Value Interpreter::call(const Program& program, size_t function, std::span<const Value> arguments) {
+        if(_stack.empty()) {
+            _stack.resize(_STACK_SIZE);
+            _frames.reserve(_MAX_DEPTH);
+        }
+        _frames.clear();
+
+        const auto* const functions = program.functions.data();
+        const auto* const constants = program.constants.data();
+        const auto* const stack_end = _stack.data() + _stack.size();
+        auto current = static_cast<uint32_t>(function);
+        if(functions[current].register_count > _stack.size()) {
+            throw RuntimeError(fmt::format("{} in {}", trap_kind::get_message(TrapKind::StackOverflow), functions[current].name));
+        }
+
+        auto* r = _stack.data();
+        std::copy(arguments.begin(), arguments.end(), r);
+        const auto* code = program.code.data() + functions[current].code_start;
+        const auto* pc = code;
+        Value result = 0;
+        auto trap = TrapKind::StackOverflow;
+
+#ifdef KARMAC_VM_COMPUTED_GOTO
+#define KARMAC_VM_LABEL(name, format) &&op_##name,
+        static const void* const labels[] = { KARMAC_OPCODES(KARMAC_VM_LABEL) };
+#undef KARMAC_VM_LABEL
+        KARMAC_VM_DISPATCH();
+#else
+        for(;;) {
+        switch(pc->op) {
+#endif
+
+        KARMAC_VM_CASE(Move)
+            r[pc->a] = r[pc->b];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LoadImm)
+            r[pc->a] = static_cast<Value>(static_cast<int16_t>(pc->b));
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LoadConst)
+            r[pc->a] = constants[pc->b | (static_cast<uint32_t>(pc->c) << 16)];
+            KARMAC_VM_NEXT();
+
+        KARMAC_VM_CASE(Jump)
+            pc = code + pc->a;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(JumpIfTrue)
+            pc = r[pc->a] != 0 ? code + pc->b : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(JumpIfFalse)
+            pc = r[pc->a] == 0 ? code + pc->b : pc + 1;
+            KARMAC_VM_DISPATCH();
+
+        KARMAC_VM_CASE(BranchEq)
+            pc = r[pc->a] == r[pc->b] ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(BranchNe)
+            pc = r[pc->a] != r[pc->b] ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(BranchLtS)
+            pc = static_cast<int64_t>(r[pc->a]) < static_cast<int64_t>(r[pc->b]) ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(BranchLtU)
+            pc = r[pc->a] < r[pc->b] ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(BranchLeS)
+            pc = static_cast<int64_t>(r[pc->a]) <= static_cast<int64_t>(r[pc->b]) ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(BranchLeU)
+            pc = r[pc->a] <= r[pc->b] ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+
+        //The variable is below the end before the step, so it can't wrap around
+        KARMAC_VM_CASE(ForStepS)
+            pc = static_cast<int64_t>(++r[pc->a]) < static_cast<int64_t>(r[pc->b]) ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+        KARMAC_VM_CASE(ForStepU)
+            pc = ++r[pc->a] < r[pc->b] ? code + pc->c : pc + 1;
+            KARMAC_VM_DISPATCH();
+
+        KARMAC_VM_INTEGERS(KARMAC_VM_BINARY, Add, add)
+        KARMAC_VM_FLOATS(KARMAC_VM_BINARY, Add, add)
+        KARMAC_VM_INTEGERS(KARMAC_VM_BINARY, Sub, subtract)
+        KARMAC_VM_FLOATS(KARMAC_VM_BINARY, Sub, subtract)
+        KARMAC_VM_INTEGERS(KARMAC_VM_BINARY, Mul, multiply)
+        KARMAC_VM_FLOATS(KARMAC_VM_BINARY, Mul, multiply)
+        KARMAC_VM_INTEGERS(KARMAC_VM_DIVISION, Div, divide)
+        KARMAC_VM_FLOATS(KARMAC_VM_BINARY, Div, divide)
+        KARMAC_VM_INTEGERS(KARMAC_VM_DIVISION, Mod, modulo)
+        KARMAC_VM_INTEGERS(KARMAC_VM_BINARY, Shl, shift_left)
+        KARMAC_VM_INTEGERS(KARMAC_VM_BINARY, Shr, shift_right)
+        KARMAC_VM_INTEGERS(KARMAC_VM_IMMEDIATE, AddImm, add_immediate)
+        KARMAC_VM_INTEGERS(KARMAC_VM_UNARY, Neg, negate)
+        KARMAC_VM_FLOATS(KARMAC_VM_UNARY, Neg, negate)
+
+        //Bitwise operations and equality keep the extension of integers
+        KARMAC_VM_CASE(And)
+            r[pc->a] = r[pc->b] & r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(Or)
+            r[pc->a] = r[pc->b] | r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(Xor)
+            r[pc->a] = r[pc->b] ^ r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(Not)
+            r[pc->a] = r[pc->b] ^ 1;
+            KARMAC_VM_NEXT();
+
+        KARMAC_VM_CASE(Eq)
+            r[pc->a] = r[pc->b] == r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(Ne)
+            r[pc->a] = r[pc->b] != r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LtS)
+            r[pc->a] = static_cast<int64_t>(r[pc->b]) < static_cast<int64_t>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LtU)
+            r[pc->a] = r[pc->b] < r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LeS)
+            r[pc->a] = static_cast<int64_t>(r[pc->b]) <= static_cast<int64_t>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LeU)
+            r[pc->a] = r[pc->b] <= r[pc->c];
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(EqF32)
+            r[pc->a] = unbox<float>(r[pc->b]) == unbox<float>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(NeF32)
+            r[pc->a] = unbox<float>(r[pc->b]) != unbox<float>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LtF32)
+            r[pc->a] = unbox<float>(r[pc->b]) < unbox<float>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LeF32)
+            r[pc->a] = unbox<float>(r[pc->b]) <= unbox<float>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(EqF64)
+            r[pc->a] = unbox<double>(r[pc->b]) == unbox<double>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(NeF64)
+            r[pc->a] = unbox<double>(r[pc->b]) != unbox<double>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LtF64)
+            r[pc->a] = unbox<double>(r[pc->b]) < unbox<double>(r[pc->c]);
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(LeF64)
+            r[pc->a] = unbox<double>(r[pc->b]) <= unbox<double>(r[pc->c]);
+            KARMAC_VM_NEXT();
+
+        KARMAC_VM_CASE(Call) {
+            const auto& callee = functions[pc->b];
+            auto* const registers = r + pc->c;
+            if(registers + callee.register_count > stack_end || _frames.size() == _MAX_DEPTH) {
+                trap = TrapKind::StackOverflow;
+                goto trapped;
+            }
+
+            _frames.push_back({ code, pc, r, current });
+            current = pc->b;
+            r = registers;
+            code = program.code.data() + callee.code_start;
+            pc = code;
+            KARMAC_VM_DISPATCH();
+        }
+        KARMAC_VM_CASE(Return)
+            result = r[pc->a];
+            goto leave;
+        KARMAC_VM_CASE(ReturnVoid)
+            result = 0;
+        leave:
+            if(_frames.empty()) {
+                return result;
+            }
+            {
+                const auto& frame = _frames.back();
+                code = frame.code;
+                pc = frame.pc;
+                r = frame.registers;
+                current = frame.function;
+                _frames.pop_back();
+            }
+            r[pc->a] = result;
+            KARMAC_VM_NEXT();
+        KARMAC_VM_CASE(Trap)
+            trap = static_cast<TrapKind>(pc->a);
+            goto trapped;
+
+#ifndef KARMAC_VM_COMPUTED_GOTO
+            case Opcode::Count:
+                break;
+        }
+        }
+#endif
+
+    trapped:
+        throw RuntimeError(fmt::format("{} in {}", trap_kind::get_message(trap), functions[current].name));
+    }
+}
+
+#undef KARMAC_VM_COMPUTED_GOTO
+#undef KARMAC_VM_CASE
+#undef KARMAC_VM_DISPATCH
+#undef KARMAC_VM_NEXT
+#undef KARMAC_VM_BINARY
+#undef KARMAC_VM_DIVISION
+#undef KARMAC_VM_UNARY
+#undef KARMAC_VM_IMMEDIATE
+#undef KARMAC_VM_INTEGERS
+#undef KARMAC_VM_FLOATS
\ No newline at end of file
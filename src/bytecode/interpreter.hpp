@@ -0,0 +1,41 @@
+#pragma once
+
+#include "program.hpp"
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace karmac::bytecode {
+    //A trap of the executed program, the message names the trap and the function it happened in
+    class RuntimeError final : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    //Executes bytecode with one indirect jump per instruction: every handler jumps straight to the handler of the next
+    //instruction through a table of label addresses where the compiler supports it, a switch in a loop otherwise.
+    //Integer arithmetic wraps around in the width of its type, shift amounts are taken modulo the width and dividing the
+    //minimum of a signed type by -1 gives the minimum.
+    //The registers of all frames are one fixed stack, so calls only move the frame base to their arguments. An
+    //interpreter can be reused, the stack is allocated by the first call.
+    class Interpreter final {
+    private:
+        static constexpr size_t _STACK_SIZE = 1024 * 1024;
+        static constexpr size_t _MAX_DEPTH = 64 * 1024;
+
+        struct Frame {
+            const Instruction* code;
+            //The call instruction, its a field is the register of the result
+            const Instruction* pc;
+            Value* registers;
+            uint32_t function;
+        };
+
+        std::vector<Value> _stack;
+        std::vector<Frame> _frames;
+    public:
+        //Runs the function with the arguments in the representation of the registers and returns its result, 0 for
+        //void functions. Throws RuntimeError when the program traps or overflows the stack.
+        [[nodiscard]] Value call(const Program& program, size_t function, std::span<const Value> arguments);
+    };
+}
\ No newline at end of file
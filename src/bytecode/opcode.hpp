@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+//Typed families have one opcode per value type in the order of bytecode::ValueType, the opcode for a type is the first
+//one of the family plus the index of the type. Integer families stop before the float types.
+#define KARMAC_INTEGER_FAMILY(X, name, format) \
+    X(name##U8, format) X(name##I8, format) X(name##U16, format) X(name##I16, format) \
+    X(name##U32, format) X(name##I32, format) X(name##U64, format) X(name##I64, format)
+#define KARMAC_NUMERIC_FAMILY(X, name, format) KARMAC_INTEGER_FAMILY(X, name, format) X(name##F32, format) X(name##F64, format)
+
+//Every opcode with the format of its operands, see bytecode::Format
+#define KARMAC_OPCODES(X) \
+    X(Move, RR) \
+    X(LoadImm, RI) \
+    X(LoadConst, RK) \
+    X(Jump, T) \
+    X(JumpIfTrue, RT) \
+    X(JumpIfFalse, RT) \
+    /* Compare and branch, integers are compared by signedness since registers hold them extended to 64 bits */ \
+    X(BranchEq, RRT) \
+    X(BranchNe, RRT) \
+    X(BranchLtS, RRT) \
+    X(BranchLtU, RRT) \
+    X(BranchLeS, RRT) \
+    X(BranchLeU, RRT) \
+    /* Increments a and branches if it is still below b, the step of a for loop */ \
+    X(ForStepS, RRT) \
+    X(ForStepU, RRT) \
+    KARMAC_NUMERIC_FAMILY(X, Add, RRR) \
+    KARMAC_NUMERIC_FAMILY(X, Sub, RRR) \
+    KARMAC_NUMERIC_FAMILY(X, Mul, RRR) \
+    KARMAC_NUMERIC_FAMILY(X, Div, RRR) \
+    KARMAC_INTEGER_FAMILY(X, Mod, RRR) \
+    KARMAC_INTEGER_FAMILY(X, Shl, RRR) \
+    KARMAC_INTEGER_FAMILY(X, Shr, RRR) \
+    KARMAC_INTEGER_FAMILY(X, AddImm, RRI) \
+    KARMAC_NUMERIC_FAMILY(X, Neg, RR) \
+    X(And, RRR) \
+    X(Or, RRR) \
+    X(Xor, RRR) \
+    X(Not, RR) \
+    X(Eq, RRR) \
+    X(Ne, RRR) \
+    X(LtS, RRR) \
+    X(LtU, RRR) \
+    X(LeS, RRR) \
+    X(LeU, RRR) \
+    X(EqF32, RRR) \
+    X(NeF32, RRR) \
+    X(LtF32, RRR) \
+    X(LeF32, RRR) \
+    X(EqF64, RRR) \
+    X(NeF64, RRR) \
+    X(LtF64, RRR) \
+    X(LeF64, RRR) \
+    X(Call, Call) \
+    X(Return, R) \
+    X(ReturnVoid, None) \
+    X(Trap, Trap)
+
+namespace karmac::bytecode {
+    //Registers hold every value in 64 bits: integers sign-extended for signed types and zero-extended for unsigned
+    //ones, bools as 0 or 1, f32 as the bits of a float and f64 as the bits of a double. Size types are 64-bit integers.
+    enum class ValueType : uint8_t {
+        U8,
+        I8,
+        U16,
+        I16,
+        U32,
+        I32,
+        U64,
+        I64,
+        F32,
+        F64
+    };
+
+#define KARMAC_OPCODE_ENUM(name, format) name,
+    enum class Opcode : uint16_t {
+        KARMAC_OPCODES(KARMAC_OPCODE_ENUM)
+        Count
+    };
+#undef KARMAC_OPCODE_ENUM
+
+    //How the a, b and c fields of an instruction are used, R is a register, I a signed 16-bit immediate, K an index
+    //into the constants split over b and c and T the index of an instruction of the same function
+    enum class Format : uint8_t {
+        None,
+        R,
+        RR,
+        RRR,
+        RI,
+        RRI,
+        RK,
+        T,
+        RT,
+        RRT,
+        //Result register, function index and the register of the first argument
+        Call,
+        //The TrapKind in a
+        Trap
+    };
+
+    enum class TrapKind : uint16_t {
+        DivisionByZero,
+        MissingReturn,
+        StackOverflow
+    };
+
+    namespace trap_kind {
+        [[nodiscard]] constexpr std::string_view get_message(TrapKind kind) noexcept {
+            switch(kind) {
+                case TrapKind::DivisionByZero:
+                    return "division by zero";
+                case TrapKind::MissingReturn:
+                    return "reached the end of a function without returning a value";
+                case TrapKind::StackOverflow:
+                    return "stack overflow";
+                default:
+                    return "unknown trap";
+            }
+        }
+    }
+
+    //Fixed size instructions, the fields are named by the order of the operands
+    struct Instruction {
+        Opcode op;
+        uint16_t a = 0;
+        uint16_t b = 0;
+        uint16_t c = 0;
+    };
+
+    namespace opcode {
+#define KARMAC_OPCODE_NAME(name, format) #name,
+        static constexpr std::array<std::string_view, static_cast<size_t>(Opcode::Count)> _NAMES = {
+            KARMAC_OPCODES(KARMAC_OPCODE_NAME)
+        };
+#undef KARMAC_OPCODE_NAME
+
+#define KARMAC_OPCODE_FORMAT(name, format) Format::format,
+        static constexpr std::array<Format, static_cast<size_t>(Opcode::Count)> _FORMATS = {
+            KARMAC_OPCODES(KARMAC_OPCODE_FORMAT)
+        };
+#undef KARMAC_OPCODE_FORMAT
+
+        [[nodiscard]] constexpr std::string_view get_name(Opcode op) noexcept {
+            return _NAMES[static_cast<size_t>(op)];
+        }
+
+        [[nodiscard]] constexpr Format get_format(Opcode op) noexcept {
+            return _FORMATS[static_cast<size_t>(op)];
+        }
+
+        //The opcode of a typed family for `type`, `family` is the first opcode of the family
+        [[nodiscard]] constexpr Opcode get_typed(Opcode family, ValueType type) noexcept {
+            return static_cast<Opcode>(static_cast<uint16_t>(family) + static_cast<uint16_t>(type));
+        }
+    }
+}
\ No newline at end of file
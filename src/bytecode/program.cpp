@@ -0,0 +1,87 @@
+#include "program.hpp"
+
+#include <fmt/format.h>
+#include <iterator>
+
+namespace karmac::bytecode {
+    size_t Program::find_function(std::string_view name) const noexcept {
+        for(size_t i = 0; i < functions.size(); i++) {
+            if(functions[i].name == name) {
+                return i;
+            }
+        }
+        return functions.size();
+    }
+
+    static std::string_view get_trap_name(TrapKind kind) noexcept {
+        switch(kind) {
+            case TrapKind::DivisionByZero:
+                return "division_by_zero";
+            case TrapKind::MissingReturn:
+                return "missing_return";
+            case TrapKind::StackOverflow:
+                return "stack_overflow";
+            default:
+                return "unknown";
+        }
+    }
+
+    static void append_operands(fmt::memory_buffer& buffer, const Program& program, const Instruction& instruction) {
+        const auto out = std::back_inserter(buffer);
+        const auto immediate = static_cast<int16_t>(instruction.c);
+        switch(opcode::get_format(instruction.op)) {
+            case Format::None:
+                break;
+            case Format::R:
+                fmt::format_to(out, " r{}", instruction.a);
+                break;
+            case Format::RR:
+                fmt::format_to(out, " r{}, r{}", instruction.a, instruction.b);
+                break;
+            case Format::RRR:
+                fmt::format_to(out, " r{}, r{}, r{}", instruction.a, instruction.b, instruction.c);
+                break;
+            case Format::RI:
+                fmt::format_to(out, " r{}, {}", instruction.a, static_cast<int16_t>(instruction.b));
+                break;
+            case Format::RRI:
+                fmt::format_to(out, " r{}, r{}, {}", instruction.a, instruction.b, immediate);
+                break;
+            case Format::RK: {
+                const auto index = instruction.b | (static_cast<uint32_t>(instruction.c) << 16);
+                fmt::format_to(out, " r{}, k{} ({:#x})", instruction.a, index, program.constants[index]);
+                break;
+            }
+            case Format::T:
+                fmt::format_to(out, " @{}", instruction.a);
+                break;
+            case Format::RT:
+                fmt::format_to(out, " r{}, @{}", instruction.a, instruction.b);
+                break;
+            case Format::RRT:
+                fmt::format_to(out, " r{}, r{}, @{}", instruction.a, instruction.b, instruction.c);
+                break;
+            case Format::Call:
+                fmt::format_to(out, " r{}, {}, r{}", instruction.a, program.functions[instruction.b].name, instruction.c);
+                break;
+            case Format::Trap:
+                fmt::format_to(out, " {}", get_trap_name(static_cast<TrapKind>(instruction.a)));
+                break;
+        }
+    }
+
+    std::string disassemble(const Program& program) {
+        fmt::memory_buffer buffer;
+        const auto out = std::back_inserter(buffer);
+        for(const auto& function : program.functions) {
+            fmt::format_to(out, "fn {}: {} parameters, {} registers\n", function.name, function.parameter_count, function.register_count);
+            for(uint32_t i = 0; i < function.code_size; i++) {
+                const auto& instruction = program.code[function.code_start + i];
+                fmt::format_to(out, "  {:>5}  {}", i, opcode::get_name(instruction.op));
+                append_operands(buffer, program, instruction);
+                buffer.push_back('\n');
+            }
+        }
+        return fmt::to_string(buffer);
+    }
+}
\ No newline at end of file
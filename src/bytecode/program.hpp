@@ -0,0 +1,32 @@
+#pragma once
+
+#include "opcode.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac::bytecode {
+    using Value = uint64_t;
+
+    //The parameters are the first registers of a function, jump targets are relative to its first instruction
+    struct Function {
+        std::string_view name;
+        uint32_t code_start = 0;
+        uint32_t code_size = 0;
+        uint16_t parameter_count = 0;
+        uint16_t register_count = 0;
+    };
+
+    //The code of all functions of a file and the constants that don't fit into an immediate
+    struct Program {
+        std::vector<Function> functions;
+        std::vector<Instruction> code;
+        std::vector<Value> constants;
+
+        //Index of the function named `name`, functions.size() if there is none
+        [[nodiscard]] size_t find_function(std::string_view name) const noexcept;
+    };
+
+    //One line per instruction, functions are separated by their name
+    [[nodiscard]] std::string disassemble(const Program& program);
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "frontend_cache.hpp"
+#include "../util/hash/hash.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace karmac {
+    static constexpr std::string_view _TOKENS_KIND = "tokens";
+    static constexpr std::string_view _OBJECT_KIND = "o";
+    static constexpr std::string_view _TEMP_PREFIX = ".tmp-";
+    static constexpr std::string_view _INDEX_NAME = "size";
+
+    static uint64_t get_process_id() noexcept {
+#ifdef WIN32
+        return GetCurrentProcessId();
+#else
+        return static_cast<uint64_t>(getpid());
+#endif
+    }
+
+    FrontendCache::FrontendCache(std::filesystem::path directory, uint64_t max_size)
+        : _directory(std::move(directory)), _max_size(max_size) {
+        std::filesystem::create_directories(_directory);
+    }
+
+    uint64_t FrontendCache::get_key(const std::string_view& source) noexcept {
+        static const auto seed = hash::hash64(KARMAC_VERSION) ^ token_stream::VERSION;
+        return hash::hash64(source, seed);
+    }
+
+    std::filesystem::path FrontendCache::get_path(uint64_t key, const std::string_view& kind) const {
+        const auto name = fmt::format("{:016x}", key);
+        return _directory / name.substr(0, 2) / fmt::format("{}.{}", name, kind);
+    }
+
+    std::optional<MappedFile> FrontendCache::find(uint64_t key, const std::string_view& kind) const {
+        const auto path = get_path(key, kind);
+
+        std::error_code error;
+        if(!std::filesystem::is_regular_file(path, error)) {
+            return std::nullopt;
+        }
+
+        try {
+            MappedFile file(path);
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+            return file;
+        } catch(const std::exception&) {
+            //The entry was evicted by another process in the meantime
+            return std::nullopt;
+        }
+    }
+
+    //Publishes `data` at `path` with an atomic rename, returns false if it couldn't be written
+    static bool write_atomically(const std::filesystem::path& path, const std::string_view& data) {
+        static std::atomic<uint64_t> counter = 0;
+
+        const auto unique = hash::hash64(fmt::format("{}:{}:{}:{}", get_process_id(), std::hash<std::thread::id>()(std::this_thread::get_id()),
+                                                     std::chrono::steady_clock::now().time_since_epoch().count(), counter++));
+        const auto temp_path = path.parent_path() / fmt::format("{}{:016x}", _TEMP_PREFIX, unique);
+
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        {
+            std::ofstream output_stream(temp_path, std::ios_base::binary | std::ios_base::trunc);
+            output_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+            if(output_stream.fail()) {
+                output_stream.close();
+                std::filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+
+        //Another process may have published the same entry already, both have the same content
+        std::filesystem::rename(temp_path, path, error);
+        if(error) {
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+        return true;
+    }
+
+    void FrontendCache::store(uint64_t key, const std::string_view& kind, const std::string_view& data) {
+        if(write_atomically(get_path(key, kind), data)) {
+            _stored_size += data.size();
+        }
+    }
+
+    std::filesystem::path FrontendCache::get_index_path() const {
+        return _directory / _INDEX_NAME;
+    }
+
+    std::optional<uint64_t> FrontendCache::read_index() const {
+        std::ifstream input_stream(get_index_path(), std::ios_base::binary);
+        const std::string text((std::istreambuf_iterator<char>(input_stream)), std::istreambuf_iterator<char>());
+
+        uint64_t size = 0;
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), size);
+        if(text.empty() || result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+            return std::nullopt;
+        }
+        return size;
+    }
+
+    void FrontendCache::write_index(uint64_t size) const {
+        (void) write_atomically(get_index_path(), fmt::format("{}", size));
+    }
+
+    std::optional<CachedTokenStream> FrontendCache::find_tokens(const std::string_view& source, SourceLocation base) {
+        auto file = find(get_key(source), _TOKENS_KIND);
+
+        if(file) {
+            try {
+                token_stream::TokenStreamView tokens(file->get_data(), base);
+                if(tokens.get_source_size() == source.size()) {
+                    ++_token_hits;
+                    return CachedTokenStream { std::move(*file), tokens };
+                }
+            } catch(const std::exception&) {
+                //Entries of other versions or corrupted entries are treated as misses and replaced
+            }
+        }
+
+        ++_token_misses;
+        return std::nullopt;
+    }
+
+    void FrontendCache::store_tokens(const std::string_view& source, SourceLocation base, const std::vector<Token*>& tokens) {
+        store(get_key(source), _TOKENS_KIND, token_stream::serialize(tokens, base, source.size()));
+        ++_stores;
+    }
+
+    std::optional<MappedFile> FrontendCache::find_object(uint64_t key) {
+        auto file = find(key, _OBJECT_KIND);
+        ++(file ? _object_hits : _object_misses);
+        return file;
+    }
+
+    void FrontendCache::store_object(uint64_t key, const std::string_view& object) {
+        store(key, _OBJECT_KIND, object);
+        ++_stores;
+    }
+
+    void FrontendCache::update_size() {
+        const auto stored_size = _stored_size.exchange(0);
+        if(stored_size == 0) {
+            return;
+        }
+
+        //Updates of processes that finish at the same time may be lost, which only delays the next trim. Entries that
+        //replaced an existing one are counted twice, which only brings it forward.
+        const auto size = read_index();
+        if(!size || *size + stored_size > _max_size) {
+            trim();
+        } else {
+            write_index(*size + stored_size);
+        }
+    }
+
+    void FrontendCache::trim() {
+        struct Entry {
+            std::filesystem::path path;
+            std::filesystem::file_time_type last_use;
+            uint64_t size;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t total_size = 0;
+
+        const auto stale_time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+        const auto index_path = get_index_path();
+
+        std::error_code error;
+        for(auto iterator = std::filesystem::recursive_directory_iterator(_directory, error);
+            iterator != std::filesystem::recursive_directory_iterator(); iterator.increment(error)) {
+            if(error) {
+                break;
+            }
+            if(!iterator->is_regular_file(error) || iterator->path() == index_path) {
+                continue;
+            }
+
+            const auto last_use = iterator->last_write_time(error);
+            const auto size = iterator->file_size(error);
+            if(error) {
+                continue;
+            }
+
+            //Temporary files of processes that died while writing
+            if(iterator->path().filename().string().starts_with(_TEMP_PREFIX)) {
+                if(last_use < stale_time) {
+                    std::filesystem::remove(iterator->path(), error);
+                }
+                continue;
+            }
+
+            entries.push_back({ iterator->path(), last_use, size });
+            total_size += size;
+        }
+
+        if(total_size <= _max_size) {
+            write_index(total_size);
+            return;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& first, const Entry& second) {
+            return first.last_use < second.last_use;
+        });
+
+        for(const auto& entry : entries) {
+            if(total_size <= _max_size) {
+                break;
+            }
+
+            if(std::filesystem::remove(entry.path, error)) {
+                ++_evictions;
+            }
+            total_size -= entry.size;
+        }
+        write_index(total_size);
+    }
+
+    CacheStatistics FrontendCache::get_statistics() const noexcept {
+        return { _token_hits.load(), _token_misses.load(), _object_hits.load(), _object_misses.load(), _stores.load(), _evictions.load() };
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../tokenize/stream/token_stream.hpp"
+#include "../util/io/mapped_file.hpp"
+#include <atomic>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace karmac {
+    struct CacheStatistics {
+        uint64_t token_hits = 0;
+        uint64_t token_misses = 0;
+        uint64_t object_hits = 0;
+        uint64_t object_misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;
+    };
+
+    //A token stream loaded from the cache, the view points into the mapping
+    struct CachedTokenStream {
+        MappedFile file;
+        token_stream::TokenStreamView tokens;
+    };
+
+    //Cache directory shared by all karmac processes. Token streams are keyed by a hash of the source text and the
+    //compiler version, objects by a key of the JIT. Entries are published with an atomic rename, so readers never see
+    //partially written entries.
+    //The last write time of an entry is its last use, `trim()` evicts the least recently used entries. The total size
+    //of the entries is kept in an index file, so only processes whose stores push the cache over its limit walk it.
+    class FrontendCache final {
+    private:
+        std::filesystem::path _directory;
+        uint64_t _max_size;
+
+        std::atomic<uint64_t> _token_hits = 0;
+        std::atomic<uint64_t> _token_misses = 0;
+        std::atomic<uint64_t> _object_hits = 0;
+        std::atomic<uint64_t> _object_misses = 0;
+        std::atomic<uint64_t> _stores = 0;
+        std::atomic<uint64_t> _evictions = 0;
+        //Bytes published by this process that aren't in the size index yet
+        std::atomic<uint64_t> _stored_size = 0;
+
+        [[nodiscard]] std::filesystem::path get_path(uint64_t key, const std::string_view& kind) const;
+        [[nodiscard]] std::optional<MappedFile> find(uint64_t key, const std::string_view& kind) const;
+        void store(uint64_t key, const std::string_view& kind, const std::string_view& data);
+
+        [[nodiscard]] std::filesystem::path get_index_path() const;
+        //The total size recorded by the last process, std::nullopt if there is no valid index
+        [[nodiscard]] std::optional<uint64_t> read_index() const;
+        void write_index(uint64_t size) const;
+    public:
+        static constexpr uint64_t DEFAULT_MAX_SIZE = 1024 * 1024 * 1024;
+
+        explicit FrontendCache(std::filesystem::path directory, uint64_t max_size = DEFAULT_MAX_SIZE);
+
+        [[nodiscard]] static uint64_t get_key(const std::string_view& source) noexcept;
+
+        //Entries don't depend on where the source is loaded, `base` is the location of its first char
+        [[nodiscard]] std::optional<CachedTokenStream> find_tokens(const std::string_view& source, SourceLocation base);
+        void store_tokens(const std::string_view& source, SourceLocation base, const std::vector<Token*>& tokens);
+
+        //Machine code of JIT compiled functions, the key is computed by the JIT from their IR
+        [[nodiscard]] std::optional<MappedFile> find_object(uint64_t key);
+        void store_object(uint64_t key, const std::string_view& object);
+
+        //Adds the stores of this process to the size index, trims the cache if they push it over its size limit
+        void update_size();
+        //Removes the least recently used entries until the cache fits into its size limit and records the exact size in
+        //the index. Walks the whole directory.
+        void trim();
+
+        [[nodiscard]] CacheStatistics get_statistics() const noexcept;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "../tokenize/token/token_type.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace karmac {
+    enum class Type : uint8_t {
+        //The expression has an error that was already reported, it is accepted everywhere
+        Error,
+        Void,
+        Bool,
+        U8,
+        I8,
+        U16,
+        I16,
+        U32,
+        I32,
+        U64,
+        I64,
+        USize,
+        ISize,
+        F32,
+        F64,
+        String,
+        Function,
+        //Unsuffixed literals and the constants computed from them, they take the type their context requires
+        UntypedInteger,
+        UntypedFloat
+    };
+
+    namespace type {
+        static constexpr std::array<std::string_view, static_cast<size_t>(Type::UntypedFloat) + 1> _NAMES = {
+            "<error>", "void", "bool", "u8", "i8", "u16", "i16", "u32", "i32", "u64", "i64", "usize", "isize", "f32", "f64", "str",
+            "function", "integer constant", "float constant"
+        };
+
+        [[nodiscard]] constexpr std::string_view get_name(Type type) noexcept {
+            return _NAMES[static_cast<size_t>(type)];
+        }
+
+        //The types that can be named in the source
+        [[nodiscard]] constexpr std::optional<Type> from_name(std::string_view name) noexcept {
+            for(auto i = static_cast<size_t>(Type::Bool); i <= static_cast<size_t>(Type::String); i++) {
+                if(_NAMES[i] == name) {
+                    return static_cast<Type>(i);
+                }
+            }
+            return std::nullopt;
+        }
+
+        [[nodiscard]] constexpr Type from_literal(TokenType literal) noexcept {
+            switch(literal) {
+                case TokenType::U8Literal:
+                    return Type::U8;
+                case TokenType::I8Literal:
+                    return Type::I8;
+                case TokenType::U16Literal:
+                    return Type::U16;
+                case TokenType::I16Literal:
+                    return Type::I16;
+                case TokenType::U32Literal:
+                    return Type::U32;
+                case TokenType::I32Literal:
+                    return Type::I32;
+                case TokenType::U64Literal:
+                    return Type::U64;
+                case TokenType::I64Literal:
+                    return Type::I64;
+                case TokenType::USizeLiteral:
+                    return Type::USize;
+                case TokenType::ISizeLiteral:
+                    return Type::ISize;
+                case TokenType::F32Literal:
+                    return Type::F32;
+                case TokenType::F64Literal:
+                    return Type::F64;
+                case TokenType::IntegerLiteral:
+                    return Type::UntypedInteger;
+                case TokenType::FloatLiteral:
+                    return Type::UntypedFloat;
+                case TokenType::StringLiteral:
+                    return Type::String;
+                default:
+                    return Type::Error;
+            }
+        }
+
+        [[nodiscard]] constexpr bool is_untyped(Type type) noexcept {
+            return type == Type::UntypedInteger || type == Type::UntypedFloat;
+        }
+
+        [[nodiscard]] constexpr bool is_integer(Type type) noexcept {
+            return (type >= Type::U8 && type <= Type::ISize) || type == Type::UntypedInteger;
+        }
+
+        [[nodiscard]] constexpr bool is_float(Type type) noexcept {
+            return type == Type::F32 || type == Type::F64 || type == Type::UntypedFloat;
+        }
+
+        [[nodiscard]] constexpr bool is_numeric(Type type) noexcept {
+            return is_integer(type) || is_float(type);
+        }
+
+        //Untyped integers are signed
+        [[nodiscard]] constexpr bool is_signed(Type type) noexcept {
+            switch(type) {
+                case Type::I8:
+                case Type::I16:
+                case Type::I32:
+                case Type::I64:
+                case Type::ISize:
+                case Type::UntypedInteger:
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        //Width of the integer types, size types are 64 bits wide and untyped integers hold an int64_t
+        [[nodiscard]] constexpr uint32_t get_bits(Type type) noexcept {
+            switch(type) {
+                case Type::U8:
+                case Type::I8:
+                    return 8;
+                case Type::U16:
+                case Type::I16:
+                    return 16;
+                case Type::U32:
+                case Type::I32:
+                case Type::F32:
+                    return 32;
+                default:
+                    return 64;
+            }
+        }
+
+        //The type untyped constants get if nothing else is required
+        [[nodiscard]] constexpr Type get_default(Type type) noexcept {
+            switch(type) {
+                case Type::UntypedInteger:
+                    return Type::I32;
+                case Type::UntypedFloat:
+                    return Type::F64;
+                default:
+                    return type;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,1116 @@
+#include "type_checker.hpp"
+#include "../tokenize/token/literal_token.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace karmac {
+    using ast::NodeIndex;
+    using ast::NodeKind;
+    using ast::TokenIndex;
+
+    enum class FoldResult : uint8_t {
+        Ok,
+        Overflow,
+        DivisionByZero
+    };
+
+    static int64_t get_min(Type type) noexcept {
+        if(!type::is_signed(type)) {
+            return 0;
+        }
+        const auto bits = type::get_bits(type);
+        return bits == 64 ? std::numeric_limits<int64_t>::min() : -(int64_t(1) << (bits - 1));
+    }
+
+    static uint64_t get_max(Type type) noexcept {
+        const auto bits = type::get_bits(type) - (type::is_signed(type) ? 1 : 0);
+        return bits == 64 ? std::numeric_limits<uint64_t>::max() : (uint64_t(1) << bits) - 1;
+    }
+
+    //Whether the integer `value`, which is signed if `is_signed`, is in the range of the integer type
+    static bool fits(Type type, uint64_t value, bool is_signed) noexcept {
+        if(is_signed && static_cast<int64_t>(value) < 0) {
+            return static_cast<int64_t>(value) >= get_min(type);
+        }
+        return value <= get_max(type);
+    }
+
+    //Truncates to the width of the type and extends again by its signedness
+    static uint64_t wrap(Type type, uint64_t value) noexcept {
+        const auto bits = type::get_bits(type);
+        if(bits == 64) {
+            return value;
+        }
+
+        const auto mask = (uint64_t(1) << bits) - 1;
+        value &= mask;
+        if(type::is_signed(type) && ((value >> (bits - 1)) & 1) != 0) {
+            value |= ~mask;
+        }
+        return value;
+    }
+
+    static bool multiply_overflows(int64_t x, int64_t y) noexcept {
+        constexpr auto min = std::numeric_limits<int64_t>::min();
+        constexpr auto max = std::numeric_limits<int64_t>::max();
+
+        if(x == 0 || y == 0) {
+            return false;
+        }
+        if(x > 0) {
+            return y > 0 ? x > max / y : y < min / x;
+        }
+        return y > 0 ? x < min / y : x < max / y;
+    }
+
+    static FoldResult fold_integer(TokenType op, Type type, uint64_t a, uint64_t b, uint64_t& result) noexcept {
+        constexpr auto min = std::numeric_limits<int64_t>::min();
+        constexpr auto max = std::numeric_limits<int64_t>::max();
+
+        const auto is_signed = type::is_signed(type);
+        if(is_signed) {
+            const auto x = static_cast<int64_t>(a);
+            const auto y = static_cast<int64_t>(b);
+
+            switch(op) {
+                case TokenType::Add:
+                    if((y > 0 && x > max - y) || (y < 0 && x < min - y)) {
+                        return FoldResult::Overflow;
+                    }
+                    result = static_cast<uint64_t>(x + y);
+                    break;
+                case TokenType::Sub:
+                    if((y < 0 && x > max + y) || (y > 0 && x < min + y)) {
+                        return FoldResult::Overflow;
+                    }
+                    result = static_cast<uint64_t>(x - y);
+                    break;
+                case TokenType::Mul:
+                    if(multiply_overflows(x, y)) {
+                        return FoldResult::Overflow;
+                    }
+                    result = static_cast<uint64_t>(x * y);
+                    break;
+                case TokenType::Div:
+                case TokenType::Mod:
+                    if(y == 0) {
+                        return FoldResult::DivisionByZero;
+                    }
+                    if(x == min && y == -1) {
+                        if(op == TokenType::Div) {
+                            return FoldResult::Overflow;
+                        }
+                        result = 0;
+                    } else {
+                        result = static_cast<uint64_t>(op == TokenType::Div ? x / y : x % y);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        } else {
+            switch(op) {
+                case TokenType::Add:
+                    result = a + b;
+                    if(result < a) {
+                        return FoldResult::Overflow;
+                    }
+                    break;
+                case TokenType::Sub:
+                    if(a < b) {
+                        return FoldResult::Overflow;
+                    }
+                    result = a - b;
+                    break;
+                case TokenType::Mul:
+                    result = a * b;
+                    if(a != 0 && result / a != b) {
+                        return FoldResult::Overflow;
+                    }
+                    break;
+                case TokenType::Div:
+                case TokenType::Mod:
+                    if(b == 0) {
+                        return FoldResult::DivisionByZero;
+                    }
+                    result = op == TokenType::Div ? a / b : a % b;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        //Bitwise operations keep both representations
+        switch(op) {
+            case TokenType::And:
+                result = a & b;
+                return FoldResult::Ok;
+            case TokenType::Or:
+                result = a | b;
+                return FoldResult::Ok;
+            case TokenType::Xor:
+                result = a ^ b;
+                return FoldResult::Ok;
+            default:
+                return fits(type, result, is_signed) ? FoldResult::Ok : FoldResult::Overflow;
+        }
+    }
+
+    static bool is_shift(TokenType op) noexcept {
+        return op == TokenType::LeftShift || op == TokenType::RightShift;
+    }
+
+    //Whether the binary operator takes operands of the type
+    static bool accepts(TokenType op, Type type) noexcept {
+        switch(op) {
+            case TokenType::Add:
+            case TokenType::Sub:
+            case TokenType::Mul:
+            case TokenType::Div:
+            case TokenType::Less:
+            case TokenType::LessEquals:
+            case TokenType::Greater:
+            case TokenType::GreaterEquals:
+                return type::is_numeric(type);
+            case TokenType::Mod:
+            case TokenType::And:
+            case TokenType::Or:
+            case TokenType::Xor:
+            case TokenType::LeftShift:
+            case TokenType::RightShift:
+                return type::is_integer(type);
+            case TokenType::Equals:
+            case TokenType::NotEquals:
+                return type::is_numeric(type) || type == Type::Bool;
+            case TokenType::Conjunction:
+            case TokenType::Disjunction:
+                return type == Type::Bool;
+            default:
+                return false;
+        }
+    }
+
+    //The magnitude of integer literals, literals are never negative, and the bits of float literals as double
+    static uint64_t get_literal_bits(const Token& token) noexcept {
+        switch(token.get_type()) {
+            case TokenType::U8Literal:
+                return static_cast<const U8LiteralToken&>(token).get_value();
+            case TokenType::I8Literal:
+                return static_cast<uint8_t>(static_cast<const I8LiteralToken&>(token).get_value());
+            case TokenType::U16Literal:
+                return static_cast<const U16LiteralToken&>(token).get_value();
+            case TokenType::I16Literal:
+                return static_cast<uint16_t>(static_cast<const I16LiteralToken&>(token).get_value());
+            case TokenType::U32Literal:
+                return static_cast<const U32LiteralToken&>(token).get_value();
+            case TokenType::I32Literal:
+                return static_cast<uint32_t>(static_cast<const I32LiteralToken&>(token).get_value());
+            case TokenType::U64Literal:
+                return static_cast<const U64LiteralToken&>(token).get_value();
+            case TokenType::I64Literal:
+                return static_cast<uint64_t>(static_cast<const I64LiteralToken&>(token).get_value());
+            case TokenType::USizeLiteral:
+                return static_cast<const USizeLiteralToken&>(token).get_value();
+            case TokenType::ISizeLiteral:
+                return static_cast<uint64_t>(static_cast<const ISizeLiteralToken&>(token).get_value());
+            case TokenType::F32Literal:
+                return std::bit_cast<uint64_t>(static_cast<double>(static_cast<const F32LiteralToken&>(token).get_value()));
+            case TokenType::F64Literal:
+                return std::bit_cast<uint64_t>(static_cast<const F64LiteralToken&>(token).get_value());
+            case TokenType::IntegerLiteral:
+                return static_cast<const IntegerLiteralToken&>(token).get_value();
+            case TokenType::FloatLiteral:
+                return std::bit_cast<uint64_t>(static_cast<const FloatLiteralToken&>(token).get_value());
+            default:
+                return 0;
+        }
+    }
+
+    static std::string format_value(Type type, uint64_t value) {
+        if(type::is_float(type)) {
+            return fmt::format("{}", std::bit_cast<double>(value));
+        }
+        return type::is_signed(type) ? fmt::format("{}", static_cast<int64_t>(value)) : fmt::format("{}", value);
+    }
+
+    Type TypeChecker::get_named_type(TokenIndex name) {
+        const auto type = type::from_name(_tree->get_token(name).to_string());
+        if(!type) {
+            report(name, ErrorKind::UnknownType);
+            return Type::Error;
+        }
+        return *type;
+    }
+
+    uint64_t TypeChecker::get_value_as(NodeIndex node, Type type) const noexcept {
+        const auto source = _types[node];
+        const auto value = _values[node];
+        if(type::is_float(type) && type::is_integer(source)) {
+            const auto floating = type::is_signed(source) ? static_cast<double>(static_cast<int64_t>(value)) : static_cast<double>(value);
+            return std::bit_cast<uint64_t>(floating);
+        }
+        return value;
+    }
+
+    void TypeChecker::settle(NodeIndex node, Type type) noexcept {
+        const auto source = _types[node];
+        if(!type::is_untyped(source)) {
+            return;
+        }
+
+        _types[node] = type;
+        if(_constants[node] != 0) {
+            if(type::is_float(type)) {
+                auto floating = std::bit_cast<double>(get_value_as(node, Type::UntypedFloat));
+                if(type == Type::F32) {
+                    floating = static_cast<float>(floating);
+                }
+                _values[node] = std::bit_cast<uint64_t>(floating);
+            } else if(type::is_integer(type)) {
+                karmac_assert(source == Type::UntypedInteger);
+                _values[node] = wrap(type, _values[node]);
+            }
+        }
+
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Unary:
+                settle(data.lhs, type);
+                break;
+            case NodeKind::Binary:
+                settle(data.lhs, type);
+                //The amount of a shift has its own type
+                if(!is_shift(_tree->get_token(_tree->get_main_token(node)).get_type())) {
+                    settle(data.rhs, type);
+                }
+                break;
+            case NodeKind::Conditional: {
+                const auto view = _tree->get_conditional(node);
+                settle(view.then, type);
+                settle(view.otherwise, type);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    bool TypeChecker::coerce(NodeIndex node, Type type) {
+        const auto source = _types[node];
+        if(source == type || source == Type::Error || type == Type::Error) {
+            settle_default(node);
+            return true;
+        }
+
+        const auto token = _tree->get_main_token(node);
+        if(!type::is_untyped(source) || !type::is_numeric(type) || (source == Type::UntypedFloat && type::is_integer(type))) {
+            report(token, ErrorKind::Mismatch, type, source);
+            settle_default(node);
+            return false;
+        }
+
+        if(_constants[node] != 0) {
+            const auto value = _values[node];
+            const auto overflows = type::is_integer(type) ? !fits(type, value, true)
+                                 : type == Type::F32 && std::isinf(static_cast<float>(std::bit_cast<double>(get_value_as(node, type))));
+            if(overflows) {
+                report(token, ErrorKind::Overflow, type, source, value);
+                settle(node, type);
+                return false;
+            }
+        }
+
+        settle(node, type);
+        return true;
+    }
+
+    Type TypeChecker::unify(TokenIndex op, NodeIndex lhs, NodeIndex rhs) {
+        const auto left = _types[lhs];
+        const auto right = _types[rhs];
+
+        if(left == Type::Error || right == Type::Error) {
+            settle_default(lhs);
+            settle_default(rhs);
+            return Type::Error;
+        }
+        if(left == right) {
+            return left;
+        }
+        if(type::is_untyped(left) && type::is_untyped(right)) {
+            return Type::UntypedFloat;
+        }
+        if(type::is_untyped(left)) {
+            return coerce(lhs, right) ? right : Type::Error;
+        }
+        if(type::is_untyped(right)) {
+            return coerce(rhs, left) ? left : Type::Error;
+        }
+
+        report(op, ErrorKind::InvalidOperands, left, right);
+        return Type::Error;
+    }
+
+    void TypeChecker::check_place(NodeIndex node) {
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Identifier: {
+                const auto declaration = _resolver->get_declaration(node);
+                if(declaration == ast::NO_NODE) {
+                    return;
+                }
+                const auto kind = _tree->get_kind(declaration);
+                if(kind == NodeKind::Declaration && _tree->is_constant(declaration)) {
+                    report(_tree->get_main_token(node), ErrorKind::AssignConstant);
+                } else if(kind == NodeKind::Function) {
+                    report(_tree->get_main_token(node), ErrorKind::NotAssignable);
+                }
+                break;
+            }
+            //Report their own errors so far
+            case NodeKind::Index:
+            case NodeKind::Member:
+                break;
+            default:
+                if(_types[node] != Type::Error) {
+                    report(_tree->get_main_token(node), ErrorKind::NotAssignable);
+                }
+                break;
+        }
+    }
+
+    void TypeChecker::check(const ast::Tree& tree, const Resolver& resolver) {
+        _tree = &tree;
+        _resolver = &resolver;
+        _types.assign(tree.get_node_count(), Type::Void);
+        _constants.assign(tree.get_node_count(), 0);
+        _values.assign(tree.get_node_count(), 0);
+        _folded = 0;
+        _errors.clear();
+
+        //Calls can precede the function
+        const auto functions = tree.get_children(ast::NO_NODE);
+        for(const auto function : functions) {
+            const auto view = tree.get_function(function);
+            for(const auto parameter : view.parameters) {
+                _types[parameter] = get_named_type(tree.get_data(parameter).lhs);
+            }
+            _types[function] = view.return_type == ast::NO_TOKEN ? Type::Void : get_named_type(view.return_type);
+        }
+        for(const auto function : functions) {
+            check_function(function);
+        }
+
+        //Signatures report their errors before the bodies
+        std::stable_sort(_errors.begin(), _errors.end(), [](const Error& a, const Error& b) {
+            return a.token < b.token;
+        });
+    }
+
+    std::vector<Diagnostic> TypeChecker::get_errors() const {
+        std::vector<Diagnostic> errors;
+        errors.reserve(_errors.size());
+        for(const auto& error : _errors) {
+            const auto& token = _tree->get_token(error.token);
+            const auto first = type::get_name(error.first);
+            const auto second = type::get_name(error.second);
+            const auto spelling = token_type::to_string(token.get_type());
+
+            std::string message;
+            switch(error.kind) {
+                case ErrorKind::UnknownType:
+                    message = fmt::format("\"{}\" is not a type", token.to_string());
+                    break;
+                case ErrorKind::Mismatch:
+                    message = fmt::format("expected {}, found {}", first, second);
+                    break;
+                case ErrorKind::InvalidOperand:
+                    message = fmt::format("\"{}\" can't be applied to {}", spelling, first);
+                    break;
+                case ErrorKind::InvalidOperands:
+                    message = fmt::format("\"{}\" can't be applied to {} and {}", spelling, first, second);
+                    break;
+                case ErrorKind::Overflow:
+                    message = error.second == Type::Error ? fmt::format("constant doesn't fit {}", first)
+                                                          : fmt::format("constant {} doesn't fit {}", format_value(error.second, error.value), first);
+                    break;
+                case ErrorKind::FoldOverflow:
+                    message = fmt::format("constant expression overflows {}", first);
+                    break;
+                case ErrorKind::DivisionByZero:
+                    message = "constant division by zero";
+                    break;
+                case ErrorKind::ShiftRange:
+                    message = fmt::format("shift by {} is out of range for {}", format_value(error.second, error.value), first);
+                    break;
+                case ErrorKind::NotCallable:
+                    message = fmt::format("{} can't be called", first);
+                    break;
+                case ErrorKind::IndirectCall:
+                    message = "function values can't be called yet, only functions by name";
+                    break;
+                case ErrorKind::ArgumentCount:
+                    message = fmt::format("expected {} arguments, found {}", error.count, error.value);
+                    break;
+                case ErrorKind::NotAssignable:
+                    message = "expression can't be assigned";
+                    break;
+                case ErrorKind::AssignConstant:
+                    message = fmt::format("\"{}\" is a constant", token.to_string());
+                    break;
+                case ErrorKind::NotIterable:
+                    message = fmt::format("{} can't be iterated", first);
+                    break;
+                case ErrorKind::RangeOutsideFor:
+                    message = "ranges can only be iterated by for";
+                    break;
+                case ErrorKind::MissingReturnValue:
+                    message = fmt::format("missing return value of type {}", first);
+                    break;
+                case ErrorKind::UnexpectedReturnValue:
+                    message = "function doesn't return a value";
+                    break;
+                case ErrorKind::NotIndexable:
+                    message = fmt::format("{} can't be indexed", first);
+                    break;
+                case ErrorKind::NoMembers:
+                    message = fmt::format("{} has no members", first);
+                    break;
+                case ErrorKind::VoidValue:
+                    message = "expression has no value to initialize a variable with";
+                    break;
+                case ErrorKind::BreakOutsideLoop:
+                    message = "break outside of a loop";
+                    break;
+                case ErrorKind::ContinueOutsideLoop:
+                    message = "continue outside of a loop";
+                    break;
+            }
+            errors.push_back({ token.get_location(), std::move(message) });
+        }
+        return errors;
+    }
+
+    void TypeChecker::check_function(NodeIndex function) {
+        const auto view = _tree->get_function(function);
+        if(_tree->get_kind(view.body) == NodeKind::LazyBody) {
+            return;
+        }
+
+        _return_type = _types[function];
+        _loop_depth = 0;
+        check_statement(view.body);
+    }
+
+    void TypeChecker::check_statement(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Block:
+                for(const auto statement : _tree->get_children(node)) {
+                    check_statement(statement);
+                }
+                break;
+            case NodeKind::Declaration:
+                check_declaration(node);
+                break;
+            case NodeKind::If: {
+                const auto view = _tree->get_if(node);
+                check_expression(view.condition);
+                coerce(view.condition, Type::Bool);
+                check_statement(view.then);
+                if(view.otherwise != ast::NO_NODE) {
+                    check_statement(view.otherwise);
+                }
+                break;
+            }
+            case NodeKind::While:
+                check_expression(data.lhs);
+                coerce(data.lhs, Type::Bool);
+                _loop_depth++;
+                check_statement(data.rhs);
+                _loop_depth--;
+                break;
+            case NodeKind::For:
+                check_for(node);
+                break;
+            case NodeKind::Return:
+                if(data.lhs == ast::NO_NODE) {
+                    if(_return_type != Type::Void && _return_type != Type::Error) {
+                        report(_tree->get_main_token(node), ErrorKind::MissingReturnValue, _return_type);
+                    }
+                } else {
+                    check_expression(data.lhs);
+                    if(_return_type == Type::Void) {
+                        report(_tree->get_main_token(node), ErrorKind::UnexpectedReturnValue);
+                        settle_default(data.lhs);
+                    } else {
+                        coerce(data.lhs, _return_type);
+                    }
+                }
+                break;
+            case NodeKind::Break:
+                if(_loop_depth == 0) {
+                    report(_tree->get_main_token(node), ErrorKind::BreakOutsideLoop);
+                }
+                break;
+            case NodeKind::Continue:
+                if(_loop_depth == 0) {
+                    report(_tree->get_main_token(node), ErrorKind::ContinueOutsideLoop);
+                }
+                break;
+            default:
+                check_expression(node);
+                coerce_default(node);
+                break;
+        }
+    }
+
+    void TypeChecker::check_declaration(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        const auto value = data.rhs;
+        const auto constant = _tree->is_constant(node);
+        check_expression(value);
+
+        if(data.lhs != ast::NO_TOKEN) {
+            const auto type = get_named_type(data.lhs);
+            coerce(value, type);
+            _types[node] = type;
+        } else if(constant && _constants[value] != 0 && type::is_untyped(_types[value])) {
+            //Every use of the constant takes the type it requires
+            _types[node] = _types[value];
+            set_constant(node, _values[value]);
+            settle_default(value);
+            return;
+        } else {
+            coerce_default(value);
+            _types[node] = _types[value];
+            //Calls of functions without result, variables of them would have no representation
+            if(_types[node] == Type::Void) {
+                report(_tree->get_main_token(value), ErrorKind::VoidValue);
+                _types[node] = Type::Error;
+            }
+        }
+
+        if(constant && _constants[value] != 0 && _types[node] != Type::Error) {
+            set_constant(node, _values[value]);
+        }
+    }
+
+    void TypeChecker::check_for(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        const auto range = data.lhs;
+        const auto op = _tree->get_main_token(range);
+
+        auto element = Type::Error;
+        if(_tree->get_kind(range) == NodeKind::Binary && _tree->get_token(op).get_type() == TokenType::DoubleDot) {
+            const auto& bounds = _tree->get_data(range);
+            check_expression(bounds.lhs);
+            check_expression(bounds.rhs);
+
+            const auto left = _types[bounds.lhs];
+            const auto right = _types[bounds.rhs];
+            if(left != Type::Error && right != Type::Error && (!type::is_integer(left) || !type::is_integer(right))) {
+                report(op, ErrorKind::InvalidOperands, left, right);
+                settle_default(bounds.lhs);
+                settle_default(bounds.rhs);
+            } else {
+                element = unify(op, bounds.lhs, bounds.rhs);
+                if(type::is_untyped(element)) {
+                    element = type::get_default(element);
+                    coerce(bounds.lhs, element);
+                    coerce(bounds.rhs, element);
+                }
+            }
+            _types[range] = element;
+        } else {
+            check_expression(range);
+            coerce_default(range);
+            if(_types[range] != Type::Error) {
+                report(op, ErrorKind::NotIterable, _types[range]);
+            }
+        }
+
+        _types[node] = element;
+        _loop_depth++;
+        check_statement(data.rhs);
+        _loop_depth--;
+    }
+
+    void TypeChecker::check_expression(NodeIndex node) {
+        const auto& data = _tree->get_data(node);
+        const auto kind = _tree->get_kind(node);
+        switch(kind) {
+            case NodeKind::Identifier:
+                check_identifier(node);
+                break;
+            case NodeKind::Literal:
+                check_literal(node, false);
+                break;
+            case NodeKind::Unary:
+                check_unary(node);
+                break;
+            case NodeKind::Postfix: {
+                check_expression(data.lhs);
+                check_place(data.lhs);
+                const auto type = _types[data.lhs];
+                if(type != Type::Error && !type::is_numeric(type)) {
+                    report(_tree->get_main_token(node), ErrorKind::InvalidOperand, type);
+                }
+                settle_default(data.lhs);
+                _types[node] = type::is_numeric(type) ? _types[data.lhs] : Type::Error;
+                break;
+            }
+            case NodeKind::Binary:
+                check_binary(node);
+                break;
+            case NodeKind::Assignment:
+                check_assignment(node);
+                break;
+            case NodeKind::Conditional:
+                check_conditional(node);
+                break;
+            case NodeKind::Call:
+                check_call(node);
+                break;
+            case NodeKind::Index:
+                check_expression(data.lhs);
+                check_expression(data.rhs);
+                settle_default(data.lhs);
+                settle_default(data.rhs);
+                //There are no arrays yet
+                if(_types[data.lhs] != Type::Error) {
+                    report(_tree->get_main_token(node), ErrorKind::NotIndexable, _types[data.lhs]);
+                }
+                _types[node] = Type::Error;
+                break;
+            case NodeKind::Member:
+                check_expression(data.lhs);
+                settle_default(data.lhs);
+                if(_types[data.lhs] != Type::Error) {
+                    report(_tree->get_main_token(node), ErrorKind::NoMembers, _types[data.lhs]);
+                }
+                _types[node] = Type::Error;
+                break;
+            default:
+                break;
+        }
+
+        if(_constants[node] != 0 && kind != NodeKind::Literal) {
+            ++_folded;
+        }
+    }
+
+    void TypeChecker::check_literal(NodeIndex node, bool negated) {
+        const auto token = _tree->get_main_token(node);
+        const auto& literal = _tree->get_token(token);
+        auto type = type::from_literal(literal.get_type());
+        if(type == Type::String) {
+            _types[node] = type;
+            return;
+        }
+
+        auto value = get_literal_bits(literal);
+        if(type == Type::UntypedInteger) {
+            //Untyped constants hold an int64_t, the magnitude of its minimum only fits negated. Larger literals can
+            //only be u64.
+            if(value > get_max(type) && !(negated && value == get_max(type) + 1)) {
+                type = Type::U64;
+            }
+        } else if(type::is_float(type)) {
+            if(type != Type::UntypedFloat && std::isinf(std::bit_cast<double>(value))) {
+                report(token, ErrorKind::Overflow, type);
+            }
+        } else if(value > get_max(type)) {
+            //Only the magnitude of the minimum of a signed type gets here, the tokenizer rejects larger literals
+            if(!negated) {
+                report(token, ErrorKind::Overflow, type, Type::U64, value);
+            }
+            value = wrap(type, value);
+        }
+
+        _types[node] = type;
+        set_constant(node, value);
+    }
+
+    void TypeChecker::check_identifier(NodeIndex node) {
+        const auto declaration = _resolver->get_declaration(node);
+        if(declaration == ast::NO_NODE) {
+            _types[node] = Type::Error;
+            return;
+        }
+
+        if(_tree->get_kind(declaration) == NodeKind::Function) {
+            _types[node] = Type::Function;
+            return;
+        }
+
+        _types[node] = _types[declaration];
+        if(_constants[declaration] != 0) {
+            set_constant(node, _values[declaration]);
+        }
+    }
+
+    void TypeChecker::check_unary(NodeIndex node) {
+        const auto token = _tree->get_main_token(node);
+        const auto op = _tree->get_token(token).get_type();
+        const auto operand = _tree->get_data(node).lhs;
+
+        if(op == TokenType::Sub && _tree->get_kind(operand) == NodeKind::Literal) {
+            check_literal(operand, true);
+        } else {
+            check_expression(operand);
+        }
+
+        const auto type = _types[operand];
+        if(type == Type::Error) {
+            _types[node] = Type::Error;
+            return;
+        }
+
+        auto valid = false;
+        switch(op) {
+            case TokenType::Sub:
+                valid = type::is_float(type) || type::is_signed(type);
+                break;
+            case TokenType::Add:
+                valid = type::is_numeric(type);
+                break;
+            case TokenType::Not:
+                valid = type == Type::Bool;
+                break;
+            case TokenType::Increment:
+            case TokenType::Decrement:
+                check_place(operand);
+                valid = type::is_numeric(type);
+                break;
+            default:
+                break;
+        }
+        if(!valid) {
+            report(token, ErrorKind::InvalidOperand, type);
+            settle_default(operand);
+            _types[node] = Type::Error;
+            return;
+        }
+
+        if(op == TokenType::Increment || op == TokenType::Decrement) {
+            settle_default(operand);
+            _types[node] = _types[operand];
+            return;
+        }
+
+        _types[node] = type;
+        if(_constants[operand] == 0) {
+            return;
+        }
+
+        const auto value = _values[operand];
+        switch(op) {
+            case TokenType::Sub:
+                if(type::is_float(type)) {
+                    set_constant(node, std::bit_cast<uint64_t>(-std::bit_cast<double>(value)));
+                } else if(static_cast<int64_t>(value) == get_min(type)) {
+                    //The literal was the magnitude of the minimum
+                    if(_tree->get_kind(operand) == NodeKind::Literal) {
+                        set_constant(node, value);
+                    } else {
+                        report(token, ErrorKind::FoldOverflow, type);
+                    }
+                } else {
+                    set_constant(node, static_cast<uint64_t>(-static_cast<int64_t>(value)));
+                }
+                break;
+            case TokenType::Not:
+                set_constant(node, value ^ 1);
+                break;
+            default:
+                set_constant(node, value);
+                break;
+        }
+    }
+
+    void TypeChecker::check_binary(NodeIndex node) {
+        const auto token = _tree->get_main_token(node);
+        const auto op = _tree->get_token(token).get_type();
+        const auto& data = _tree->get_data(node);
+        check_expression(data.lhs);
+        check_expression(data.rhs);
+
+        const auto left = _types[data.lhs];
+        const auto right = _types[data.rhs];
+        const auto fail = [this, node, &data] {
+            settle_default(data.lhs);
+            settle_default(data.rhs);
+            _types[node] = Type::Error;
+        };
+
+        if(op == TokenType::DoubleDot) {
+            report(token, ErrorKind::RangeOutsideFor);
+            fail();
+            return;
+        }
+        if(left == Type::Error || right == Type::Error) {
+            fail();
+            return;
+        }
+        if(!accepts(op, left) || !accepts(op, right)) {
+            report(token, ErrorKind::InvalidOperands, left, right);
+            fail();
+            return;
+        }
+
+        if(is_shift(op)) {
+            coerce_default(data.rhs);
+            _types[node] = left;
+            if(_constants[data.rhs] == 0) {
+                return;
+            }
+
+            const auto amount = _values[data.rhs];
+            const auto bits = type::get_bits(left);
+            if((type::is_signed(_types[data.rhs]) && static_cast<int64_t>(amount) < 0) || amount >= bits) {
+                report(token, ErrorKind::ShiftRange, left, _types[data.rhs], amount);
+                return;
+            }
+            if(_constants[data.lhs] != 0) {
+                fold_binary(node, op, left, data.lhs, data.rhs);
+            }
+            return;
+        }
+
+        if(op == TokenType::Conjunction || op == TokenType::Disjunction) {
+            _types[node] = Type::Bool;
+            if(_constants[data.lhs] == 0) {
+                return;
+            }
+            //The right operand doesn't matter if the left one decides
+            const auto decides = (_values[data.lhs] != 0) == (op == TokenType::Disjunction);
+            if(decides) {
+                set_constant(node, _values[data.lhs]);
+            } else if(_constants[data.rhs] != 0) {
+                set_constant(node, _values[data.rhs]);
+            }
+            return;
+        }
+
+        auto type = unify(token, data.lhs, data.rhs);
+        if(type == Type::Error) {
+            _types[node] = Type::Error;
+            return;
+        }
+        if(token_type::is_comparison(op) && type::is_untyped(type)) {
+            //Nothing requires another type of the operands
+            type = type::get_default(type);
+            coerce(data.lhs, type);
+            coerce(data.rhs, type);
+        }
+
+        _types[node] = token_type::is_comparison(op) ? Type::Bool : type;
+        if(_constants[data.lhs] != 0 && _constants[data.rhs] != 0) {
+            fold_binary(node, op, type, data.lhs, data.rhs);
+        }
+    }
+
+    void TypeChecker::fold_binary(NodeIndex node, TokenType op, Type type, NodeIndex lhs, NodeIndex rhs) {
+        const auto token = _tree->get_main_token(node);
+
+        if(type::is_float(type)) {
+            const auto a = std::bit_cast<double>(get_value_as(lhs, type));
+            const auto b = std::bit_cast<double>(get_value_as(rhs, type));
+
+            double result;
+            switch(op) {
+                case TokenType::Add:
+                    result = a + b;
+                    break;
+                case TokenType::Sub:
+                    result = a - b;
+                    break;
+                case TokenType::Mul:
+                    result = a * b;
+                    break;
+                case TokenType::Div:
+                    if(b == 0.0) {
+                        report(token, ErrorKind::DivisionByZero);
+                        return;
+                    }
+                    result = a / b;
+                    break;
+                case TokenType::Less:
+                    set_constant(node, a < b);
+                    return;
+                case TokenType::LessEquals:
+                    set_constant(node, a <= b);
+                    return;
+                case TokenType::Greater:
+                    set_constant(node, a > b);
+                    return;
+                case TokenType::GreaterEquals:
+                    set_constant(node, a >= b);
+                    return;
+                case TokenType::Equals:
+                    set_constant(node, a == b);
+                    return;
+                case TokenType::NotEquals:
+                    set_constant(node, a != b);
+                    return;
+                default:
+                    return;
+            }
+
+            if(type == Type::F32) {
+                result = static_cast<float>(result);
+            }
+            if(std::isinf(result)) {
+                report(token, ErrorKind::FoldOverflow, type);
+                return;
+            }
+            set_constant(node, std::bit_cast<uint64_t>(result));
+            return;
+        }
+
+        const auto a = _values[lhs];
+        const auto b = _values[rhs];
+        const auto is_signed = type::is_signed(type);
+        switch(op) {
+            case TokenType::Less:
+                set_constant(node, is_signed ? static_cast<int64_t>(a) < static_cast<int64_t>(b) : a < b);
+                return;
+            case TokenType::LessEquals:
+                set_constant(node, is_signed ? static_cast<int64_t>(a) <= static_cast<int64_t>(b) : a <= b);
+                return;
+            case TokenType::Greater:
+                set_constant(node, is_signed ? static_cast<int64_t>(a) > static_cast<int64_t>(b) : a > b);
+                return;
+            case TokenType::GreaterEquals:
+                set_constant(node, is_signed ? static_cast<int64_t>(a) >= static_cast<int64_t>(b) : a >= b);
+                return;
+            case TokenType::Equals:
+                set_constant(node, a == b);
+                return;
+            case TokenType::NotEquals:
+                set_constant(node, a != b);
+                return;
+            //Shifts wrap the bits instead of overflowing, the amount was checked
+            case TokenType::LeftShift:
+                set_constant(node, wrap(type, a << b));
+                return;
+            case TokenType::RightShift:
+                set_constant(node, is_signed ? static_cast<uint64_t>(static_cast<int64_t>(a) >> b) : a >> b);
+                return;
+            default:
+                break;
+        }
+
+        uint64_t result = 0;
+        switch(fold_integer(op, type, a, b, result)) {
+            case FoldResult::Ok:
+                set_constant(node, result);
+                break;
+            case FoldResult::Overflow:
+                report(token, ErrorKind::FoldOverflow, type);
+                break;
+            case FoldResult::DivisionByZero:
+                report(token, ErrorKind::DivisionByZero);
+                break;
+        }
+    }
+
+    void TypeChecker::check_assignment(NodeIndex node) {
+        const auto token = _tree->get_main_token(node);
+        const auto op = token_type::get_compound_operator(_tree->get_token(token).get_type());
+        const auto& data = _tree->get_data(node);
+        check_expression(data.lhs);
+        check_expression(data.rhs);
+        check_place(data.lhs);
+        settle_default(data.lhs);
+
+        const auto type = _types[data.lhs];
+        _types[node] = type;
+
+        if(op == TokenType::Assign) {
+            coerce(data.rhs, type);
+            return;
+        }
+        if(type == Type::Error) {
+            settle_default(data.rhs);
+            return;
+        }
+        if(!accepts(op, type)) {
+            report(token, ErrorKind::InvalidOperand, type);
+            settle_default(data.rhs);
+            return;
+        }
+
+        if(is_shift(op)) {
+            coerce_default(data.rhs);
+            const auto amount = _types[data.rhs];
+            if(amount != Type::Error && !type::is_integer(amount)) {
+                report(token, ErrorKind::InvalidOperands, type, amount);
+            }
+        } else {
+            coerce(data.rhs, type);
+        }
+    }
+
+    void TypeChecker::check_conditional(NodeIndex node) {
+        const auto view = _tree->get_conditional(node);
+        check_expression(view.condition);
+        coerce(view.condition, Type::Bool);
+        check_expression(view.then);
+        check_expression(view.otherwise);
+
+        const auto type = unify(_tree->get_main_token(node), view.then, view.otherwise);
+        _types[node] = type;
+        if(type == Type::Error || _constants[view.condition] == 0 || _types[view.condition] != Type::Bool) {
+            return;
+        }
+
+        const auto chosen = _values[view.condition] != 0 ? view.then : view.otherwise;
+        if(_constants[chosen] != 0) {
+            set_constant(node, get_value_as(chosen, type));
+        }
+    }
+
+    void TypeChecker::check_call(NodeIndex node) {
+        const auto view = _tree->get_call(node);
+        check_expression(view.callee);
+        settle_default(view.callee);
+
+        const auto callee = _types[view.callee];
+        //Function values that aren't names of functions, variables and conditionals, can't be called yet
+        const auto function = _tree->get_kind(view.callee) == NodeKind::Identifier ? _resolver->get_declaration(view.callee) : ast::NO_NODE;
+        const auto direct = function != ast::NO_NODE && _tree->get_kind(function) == NodeKind::Function;
+        if(callee != Type::Function || !direct) {
+            if(callee == Type::Function) {
+                report(_tree->get_main_token(node), ErrorKind::IndirectCall);
+            } else if(callee != Type::Error) {
+                report(_tree->get_main_token(node), ErrorKind::NotCallable, callee);
+            }
+            for(const auto argument : view.arguments) {
+                check_expression(argument);
+                coerce_default(argument);
+            }
+            _types[node] = Type::Error;
+            return;
+        }
+
+        const auto parameters = _tree->get_function(function).parameters;
+        if(parameters.size() != view.arguments.size()) {
+            _errors.push_back({ _tree->get_main_token(node), ErrorKind::ArgumentCount, Type::Error, Type::Error,
+                                static_cast<uint32_t>(parameters.size()), view.arguments.size() });
+        }
+
+        for(size_t i = 0; i < view.arguments.size(); i++) {
+            const auto argument = view.arguments[i];
+            check_expression(argument);
+            if(i < parameters.size()) {
+                coerce(argument, _types[parameters[i]]);
+            } else {
+                coerce_default(argument);
+            }
+        }
+        _types[node] = _types[function];
+    }
+}
\ No newline at end of file
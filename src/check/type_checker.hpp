@@ -0,0 +1,164 @@
+#pragma once
+
+#include "type.hpp"
+#include "../parse/ast/tree.hpp"
+#include "../resolve/resolver.hpp"
+#include "../source/diagnostic.hpp"
+#include <bit>
+#include <vector>
+
+namespace karmac {
+    //Assigns a type to every expression of a resolved tree and folds the constant ones, in one pass over the tree.
+    //Results are kept in side arrays indexed by node, the tree isn't modified. Unsuffixed literals are untyped
+    //constants, which take the type their context requires: the other operand, the declared type of a variable or
+    //parameter, the return type. Untyped constants that are used where no type is required become i32 or f64.
+    //Constants are folded in the precision of their type, an integer that doesn't fit it is an error. Untyped integers
+    //are folded as int64_t, the converted result has to fit the type it finally gets. Unsuffixed literals beyond int64_t
+    //are u64, unless they are the negated magnitude of its minimum.
+    //Integer constants are stored sign-extended for signed types and zero-extended for unsigned ones, floats as the
+    //bits of a double and bools as 0 or 1.
+    //The tree has to outlive the results.
+    class TypeChecker final {
+    private:
+        enum class ErrorKind : uint8_t {
+            UnknownType,
+            Mismatch,
+            InvalidOperand,
+            InvalidOperands,
+            Overflow,
+            FoldOverflow,
+            DivisionByZero,
+            ShiftRange,
+            NotCallable,
+            IndirectCall,
+            ArgumentCount,
+            NotAssignable,
+            AssignConstant,
+            NotIterable,
+            RangeOutsideFor,
+            MissingReturnValue,
+            UnexpectedReturnValue,
+            NotIndexable,
+            NoMembers,
+            VoidValue,
+            BreakOutsideLoop,
+            ContinueOutsideLoop
+        };
+
+        //Messages are only formatted on request like the ones of the resolver
+        struct Error {
+            ast::TokenIndex token;
+            ErrorKind kind;
+            Type first;
+            Type second;
+            uint32_t count = 0;
+            uint64_t value = 0;
+        };
+
+        const ast::Tree* _tree = nullptr;
+        const Resolver* _resolver = nullptr;
+
+        std::vector<Type> _types;
+        std::vector<uint8_t> _constants;
+        std::vector<uint64_t> _values;
+        size_t _folded = 0;
+
+        //Return type of the function whose body is checked
+        Type _return_type = Type::Void;
+        //Loops around the statement being checked
+        uint32_t _loop_depth = 0;
+
+        std::vector<Error> _errors;
+
+        inline void report(ast::TokenIndex token, ErrorKind kind, Type first = Type::Error, Type second = Type::Error, uint64_t value = 0) {
+            _errors.push_back({ token, kind, first, second, 0, value });
+        }
+
+        inline void set_constant(ast::NodeIndex node, uint64_t value) noexcept {
+            _constants[node] = 1;
+            _values[node] = value;
+        }
+
+        [[nodiscard]] Type get_named_type(ast::TokenIndex name);
+        //The value of a constant in the representation of `type`, only integers are converted to floats
+        [[nodiscard]] uint64_t get_value_as(ast::NodeIndex node, Type type) const noexcept;
+
+        //Gives an untyped expression and all untyped expressions it is computed from the type `type`
+        void settle(ast::NodeIndex node, Type type) noexcept;
+        //Settles without checking the value, for expressions that already have an error
+        inline void settle_default(ast::NodeIndex node) noexcept {
+            settle(node, type::get_default(_types[node]));
+        }
+        //Converts the expression to `type` if it is untyped, returns false and reports an error if it has another type
+        //or its value doesn't fit
+        bool coerce(ast::NodeIndex node, Type type);
+        inline bool coerce_default(ast::NodeIndex node) {
+            return coerce(node, type::get_default(_types[node]));
+        }
+        //The common type of two operands, Type::Error if there is none
+        [[nodiscard]] Type unify(ast::TokenIndex op, ast::NodeIndex lhs, ast::NodeIndex rhs);
+        //Reports targets that can't be assigned
+        void check_place(ast::NodeIndex node);
+
+        void check_function(ast::NodeIndex function);
+        void check_statement(ast::NodeIndex node);
+        void check_declaration(ast::NodeIndex node);
+        void check_for(ast::NodeIndex node);
+
+        void check_expression(ast::NodeIndex node);
+        //`negated` accepts the magnitude of the minimum of signed types
+        void check_literal(ast::NodeIndex node, bool negated);
+        void check_identifier(ast::NodeIndex node);
+        void check_unary(ast::NodeIndex node);
+        void check_binary(ast::NodeIndex node);
+        void check_assignment(ast::NodeIndex node);
+        void check_conditional(ast::NodeIndex node);
+        void check_call(ast::NodeIndex node);
+
+        //Both operands are constants of `type`, or an untyped integer and an untyped float for Type::UntypedFloat
+        void fold_binary(ast::NodeIndex node, TokenType op, Type type, ast::NodeIndex lhs, ast::NodeIndex rhs);
+    public:
+        //Replaces the results with the ones of `tree`, which was resolved by `resolver`. Unparsed function bodies are
+        //skipped.
+        void check(const ast::Tree& tree, const Resolver& resolver);
+
+        //Indexed by node. Expressions have their type, Parameters, Declarations and Fors the type of the name they
+        //declare and Functions their return type. Constant declarations of untyped values stay untyped.
+        [[nodiscard]] inline const std::vector<Type>& get_types() const noexcept {
+            return _types;
+        }
+
+        [[nodiscard]] inline Type get_type(ast::NodeIndex node) const noexcept {
+            return _types[node];
+        }
+
+        //Whether the value of the expression or constant declaration is known
+        [[nodiscard]] inline bool is_constant(ast::NodeIndex node) const noexcept {
+            return _constants[node] != 0;
+        }
+
+        [[nodiscard]] inline uint64_t get_value(ast::NodeIndex node) const noexcept {
+            return _values[node];
+        }
+
+        [[nodiscard]] inline int64_t get_integer(ast::NodeIndex node) const noexcept {
+            return static_cast<int64_t>(_values[node]);
+        }
+
+        [[nodiscard]] inline double get_float(ast::NodeIndex node) const noexcept {
+            return std::bit_cast<double>(_values[node]);
+        }
+
+        //Constant expressions that aren't literals, they don't have to be evaluated at run time
+        [[nodiscard]] inline size_t get_folded_count() const noexcept {
+            return _folded;
+        }
+
+        [[nodiscard]] inline size_t get_error_count() const noexcept {
+            return _errors.size();
+        }
+
+        //Type errors in source order
+        [[nodiscard]] std::vector<Diagnostic> get_errors() const;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "elf.hpp"
+#include "../util/io/endian.hpp"
+
+#include <array>
+
+namespace karmac::codegen::elf {
+    enum class SectionType : uint32_t {
+        Null = 0,
+        ProgramBits = 1,
+        SymbolTable = 2,
+        StringTable = 3
+    };
+
+    //Section header indices
+    enum Section : uint16_t {
+        NoSection,
+        Text,
+        SymbolTable,
+        StringTable,
+        SectionNames,
+        NoteStack,
+        SectionCount
+    };
+
+    static constexpr uint16_t _ABSOLUTE_SECTION = 0xFFF1;
+    static constexpr size_t _HEADER_SIZE = 64;
+    static constexpr size_t _SECTION_HEADER_SIZE = 64;
+    static constexpr size_t _SYMBOL_SIZE = 24;
+
+    static constexpr uint8_t _BINDING_LOCAL = 0;
+    static constexpr uint8_t _BINDING_GLOBAL = 1;
+    static constexpr uint8_t _SYMBOL_FUNCTION = 2;
+    static constexpr uint8_t _SYMBOL_SECTION = 3;
+    static constexpr uint8_t _SYMBOL_FILE = 4;
+
+    static constexpr uint64_t _FLAG_ALLOCATE = 2;
+    static constexpr uint64_t _FLAG_EXECUTE = 4;
+
+    struct SectionHeader {
+        uint32_t name = 0;
+        SectionType type = SectionType::Null;
+        uint64_t flags = 0;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t link = 0;
+        uint32_t info = 0;
+        uint64_t alignment = 0;
+        uint64_t entry_size = 0;
+    };
+
+    static uint32_t add_string(std::string& table, std::string_view string) {
+        const auto offset = static_cast<uint32_t>(table.size());
+        table.append(string);
+        table.push_back('\0');
+        return offset;
+    }
+
+    static void add_symbol(std::string& table, uint32_t name, uint8_t binding, uint8_t type, uint16_t section, uint64_t value, uint64_t size) {
+        endian::write_le<uint32_t>(table, name);
+        endian::write_le<uint8_t>(table, static_cast<uint8_t>(binding << 4 | type));
+        endian::write_le<uint8_t>(table, 0);
+        endian::write_le<uint16_t>(table, section);
+        endian::write_le<uint64_t>(table, value);
+        endian::write_le<uint64_t>(table, size);
+    }
+
+    static void align(std::string& buffer, size_t alignment) {
+        buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, '\0');
+    }
+
+    std::string write_object(std::string_view file, std::string_view text, std::span<const Symbol> functions) {
+        std::string strings(1, '\0');
+        std::string symbols(_SYMBOL_SIZE, '\0');
+        add_symbol(symbols, add_string(strings, file), _BINDING_LOCAL, _SYMBOL_FILE, _ABSOLUTE_SECTION, 0, 0);
+        add_symbol(symbols, 0, _BINDING_LOCAL, _SYMBOL_SECTION, Section::Text, 0, 0);
+        const auto first_global = static_cast<uint32_t>(symbols.size() / _SYMBOL_SIZE);
+        for(const auto& function : functions) {
+            add_symbol(symbols, add_string(strings, function.name), _BINDING_GLOBAL, _SYMBOL_FUNCTION, Section::Text, function.offset, function.size);
+        }
+
+        std::array<SectionHeader, Section::SectionCount> sections;
+        std::string names(1, '\0');
+        sections[Section::Text] = { add_string(names, ".text"), SectionType::ProgramBits, _FLAG_ALLOCATE | _FLAG_EXECUTE, 0, text.size(), 0, 0, 16, 0 };
+        sections[Section::SymbolTable] = { add_string(names, ".symtab"), SectionType::SymbolTable, 0, 0, symbols.size(), Section::StringTable,
+                                           first_global, 8, _SYMBOL_SIZE };
+        sections[Section::StringTable] = { add_string(names, ".strtab"), SectionType::StringTable, 0, 0, strings.size(), 0, 0, 1, 0 };
+        sections[Section::SectionNames] = { add_string(names, ".shstrtab"), SectionType::StringTable, 0, 0, 0, 0, 0, 1, 0 };
+        sections[Section::NoteStack] = { add_string(names, ".note.GNU-stack"), SectionType::ProgramBits, 0, 0, 0, 0, 0, 1, 0 };
+        sections[Section::SectionNames].size = names.size();
+
+        //The header is written last, once the offset of the section headers is known
+        std::string object(_HEADER_SIZE, '\0');
+        const std::array<std::pair<Section, std::string_view>, 4> contents = {{
+            { Section::Text, text }, { Section::SymbolTable, symbols }, { Section::StringTable, strings }, { Section::SectionNames, names }
+        }};
+        for(const auto& [section, data] : contents) {
+            align(object, sections[section].alignment);
+            sections[section].offset = object.size();
+            object.append(data);
+        }
+        sections[Section::NoteStack].offset = object.size();
+
+        align(object, 8);
+        const auto section_headers = object.size();
+        for(const auto& section : sections) {
+            endian::write_le<uint32_t>(object, section.name);
+            endian::write_le<uint32_t>(object, static_cast<uint32_t>(section.type));
+            endian::write_le<uint64_t>(object, section.flags);
+            endian::write_le<uint64_t>(object, 0);
+            endian::write_le<uint64_t>(object, section.offset);
+            endian::write_le<uint64_t>(object, section.size);
+            endian::write_le<uint32_t>(object, section.link);
+            endian::write_le<uint32_t>(object, section.info);
+            endian::write_le<uint64_t>(object, section.alignment);
+            endian::write_le<uint64_t>(object, section.entry_size);
+        }
+
+        std::string header = { '\x7F', 'E', 'L', 'F', 2, 1, 1, 0 };
+        header.resize(16, '\0');
+        //Relocatable, x86-64, version 1, no entry and no program headers
+        endian::write_le<uint16_t>(header, 1);
+        endian::write_le<uint16_t>(header, 62);
+        endian::write_le<uint32_t>(header, 1);
+        endian::write_le<uint64_t>(header, 0);
+        endian::write_le<uint64_t>(header, 0);
+        endian::write_le<uint64_t>(header, section_headers);
+        endian::write_le<uint32_t>(header, 0);
+        endian::write_le<uint16_t>(header, _HEADER_SIZE);
+        endian::write_le<uint16_t>(header, 0);
+        endian::write_le<uint16_t>(header, 0);
+        endian::write_le<uint16_t>(header, _SECTION_HEADER_SIZE);
+        endian::write_le<uint16_t>(header, Section::SectionCount);
+        endian::write_le<uint16_t>(header, Section::SectionNames);
+        object.replace(0, _HEADER_SIZE, header);
+        return object;
+    }
+}
\ No newline at end of file
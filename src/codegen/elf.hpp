@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace karmac::codegen::elf {
+    //A global function in the text section
+    struct Symbol {
+        std::string_view name;
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    //A relocatable x86-64 ELF object with `text` as its only section, which has no relocations. The stack is marked
+    //as not executable. `file` names the source in the symbol table.
+    [[nodiscard]] std::string write_object(std::string_view file, std::string_view text, std::span<const Symbol> functions);
+}
\ No newline at end of file
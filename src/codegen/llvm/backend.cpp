@@ -0,0 +1,164 @@
+#include "backend.hpp"
+#include "lowering.hpp"
+#include "pipeline.hpp"
+#include "../../util/stats/alloc_stats.hpp"
+#include "../../util/stats/trace.hpp"
+
+#include <fmt/format.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+namespace karmac::codegen {
+    using ast::NodeIndex;
+
+    struct Partition {
+        std::vector<NodeIndex> functions;
+        //Bitcode for IR, an object otherwise
+        std::string output;
+        std::vector<Diagnostic> errors;
+    };
+
+    //Weighs the functions by the tokens up to the next function, the last one gets the average
+    static std::vector<Partition> split(const ast::Tree& tree, size_t count) {
+        const auto functions = tree.get_children(ast::NO_NODE);
+        std::vector<size_t> weights(functions.size());
+        size_t total = 0;
+        for(size_t i = 0; i + 1 < functions.size(); i++) {
+            weights[i] = tree.get_main_token(functions[i + 1]) - tree.get_main_token(functions[i]);
+            total += weights[i];
+        }
+        if(!functions.empty()) {
+            weights.back() = functions.size() > 1 ? total / (functions.size() - 1) : 1;
+            total += weights.back();
+        }
+
+        //A partition ends once it reaches its share of the total
+        std::vector<Partition> partitions(1);
+        size_t done = 0;
+        for(size_t i = 0; i < functions.size(); i++) {
+            if(!partitions.back().functions.empty() && done * count >= total * partitions.size()) {
+                partitions.emplace_back();
+            }
+            partitions.back().functions.push_back(functions[i]);
+            done += weights[i];
+        }
+        return partitions;
+    }
+
+    static std::string emit_object(llvm::Module& module, llvm::TargetMachine& machine) {
+        llvm::SmallVector<char, 0> buffer;
+        llvm::raw_svector_ostream stream(buffer);
+        llvm::legacy::PassManager passes;
+        if(machine.addPassesToEmitFile(passes, stream, nullptr, llvm::CGFT_ObjectFile)) {
+            throw std::runtime_error(fmt::format("LLVM can't emit objects for {}", machine.getTargetTriple().str()));
+        }
+        passes.run(module);
+        return std::string(buffer.data(), buffer.size());
+    }
+
+    static std::string link(std::vector<Partition>& partitions, std::string_view name) {
+        KARMAC_TRACE_ZONE("llvm link");
+
+        llvm::LLVMContext context;
+        auto linked = std::make_unique<llvm::Module>(llvm::StringRef(name.data(), name.size()), context);
+        llvm::Linker linker(*linked);
+        for(const auto& partition : partitions) {
+            auto module = llvm::parseBitcodeFile(llvm::MemoryBufferRef(partition.output, linked->getName()), context);
+            if(!module) {
+                throw std::runtime_error(fmt::format("LLVM failed to read a partition: {}", llvm::toString(module.takeError())));
+            }
+            if(linker.linkInModule(std::move(*module))) {
+                throw std::runtime_error("LLVM failed to link the partitions");
+            }
+        }
+
+        std::string text;
+        llvm::raw_string_ostream stream(text);
+        linked->print(stream, nullptr);
+        stream.flush();
+        return text;
+    }
+
+    void LlvmBackend::compile(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::string_view name, LlvmOutput output,
+                              size_t partitions, ThreadPool* pool) {
+        _outputs.clear();
+        _errors.clear();
+
+        auto parts = split(tree, std::max<size_t>(partitions, 1));
+        const auto compile_partition = [&](size_t i) {
+            KARMAC_ALLOC_PHASE(Codegen);
+            auto& partition = parts[i];
+
+            llvm::LLVMContext context;
+            std::unique_ptr<llvm::Module> module;
+            {
+                KARMAC_TRACE_ZONE("llvm lower");
+                LlvmLowering lowering(tree, resolver, checker, context);
+                module = lowering.lower(fmt::format("{}.{}", name, i), partition.functions);
+                partition.errors = lowering.get_errors();
+            }
+            if(!partition.errors.empty()) {
+                return;
+            }
+
+            const auto machine = create_target_machine();
+            module->setTargetTriple(machine->getTargetTriple().str());
+            module->setDataLayout(machine->createDataLayout());
+            {
+                KARMAC_TRACE_ZONE("llvm verify");
+                std::string message;
+                llvm::raw_string_ostream stream(message);
+                if(llvm::verifyModule(*module, &stream)) {
+                    stream.flush();
+                    throw std::runtime_error(fmt::format("LLVM rejected the IR of {}: {}", name, message));
+                }
+            }
+            {
+                KARMAC_TRACE_ZONE("llvm optimize");
+                optimize(*module, *machine);
+            }
+
+            KARMAC_TRACE_ZONE("llvm emit");
+            if(output == LlvmOutput::Object) {
+                partition.output = emit_object(*module, *machine);
+            } else {
+                llvm::raw_string_ostream stream(partition.output);
+                llvm::WriteBitcodeToFile(*module, stream);
+                stream.flush();
+            }
+        };
+
+        if(pool != nullptr && parts.size() > 1) {
+            pool->run(parts.size(), compile_partition);
+        } else {
+            for(size_t i = 0; i < parts.size(); i++) {
+                compile_partition(i);
+            }
+        }
+
+        //The partitions are consecutive, so their errors stay in source order
+        for(const auto& partition : parts) {
+            _errors.insert(_errors.end(), partition.errors.begin(), partition.errors.end());
+        }
+        if(!_errors.empty()) {
+            return;
+        }
+
+        if(output == LlvmOutput::Ir) {
+            KARMAC_ALLOC_PHASE(Codegen);
+            _outputs.push_back(link(parts, name));
+            return;
+        }
+        for(auto& partition : parts) {
+            _outputs.push_back(std::move(partition.output));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "../../check/type_checker.hpp"
+#include "../../parse/ast/tree.hpp"
+#include "../../resolve/resolver.hpp"
+#include "../../source/diagnostic.hpp"
+#include "../../util/thread/thread_pool.hpp"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac::codegen {
+    enum class LlvmOutput : uint8_t {
+        //One module as text
+        Ir,
+        //One native object per partition
+        Object
+    };
+
+    //Compiles a checked tree with LLVM. The functions are split into partitions of consecutive functions with about
+    //the same amount of source, every partition is lowered, optimized and emitted as its own module in its own
+    //context, so the partitions run in parallel. Calls between partitions go through external declarations, which
+    //also means nothing is inlined across them. For IR the optimized partitions are linked into one module again.
+    class LlvmBackend final {
+    private:
+        std::vector<std::string> _outputs;
+        std::vector<Diagnostic> _errors;
+    public:
+        //Replaces the outputs with the ones of `tree`, which was checked without errors. Uses up to `partitions`
+        //partitions, on `pool` if set. Throws std::runtime_error if LLVM fails.
+        void compile(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::string_view name, LlvmOutput output,
+                     size_t partitions, ThreadPool* pool);
+
+        //The IR as text or the objects in partition order, empty if there were errors
+        [[nodiscard]] inline const std::vector<std::string>& get_outputs() const noexcept {
+            return _outputs;
+        }
+
+        //Constructs that can't be compiled yet, in source order
+        [[nodiscard]] inline const std::vector<Diagnostic>& get_errors() const noexcept {
+            return _errors;
+        }
+    };
+}
\ No newline at end of file
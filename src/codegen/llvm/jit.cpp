@@ -0,0 +1,203 @@
+#include "jit.hpp"
+#include "lowering.hpp"
+#include "pipeline.hpp"
+#include "../native.hpp"
+#include "../../bytecode/interpreter.hpp"
+#include "../../util/hash/hash.hpp"
+#include "../../util/stats/alloc_stats.hpp"
+#include "../../util/stats/trace.hpp"
+
+#include <fmt/format.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/ExecutionEngine/Orc/CompileUtils.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace karmac::codegen {
+    //Module flag with the cache key of a function module, set before it is optimized
+    static constexpr std::string_view _CACHE_KEY_FLAG = "karmac.cache_key";
+
+    //State of one run shared by the layers of the JIT
+    struct JitState {
+        FrontendCache* cache;
+        //Used by the optimization, the compiler has its own
+        std::unique_ptr<llvm::TargetMachine> machine;
+        //Seed of the cache keys, covers everything besides the IR that changes the machine code
+        uint64_t seed = 0;
+        //Objects found in the cache by the transform, which doesn't optimize their modules
+        std::unordered_map<uint64_t, MappedFile> found_objects;
+        size_t compiled_functions = 0;
+        size_t cached_functions = 0;
+    };
+
+    template<typename T>
+    static T check(llvm::Expected<T> value) {
+        if(!value) {
+            throw std::runtime_error(fmt::format("LLVM JIT failed: {}", llvm::toString(value.takeError())));
+        }
+        return std::move(*value);
+    }
+
+    static void check(llvm::Error error) {
+        if(error) {
+            throw std::runtime_error(fmt::format("LLVM JIT failed: {}", llvm::toString(std::move(error))));
+        }
+    }
+
+    static uint64_t get_cache_key(const llvm::Module& module, uint64_t seed) {
+        std::string bitcode;
+        llvm::raw_string_ostream stream(bitcode);
+        llvm::WriteBitcodeToFile(module, stream);
+        stream.flush();
+        return hash::hash64(bitcode, seed);
+    }
+
+    //Compiles the modules of single functions split off by the lazy JIT, or takes their object from the cache
+    class CachingCompiler final : public llvm::orc::IRCompileLayer::IRCompiler {
+    private:
+        std::unique_ptr<llvm::TargetMachine> _machine;
+        JitState& _state;
+    public:
+        CachingCompiler(std::unique_ptr<llvm::TargetMachine> machine, JitState& state) :
+            IRCompiler(llvm::orc::irManglingOptionsFromTargetOptions(machine->Options)), _machine(std::move(machine)), _state(state) {}
+
+        llvm::Expected<std::unique_ptr<llvm::MemoryBuffer>> operator()(llvm::Module& module) override {
+            KARMAC_TRACE_ZONE("llvm emit");
+            KARMAC_ALLOC_PHASE(Codegen);
+
+            std::optional<uint64_t> key;
+            if(const auto* flag = llvm::mdconst::extract_or_null<llvm::ConstantInt>(module.getModuleFlag(_CACHE_KEY_FLAG))) {
+                key = flag->getZExtValue();
+                const auto found = _state.found_objects.find(*key);
+                if(found != _state.found_objects.end()) {
+                    auto object = llvm::MemoryBuffer::getMemBufferCopy(found->second.get_data(), module.getModuleIdentifier());
+                    _state.found_objects.erase(found);
+                    _state.cached_functions++;
+                    return object;
+                }
+            }
+
+            auto object = llvm::orc::SimpleCompiler(*_machine)(module);
+            if(object && key) {
+                _state.cache->store_object(*key, (*object)->getBuffer());
+            }
+            _state.compiled_functions++;
+            return object;
+        }
+    };
+
+    LlvmJit::LlvmJit(FrontendCache* cache) noexcept : _cache(cache) {}
+
+    uint64_t LlvmJit::run_main(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, ast::NodeIndex main,
+                               std::string_view name) {
+        _errors.clear();
+        _compiled_functions = 0;
+        _cached_functions = 0;
+
+        JitState state;
+        std::unique_ptr<llvm::orc::LLLazyJIT> jit;
+        {
+            KARMAC_TRACE_ZONE("jit setup");
+            initialize_native_target();
+
+            state.cache = _cache;
+            state.machine = check(check(llvm::orc::JITTargetMachineBuilder::detectHost()).createTargetMachine());
+            state.seed = hash::hash64(fmt::format("{} {} {} {} {}", KARMAC_VERSION, LLVM_VERSION_STRING, state.machine->getTargetTriple().str(),
+                                                  state.machine->getTargetCPU().str(), state.machine->getTargetFeatureString().str()));
+
+            llvm::orc::LLLazyJITBuilder builder;
+            builder.setCompileFunctionCreator([&state](llvm::orc::JITTargetMachineBuilder machine)
+                                                  -> llvm::Expected<std::unique_ptr<llvm::orc::IRCompileLayer::IRCompiler>> {
+                auto target = machine.createTargetMachine();
+                if(!target) {
+                    return target.takeError();
+                }
+                return std::make_unique<CachingCompiler>(std::move(*target), state);
+            });
+            jit = check(builder.create());
+
+            //Every function module passes here on its first call
+            jit->getIRTransformLayer().setTransform([&state](llvm::orc::ThreadSafeModule module, const llvm::orc::MaterializationResponsibility&) {
+                module.withModuleDo([&state](llvm::Module& function) {
+                    KARMAC_ALLOC_PHASE(Codegen);
+                    if(state.cache != nullptr) {
+                        KARMAC_TRACE_ZONE("jit cache lookup");
+                        const auto key = get_cache_key(function, state.seed);
+                        function.addModuleFlag(llvm::Module::Warning, _CACHE_KEY_FLAG, llvm::ConstantInt::get(llvm::Type::getInt64Ty(function.getContext()), key));
+                        if(auto object = state.cache->find_object(key)) {
+                            state.found_objects.insert_or_assign(key, std::move(*object));
+                            return;
+                        }
+                    }
+
+                    KARMAC_TRACE_ZONE("llvm optimize");
+                    optimize(function, *state.machine);
+                });
+                return llvm::Expected<llvm::orc::ThreadSafeModule>(std::move(module));
+            });
+
+            auto& library = jit->getMainJITDylib();
+            llvm::orc::SymbolMap runtime;
+            runtime[jit->mangleAndIntern("karmac_trap")] = llvm::JITEvaluatedSymbol(static_cast<llvm::JITTargetAddress>(native::get_trap_handler()),
+                                                                                  llvm::JITSymbolFlags::Exported | llvm::JITSymbolFlags::Callable);
+            check(library.define(llvm::orc::absoluteSymbols(std::move(runtime))));
+            //Code generation may call helpers of the C runtime
+            library.addGenerator(check(llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(jit->getDataLayout().getGlobalPrefix())));
+        }
+
+        //Every function gets its own module, the lazy JIT would otherwise clone the whole module for each of them
+        const auto functions = tree.get_children(ast::NO_NODE);
+        llvm::orc::ThreadSafeContext context(std::make_unique<llvm::LLVMContext>());
+        std::vector<std::unique_ptr<llvm::Module>> modules;
+        {
+            KARMAC_TRACE_ZONE("llvm lower");
+            KARMAC_ALLOC_PHASE(Codegen);
+            LlvmLowering lowering(tree, resolver, checker, *context.getContext(), TrapHandling::Call);
+            modules.reserve(functions.size());
+            for(size_t i = 0; i < functions.size(); i++) {
+                modules.push_back(lowering.lower(name, functions.subspan(i, 1)));
+                _errors.insert(_errors.end(), lowering.get_errors().begin(), lowering.get_errors().end());
+            }
+        }
+        if(!_errors.empty()) {
+            return 0;
+        }
+
+        {
+            KARMAC_TRACE_ZONE("llvm verify");
+            for(auto& module : modules) {
+                module->setDataLayout(jit->getDataLayout());
+                module->setTargetTriple(jit->getTargetTriple().str());
+
+                std::string message;
+                llvm::raw_string_ostream stream(message);
+                if(llvm::verifyModule(*module, &stream)) {
+                    stream.flush();
+                    throw std::runtime_error(fmt::format("LLVM rejected the IR of {}: {}", name, message));
+                }
+                check(jit->addLazyIRModule(llvm::orc::ThreadSafeModule(std::move(module), context)));
+            }
+        }
+
+        const auto address = check(jit->lookup("main")).getAddress();
+        uint64_t result = 0;
+        const auto trap = native::call_main(static_cast<uintptr_t>(address), checker.get_type(main), result);
+        _compiled_functions = state.compiled_functions;
+        _cached_functions = state.cached_functions;
+
+        if(trap) {
+            const auto function = tree.get_function(functions[trap->function]);
+            throw bytecode::RuntimeError(fmt::format("{} in {}", bytecode::trap_kind::get_message(trap->kind), tree.get_token(function.name).to_string()));
+        }
+        return result;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../../cache/frontend_cache.hpp"
+#include "../../check/type_checker.hpp"
+#include "../../parse/ast/tree.hpp"
+#include "../../resolve/resolver.hpp"
+#include "../../source/diagnostic.hpp"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace karmac::codegen {
+    //Runs a checked tree in process with the lazy LLVM ORC JIT. The whole tree is lowered up front, which is cheap,
+    //but every function is only optimized and compiled when it is called the first time. With a cache the objects of
+    //functions are stored by a hash of their unoptimized IR, so later runs skip optimization and code generation of
+    //unchanged functions.
+    //Traps throw bytecode::RuntimeError like the interpreter does, deep recursion overflows the native stack though.
+    class LlvmJit final {
+    private:
+        FrontendCache* _cache;
+        std::vector<Diagnostic> _errors;
+        size_t _compiled_functions = 0;
+        size_t _cached_functions = 0;
+    public:
+        //`cache` may be null
+        explicit LlvmJit(FrontendCache* cache) noexcept;
+
+        //Calls `main`, a function of `tree` without parameters, and returns its result like the interpreter does,
+        //integers extended to 64 bits. Returns 0 if the tree can't be lowered, see `get_errors`. Throws
+        //bytecode::RuntimeError if the program traps and std::runtime_error if LLVM fails.
+        [[nodiscard]] uint64_t run_main(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, ast::NodeIndex main,
+                                        std::string_view name);
+
+        //Constructs that can't be compiled yet, in source order
+        [[nodiscard]] inline const std::vector<Diagnostic>& get_errors() const noexcept {
+            return _errors;
+        }
+
+        //Functions compiled by the last run, the ones loaded from the cache aren't counted
+        [[nodiscard]] inline size_t get_compiled_functions() const noexcept {
+            return _compiled_functions;
+        }
+
+        [[nodiscard]] inline size_t get_cached_functions() const noexcept {
+            return _cached_functions;
+        }
+    };
+}
\ No newline at end of file
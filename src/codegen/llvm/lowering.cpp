@@ -0,0 +1,613 @@
+#include "lowering.hpp"
+
+#include <fmt/format.h>
+#include <llvm/IR/Intrinsics.h>
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace karmac::codegen {
+    using ast::NodeIndex;
+    using ast::NodeKind;
+
+    static llvm::CmpInst::Predicate get_predicate(TokenType op, Type type) noexcept {
+        if(type::is_float(type)) {
+            //Ordered like the comparisons of the interpreter, except != which is true for NaNs
+            switch(op) {
+                case TokenType::Equals:
+                    return llvm::CmpInst::FCMP_OEQ;
+                case TokenType::NotEquals:
+                    return llvm::CmpInst::FCMP_UNE;
+                case TokenType::Less:
+                    return llvm::CmpInst::FCMP_OLT;
+                case TokenType::LessEquals:
+                    return llvm::CmpInst::FCMP_OLE;
+                case TokenType::Greater:
+                    return llvm::CmpInst::FCMP_OGT;
+                default:
+                    return llvm::CmpInst::FCMP_OGE;
+            }
+        }
+
+        const auto is_signed = type::is_signed(type);
+        switch(op) {
+            case TokenType::Equals:
+                return llvm::CmpInst::ICMP_EQ;
+            case TokenType::NotEquals:
+                return llvm::CmpInst::ICMP_NE;
+            case TokenType::Less:
+                return is_signed ? llvm::CmpInst::ICMP_SLT : llvm::CmpInst::ICMP_ULT;
+            case TokenType::LessEquals:
+                return is_signed ? llvm::CmpInst::ICMP_SLE : llvm::CmpInst::ICMP_ULE;
+            case TokenType::Greater:
+                return is_signed ? llvm::CmpInst::ICMP_SGT : llvm::CmpInst::ICMP_UGT;
+            default:
+                return is_signed ? llvm::CmpInst::ICMP_SGE : llvm::CmpInst::ICMP_UGE;
+        }
+    }
+
+    //Bools and small integers are extended to an int at calls like in C
+    static void add_extension(llvm::AttrBuilder& attributes, Type type) noexcept {
+        if(type == Type::Bool || type::get_bits(type) < 32) {
+            attributes.addAttribute(type::is_signed(type) ? llvm::Attribute::SExt : llvm::Attribute::ZExt);
+        }
+    }
+
+    LlvmLowering::LlvmLowering(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, llvm::LLVMContext& context,
+                               TrapHandling trap_handling) :
+        _tree(tree), _resolver(resolver), _checker(checker), _context(context), _trap_handling(trap_handling), _builder(context) {}
+
+    llvm::Type* LlvmLowering::get_type(Type type) const noexcept {
+        switch(type::get_default(type)) {
+            case Type::Void:
+                return nullptr;
+            case Type::Bool:
+                return llvm::Type::getInt1Ty(_context);
+            case Type::U8:
+            case Type::I8:
+                return llvm::Type::getInt8Ty(_context);
+            case Type::U16:
+            case Type::I16:
+                return llvm::Type::getInt16Ty(_context);
+            case Type::U32:
+            case Type::I32:
+                return llvm::Type::getInt32Ty(_context);
+            case Type::F32:
+                return llvm::Type::getFloatTy(_context);
+            case Type::F64:
+                return llvm::Type::getDoubleTy(_context);
+            default:
+                return llvm::Type::getInt64Ty(_context);
+        }
+    }
+
+    llvm::Function* LlvmLowering::get_function(NodeIndex function) {
+        const auto view = _tree.get_function(function);
+        const auto name = _tree.get_token(view.name).to_string();
+        const llvm::StringRef llvm_name(name.data(), name.size());
+        if(auto* existing = _module->getFunction(llvm_name)) {
+            return existing;
+        }
+
+        const auto return_type = _checker.get_type(function);
+        auto* result = get_type(return_type);
+        if(result == nullptr) {
+            result = name == "main" ? _builder.getInt32Ty() : _builder.getVoidTy();
+        }
+
+        std::vector<llvm::Type*> parameters;
+        for(const auto parameter : view.parameters) {
+            parameters.push_back(get_type(_checker.get_type(parameter)));
+        }
+
+        auto* declaration = llvm::Function::Create(llvm::FunctionType::get(result, parameters, false), llvm::Function::ExternalLinkage,
+                                                   llvm_name, _module);
+        llvm::AttrBuilder attributes(_context);
+        add_extension(attributes, return_type);
+        declaration->addRetAttrs(attributes);
+        for(size_t i = 0; i < view.parameters.size(); i++) {
+            llvm::AttrBuilder parameter(_context);
+            add_extension(parameter, _checker.get_type(view.parameters[i]));
+            declaration->addParamAttrs(static_cast<unsigned>(i), parameter);
+        }
+        declaration->addFnAttr(llvm::Attribute::NoUnwind);
+        return declaration;
+    }
+
+    llvm::Value* LlvmLowering::get_constant(NodeIndex node) {
+        const auto type = _checker.get_type(node);
+        auto* llvm_type = get_type(type);
+        const auto value = _checker.get_value(node);
+        if(type::is_float(type)) {
+            return llvm::ConstantFP::get(llvm_type, std::bit_cast<double>(value));
+        }
+        //The value is extended to 64 bits
+        return llvm::ConstantInt::get(llvm_type, value & llvm::cast<llvm::IntegerType>(llvm_type)->getBitMask());
+    }
+
+    llvm::Value* LlvmLowering::get_poison(NodeIndex node) {
+        auto* type = get_type(_checker.get_type(node));
+        return type == nullptr ? nullptr : llvm::PoisonValue::get(type);
+    }
+
+    llvm::AllocaInst* LlvmLowering::get_variable(NodeIndex node) const noexcept {
+        if(_tree.get_kind(node) != NodeKind::Identifier || _checker.is_constant(node) || _checker.get_type(node) == Type::Function) {
+            return nullptr;
+        }
+        return _variables[_resolver.get_declaration(node)];
+    }
+
+    llvm::AllocaInst* LlvmLowering::allocate(NodeIndex node) {
+        //Slots in the entry block are promoted to registers
+        auto& entry = _function->getEntryBlock();
+        llvm::IRBuilder<> builder(&entry, entry.begin());
+        auto* slot = builder.CreateAlloca(get_type(_checker.get_type(node)));
+        _variables[node] = slot;
+        return slot;
+    }
+
+    void LlvmLowering::start_block(std::string_view name) {
+        _builder.SetInsertPoint(llvm::BasicBlock::Create(_context, llvm::StringRef(name.data(), name.size()), _function));
+    }
+
+    void LlvmLowering::trap_if(llvm::Value* condition, bytecode::TrapKind kind) {
+        auto*& trap = _traps[static_cast<size_t>(kind)];
+        if(trap == nullptr) {
+            const auto insert_point = _builder.GetInsertBlock();
+            trap = llvm::BasicBlock::Create(_context, "trap", _function);
+            _builder.SetInsertPoint(trap);
+            if(_trap_handling == TrapHandling::Call) {
+                const auto handler = _module->getOrInsertFunction("karmac_trap", _builder.getVoidTy(), _builder.getInt16Ty(), _builder.getInt32Ty());
+                auto* call = _builder.CreateCall(handler, { _builder.getInt16(static_cast<uint16_t>(kind)), _builder.getInt32(_function_index) });
+                call->setDoesNotReturn();
+            } else {
+                _builder.CreateCall(llvm::Intrinsic::getDeclaration(_module, llvm::Intrinsic::trap));
+            }
+            _builder.CreateUnreachable();
+            _builder.SetInsertPoint(insert_point);
+        }
+
+        auto* next = llvm::BasicBlock::Create(_context, "", _function);
+        _builder.CreateCondBr(condition, trap, next);
+        _builder.SetInsertPoint(next);
+    }
+
+    std::unique_ptr<llvm::Module> LlvmLowering::lower(std::string_view name, std::span<const NodeIndex> functions) {
+        auto module = std::make_unique<llvm::Module>(llvm::StringRef(name.data(), name.size()), _context);
+        _module = module.get();
+        //Slots are set before they are used, so they are kept when a lowering creates several modules
+        if(_variables.empty()) {
+            _variables.assign(_tree.get_node_count(), nullptr);
+        }
+        _errors.clear();
+
+        const auto all_functions = _tree.get_children(ast::NO_NODE);
+        for(const auto function : functions) {
+            _function_index = static_cast<uint32_t>(std::lower_bound(all_functions.begin(), all_functions.end(), function) - all_functions.begin());
+            lower_function(function);
+        }
+
+        _module = nullptr;
+        return module;
+    }
+
+    void LlvmLowering::lower_function(NodeIndex function) {
+        const auto view = _tree.get_function(function);
+        karmac_assert(_tree.get_kind(view.body) == NodeKind::Block);
+
+        _function = get_function(function);
+        _returns_exit_code = _checker.get_type(function) == Type::Void && !_function->getReturnType()->isVoidTy();
+        _traps = {};
+        _builder.SetInsertPoint(llvm::BasicBlock::Create(_context, "entry", _function));
+
+        for(size_t i = 0; i < view.parameters.size(); i++) {
+            _builder.CreateStore(_function->getArg(static_cast<unsigned>(i)), allocate(view.parameters[i]));
+        }
+        lower_statement(view.body);
+
+        //Reached by falling off the end of the body
+        if(_builder.GetInsertBlock()->getTerminator() == nullptr) {
+            if(_returns_exit_code) {
+                _builder.CreateRet(_builder.getInt32(0));
+            } else if(_checker.get_type(function) == Type::Void) {
+                _builder.CreateRetVoid();
+            } else {
+                trap_if(_builder.getTrue(), bytecode::TrapKind::MissingReturn);
+                _builder.CreateUnreachable();
+            }
+        }
+        _function = nullptr;
+    }
+
+    void LlvmLowering::lower_statement(NodeIndex node) {
+        switch(_tree.get_kind(node)) {
+            case NodeKind::Block:
+                for(const auto statement : _tree.get_children(node)) {
+                    lower_statement(statement);
+                }
+                break;
+            case NodeKind::Declaration:
+                lower_declaration(node);
+                break;
+            case NodeKind::If:
+                lower_if(node);
+                break;
+            case NodeKind::While:
+                lower_while(node);
+                break;
+            case NodeKind::For:
+                lower_for(node);
+                break;
+            case NodeKind::Return:
+                lower_return(node);
+                break;
+            //The checker rejects break and continue outside of loops
+            case NodeKind::Break:
+                karmac_assert(_break_target != nullptr);
+                _builder.CreateBr(_break_target);
+                start_block("after.break");
+                break;
+            case NodeKind::Continue:
+                karmac_assert(_continue_target != nullptr);
+                _builder.CreateBr(_continue_target);
+                start_block("after.continue");
+                break;
+            default:
+                static_cast<void>(lower_expression(node));
+                break;
+        }
+    }
+
+    void LlvmLowering::lower_declaration(NodeIndex node) {
+        //Uses of constants are replaced by the folded value
+        if(_checker.is_constant(node)) {
+            return;
+        }
+        if(_checker.get_type(node) == Type::Function) {
+            report(node, "function values can't be stored yet");
+            return;
+        }
+        //The checker rejects variables initialized by calls without result
+        karmac_assert(_checker.get_type(node) != Type::Void);
+
+        auto* slot = allocate(node);
+        _builder.CreateStore(lower_expression(_tree.get_data(node).rhs), slot);
+    }
+
+    void LlvmLowering::lower_if(NodeIndex node) {
+        const auto view = _tree.get_if(node);
+        auto* then = llvm::BasicBlock::Create(_context, "if.then", _function);
+        auto* end = llvm::BasicBlock::Create(_context, "if.end");
+        auto* otherwise = view.otherwise == ast::NO_NODE ? end : llvm::BasicBlock::Create(_context, "if.else", _function);
+
+        _builder.CreateCondBr(lower_expression(view.condition), then, otherwise);
+        _builder.SetInsertPoint(then);
+        lower_statement(view.then);
+        _builder.CreateBr(end);
+
+        if(view.otherwise != ast::NO_NODE) {
+            _builder.SetInsertPoint(otherwise);
+            lower_statement(view.otherwise);
+            _builder.CreateBr(end);
+        }
+
+        end->insertInto(_function);
+        _builder.SetInsertPoint(end);
+    }
+
+    void LlvmLowering::lower_while(NodeIndex node) {
+        const auto& data = _tree.get_data(node);
+        auto* condition = llvm::BasicBlock::Create(_context, "while.condition", _function);
+        auto* body = llvm::BasicBlock::Create(_context, "while.body", _function);
+        auto* end = llvm::BasicBlock::Create(_context, "while.end");
+
+        _builder.CreateBr(condition);
+        _builder.SetInsertPoint(condition);
+        _builder.CreateCondBr(lower_expression(data.lhs), body, end);
+
+        const auto outer_break = std::exchange(_break_target, end);
+        const auto outer_continue = std::exchange(_continue_target, condition);
+        _builder.SetInsertPoint(body);
+        lower_statement(data.rhs);
+        _builder.CreateBr(condition);
+        _break_target = outer_break;
+        _continue_target = outer_continue;
+
+        end->insertInto(_function);
+        _builder.SetInsertPoint(end);
+    }
+
+    void LlvmLowering::lower_for(NodeIndex node) {
+        const auto& data = _tree.get_data(node);
+        const auto& bounds = _tree.get_data(data.lhs);
+        const auto is_signed = type::is_signed(_checker.get_type(node));
+
+        //The end is evaluated once, the variable counts up to it
+        auto* variable = allocate(node);
+        _builder.CreateStore(lower_expression(bounds.lhs), variable);
+        auto* limit = lower_expression(bounds.rhs);
+
+        auto* condition = llvm::BasicBlock::Create(_context, "for.condition", _function);
+        auto* body = llvm::BasicBlock::Create(_context, "for.body", _function);
+        auto* step = llvm::BasicBlock::Create(_context, "for.step");
+        auto* end = llvm::BasicBlock::Create(_context, "for.end");
+
+        _builder.CreateBr(condition);
+        _builder.SetInsertPoint(condition);
+        auto* value = _builder.CreateLoad(variable->getAllocatedType(), variable);
+        _builder.CreateCondBr(is_signed ? _builder.CreateICmpSLT(value, limit) : _builder.CreateICmpULT(value, limit), body, end);
+
+        const auto outer_break = std::exchange(_break_target, end);
+        const auto outer_continue = std::exchange(_continue_target, step);
+        _builder.SetInsertPoint(body);
+        lower_statement(data.rhs);
+        _builder.CreateBr(step);
+        _break_target = outer_break;
+        _continue_target = outer_continue;
+
+        step->insertInto(_function);
+        _builder.SetInsertPoint(step);
+        value = _builder.CreateLoad(variable->getAllocatedType(), variable);
+        _builder.CreateStore(_builder.CreateAdd(value, llvm::ConstantInt::get(value->getType(), 1)), variable);
+        _builder.CreateBr(condition);
+
+        end->insertInto(_function);
+        _builder.SetInsertPoint(end);
+    }
+
+    void LlvmLowering::lower_return(NodeIndex node) {
+        const auto value = _tree.get_data(node).lhs;
+        if(value != ast::NO_NODE) {
+            _builder.CreateRet(lower_expression(value));
+        } else if(_returns_exit_code) {
+            _builder.CreateRet(_builder.getInt32(0));
+        } else {
+            _builder.CreateRetVoid();
+        }
+        start_block("after.return");
+    }
+
+    llvm::Value* LlvmLowering::lower_expression(NodeIndex node) {
+        if(_checker.is_constant(node)) {
+            return get_constant(node);
+        }
+
+        const auto& data = _tree.get_data(node);
+        switch(_tree.get_kind(node)) {
+            case NodeKind::Identifier: {
+                auto* variable = get_variable(node);
+                if(variable == nullptr) {
+                    report(node, "function values can't be compiled yet");
+                    return get_poison(node);
+                }
+                return _builder.CreateLoad(variable->getAllocatedType(), variable);
+            }
+            case NodeKind::Literal:
+                //Number literals are constants
+                report(node, "string literals can't be compiled yet");
+                return get_poison(node);
+            case NodeKind::Unary:
+                return lower_unary(node);
+            case NodeKind::Postfix: {
+                const auto op = _tree.get_token(_tree.get_main_token(node)).get_type();
+                return lower_increment(data.lhs, op == TokenType::Decrement, true);
+            }
+            case NodeKind::Binary:
+                return lower_binary(node);
+            case NodeKind::Assignment:
+                return lower_assignment(node);
+            case NodeKind::Conditional:
+                return lower_conditional(node);
+            case NodeKind::Call:
+                return lower_call(node);
+            default:
+                report(node, fmt::format("{} expressions can't be compiled yet", ast::node_kind::get_name(_tree.get_kind(node))));
+                return get_poison(node);
+        }
+    }
+
+    llvm::Value* LlvmLowering::lower_unary(NodeIndex node) {
+        const auto op = _tree.get_token(_tree.get_main_token(node)).get_type();
+        const auto operand = _tree.get_data(node).lhs;
+        switch(op) {
+            case TokenType::Increment:
+            case TokenType::Decrement:
+                return lower_increment(operand, op == TokenType::Decrement, false);
+            case TokenType::Add:
+                return lower_expression(operand);
+            case TokenType::Not:
+                return _builder.CreateNot(lower_expression(operand));
+            default:
+                break;
+        }
+
+        auto* value = lower_expression(operand);
+        return type::is_float(_checker.get_type(node)) ? _builder.CreateFNeg(value) : _builder.CreateNeg(value);
+    }
+
+    llvm::Value* LlvmLowering::lower_increment(NodeIndex operand, bool decrement, bool postfix) {
+        auto* variable = get_variable(operand);
+        karmac_assert(variable != nullptr);
+
+        auto* type = variable->getAllocatedType();
+        auto* value = _builder.CreateLoad(type, variable);
+        llvm::Value* result;
+        if(type->isFloatingPointTy()) {
+            auto* one = llvm::ConstantFP::get(type, 1.0);
+            result = decrement ? _builder.CreateFSub(value, one) : _builder.CreateFAdd(value, one);
+        } else {
+            auto* one = llvm::ConstantInt::get(type, 1);
+            result = decrement ? _builder.CreateSub(value, one) : _builder.CreateAdd(value, one);
+        }
+        _builder.CreateStore(result, variable);
+        return postfix ? value : result;
+    }
+
+    llvm::Value* LlvmLowering::lower_binary(NodeIndex node) {
+        const auto op = _tree.get_token(_tree.get_main_token(node)).get_type();
+        if(op == TokenType::Conjunction || op == TokenType::Disjunction) {
+            return lower_logical(node);
+        }
+
+        const auto& data = _tree.get_data(node);
+        const auto type = _checker.get_type(data.lhs);
+        auto* a = lower_expression(data.lhs);
+        auto* b = lower_expression(data.rhs);
+        if(token_type::is_comparison(op)) {
+            return _builder.CreateCmp(get_predicate(op, type), a, b);
+        }
+        return lower_arithmetic(op, type, a, b);
+    }
+
+    llvm::Value* LlvmLowering::lower_arithmetic(TokenType op, Type type, llvm::Value* a, llvm::Value* b) {
+        if(type::is_float(type)) {
+            switch(op) {
+                case TokenType::Add:
+                    return _builder.CreateFAdd(a, b);
+                case TokenType::Sub:
+                    return _builder.CreateFSub(a, b);
+                case TokenType::Mul:
+                    return _builder.CreateFMul(a, b);
+                default:
+                    return _builder.CreateFDiv(a, b);
+            }
+        }
+
+        switch(op) {
+            case TokenType::Add:
+                return _builder.CreateAdd(a, b);
+            case TokenType::Sub:
+                return _builder.CreateSub(a, b);
+            case TokenType::Mul:
+                return _builder.CreateMul(a, b);
+            case TokenType::Div:
+            case TokenType::Mod:
+                return lower_division(op, type, a, b);
+            case TokenType::LeftShift:
+            case TokenType::RightShift: {
+                //The amount can have any integer type, only its low bits are used
+                auto* amount = _builder.CreateZExtOrTrunc(b, a->getType());
+                amount = _builder.CreateAnd(amount, llvm::ConstantInt::get(a->getType(), type::get_bits(type) - 1));
+                if(op == TokenType::LeftShift) {
+                    return _builder.CreateShl(a, amount);
+                }
+                return type::is_signed(type) ? _builder.CreateAShr(a, amount) : _builder.CreateLShr(a, amount);
+            }
+            case TokenType::And:
+                return _builder.CreateAnd(a, b);
+            case TokenType::Or:
+                return _builder.CreateOr(a, b);
+            default:
+                return _builder.CreateXor(a, b);
+        }
+    }
+
+    llvm::Value* LlvmLowering::lower_division(TokenType op, Type type, llvm::Value* a, llvm::Value* b) {
+        trap_if(_builder.CreateICmpEQ(b, llvm::ConstantInt::get(b->getType(), 0)), bytecode::TrapKind::DivisionByZero);
+        if(!type::is_signed(type)) {
+            return op == TokenType::Div ? _builder.CreateUDiv(a, b) : _builder.CreateURem(a, b);
+        }
+
+        //The minimum divided by -1 overflows, dividing by 1 and negating wraps around instead. The remainder is 0
+        //either way.
+        auto* minus_one = _builder.CreateICmpEQ(b, llvm::ConstantInt::getSigned(b->getType(), -1));
+        auto* divisor = _builder.CreateSelect(minus_one, llvm::ConstantInt::get(b->getType(), 1), b);
+        if(op == TokenType::Mod) {
+            return _builder.CreateSRem(a, divisor);
+        }
+        return _builder.CreateSelect(minus_one, _builder.CreateNeg(a), _builder.CreateSDiv(a, divisor));
+    }
+
+    llvm::Value* LlvmLowering::lower_logical(NodeIndex node) {
+        const auto& data = _tree.get_data(node);
+        const auto op = _tree.get_token(_tree.get_main_token(node)).get_type();
+
+        auto* lhs = lower_expression(data.lhs);
+        auto* lhs_end = _builder.GetInsertBlock();
+        auto* rhs_start = llvm::BasicBlock::Create(_context, "logical.rhs", _function);
+        auto* end = llvm::BasicBlock::Create(_context, "logical.end");
+        if(op == TokenType::Conjunction) {
+            _builder.CreateCondBr(lhs, rhs_start, end);
+        } else {
+            _builder.CreateCondBr(lhs, end, rhs_start);
+        }
+
+        _builder.SetInsertPoint(rhs_start);
+        auto* rhs = lower_expression(data.rhs);
+        auto* rhs_end = _builder.GetInsertBlock();
+        _builder.CreateBr(end);
+
+        end->insertInto(_function);
+        _builder.SetInsertPoint(end);
+        auto* result = _builder.CreatePHI(_builder.getInt1Ty(), 2);
+        result->addIncoming(lhs, lhs_end);
+        result->addIncoming(rhs, rhs_end);
+        return result;
+    }
+
+    llvm::Value* LlvmLowering::lower_assignment(NodeIndex node) {
+        const auto& data = _tree.get_data(node);
+        auto* variable = get_variable(data.lhs);
+        if(variable == nullptr) {
+            report(data.lhs, "function values can't be compiled yet");
+            return get_poison(node);
+        }
+
+        const auto op = token_type::get_compound_operator(_tree.get_token(_tree.get_main_token(node)).get_type());
+        llvm::Value* value;
+        if(op == TokenType::Assign) {
+            value = lower_expression(data.rhs);
+        } else {
+            auto* current = _builder.CreateLoad(variable->getAllocatedType(), variable);
+            value = lower_arithmetic(op, _checker.get_type(data.lhs), current, lower_expression(data.rhs));
+        }
+        _builder.CreateStore(value, variable);
+        return value;
+    }
+
+    llvm::Value* LlvmLowering::lower_conditional(NodeIndex node) {
+        const auto view = _tree.get_conditional(node);
+        auto* then_start = llvm::BasicBlock::Create(_context, "conditional.then", _function);
+        auto* otherwise_start = llvm::BasicBlock::Create(_context, "conditional.else", _function);
+        auto* end = llvm::BasicBlock::Create(_context, "conditional.end");
+
+        _builder.CreateCondBr(lower_expression(view.condition), then_start, otherwise_start);
+        _builder.SetInsertPoint(then_start);
+        auto* then = lower_expression(view.then);
+        auto* then_end = _builder.GetInsertBlock();
+        _builder.CreateBr(end);
+
+        _builder.SetInsertPoint(otherwise_start);
+        auto* otherwise = lower_expression(view.otherwise);
+        auto* otherwise_end = _builder.GetInsertBlock();
+        _builder.CreateBr(end);
+
+        end->insertInto(_function);
+        _builder.SetInsertPoint(end);
+        if(then == nullptr) {
+            return nullptr;
+        }
+        auto* result = _builder.CreatePHI(then->getType(), 2);
+        result->addIncoming(then, then_end);
+        result->addIncoming(otherwise, otherwise_end);
+        return result;
+    }
+
+    llvm::Value* LlvmLowering::lower_call(NodeIndex node) {
+        const auto view = _tree.get_call(node);
+        auto* callee = get_function(_resolver.get_declaration(view.callee));
+
+        std::vector<llvm::Value*> arguments;
+        arguments.reserve(view.arguments.size());
+        for(const auto argument : view.arguments) {
+            arguments.push_back(lower_expression(argument));
+        }
+
+        auto* call = _builder.CreateCall(callee, arguments);
+        //Calls of main see its exit code, but it has no value in the source
+        if(_checker.get_type(node) == Type::Void) {
+            return nullptr;
+        }
+        return call;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../native.hpp"
+#include "../../bytecode/opcode.hpp"
+#include "../../check/type_checker.hpp"
+#include "../../parse/ast/tree.hpp"
+#include "../../resolve/resolver.hpp"
+#include "../../source/diagnostic.hpp"
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <array>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace karmac::codegen {
+    //Lowers the functions of a checked tree to LLVM IR with the semantics of the bytecode interpreter: integer
+    //arithmetic wraps, shift amounts are taken modulo the width, dividing the minimum of a signed type by -1 gives the
+    //minimum and division by zero traps, see TrapHandling. Variables are stack slots, the optimizer promotes them to
+    //registers.
+    //Functions keep their source names. A main function without result returns 0 as an int so objects link as
+    //programs.
+    //A lowering only reads the tree, so lowerings with their own contexts can run in parallel.
+    class LlvmLowering final {
+    private:
+        const ast::Tree& _tree;
+        const Resolver& _resolver;
+        const TypeChecker& _checker;
+        llvm::LLVMContext& _context;
+        TrapHandling _trap_handling;
+        llvm::IRBuilder<> _builder;
+        llvm::Module* _module = nullptr;
+
+        //Indexed by node, the stack slot of Parameters, Declarations and Fors
+        std::vector<llvm::AllocaInst*> _variables;
+
+        //State of the function being lowered
+        llvm::Function* _function = nullptr;
+        uint32_t _function_index = 0;
+        bool _returns_exit_code = false;
+        //Indexed by bytecode::TrapKind, created by the first operation that can trap
+        std::array<llvm::BasicBlock*, 3> _traps = {};
+        llvm::BasicBlock* _break_target = nullptr;
+        llvm::BasicBlock* _continue_target = nullptr;
+
+        std::vector<Diagnostic> _errors;
+
+        inline void report(ast::NodeIndex node, std::string message) {
+            _errors.push_back({ _tree.get_location(node), std::move(message) });
+        }
+
+        //nullptr for void
+        [[nodiscard]] llvm::Type* get_type(Type type) const noexcept;
+        //Declares functions of other modules on first use
+        [[nodiscard]] llvm::Function* get_function(ast::NodeIndex function);
+        [[nodiscard]] llvm::Value* get_constant(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* get_poison(ast::NodeIndex node);
+        //The stack slot of a variable, nullptr for other expressions
+        [[nodiscard]] llvm::AllocaInst* get_variable(ast::NodeIndex node) const noexcept;
+        [[nodiscard]] llvm::AllocaInst* allocate(ast::NodeIndex node);
+        //Continues in a new block after a jump, statements after it are unreachable
+        void start_block(std::string_view name);
+        //Branches to the trap block of `kind` if `condition` holds
+        void trap_if(llvm::Value* condition, bytecode::TrapKind kind);
+
+        void lower_function(ast::NodeIndex function);
+        void lower_statement(ast::NodeIndex node);
+        void lower_declaration(ast::NodeIndex node);
+        void lower_if(ast::NodeIndex node);
+        void lower_while(ast::NodeIndex node);
+        void lower_for(ast::NodeIndex node);
+        void lower_return(ast::NodeIndex node);
+
+        //nullptr for void calls
+        [[nodiscard]] llvm::Value* lower_expression(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* lower_unary(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* lower_increment(ast::NodeIndex operand, bool decrement, bool postfix);
+        [[nodiscard]] llvm::Value* lower_binary(ast::NodeIndex node);
+        //`a` op `b` for arithmetic and bitwise operators, `a` has the type `type`
+        [[nodiscard]] llvm::Value* lower_arithmetic(TokenType op, Type type, llvm::Value* a, llvm::Value* b);
+        [[nodiscard]] llvm::Value* lower_division(TokenType op, Type type, llvm::Value* a, llvm::Value* b);
+        [[nodiscard]] llvm::Value* lower_logical(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* lower_assignment(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* lower_conditional(ast::NodeIndex node);
+        [[nodiscard]] llvm::Value* lower_call(ast::NodeIndex node);
+    public:
+        LlvmLowering(const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, llvm::LLVMContext& context,
+                     TrapHandling trap_handling = TrapHandling::Instruction);
+
+        //Defines `functions` in a new module, the other functions of the tree they call are only declared. The
+        //module is only valid if there were no errors.
+        [[nodiscard]] std::unique_ptr<llvm::Module> lower(std::string_view name, std::span<const ast::NodeIndex> functions);
+
+        //Constructs that can't be lowered yet, in source order per module
+        [[nodiscard]] inline const std::vector<Diagnostic>& get_errors() const noexcept {
+            return _errors;
+        }
+    };
+}
\ No newline at end of file
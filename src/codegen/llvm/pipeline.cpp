@@ -0,0 +1,47 @@
+#include "pipeline.hpp"
+
+#include <fmt/format.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/TargetSelect.h>
+#include <mutex>
+#include <stdexcept>
+
+namespace karmac::codegen {
+    void initialize_native_target() {
+        static std::once_flag initialized;
+        std::call_once(initialized, [] {
+            llvm::InitializeNativeTarget();
+            llvm::InitializeNativeTargetAsmPrinter();
+        });
+    }
+
+    std::unique_ptr<llvm::TargetMachine> create_target_machine() {
+        initialize_native_target();
+
+        const auto triple = llvm::sys::getDefaultTargetTriple();
+        std::string error;
+        const auto* target = llvm::TargetRegistry::lookupTarget(triple, error);
+        if(target == nullptr) {
+            throw std::runtime_error(fmt::format("no LLVM target for {}: {}", triple, error));
+        }
+        //Position independent to link into the default executables of current toolchains
+        return std::unique_ptr<llvm::TargetMachine>(target->createTargetMachine(triple, "generic", "", {}, llvm::Reloc::PIC_));
+    }
+
+    void optimize(llvm::Module& module, llvm::TargetMachine& machine) {
+        llvm::LoopAnalysisManager loops;
+        llvm::FunctionAnalysisManager functions;
+        llvm::CGSCCAnalysisManager sccs;
+        llvm::ModuleAnalysisManager modules;
+
+        llvm::PassBuilder builder(&machine);
+        builder.registerModuleAnalyses(modules);
+        builder.registerCGSCCAnalyses(sccs);
+        builder.registerFunctionAnalyses(functions);
+        builder.registerLoopAnalyses(loops);
+        builder.crossRegisterProxies(loops, functions, sccs, modules);
+        builder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2).run(module, modules);
+    }
+}
\ No newline at end of file
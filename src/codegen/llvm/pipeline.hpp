@@ -0,0 +1,18 @@
+#pragma once
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+#include <memory>
+
+//Target setup and the optimization pipeline shared by the backend and the JIT
+namespace karmac::codegen {
+    //Registers the native target with LLVM, only the first call does something
+    void initialize_native_target();
+
+    //A machine for portable position independent objects of the host triple. Target machines aren't shared between
+    //threads. Throws std::runtime_error if LLVM doesn't support the host.
+    [[nodiscard]] std::unique_ptr<llvm::TargetMachine> create_target_machine();
+
+    //The default O2 pipeline
+    void optimize(llvm::Module& module, llvm::TargetMachine& machine);
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "native.hpp"
+
+#include <csetjmp>
+
+namespace karmac::codegen::native {
+    static thread_local std::jmp_buf* _trap_target = nullptr;
+    static thread_local Trap _trap;
+
+    [[noreturn]] static void handle_trap(uint16_t kind, uint32_t function) {
+        _trap = { static_cast<bytecode::TrapKind>(kind), function };
+        std::longjmp(*_trap_target, 1);
+    }
+
+    uintptr_t get_trap_handler() noexcept {
+        return reinterpret_cast<uintptr_t>(&handle_trap);
+    }
+
+    std::optional<Trap> call_main(uintptr_t address, Type type, uint64_t& result) {
+        std::jmp_buf target;
+        auto* const outer = _trap_target;
+        _trap_target = &target;
+        if(setjmp(target) != 0) {
+            _trap_target = outer;
+            return _trap;
+        }
+
+        result = 0;
+        switch(type) {
+            case Type::F32:
+                static_cast<void>(reinterpret_cast<float (*)()>(address)());
+                break;
+            case Type::F64:
+                static_cast<void>(reinterpret_cast<double (*)()>(address)());
+                break;
+            case Type::U64:
+            case Type::I64:
+            case Type::USize:
+            case Type::ISize:
+                result = reinterpret_cast<uint64_t (*)()>(address)();
+                break;
+            default:
+                //Small integers and bools are extended to an int by the callee, main without result returns 0
+                result = static_cast<uint64_t>(static_cast<int64_t>(reinterpret_cast<int32_t (*)()>(address)()));
+                break;
+        }
+
+        _trap_target = outer;
+        return std::nullopt;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../bytecode/opcode.hpp"
+#include "../check/type.hpp"
+#include <cstdint>
+#include <optional>
+
+namespace karmac::codegen {
+    //How generated code stops on division by zero and on missing returns
+    enum class TrapHandling : uint8_t {
+        //A trap instruction, a hardware exception that ends the program
+        Instruction,
+        //Calls `void karmac_trap(u16 kind, u32 function)` with the C calling convention, which must not return. The
+        //kind is a bytecode::TrapKind and the function the index of the trapping function among the functions of the
+        //tree. native::get_trap_handler is the implementation for code running in the compiler.
+        Call
+    };
+
+    //Runs generated code in the compiler's process
+    namespace native {
+        struct Trap {
+            bytecode::TrapKind kind;
+            uint32_t function;
+        };
+
+        //The address of karmac_trap, which jumps back to the innermost `call_main` of the calling thread
+        [[nodiscard]] uintptr_t get_trap_handler() noexcept;
+
+        //Calls the function without parameters at `address` that returns `type` with the C calling convention.
+        //Integer results are stored extended to 64 bits like in the registers of the interpreter, other results as
+        //0. Returns the trap if the code called the trap handler. Only generated code may run between the call and
+        //the trap, which skips its frames.
+        [[nodiscard]] std::optional<Trap> call_main(uintptr_t address, Type type, uint64_t& result);
+    }
+}
\ No newline at end of file
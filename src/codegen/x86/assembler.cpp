@@ -0,0 +1,295 @@
+#include "assembler.hpp"
+#include "../../util/assert.hpp"
+
+namespace karmac::codegen::x86 {
+    static constexpr uint32_t _PREFIX_OPERAND_SIZE = 0x66;
+    static constexpr uint32_t _PREFIX_DOUBLE = 0xF2;
+    static constexpr uint32_t _PREFIX_SINGLE = 0xF3;
+
+    [[nodiscard]] static inline uint32_t encode(Register reg) noexcept {
+        return static_cast<uint32_t>(reg);
+    }
+
+    [[nodiscard]] static inline bool is_int8(int64_t value) noexcept {
+        return value >= INT8_MIN && value <= INT8_MAX;
+    }
+
+    [[nodiscard]] static inline Operand xmm(uint8_t reg) noexcept {
+        return Operand::of(static_cast<Register>(reg));
+    }
+
+    void Assembler::int32(int32_t value) {
+        const auto bits = static_cast<uint32_t>(value);
+        byte(bits);
+        byte(bits >> 8);
+        byte(bits >> 16);
+        byte(bits >> 24);
+    }
+
+    void Assembler::rex(bool wide, uint32_t reg, const Operand& rm, bool force) {
+        const auto prefix = (wide ? 8u : 0u) | ((reg >> 3) & 1) << 2 | ((encode(rm.reg) >> 3) & 1);
+        if(prefix != 0 || force) {
+            byte(0x40 | prefix);
+        }
+    }
+
+    void Assembler::modrm(uint32_t reg, const Operand& rm) {
+        const auto base = encode(rm.reg) & 7;
+        if(!rm.memory) {
+            byte(0xC0 | (reg & 7) << 3 | base);
+            return;
+        }
+
+        //rbp and r13 as base always need a displacement, rsp and r12 a SIB byte
+        const auto mod = rm.displacement == 0 && base != 5 ? 0u : is_int8(rm.displacement) ? 1u : 2u;
+        byte(mod << 6 | (reg & 7) << 3 | base);
+        if(base == 4) {
+            byte(0x24);
+        }
+        if(mod == 1) {
+            byte(static_cast<uint32_t>(rm.displacement));
+        } else if(mod == 2) {
+            int32(rm.displacement);
+        }
+    }
+
+    void Assembler::instruction(uint32_t prefix, bool wide, uint32_t opcode, uint32_t reg, const Operand& rm, bool force_rex) {
+        if(prefix != 0) {
+            byte(prefix);
+        }
+        rex(wide, reg, rm, force_rex);
+        if(opcode > 0xFFFF) {
+            byte(opcode >> 16);
+        }
+        if(opcode > 0xFF) {
+            byte(opcode >> 8);
+        }
+        byte(opcode);
+        modrm(reg, rm);
+    }
+
+    void Assembler::clear() noexcept {
+        _code.clear();
+        _labels.clear();
+        _fixups.clear();
+    }
+
+    Label Assembler::create_label() {
+        _labels.push_back(_UNBOUND);
+        return static_cast<Label>(_labels.size() - 1);
+    }
+
+    void Assembler::bind(Label label) noexcept {
+        _labels[label] = get_offset();
+    }
+
+    void Assembler::resolve_labels() noexcept {
+        for(const auto& fixup : _fixups) {
+            karmac_assert(_labels[fixup.label] != _UNBOUND);
+            patch_relative(fixup.offset, _labels[fixup.label]);
+        }
+        _labels.clear();
+        _fixups.clear();
+    }
+
+    void Assembler::patch_relative(uint32_t offset, uint32_t target) noexcept {
+        const auto displacement = target - (offset + 4);
+        for(uint32_t i = 0; i < 4; i++) {
+            _code[offset + i] = static_cast<char>(displacement >> (i * 8));
+        }
+    }
+
+    void Assembler::mov(Register target, const Operand& source) {
+        instruction(0, true, 0x8B, encode(target), source);
+    }
+
+    void Assembler::mov(const Operand& target, Register source) {
+        instruction(0, true, 0x89, encode(source), target);
+    }
+
+    void Assembler::mov(const Operand& target, int32_t value) {
+        instruction(0, true, 0xC7, 0, target);
+        int32(value);
+    }
+
+    void Assembler::mov(Register target, uint64_t value) {
+        if(value <= UINT32_MAX) {
+            rex(false, 0, Operand::of(target));
+            byte(0xB8 + (encode(target) & 7));
+            int32(static_cast<int32_t>(value));
+        } else if(static_cast<int64_t>(value) >= INT32_MIN && static_cast<int64_t>(value) <= INT32_MAX) {
+            mov(Operand::of(target), static_cast<int32_t>(value));
+        } else {
+            rex(true, 0, Operand::of(target));
+            byte(0xB8 + (encode(target) & 7));
+            int32(static_cast<int32_t>(value));
+            int32(static_cast<int32_t>(value >> 32));
+        }
+    }
+
+    void Assembler::mov32(Register target, const Operand& source) {
+        instruction(0, false, 0x8B, encode(target), source);
+    }
+
+    //Byte registers need a REX prefix so their encodings select sil and dil instead of dh and bh
+    void Assembler::movzx8(Register target, Register source) {
+        instruction(0, false, 0x0FB6, encode(target), Operand::of(source), true);
+    }
+
+    void Assembler::movzx16(Register target, Register source) {
+        instruction(0, false, 0x0FB7, encode(target), Operand::of(source));
+    }
+
+    void Assembler::movsx8(Register target, Register source) {
+        instruction(0, true, 0x0FBE, encode(target), Operand::of(source));
+    }
+
+    void Assembler::movsx16(Register target, Register source) {
+        instruction(0, true, 0x0FBF, encode(target), Operand::of(source));
+    }
+
+    void Assembler::movsx32(Register target, Register source) {
+        instruction(0, true, 0x63, encode(target), Operand::of(source));
+    }
+
+    void Assembler::lea(Register target, const Operand& source) {
+        instruction(0, true, 0x8D, encode(target), source);
+    }
+
+    void Assembler::alu(Alu op, Register target, const Operand& source) {
+        instruction(0, true, static_cast<uint32_t>(op) << 3 | 3, encode(target), source);
+    }
+
+    void Assembler::alu(Alu op, const Operand& target, int32_t value) {
+        if(is_int8(value)) {
+            instruction(0, true, 0x83, static_cast<uint32_t>(op), target);
+            byte(static_cast<uint32_t>(value));
+        } else {
+            instruction(0, true, 0x81, static_cast<uint32_t>(op), target);
+            int32(value);
+        }
+    }
+
+    void Assembler::alu32(Alu op, Register target, int32_t value) {
+        if(is_int8(value)) {
+            instruction(0, false, 0x83, static_cast<uint32_t>(op), Operand::of(target));
+            byte(static_cast<uint32_t>(value));
+        } else {
+            instruction(0, false, 0x81, static_cast<uint32_t>(op), Operand::of(target));
+            int32(value);
+        }
+    }
+
+    void Assembler::alu8(Alu op, Register target, Register source) {
+        instruction(0, false, static_cast<uint32_t>(op) << 3, encode(source), Operand::of(target), true);
+    }
+
+    void Assembler::imul(Register target, const Operand& source) {
+        instruction(0, true, 0x0FAF, encode(target), source);
+    }
+
+    void Assembler::neg(Register target) {
+        instruction(0, true, 0xF7, 3, Operand::of(target));
+    }
+
+    void Assembler::div(const Operand& divisor) {
+        instruction(0, true, 0xF7, 6, divisor);
+    }
+
+    void Assembler::idiv(const Operand& divisor) {
+        instruction(0, true, 0xF7, 7, divisor);
+    }
+
+    void Assembler::cqo() {
+        byte(0x48);
+        byte(0x99);
+    }
+
+    void Assembler::shift(Shift op, Register target) {
+        instruction(0, true, 0xD3, static_cast<uint32_t>(op), Operand::of(target));
+    }
+
+    void Assembler::btc(Register target, uint8_t bit) {
+        instruction(0, true, 0x0FBA, 7, Operand::of(target));
+        byte(bit);
+    }
+
+    void Assembler::test(Register a, Register b) {
+        instruction(0, true, 0x85, encode(b), Operand::of(a));
+    }
+
+    void Assembler::setcc(Condition condition, Register target) {
+        instruction(0, false, 0x0F90 + static_cast<uint32_t>(condition), 0, Operand::of(target), true);
+    }
+
+    void Assembler::push(Register reg) {
+        rex(false, 0, Operand::of(reg));
+        byte(0x50 + (encode(reg) & 7));
+    }
+
+    void Assembler::pop(Register reg) {
+        rex(false, 0, Operand::of(reg));
+        byte(0x58 + (encode(reg) & 7));
+    }
+
+    void Assembler::jump(Label label) {
+        byte(0xE9);
+        _fixups.push_back({ get_offset(), label });
+        int32(0);
+    }
+
+    void Assembler::jump_if(Condition condition, Label label) {
+        byte(0x0F);
+        byte(0x80 + static_cast<uint32_t>(condition));
+        _fixups.push_back({ get_offset(), label });
+        int32(0);
+    }
+
+    uint32_t Assembler::call() {
+        byte(0xE8);
+        const auto offset = get_offset();
+        int32(0);
+        return offset;
+    }
+
+    void Assembler::call(Register target) {
+        instruction(0, false, 0xFF, 2, Operand::of(target));
+    }
+
+    void Assembler::ret() {
+        byte(0xC3);
+    }
+
+    void Assembler::ud2() {
+        byte(0x0F);
+        byte(0x0B);
+    }
+
+    void Assembler::int3() {
+        byte(0xCC);
+    }
+
+    void Assembler::movq(uint8_t target, const Operand& source) {
+        instruction(_PREFIX_OPERAND_SIZE, true, 0x0F6E, target, source);
+    }
+
+    void Assembler::movq(const Operand& target, uint8_t source) {
+        instruction(_PREFIX_OPERAND_SIZE, true, 0x0F7E, source, target);
+    }
+
+    void Assembler::movd(uint8_t target, const Operand& source) {
+        instruction(_PREFIX_OPERAND_SIZE, false, 0x0F6E, target, source);
+    }
+
+    void Assembler::movd(Register target, uint8_t source) {
+        instruction(_PREFIX_OPERAND_SIZE, false, 0x0F7E, source, Operand::of(target));
+    }
+
+    void Assembler::sse(SseOperation op, bool double_precision, uint8_t target, uint8_t source) {
+        instruction(double_precision ? _PREFIX_DOUBLE : _PREFIX_SINGLE, false, 0x0F00 | static_cast<uint32_t>(op), target, xmm(source));
+    }
+
+    void Assembler::ucomi(bool double_precision, uint8_t a, uint8_t b) {
+        instruction(double_precision ? _PREFIX_OPERAND_SIZE : 0, false, 0x0F2E, a, xmm(b));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace karmac::codegen::x86 {
+    //General purpose registers in encoding order
+    enum class Register : uint8_t {
+        Rax,
+        Rcx,
+        Rdx,
+        Rbx,
+        Rsp,
+        Rbp,
+        Rsi,
+        Rdi,
+        R8,
+        R9,
+        R10,
+        R11,
+        R12,
+        R13,
+        R14,
+        R15
+    };
+
+    //The condition codes of jcc and setcc
+    enum class Condition : uint8_t {
+        Overflow,
+        NoOverflow,
+        Below,
+        AboveOrEqual,
+        Equal,
+        NotEqual,
+        BelowOrEqual,
+        Above,
+        Sign,
+        NoSign,
+        Parity,
+        NoParity,
+        Less,
+        GreaterOrEqual,
+        LessOrEqual,
+        Greater
+    };
+
+    //The operations of the ALU instructions in the order of their opcode extension
+    enum class Alu : uint8_t {
+        Add,
+        Or,
+        Adc,
+        Sbb,
+        And,
+        Sub,
+        Xor,
+        Cmp
+    };
+
+    enum class Shift : uint8_t {
+        Left = 4,
+        RightLogical = 5,
+        RightArithmetic = 7
+    };
+
+    enum class SseOperation : uint8_t {
+        Add = 0x58,
+        Multiply = 0x59,
+        Subtract = 0x5C,
+        Divide = 0x5E
+    };
+
+    //A register or the memory at a base register plus a displacement
+    struct Operand {
+        Register reg = Register::Rax;
+        bool memory = false;
+        int32_t displacement = 0;
+
+        [[nodiscard]] static constexpr Operand of(Register reg) noexcept {
+            return { reg, false, 0 };
+        }
+
+        [[nodiscard]] static constexpr Operand at(Register base, int32_t displacement) noexcept {
+            return { base, true, displacement };
+        }
+
+        [[nodiscard]] constexpr bool operator ==(const Operand& other) const noexcept = default;
+    };
+
+    //Index of a position in the code that jumps can target before it is bound
+    using Label = uint32_t;
+
+    //Encodes x86-64 instructions into a growing buffer. Operations are 64 bits wide unless their name says otherwise,
+    //jumps always take 32-bit displacements.
+    class Assembler final {
+    private:
+        static constexpr uint32_t _UNBOUND = std::numeric_limits<uint32_t>::max();
+
+        struct Fixup {
+            //Offset of the displacement, which is relative to the end of the instruction at offset + 4
+            uint32_t offset;
+            Label label;
+        };
+
+        std::string _code;
+        std::vector<uint32_t> _labels;
+        std::vector<Fixup> _fixups;
+
+        inline void byte(uint32_t value) {
+            _code.push_back(static_cast<char>(value));
+        }
+
+        void int32(int32_t value);
+        //REX prefix for a register in the reg field and the register or base of `rm`, omitted if it has no bits set
+        void rex(bool wide, uint32_t reg, const Operand& rm, bool force = false);
+        //ModRM byte, SIB and displacement
+        void modrm(uint32_t reg, const Operand& rm);
+        //[prefix] [REX] opcode bytes ModRM for an instruction with a register or opcode extension in the reg field
+        void instruction(uint32_t prefix, bool wide, uint32_t opcode, uint32_t reg, const Operand& rm, bool force_rex = false);
+    public:
+        [[nodiscard]] inline const std::string& get_code() const noexcept {
+            return _code;
+        }
+
+        [[nodiscard]] inline uint32_t get_offset() const noexcept {
+            return static_cast<uint32_t>(_code.size());
+        }
+
+        //Resets the code and the labels, keeps their capacity
+        void clear() noexcept;
+
+        [[nodiscard]] Label create_label();
+        void bind(Label label) noexcept;
+        //Patches the jumps to all labels and forgets them, they must be bound
+        void resolve_labels() noexcept;
+        //Sets the 32-bit displacement at `offset` to reach `target`, both offsets in the code
+        void patch_relative(uint32_t offset, uint32_t target) noexcept;
+
+        void mov(Register target, const Operand& source);
+        void mov(const Operand& target, Register source);
+        //Sign-extends `value`
+        void mov(const Operand& target, int32_t value);
+        //The shortest encoding of a 64-bit constant
+        void mov(Register target, uint64_t value);
+        //32-bit move, which zero-extends into the 64-bit register
+        void mov32(Register target, const Operand& source);
+        void movzx8(Register target, Register source);
+        void movzx16(Register target, Register source);
+        void movsx8(Register target, Register source);
+        void movsx16(Register target, Register source);
+        void movsx32(Register target, Register source);
+        void lea(Register target, const Operand& source);
+
+        void alu(Alu op, Register target, const Operand& source);
+        void alu(Alu op, const Operand& target, int32_t value);
+        //32-bit operation, which zero-extends into the 64-bit register
+        void alu32(Alu op, Register target, int32_t value);
+        //8-bit operation on the low bytes
+        void alu8(Alu op, Register target, Register source);
+        void imul(Register target, const Operand& source);
+        void neg(Register target);
+        void div(const Operand& divisor);
+        void idiv(const Operand& divisor);
+        //Sign-extends rax into rdx
+        void cqo();
+        //Shifts by cl
+        void shift(Shift op, Register target);
+        //Complements one bit
+        void btc(Register target, uint8_t bit);
+        void test(Register a, Register b);
+        //Sets the low byte of `target` to 0 or 1
+        void setcc(Condition condition, Register target);
+
+        void push(Register reg);
+        void pop(Register reg);
+        void jump(Label label);
+        void jump_if(Condition condition, Label label);
+        //Returns the offset of the displacement to patch
+        [[nodiscard]] uint32_t call();
+        void call(Register target);
+        void ret();
+        void ud2();
+        void int3();
+
+        //movq, the low 64 bits
+        void movq(uint8_t target, const Operand& source);
+        void movq(const Operand& target, uint8_t source);
+        //movd, the low 32 bits, which zero-extend into the target
+        void movd(uint8_t target, const Operand& source);
+        void movd(Register target, uint8_t source);
+        void sse(SseOperation op, bool double_precision, uint8_t target, uint8_t source);
+        //Unordered compare, sets ZF, PF and CF
+        void ucomi(bool double_precision, uint8_t a, uint8_t b);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,629 @@
+#include "backend.hpp"
+
+#include <algorithm>
+
+namespace karmac::codegen::x86 {
+    using bytecode::Instruction;
+    using bytecode::Opcode;
+    using bytecode::TrapKind;
+    using bytecode::ValueType;
+
+    static constexpr std::array _ARGUMENT_REGISTERS = {
+        Register::Rdi, Register::Rsi, Register::Rdx, Register::Rcx, Register::R8, Register::R9
+    };
+    static constexpr uint8_t _SSE_ARGUMENT_REGISTERS = 8;
+    static constexpr std::array _CALLEE_SAVED_REGISTERS = {
+        Register::Rbx, Register::R12, Register::R13, Register::R14, Register::R15
+    };
+    //The first opcodes of the typed families in opcode order
+    static constexpr std::array _FAMILIES = {
+        Opcode::AddU8, Opcode::SubU8, Opcode::MulU8, Opcode::DivU8, Opcode::ModU8, Opcode::ShlU8, Opcode::ShrU8, Opcode::AddImmU8,
+        Opcode::NegU8
+    };
+
+    [[nodiscard]] static constexpr bool is_float(ValueType type) noexcept {
+        return type == ValueType::F32 || type == ValueType::F64;
+    }
+
+    [[nodiscard]] static constexpr bool is_signed(ValueType type) noexcept {
+        return type == ValueType::I8 || type == ValueType::I16 || type == ValueType::I32 || type == ValueType::I64;
+    }
+
+    [[nodiscard]] static constexpr uint32_t get_bits(ValueType type) noexcept {
+        return 8u << (static_cast<uint32_t>(type) / 2);
+    }
+
+    void X86Backend::classify_parameters() {
+        const auto nodes = _tree->get_children(ast::NO_NODE);
+        _parameters.clear();
+        _parameter_starts.assign(1, 0);
+        _stack_parameter_counts.clear();
+
+        for(const auto node : nodes) {
+            uint8_t registers = 0;
+            uint8_t sse_registers = 0;
+            uint8_t stack_slots = 0;
+            for(const auto parameter : _tree->get_function(node).parameters) {
+                const auto type = _checker->get_type(parameter);
+                if(type::is_float(type) && sse_registers < _SSE_ARGUMENT_REGISTERS) {
+                    _parameters.push_back({ PassedIn::SseRegister, sse_registers++, type });
+                } else if(!type::is_float(type) && registers < _ARGUMENT_REGISTERS.size()) {
+                    _parameters.push_back({ PassedIn::Register, registers++, type });
+                } else {
+                    _parameters.push_back({ PassedIn::Stack, stack_slots++, type });
+                }
+            }
+            _parameter_starts.push_back(static_cast<uint32_t>(_parameters.size()));
+            _stack_parameter_counts.push_back(stack_slots);
+        }
+    }
+
+    Operand X86Backend::get_operand(uint16_t reg) const noexcept {
+        const auto& location = _allocator.get_locations()[reg];
+        if(!location.spilled) {
+            return Operand::of(location.reg);
+        }
+        const auto saved = static_cast<int32_t>(_saved_registers.size());
+        return Operand::at(Register::Rbp, -8 * (saved + static_cast<int32_t>(location.slot) + 1));
+    }
+
+    Register X86Backend::get_target(uint16_t reg) const noexcept {
+        const auto operand = get_operand(reg);
+        return operand.memory ? Register::Rax : operand.reg;
+    }
+
+    Register X86Backend::get_target(uint16_t reg, uint16_t avoid) const noexcept {
+        return get_operand(reg) == get_operand(avoid) ? Register::Rax : get_target(reg);
+    }
+
+    Label X86Backend::get_trap(TrapKind kind) {
+        auto& trap = _traps[static_cast<size_t>(kind)];
+        if(!trap) {
+            trap = _assembler.create_label();
+        }
+        return *trap;
+    }
+
+    void X86Backend::load(Register target, uint16_t reg) {
+        const auto operand = get_operand(reg);
+        if(operand != Operand::of(target)) {
+            _assembler.mov(target, operand);
+        }
+    }
+
+    void X86Backend::store(uint16_t reg, Register source) {
+        const auto operand = get_operand(reg);
+        if(operand != Operand::of(source)) {
+            _assembler.mov(operand, source);
+        }
+    }
+
+    void X86Backend::load_float(uint8_t target, uint16_t reg, bool double_precision) {
+        if(double_precision) {
+            _assembler.movq(target, get_operand(reg));
+        } else {
+            _assembler.movd(target, get_operand(reg));
+        }
+    }
+
+    void X86Backend::extend(Register reg, ValueType type) {
+        switch(type) {
+            case ValueType::U8:
+                _assembler.movzx8(reg, reg);
+                break;
+            case ValueType::I8:
+                _assembler.movsx8(reg, reg);
+                break;
+            case ValueType::U16:
+                _assembler.movzx16(reg, reg);
+                break;
+            case ValueType::I16:
+                _assembler.movsx16(reg, reg);
+                break;
+            case ValueType::U32:
+                _assembler.mov32(reg, Operand::of(reg));
+                break;
+            case ValueType::I32:
+                _assembler.movsx32(reg, reg);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void X86Backend::compare(uint16_t a, uint16_t b) {
+        auto left = get_operand(a);
+        if(left.memory) {
+            _assembler.mov(Register::Rax, left);
+            left = Operand::of(Register::Rax);
+        }
+        _assembler.alu(Alu::Cmp, left.reg, get_operand(b));
+    }
+
+    void X86Backend::compile(const bytecode::Program& program, const ast::Tree& tree, const TypeChecker& checker, TrapHandling trap_handling) {
+        _program = &program;
+        _tree = &tree;
+        _checker = &checker;
+        _trap_handling = trap_handling;
+        _assembler.clear();
+        _functions.clear();
+        _calls.clear();
+
+        classify_parameters();
+        for(uint32_t i = 0; i < program.functions.size(); i++) {
+            compile_function(i);
+        }
+        for(const auto& call : _calls) {
+            _assembler.patch_relative(call.offset, _functions[call.function].offset);
+        }
+    }
+
+    void X86Backend::compile_function(uint32_t index) {
+        const auto& function = _program->functions[index];
+        _function_index = index;
+        _allocator.allocate(*_program, function);
+
+        //Functions start at 16 bytes like the ones of C compilers, the padding is never executed
+        while(_assembler.get_offset() % 16 != 0) {
+            _assembler.int3();
+        }
+        const auto start = _assembler.get_offset();
+        compile_prologue(index);
+
+        _traps = {};
+        _labels.clear();
+        for(uint32_t i = 0; i <= function.code_size; i++) {
+            _labels.push_back(_assembler.create_label());
+        }
+        const auto* const code = _program->code.data() + function.code_start;
+        for(uint32_t i = 0; i < function.code_size; i++) {
+            _assembler.bind(_labels[i]);
+            compile_instruction(code[i]);
+        }
+        _assembler.bind(_labels[function.code_size]);
+        compile_traps();
+        _assembler.resolve_labels();
+
+        _functions.push_back({ function.name, start, _assembler.get_offset() - start });
+    }
+
+    void X86Backend::compile_prologue(uint32_t index) {
+        const auto& function = _program->functions[index];
+        _saved_registers.clear();
+        for(const auto reg : _CALLEE_SAVED_REGISTERS) {
+            if(_allocator.is_used(reg)) {
+                _saved_registers.push_back(reg);
+            }
+        }
+
+        //Stack arguments of calls are stored at the bottom of the frame
+        uint32_t stack_arguments = 0;
+        const auto* const code = _program->code.data() + function.code_start;
+        for(uint32_t i = 0; i < function.code_size; i++) {
+            if(code[i].op == Opcode::Call) {
+                stack_arguments = std::max(stack_arguments, _stack_parameter_counts[code[i].b]);
+            }
+        }
+        //The stack is aligned to 16 bytes at calls, after the return address and rbp
+        const auto saved = static_cast<int32_t>(_saved_registers.size());
+        _frame_size = 8 * static_cast<int32_t>(_allocator.get_slot_count() + stack_arguments);
+        if((saved * 8 + _frame_size) % 16 != 0) {
+            _frame_size += 8;
+        }
+
+        _assembler.push(Register::Rbp);
+        _assembler.mov(Register::Rbp, Operand::of(Register::Rsp));
+        for(const auto reg : _saved_registers) {
+            _assembler.push(reg);
+        }
+        if(_frame_size != 0) {
+            _assembler.alu(Alu::Sub, Operand::of(Register::Rsp), _frame_size);
+        }
+
+        //Parameters never live in argument registers, so they can be moved in any order
+        const auto parameters = get_parameters(index);
+        for(uint16_t i = 0; i < parameters.size(); i++) {
+            const auto& parameter = parameters[i];
+            switch(parameter.passed_in) {
+                case PassedIn::Register:
+                    store(i, _ARGUMENT_REGISTERS[parameter.index]);
+                    break;
+                case PassedIn::SseRegister:
+                    if(parameter.type == Type::F64) {
+                        _assembler.movq(get_operand(i), parameter.index);
+                    } else {
+                        _assembler.movd(Register::Rax, parameter.index);
+                        store(i, Register::Rax);
+                    }
+                    break;
+                case PassedIn::Stack:
+                    _assembler.mov(Register::Rax, Operand::at(Register::Rbp, 16 + 8 * parameter.index));
+                    store(i, Register::Rax);
+                    break;
+            }
+        }
+
+        const auto node = _tree->get_children(ast::NO_NODE)[index];
+        _returns_exit_code = _checker->get_type(node) == Type::Void && function.name == "main";
+    }
+
+    void X86Backend::compile_epilogue() {
+        if(!_saved_registers.empty()) {
+            if(_frame_size != 0) {
+                _assembler.lea(Register::Rsp, Operand::at(Register::Rbp, -8 * static_cast<int32_t>(_saved_registers.size())));
+            }
+            for(auto reg = _saved_registers.rbegin(); reg != _saved_registers.rend(); ++reg) {
+                _assembler.pop(*reg);
+            }
+        } else if(_frame_size != 0) {
+            _assembler.mov(Register::Rsp, Operand::of(Register::Rbp));
+        }
+        _assembler.pop(Register::Rbp);
+        _assembler.ret();
+    }
+
+    void X86Backend::compile_instruction(const Instruction& instruction) {
+        const auto a = instruction.a;
+        const auto b = instruction.b;
+        const auto c = instruction.c;
+        switch(instruction.op) {
+            case Opcode::Move: {
+                const auto source = get_operand(b);
+                if(source.memory) {
+                    load(Register::Rax, b);
+                    store(a, Register::Rax);
+                } else {
+                    store(a, source.reg);
+                }
+                break;
+            }
+            case Opcode::LoadImm:
+                _assembler.mov(get_operand(a), static_cast<int32_t>(static_cast<int16_t>(b)));
+                break;
+            case Opcode::LoadConst: {
+                const auto value = _program->constants[b | static_cast<uint32_t>(c) << 16];
+                const auto target = get_operand(a);
+                if(!target.memory) {
+                    _assembler.mov(target.reg, value);
+                } else if(static_cast<int64_t>(value) >= INT32_MIN && static_cast<int64_t>(value) <= INT32_MAX) {
+                    _assembler.mov(target, static_cast<int32_t>(value));
+                } else {
+                    _assembler.mov(Register::Rax, value);
+                    store(a, Register::Rax);
+                }
+                break;
+            }
+
+            case Opcode::Jump:
+                _assembler.jump(_labels[a]);
+                break;
+            case Opcode::JumpIfTrue:
+                _assembler.alu(Alu::Cmp, get_operand(a), 0);
+                _assembler.jump_if(Condition::NotEqual, _labels[b]);
+                break;
+            case Opcode::JumpIfFalse:
+                _assembler.alu(Alu::Cmp, get_operand(a), 0);
+                _assembler.jump_if(Condition::Equal, _labels[b]);
+                break;
+
+            case Opcode::BranchEq:
+                compare(a, b);
+                _assembler.jump_if(Condition::Equal, _labels[c]);
+                break;
+            case Opcode::BranchNe:
+                compare(a, b);
+                _assembler.jump_if(Condition::NotEqual, _labels[c]);
+                break;
+            case Opcode::BranchLtS:
+                compare(a, b);
+                _assembler.jump_if(Condition::Less, _labels[c]);
+                break;
+            case Opcode::BranchLtU:
+                compare(a, b);
+                _assembler.jump_if(Condition::Below, _labels[c]);
+                break;
+            case Opcode::BranchLeS:
+                compare(a, b);
+                _assembler.jump_if(Condition::LessOrEqual, _labels[c]);
+                break;
+            case Opcode::BranchLeU:
+                compare(a, b);
+                _assembler.jump_if(Condition::BelowOrEqual, _labels[c]);
+                break;
+            case Opcode::ForStepS:
+            case Opcode::ForStepU:
+                _assembler.alu(Alu::Add, get_operand(a), 1);
+                compare(a, b);
+                _assembler.jump_if(instruction.op == Opcode::ForStepS ? Condition::Less : Condition::Below, _labels[c]);
+                break;
+
+            //Bitwise operations and equality keep the extension of integers
+            case Opcode::And:
+            case Opcode::Or:
+            case Opcode::Xor: {
+                const auto target = get_target(a, c);
+                load(target, b);
+                _assembler.alu(instruction.op == Opcode::And ? Alu::And : instruction.op == Opcode::Or ? Alu::Or : Alu::Xor, target, get_operand(c));
+                store(a, target);
+                break;
+            }
+            case Opcode::Not: {
+                const auto target = get_target(a);
+                load(target, b);
+                _assembler.alu(Alu::Xor, Operand::of(target), 1);
+                store(a, target);
+                break;
+            }
+
+            case Opcode::Eq:
+            case Opcode::Ne:
+            case Opcode::LtS:
+            case Opcode::LtU:
+            case Opcode::LeS:
+            case Opcode::LeU: {
+                static constexpr std::array _CONDITIONS = {
+                    Condition::Equal, Condition::NotEqual, Condition::Less, Condition::Below, Condition::LessOrEqual, Condition::BelowOrEqual
+                };
+                compare(b, c);
+                const auto target = get_target(a);
+                _assembler.setcc(_CONDITIONS[static_cast<size_t>(instruction.op) - static_cast<size_t>(Opcode::Eq)], target);
+                _assembler.movzx8(target, target);
+                store(a, target);
+                break;
+            }
+            case Opcode::EqF32:
+            case Opcode::NeF32:
+            case Opcode::LtF32:
+            case Opcode::LeF32:
+                compile_float_compare(instruction, false);
+                break;
+            case Opcode::EqF64:
+            case Opcode::NeF64:
+            case Opcode::LtF64:
+            case Opcode::LeF64:
+                compile_float_compare(instruction, true);
+                break;
+
+            case Opcode::Call:
+                compile_call(instruction);
+                break;
+            case Opcode::Return: {
+                const auto type = _checker->get_type(_tree->get_children(ast::NO_NODE)[_function_index]);
+                if(type == Type::F64) {
+                    load_float(0, a, true);
+                } else if(type == Type::F32) {
+                    load_float(0, a, false);
+                } else {
+                    load(Register::Rax, a);
+                }
+                compile_epilogue();
+                break;
+            }
+            case Opcode::ReturnVoid:
+                if(_returns_exit_code) {
+                    _assembler.mov(Register::Rax, uint64_t(0));
+                }
+                compile_epilogue();
+                break;
+            case Opcode::Trap:
+                _assembler.jump(get_trap(static_cast<TrapKind>(a)));
+                break;
+
+            default: {
+                //The typed families are consecutive and end with Neg
+                const auto family = *std::prev(std::upper_bound(_FAMILIES.begin(), _FAMILIES.end(), instruction.op));
+                compile_typed(instruction, family, static_cast<ValueType>(static_cast<uint16_t>(instruction.op) - static_cast<uint16_t>(family)));
+                break;
+            }
+        }
+    }
+
+    void X86Backend::compile_typed(const Instruction& instruction, Opcode family, ValueType type) {
+        const auto a = instruction.a;
+        const auto b = instruction.b;
+        const auto c = instruction.c;
+
+        if(is_float(type)) {
+            const auto double_precision = type == ValueType::F64;
+            if(family == Opcode::NegU8) {
+                //Flips the sign bit
+                const auto target = get_target(a);
+                load(target, b);
+                _assembler.btc(target, double_precision ? 63 : 31);
+                store(a, target);
+                return;
+            }
+
+            static constexpr std::array _OPERATIONS = { SseOperation::Add, SseOperation::Subtract, SseOperation::Multiply, SseOperation::Divide };
+            load_float(0, b, double_precision);
+            load_float(1, c, double_precision);
+            _assembler.sse(_OPERATIONS[std::find(_FAMILIES.begin(), _FAMILIES.end(), family) - _FAMILIES.begin()], double_precision, 0, 1);
+            if(double_precision) {
+                _assembler.movq(get_operand(a), 0);
+            } else {
+                const auto target = get_target(a);
+                _assembler.movd(target, 0);
+                store(a, target);
+            }
+            return;
+        }
+
+        switch(family) {
+            case Opcode::AddU8:
+            case Opcode::SubU8:
+            case Opcode::MulU8: {
+                const auto target = get_target(a, c);
+                load(target, b);
+                if(family == Opcode::MulU8) {
+                    _assembler.imul(target, get_operand(c));
+                } else {
+                    _assembler.alu(family == Opcode::AddU8 ? Alu::Add : Alu::Sub, target, get_operand(c));
+                }
+                extend(target, type);
+                store(a, target);
+                break;
+            }
+            case Opcode::DivU8:
+                compile_division(instruction, false, type);
+                break;
+            case Opcode::ModU8:
+                compile_division(instruction, true, type);
+                break;
+            case Opcode::ShlU8:
+            case Opcode::ShrU8: {
+                //x86 takes shift amounts modulo 64, narrower types are masked to their width
+                load(Register::Rcx, c);
+                if(get_bits(type) < 64) {
+                    _assembler.alu32(Alu::And, Register::Rcx, static_cast<int32_t>(get_bits(type) - 1));
+                }
+                const auto target = get_target(a);
+                load(target, b);
+                if(family == Opcode::ShlU8) {
+                    _assembler.shift(Shift::Left, target);
+                    extend(target, type);
+                } else {
+                    //Signed values are extended, so they stay in range when their sign is shifted in
+                    _assembler.shift(is_signed(type) ? Shift::RightArithmetic : Shift::RightLogical, target);
+                }
+                store(a, target);
+                break;
+            }
+            case Opcode::AddImmU8: {
+                const auto target = get_target(a);
+                load(target, b);
+                _assembler.alu(Alu::Add, Operand::of(target), static_cast<int32_t>(static_cast<int16_t>(c)));
+                extend(target, type);
+                store(a, target);
+                break;
+            }
+            default: {
+                const auto target = get_target(a);
+                load(target, b);
+                _assembler.neg(target);
+                extend(target, type);
+                store(a, target);
+                break;
+            }
+        }
+    }
+
+    void X86Backend::compile_division(const Instruction& instruction, bool modulo, ValueType type) {
+        load(Register::R11, instruction.c);
+        _assembler.test(Register::R11, Register::R11);
+        _assembler.jump_if(Condition::Equal, get_trap(TrapKind::DivisionByZero));
+        load(Register::Rax, instruction.b);
+
+        if(is_signed(type)) {
+            //idiv faults on the minimum divided by -1, which gives the minimum and a remainder of 0
+            const auto divide = _assembler.create_label();
+            const auto done = _assembler.create_label();
+            _assembler.alu(Alu::Cmp, Operand::of(Register::R11), -1);
+            _assembler.jump_if(Condition::NotEqual, divide);
+            if(modulo) {
+                _assembler.mov(Register::Rdx, uint64_t(0));
+            } else {
+                _assembler.neg(Register::Rax);
+                extend(Register::Rax, type);
+            }
+            _assembler.jump(done);
+
+            _assembler.bind(divide);
+            _assembler.cqo();
+            _assembler.idiv(Operand::of(Register::R11));
+            _assembler.bind(done);
+        } else {
+            _assembler.mov(Register::Rdx, uint64_t(0));
+            _assembler.div(Operand::of(Register::R11));
+        }
+
+        //Quotients and remainders of extended values are in range of their type
+        store(instruction.a, modulo ? Register::Rdx : Register::Rax);
+    }
+
+    void X86Backend::compile_float_compare(const Instruction& instruction, bool double_precision) {
+        load_float(0, instruction.b, double_precision);
+        load_float(1, instruction.c, double_precision);
+
+        //Unordered sets ZF, PF and CF, so only != holds for NaNs
+        const auto family = double_precision ? Opcode::EqF64 : Opcode::EqF32;
+        switch(static_cast<uint16_t>(instruction.op) - static_cast<uint16_t>(family)) {
+            case 0:
+                _assembler.ucomi(double_precision, 0, 1);
+                _assembler.setcc(Condition::Equal, Register::Rax);
+                _assembler.setcc(Condition::NoParity, Register::Rcx);
+                _assembler.alu8(Alu::And, Register::Rax, Register::Rcx);
+                break;
+            case 1:
+                _assembler.ucomi(double_precision, 0, 1);
+                _assembler.setcc(Condition::NotEqual, Register::Rax);
+                _assembler.setcc(Condition::Parity, Register::Rcx);
+                _assembler.alu8(Alu::Or, Register::Rax, Register::Rcx);
+                break;
+            case 2:
+                _assembler.ucomi(double_precision, 1, 0);
+                _assembler.setcc(Condition::Above, Register::Rax);
+                break;
+            default:
+                _assembler.ucomi(double_precision, 1, 0);
+                _assembler.setcc(Condition::AboveOrEqual, Register::Rax);
+                break;
+        }
+        _assembler.movzx8(Register::Rax, Register::Rax);
+        store(instruction.a, Register::Rax);
+    }
+
+    void X86Backend::compile_call(const Instruction& instruction) {
+        //Arguments never live in argument registers, so they can be moved in any order
+        const auto parameters = get_parameters(instruction.b);
+        for(uint16_t i = 0; i < parameters.size(); i++) {
+            const auto argument = static_cast<uint16_t>(instruction.c + i);
+            const auto& parameter = parameters[i];
+            switch(parameter.passed_in) {
+                case PassedIn::Register:
+                    load(_ARGUMENT_REGISTERS[parameter.index], argument);
+                    break;
+                case PassedIn::SseRegister:
+                    _assembler.movq(parameter.index, get_operand(argument));
+                    break;
+                case PassedIn::Stack:
+                    load(Register::Rax, argument);
+                    _assembler.mov(Operand::at(Register::Rsp, 8 * parameter.index), Register::Rax);
+                    break;
+            }
+        }
+        _calls.push_back({ _assembler.call(), instruction.b });
+
+        switch(_checker->get_type(_tree->get_children(ast::NO_NODE)[instruction.b])) {
+            case Type::Void:
+                break;
+            case Type::F64:
+                _assembler.movq(get_operand(instruction.a), 0);
+                break;
+            case Type::F32: {
+                const auto target = get_target(instruction.a);
+                _assembler.movd(target, 0);
+                store(instruction.a, target);
+                break;
+            }
+            default:
+                store(instruction.a, Register::Rax);
+                break;
+        }
+    }
+
+    void X86Backend::compile_traps() {
+        for(size_t kind = 0; kind < _traps.size(); kind++) {
+            if(!_traps[kind]) {
+                continue;
+            }
+            _assembler.bind(*_traps[kind]);
+            if(_trap_handling == TrapHandling::Call) {
+                _assembler.mov(Register::Rdi, static_cast<uint64_t>(kind));
+                _assembler.mov(Register::Rsi, static_cast<uint64_t>(_function_index));
+                _assembler.mov(Register::Rax, static_cast<uint64_t>(native::get_trap_handler()));
+                _assembler.call(Register::Rax);
+            }
+            _assembler.ud2();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "assembler.hpp"
+#include "register_allocator.hpp"
+#include "../elf.hpp"
+#include "../native.hpp"
+#include "../../bytecode/program.hpp"
+#include "../../check/type_checker.hpp"
+#include "../../parse/ast/tree.hpp"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace karmac::codegen::x86 {
+    //Whether the compiler itself runs on x86-64 with the System V calling convention, so it can run the code
+#if (defined(__x86_64__) || defined(_M_X64)) && !defined(WIN32)
+    inline constexpr bool IS_HOST = true;
+#else
+    inline constexpr bool IS_HOST = false;
+#endif
+
+    //Baseline backend: translates bytecode to x86-64 machine code in one pass per function without optimizing it, for
+    //fast builds. Bytecode registers get machine registers or stack slots by linear scan, every instruction becomes a
+    //short fixed sequence that computes in the scratch registers. The code has the semantics of the interpreter.
+    //Functions follow the System V calling convention and keep their source names, a main function without result
+    //returns 0, so the code links with C. Calls between the functions are resolved, the code has no relocations.
+    class X86Backend final {
+    private:
+        struct CallFixup {
+            uint32_t offset;
+            uint32_t function;
+        };
+
+        enum class PassedIn : uint8_t {
+            Register,
+            SseRegister,
+            Stack
+        };
+
+        //Where the calling convention passes a parameter, the index counts the registers or stack slots of its kind
+        struct Parameter {
+            PassedIn passed_in;
+            uint8_t index;
+            Type type;
+        };
+
+        const bytecode::Program* _program = nullptr;
+        const ast::Tree* _tree = nullptr;
+        const TypeChecker* _checker = nullptr;
+        TrapHandling _trap_handling = TrapHandling::Instruction;
+        Assembler _assembler;
+        RegisterAllocator _allocator;
+        std::vector<elf::Symbol> _functions;
+        std::vector<CallFixup> _calls;
+        //The parameters of all functions, those of function i start at _parameter_starts[i]
+        std::vector<Parameter> _parameters;
+        std::vector<uint32_t> _parameter_starts;
+        std::vector<uint32_t> _stack_parameter_counts;
+
+        //State of the function being compiled
+        uint32_t _function_index = 0;
+        //Callee-saved registers pushed by the prologue
+        std::vector<Register> _saved_registers;
+        int32_t _frame_size = 0;
+        bool _returns_exit_code = false;
+        //Label of every instruction
+        std::vector<Label> _labels;
+        //Indexed by bytecode::TrapKind, created by the first instruction that can trap
+        std::array<std::optional<Label>, 3> _traps;
+
+        [[nodiscard]] Operand get_operand(uint16_t reg) const noexcept;
+        //The register to compute the value of `reg` in, its own one if it has one and rax otherwise
+        [[nodiscard]] Register get_target(uint16_t reg) const noexcept;
+        //Also rax if `reg` is located where `avoid` is, which is read after the target is written
+        [[nodiscard]] Register get_target(uint16_t reg, uint16_t avoid) const noexcept;
+        [[nodiscard]] Label get_trap(bytecode::TrapKind kind);
+        void load(Register target, uint16_t reg);
+        void store(uint16_t reg, Register source);
+        //Loads a float into the low bits of an SSE register
+        void load_float(uint8_t target, uint16_t reg, bool double_precision);
+        //Restores the extension of an integer of `type` computed in 64 bits
+        void extend(Register reg, bytecode::ValueType type);
+        //Compares a to b, in a register if possible
+        void compare(uint16_t a, uint16_t b);
+
+        void classify_parameters();
+        [[nodiscard]] inline std::span<const Parameter> get_parameters(uint32_t function) const noexcept {
+            return { _parameters.data() + _parameter_starts[function], _parameters.data() + _parameter_starts[function + 1] };
+        }
+
+        void compile_function(uint32_t index);
+        void compile_prologue(uint32_t index);
+        void compile_epilogue();
+        void compile_instruction(const bytecode::Instruction& instruction);
+        void compile_typed(const bytecode::Instruction& instruction, bytecode::Opcode family, bytecode::ValueType type);
+        void compile_division(const bytecode::Instruction& instruction, bool modulo, bytecode::ValueType type);
+        void compile_float_compare(const bytecode::Instruction& instruction, bool double_precision);
+        void compile_call(const bytecode::Instruction& instruction);
+        void compile_traps();
+    public:
+        //Replaces the code with the one of `program`, which was compiled from `tree`
+        void compile(const bytecode::Program& program, const ast::Tree& tree, const TypeChecker& checker, TrapHandling trap_handling);
+
+        [[nodiscard]] inline const std::string& get_code() const noexcept {
+            return _assembler.get_code();
+        }
+
+        //In the order of the program, names refer to the program
+        [[nodiscard]] inline const std::vector<elf::Symbol>& get_functions() const noexcept {
+            return _functions;
+        }
+    };
+}
\ No newline at end of file
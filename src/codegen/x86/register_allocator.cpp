@@ -0,0 +1,214 @@
+#include "register_allocator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace karmac::codegen::x86 {
+    using bytecode::Format;
+    using bytecode::Opcode;
+
+    static constexpr uint32_t _NO_POSITION = std::numeric_limits<uint32_t>::max();
+
+    //In order of preference, caller-saved registers first so callee-saved ones stay free for intervals across calls
+    static constexpr std::array _ANY_REGISTERS = {
+        Register::R10, Register::R9, Register::R8, Register::Rdi, Register::Rsi,
+        Register::Rbx, Register::R12, Register::R13, Register::R14, Register::R15
+    };
+    static constexpr std::array _NON_ARGUMENT_REGISTERS = {
+        Register::R10, Register::Rbx, Register::R12, Register::R13, Register::R14, Register::R15
+    };
+    static constexpr std::array _CALLEE_SAVED_REGISTERS = {
+        Register::Rbx, Register::R12, Register::R13, Register::R14, Register::R15
+    };
+
+    [[nodiscard]] static constexpr uint32_t get_bit(Register reg) noexcept {
+        return 1u << static_cast<uint32_t>(reg);
+    }
+
+    template<size_t N>
+    [[nodiscard]] static constexpr uint32_t get_mask(const std::array<Register, N>& registers) noexcept {
+        uint32_t mask = 0;
+        for(const auto reg : registers) {
+            mask |= get_bit(reg);
+        }
+        return mask;
+    }
+
+    void RegisterAllocator::compute_intervals(const bytecode::Program& program, const bytecode::Function& function) {
+        _intervals.assign(function.register_count, { _NO_POSITION, 0, Constraint::None });
+        _loops.clear();
+        _calls.assign(function.code_size + size_t(1), 0);
+
+        const auto use = [this](uint16_t reg, uint32_t position) {
+            auto& interval = _intervals[reg];
+            interval.start = std::min(interval.start, position);
+            interval.end = std::max(interval.end, position);
+        };
+        const auto branch = [this](uint32_t target, uint32_t position) {
+            if(target <= position) {
+                _loops.push_back({ target, position });
+            }
+        };
+
+        //Parameters are written before the first instruction
+        for(uint16_t i = 0; i < function.parameter_count; i++) {
+            use(i, 0);
+            _intervals[i].constraint = Constraint::AvoidArguments;
+        }
+
+        const auto* const code = program.code.data() + function.code_start;
+        for(uint32_t i = 0; i < function.code_size; i++) {
+            const auto& instruction = code[i];
+            const auto read = 2 * i;
+            const auto write = 2 * i + 1;
+            _calls[i + 1] = _calls[i];
+
+            switch(bytecode::opcode::get_format(instruction.op)) {
+                case Format::None:
+                case Format::Trap:
+                    break;
+                case Format::R:
+                    use(instruction.a, read);
+                    break;
+                case Format::RR:
+                case Format::RRI:
+                    use(instruction.b, read);
+                    use(instruction.a, write);
+                    break;
+                case Format::RRR:
+                    use(instruction.b, read);
+                    use(instruction.c, read);
+                    use(instruction.a, write);
+                    break;
+                case Format::RI:
+                case Format::RK:
+                    use(instruction.a, write);
+                    break;
+                case Format::T:
+                    branch(instruction.a, i);
+                    break;
+                case Format::RT:
+                    use(instruction.a, read);
+                    branch(instruction.b, i);
+                    break;
+                case Format::RRT:
+                    use(instruction.a, read);
+                    use(instruction.b, read);
+                    if(instruction.op == Opcode::ForStepS || instruction.op == Opcode::ForStepU) {
+                        use(instruction.a, write);
+                    }
+                    branch(instruction.c, i);
+                    break;
+                case Format::Call: {
+                    const auto arguments = program.functions[instruction.b].parameter_count;
+                    for(uint16_t j = 0; j < arguments; j++) {
+                        use(static_cast<uint16_t>(instruction.c + j), read);
+                        _intervals[instruction.c + j].constraint = Constraint::AvoidArguments;
+                    }
+                    use(instruction.a, write);
+                    _calls[i + 1]++;
+                    break;
+                }
+            }
+        }
+
+        //A register live into a loop is live until its last branch back, loops are nested or disjoint so one pass is
+        //enough
+        for(const auto& loop : _loops) {
+            for(auto& interval : _intervals) {
+                if(interval.start < 2 * loop.start && interval.end >= 2 * loop.start) {
+                    interval.end = std::max(interval.end, 2 * loop.end + 1);
+                }
+            }
+        }
+
+        //A call clobbers the caller-saved registers between reading its arguments and writing its result
+        for(auto& interval : _intervals) {
+            if(interval.start == _NO_POSITION || interval.end == 0) {
+                continue;
+            }
+            const auto first = (interval.start + 1) / 2;
+            const auto last = (interval.end - 1) / 2;
+            if(first <= last && _calls[last + 1] != _calls[first]) {
+                interval.constraint = Constraint::CalleeSaved;
+            }
+        }
+    }
+
+    void RegisterAllocator::allocate(const bytecode::Program& program, const bytecode::Function& function) {
+        compute_intervals(program, function);
+
+        _locations.assign(function.register_count, {});
+        _used_registers = 0;
+        _slot_count = 0;
+
+        _order.clear();
+        for(uint16_t i = 0; i < function.register_count; i++) {
+            if(_intervals[i].start != _NO_POSITION) {
+                _order.push_back(i);
+            }
+        }
+        std::stable_sort(_order.begin(), _order.end(), [this](uint16_t a, uint16_t b) {
+            return _intervals[a].start < _intervals[b].start;
+        });
+
+        //Sorted by the end of the intervals
+        _active.clear();
+        auto free = get_mask(_ANY_REGISTERS);
+        const auto activate = [this](uint16_t reg) {
+            const auto end = _intervals[reg].end;
+            const auto position = std::upper_bound(_active.begin(), _active.end(), end, [this](uint32_t value, uint16_t other) {
+                return value < _intervals[other].end;
+            });
+            _active.insert(position, reg);
+        };
+
+        for(const auto current : _order) {
+            const auto& interval = _intervals[current];
+
+            size_t expired = 0;
+            while(expired < _active.size() && _intervals[_active[expired]].end < interval.start) {
+                free |= get_bit(_locations[_active[expired]].reg);
+                expired++;
+            }
+            _active.erase(_active.begin(), _active.begin() + static_cast<ptrdiff_t>(expired));
+
+            auto candidates = get_mask(_ANY_REGISTERS);
+            std::span<const Register> preference = _ANY_REGISTERS;
+            if(interval.constraint == Constraint::AvoidArguments) {
+                candidates = get_mask(_NON_ARGUMENT_REGISTERS);
+                preference = _NON_ARGUMENT_REGISTERS;
+            } else if(interval.constraint == Constraint::CalleeSaved) {
+                candidates = get_mask(_CALLEE_SAVED_REGISTERS);
+                preference = _CALLEE_SAVED_REGISTERS;
+            }
+
+            const auto found = std::find_if(preference.begin(), preference.end(), [free](Register reg) {
+                return (free & get_bit(reg)) != 0;
+            });
+            if(found != preference.end()) {
+                _locations[current].reg = *found;
+                free &= ~get_bit(*found);
+                _used_registers |= get_bit(*found);
+                activate(current);
+                continue;
+            }
+
+            //Spills the interval that ends last, either the current one or an active one with a suitable register
+            auto victim = _active.rbegin();
+            while(victim != _active.rend() && (candidates & get_bit(_locations[*victim].reg)) == 0) {
+                ++victim;
+            }
+            if(victim != _active.rend() && _intervals[*victim].end > interval.end) {
+                const auto spilled = *victim;
+                _locations[current].reg = _locations[spilled].reg;
+                _locations[spilled] = { Register::Rax, true, _slot_count++ };
+                _active.erase(std::next(victim).base());
+                activate(current);
+            } else {
+                _locations[current] = { Register::Rax, true, _slot_count++ };
+            }
+        }
+    }
+}
\ No newline at end of file
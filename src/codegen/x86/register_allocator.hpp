@@ -0,0 +1,77 @@
+#pragma once
+
+#include "assembler.hpp"
+#include "../../bytecode/program.hpp"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace karmac::codegen::x86 {
+    //Where a bytecode register lives for the whole function
+    struct Location {
+        //Registers that are never used are located in rax, a scratch register
+        Register reg = Register::Rax;
+        //In the stack slot `slot` instead of a register
+        bool spilled = false;
+        uint32_t slot = 0;
+    };
+
+    //Linear scan register allocation for the bytecode registers of a function after Poletto and Sarkar. The live
+    //interval of a register spans from its first to its last use in code order and is extended to the end of every
+    //loop it is live into. Each interval gets one location: a register that is free for all of it or a stack slot
+    //when the interval ends after all others that compete for its registers.
+    //Intervals live across a call only get callee-saved registers. Arguments and parameters never get the registers
+    //that pass arguments, so moving them in place doesn't overwrite other arguments. rax, rcx, rdx and r11 stay free
+    //as scratch registers.
+    class RegisterAllocator final {
+    private:
+        enum class Constraint : uint8_t {
+            None,
+            //An argument of a call or a parameter
+            AvoidArguments,
+            //Lives across a call
+            CalleeSaved
+        };
+
+        struct Interval {
+            //Instruction i reads its operands at 2i and writes its result at 2i + 1
+            uint32_t start;
+            uint32_t end;
+            Constraint constraint;
+        };
+
+        struct Loop {
+            uint32_t start;
+            uint32_t end;
+        };
+
+        std::vector<Interval> _intervals;
+        std::vector<Loop> _loops;
+        //Calls before each instruction
+        std::vector<uint32_t> _calls;
+        std::vector<uint16_t> _order;
+        std::vector<uint16_t> _active;
+
+        std::vector<Location> _locations;
+        uint32_t _used_registers = 0;
+        uint32_t _slot_count = 0;
+
+        void compute_intervals(const bytecode::Program& program, const bytecode::Function& function);
+    public:
+        //Replaces the locations with the ones for `function` of `program`
+        void allocate(const bytecode::Program& program, const bytecode::Function& function);
+
+        //Indexed by bytecode register
+        [[nodiscard]] inline const std::vector<Location>& get_locations() const noexcept {
+            return _locations;
+        }
+
+        [[nodiscard]] inline bool is_used(Register reg) const noexcept {
+            return (_used_registers >> static_cast<uint32_t>(reg) & 1) != 0;
+        }
+
+        [[nodiscard]] inline uint32_t get_slot_count() const noexcept {
+            return _slot_count;
+        }
+    };
+}
\ No newline at end of file
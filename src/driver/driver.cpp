@@ -0,0 +1,671 @@
+#include "driver.hpp"
+#include "../bytecode/compiler.hpp"
+#include "../bytecode/interpreter.hpp"
+#include "../parse/ast_dump.hpp"
+#include "../parse/parser.hpp"
+#include "../resolve/resolver.hpp"
+#include "../tokenize/lex_stats.hpp"
+#include "../tokenize/tokenizer_pool.hpp"
+#include "../util/io/file.hpp"
+#include "../util/stats/alloc_stats.hpp"
+#include "../util/stats/trace.hpp"
+#include "../util/text/utf8/utf8.hpp"
+
+#include "../codegen/elf.hpp"
+#include "../codegen/native.hpp"
+#include "../codegen/x86/backend.hpp"
+#include "../util/memory/executable_memory.hpp"
+
+#ifdef KARMAC_LLVM
+#include "../codegen/llvm/backend.hpp"
+#include "../codegen/llvm/jit.hpp"
+#endif
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+namespace karmac::driver {
+    Driver::Driver(const Options& options) : _options(options) {
+        if(_options.cache_dir) {
+            _cache.emplace(*_options.cache_dir, _options.cache_max_size.value_or(FrontendCache::DEFAULT_MAX_SIZE));
+        }
+        //Several inputs are compiled on one thread each instead
+        if(_options.jobs > 1 && _options.inputs.size() == 1) {
+            _pool.emplace(_options.jobs);
+        }
+    }
+
+    void Driver::dump_tokens(const SourceFile& file, const std::vector<Token*>& tokens, std::FILE* output, CompileResult& result) const {
+        KARMAC_TRACE_ZONE("output");
+        KARMAC_ALLOC_PHASE(Output);
+
+        if(output != nullptr) {
+            token_dump::TokenDumper(output, _options.token_format, file).dump(tokens);
+        } else {
+            token_dump::TokenDumper dumper(_options.token_format, file);
+            dumper.dump(tokens);
+            result.output = dumper.get_buffer();
+        }
+    }
+
+    void Driver::dump_ast(const SourceFile& file, const ast::Tree& tree, std::FILE* output, CompileResult& result) const {
+        KARMAC_TRACE_ZONE("output");
+        KARMAC_ALLOC_PHASE(Output);
+
+        if(output != nullptr) {
+            ast_dump::AstDumper(output, file).dump(tree);
+        } else {
+            ast_dump::AstDumper dumper(file);
+            dumper.dump(tree);
+            result.output = dumper.get_buffer();
+        }
+    }
+
+    void Driver::dump_bytecode(const bytecode::Program& program, std::FILE* output, CompileResult& result) const {
+        KARMAC_TRACE_ZONE("output");
+        KARMAC_ALLOC_PHASE(Output);
+
+        auto text = bytecode::disassemble(program);
+        if(output != nullptr) {
+            std::fwrite(text.data(), 1, text.size(), output);
+        } else {
+            result.output = std::move(text);
+        }
+    }
+
+    void Driver::write_objects(const SourceFile& file, std::span<const std::string> objects, std::FILE* output, CompileResult& result) {
+        KARMAC_TRACE_ZONE("output");
+        KARMAC_ALLOC_PHASE(Output);
+
+        //Named after the input in the working directory like cc -c does
+        const auto base = _options.output ? std::filesystem::path(*_options.output) : std::filesystem::path(file.get_path()).filename().replace_extension(".o");
+        for(size_t i = 0; i < objects.size(); i++) {
+            auto path = base;
+            if(objects.size() > 1) {
+                path.replace_extension(fmt::format(".{}{}", i, base.extension().string()));
+            }
+
+            try {
+                io::write_file(path, objects[i]);
+            } catch(const std::exception&) {
+                add_diagnostic(result, output, path.string(), "failed to write the object");
+                return;
+            }
+        }
+    }
+
+    void Driver::compile_baseline(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                                  std::FILE* output, CompileResult& result) {
+        codegen::x86::X86Backend backend;
+        {
+            KARMAC_TRACE_ZONE("x86 codegen");
+            KARMAC_ALLOC_PHASE(Codegen);
+            backend.compile(program, tree, checker, codegen::TrapHandling::Instruction);
+        }
+
+        std::string object;
+        {
+            KARMAC_TRACE_ZONE("elf");
+            KARMAC_ALLOC_PHASE(Output);
+            object = codegen::elf::write_object(std::filesystem::path(file.get_path()).filename().string(), backend.get_code(), backend.get_functions());
+        }
+        write_objects(file, std::span(&object, 1), output, result);
+    }
+
+#ifdef KARMAC_LLVM
+    void Driver::compile_llvm(const SourceFile& file, const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::FILE* output,
+                              CompileResult& result) {
+        const std::filesystem::path path(file.get_path());
+        const auto objects = _options.emit == Emit::Obj;
+
+        //A single input is split for the threads of the parser, several inputs already run on one thread each
+        codegen::LlvmBackend backend;
+        {
+            KARMAC_TRACE_ZONE("codegen");
+            backend.compile(tree, resolver, checker, path.stem().string(), objects ? codegen::LlvmOutput::Object : codegen::LlvmOutput::Ir,
+                            _pool ? _pool->get_thread_count() : 1, _pool ? &*_pool : nullptr);
+        }
+        for(const auto& error : backend.get_errors()) {
+            add_diagnostic(result, output, _sources.to_string(error.location), error.message);
+        }
+        if(!result.success) {
+            return;
+        }
+
+        const auto& outputs = backend.get_outputs();
+        if(!objects) {
+            KARMAC_TRACE_ZONE("output");
+            KARMAC_ALLOC_PHASE(Output);
+            if(output != nullptr) {
+                std::fwrite(outputs[0].data(), 1, outputs[0].size(), output);
+            } else {
+                result.output = outputs[0];
+            }
+            return;
+        }
+        write_objects(file, outputs, output, result);
+    }
+#endif
+
+    ast::NodeIndex Driver::find_main(const SourceFile& file, const ast::Tree& tree, std::FILE* output, CompileResult& result) const {
+        for(const auto function : tree.get_children(ast::NO_NODE)) {
+            const auto view = tree.get_function(function);
+            if(tree.get_token(view.name).to_string() != "main") {
+                continue;
+            }
+            if(!view.parameters.empty()) {
+                add_diagnostic(result, output, _sources.to_string(tree.get_location(function)), "main can't take parameters");
+                return ast::NO_NODE;
+            }
+            return function;
+        }
+
+        add_diagnostic(result, output, file.get_path(), "no main function to run");
+        return ast::NO_NODE;
+    }
+
+    void Driver::set_exit_code(const TypeChecker& checker, ast::NodeIndex main, uint64_t value, CompileResult& result) noexcept {
+        //Signed results are sign-extended, the truncation keeps small negative results
+        const auto type = checker.get_type(main);
+        result.exit_code = type::is_integer(type) || type == Type::Bool ? static_cast<int>(value) : ExitCode::Success;
+    }
+
+    void Driver::run_main(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                          std::FILE* output, CompileResult& result) {
+        const auto function = find_main(file, tree, output, result);
+        if(function == ast::NO_NODE) {
+            return;
+        }
+
+        bytecode::Value value;
+        try {
+            KARMAC_TRACE_ZONE("run");
+            KARMAC_ALLOC_PHASE(Run);
+            bytecode::Interpreter interpreter;
+            value = interpreter.call(program, program.find_function("main"), {});
+        } catch(const bytecode::RuntimeError& e) {
+            add_diagnostic(result, output, file.get_path(), fmt::format("runtime error: {}", e.what()));
+            result.exit_code = ExitCode::RunError;
+            return;
+        }
+        set_exit_code(checker, function, value, result);
+    }
+
+    void Driver::run_baseline(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                              std::FILE* output, CompileResult& result) {
+        const auto function = find_main(file, tree, output, result);
+        if(function == ast::NO_NODE) {
+            return;
+        }
+
+        codegen::x86::X86Backend backend;
+        {
+            KARMAC_TRACE_ZONE("x86 codegen");
+            KARMAC_ALLOC_PHASE(Codegen);
+            backend.compile(program, tree, checker, codegen::TrapHandling::Call);
+        }
+
+        uint64_t value;
+        {
+            KARMAC_TRACE_ZONE("run");
+            KARMAC_ALLOC_PHASE(Run);
+            const ExecutableMemory code(backend.get_code());
+            const auto main = backend.get_functions()[program.find_function("main")];
+            const auto trap = codegen::native::call_main(code.get_address(main.offset), checker.get_type(function), value);
+            if(trap) {
+                add_diagnostic(result, output, file.get_path(), fmt::format("runtime error: {} in {}", bytecode::trap_kind::get_message(trap->kind),
+                                                                            program.functions[trap->function].name));
+                result.exit_code = ExitCode::RunError;
+                return;
+            }
+        }
+        set_exit_code(checker, function, value, result);
+    }
+
+#ifdef KARMAC_LLVM
+    void Driver::run_jit(const SourceFile& file, const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::FILE* output,
+                         CompileResult& result) {
+        const auto function = find_main(file, tree, output, result);
+        if(function == ast::NO_NODE) {
+            return;
+        }
+
+        codegen::LlvmJit jit(_cache ? &*_cache : nullptr);
+        std::optional<uint64_t> value;
+        try {
+            KARMAC_TRACE_ZONE("run");
+            KARMAC_ALLOC_PHASE(Run);
+            value = jit.run_main(tree, resolver, checker, function, std::filesystem::path(file.get_path()).stem().string());
+        } catch(const bytecode::RuntimeError& e) {
+            add_diagnostic(result, output, file.get_path(), fmt::format("runtime error: {}", e.what()));
+            result.exit_code = ExitCode::RunError;
+        }
+        result.jit_compiled_functions = jit.get_compiled_functions();
+        result.jit_cached_functions = jit.get_cached_functions();
+        if(!value) {
+            return;
+        }
+
+        for(const auto& error : jit.get_errors()) {
+            add_diagnostic(result, output, _sources.to_string(error.location), error.message);
+        }
+        if(result.success) {
+            set_exit_code(checker, function, *value, result);
+        }
+    }
+#endif
+
+    void Driver::add_diagnostic(CompileResult& result, std::FILE* output, const std::string_view& where, const std::string_view& message) {
+        result.success = false;
+
+        const auto diagnostic = fmt::format("{}: error: {}\n", where, message);
+        if(output != nullptr) {
+            std::fputs(diagnostic.c_str(), stderr);
+        }
+        result.diagnostics += diagnostic;
+    }
+
+    void Driver::compile_source(const SourceFile& file, std::FILE* output, CompileResult& result) {
+        const auto source = file.get_text();
+
+        std::optional<CachedTokenStream> cached;
+        if(_cache) {
+            KARMAC_TRACE_ZONE("cache lookup");
+            KARMAC_ALLOC_PHASE(Cache);
+            cached = _cache->find_tokens(source, file.get_start());
+        }
+
+        if(cached && _options.emit == Emit::Tokens) {
+            KARMAC_TRACE_ZONE("output");
+            KARMAC_ALLOC_PHASE(Output);
+
+            auto dumper = output != nullptr ? token_dump::TokenDumper(output, _options.token_format, file) : token_dump::TokenDumper(_options.token_format, file);
+            for(const auto& record : cached->tokens) {
+                dumper.dump(record);
+            }
+            if(output == nullptr) {
+                result.output = dumper.get_buffer();
+            }
+            return;
+        }
+
+        auto tokenizer = TokenizerPool::acquire();
+        if(cached) {
+            KARMAC_TRACE_ZONE("cache load");
+            KARMAC_ALLOC_PHASE(Cache);
+            try {
+                tokenizer->load(cached->tokens);
+            } catch(const std::exception&) {
+                //A corrupted entry is lexed again and replaced
+                cached.reset();
+            }
+        }
+
+        if(!cached) {
+            {
+                KARMAC_TRACE_ZONE("lex");
+                KARMAC_ALLOC_PHASE(Lex);
+                tokenizer->reset(source, file.get_start());
+            }
+
+            //Tokens recovered from errors aren't cached
+            if(_cache && tokenizer->get_errors().empty()) {
+                KARMAC_TRACE_ZONE("cache store");
+                KARMAC_ALLOC_PHASE(Cache);
+                _cache->store_tokens(source, file.get_start(), tokenizer->get_tokens());
+            }
+        }
+
+        const auto& lex_errors = tokenizer->get_errors();
+        if(_options.emit == Emit::Tokens && !lex_errors.empty()) {
+            for(const auto& error : lex_errors) {
+                add_diagnostic(result, output, _sources.to_string(error.get_location()), error.what());
+            }
+            return;
+        }
+
+        if(_options.emit == Emit::Tokens) {
+            dump_tokens(file, tokenizer->get_tokens(), output, result);
+            return;
+        }
+
+        //Only the outline can do without the function bodies so far
+        const auto lazy = _options.emit == Emit::Outline;
+        const auto parallel = !lazy && _pool;
+        //Blocks of recovered brackets aren't trusted for skipping bodies
+        const auto use_blocks = (lazy || parallel) && lex_errors.empty();
+
+        const auto by_location = [](const Diagnostic& a, const Diagnostic& b) {
+            return a.location < b.location;
+        };
+
+        ast::Tree tree;
+        {
+            KARMAC_TRACE_ZONE("parse");
+            KARMAC_ALLOC_PHASE(Parse);
+            Parser parser(tokenizer->get_tokens(), tree, file.get_end(),
+                          use_blocks ? std::span(tokenizer->get_blocks()) : std::span<const tokenize::BracketRange>());
+            if(parallel) {
+                parser.parse(*_pool);
+            } else {
+                parser.parse();
+            }
+
+            result.function_bodies = tree.get_children(ast::NO_NODE).size();
+            result.skipped_bodies = parser.get_skipped_bodies();
+
+            //Lexer errors don't stop the parser, both report in source order
+            std::vector<Diagnostic> errors;
+            errors.reserve(lex_errors.size() + parser.get_errors().size());
+            for(const auto& error : lex_errors) {
+                errors.push_back({ error.get_location(), error.what() });
+            }
+            for(const auto& error : parser.get_errors()) {
+                errors.push_back({ error.get_location(), error.what() });
+            }
+            std::inplace_merge(errors.begin(), errors.begin() + static_cast<ptrdiff_t>(lex_errors.size()), errors.end(), by_location);
+            for(const auto& error : errors) {
+                add_diagnostic(result, output, _sources.to_string(error.location), error.message);
+            }
+        }
+        if(!result.success) {
+            return;
+        }
+
+        if(_options.emit == Emit::Ast || _options.emit == Emit::Outline) {
+            dump_ast(file, tree, output, result);
+            return;
+        }
+
+        Resolver resolver;
+        {
+            KARMAC_TRACE_ZONE("resolve");
+            KARMAC_ALLOC_PHASE(Resolve);
+            resolver.resolve(tree, tokenizer->get_identifiers().size());
+        }
+
+        TypeChecker checker;
+        {
+            KARMAC_TRACE_ZONE("check");
+            KARMAC_ALLOC_PHASE(Check);
+            checker.check(tree, resolver);
+        }
+        result.folded_constants = checker.get_folded_count();
+
+        //Both passes report in source order
+        const auto resolve_errors = resolver.get_errors();
+        const auto type_errors = checker.get_errors();
+        std::vector<Diagnostic> errors;
+        errors.reserve(resolve_errors.size() + type_errors.size());
+        std::merge(resolve_errors.begin(), resolve_errors.end(), type_errors.begin(), type_errors.end(), std::back_inserter(errors), by_location);
+        for(const auto& error : errors) {
+            add_diagnostic(result, output, _sources.to_string(error.location), error.message);
+        }
+        if(!result.success) {
+            return;
+        }
+
+#ifdef KARMAC_LLVM
+        if(_options.emit == Emit::Ir || (_options.emit == Emit::Obj && _options.codegen == Codegen::Llvm)) {
+            compile_llvm(file, tree, resolver, checker, output, result);
+            return;
+        }
+        if(_options.run && _options.engine == Engine::Jit) {
+            run_jit(file, tree, resolver, checker, output, result);
+            return;
+        }
+#endif
+        if(!_options.run && _options.emit != Emit::Bytecode && _options.emit != Emit::Obj) {
+            return;
+        }
+
+        bytecode::Compiler compiler;
+        {
+            KARMAC_TRACE_ZONE("codegen");
+            KARMAC_ALLOC_PHASE(Codegen);
+            compiler.compile(tree, resolver, checker);
+        }
+        for(const auto& error : compiler.get_errors()) {
+            add_diagnostic(result, output, _sources.to_string(error.location), error.message);
+        }
+        if(!result.success) {
+            return;
+        }
+
+        if(_options.emit == Emit::Bytecode) {
+            dump_bytecode(compiler.get_program(), output, result);
+            return;
+        }
+        if(_options.emit == Emit::Obj) {
+            compile_baseline(file, tree, checker, compiler.get_program(), output, result);
+            return;
+        }
+        if(_options.engine == Engine::Baseline) {
+            run_baseline(file, tree, checker, compiler.get_program(), output, result);
+            return;
+        }
+        run_main(file, tree, checker, compiler.get_program(), output, result);
+    }
+
+    CompileResult Driver::compile(const std::string& path, std::FILE* output) {
+        KARMAC_TRACE_ZONE("compile file");
+
+        CompileResult result;
+        const auto fail = [&result, &path, output](const std::string_view& message) {
+            add_diagnostic(result, output, path, message);
+        };
+
+        const SourceFile* file;
+        try {
+            KARMAC_TRACE_ZONE("load");
+            KARMAC_ALLOC_PHASE(Load);
+            file = &_sources.load_file(path);
+        } catch(const std::exception& e) {
+            fail(e.what());
+            return result;
+        }
+        const auto source = file->get_text();
+        result.source_bytes = source.size();
+
+        {
+            KARMAC_TRACE_ZONE("utf8 validation");
+            size_t error_index;
+            if(!utf8::validate(source, error_index)) {
+                fail(fmt::format("invalid utf8 at byte {}", error_index));
+                return result;
+            }
+        }
+
+        try {
+            compile_source(*file, output, result);
+        } catch(const std::exception& e) {
+            fail(e.what());
+        }
+
+        return result;
+    }
+
+    std::vector<CompileResult> Driver::compile_parallel(size_t jobs) {
+        std::vector<CompileResult> results(_options.inputs.size());
+        std::atomic<size_t> next_input = 0;
+
+        const auto worker = [this, &results, &next_input] {
+            for(auto i = next_input++; i < results.size(); i = next_input++) {
+                results[i] = compile(_options.inputs[i], nullptr);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for(size_t i = 1; i < jobs; i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for(auto& thread : threads) {
+            thread.join();
+        }
+
+        return results;
+    }
+
+    int Driver::run() {
+        std::unique_ptr<std::FILE, decltype(&std::fclose)> output_file(nullptr, &std::fclose);
+        auto* output = stdout;
+        //Objects are written to their own files
+        if(_options.output && _options.emit != Emit::None && _options.emit != Emit::Obj) {
+            output_file.reset(std::fopen(_options.output->c_str(), "wb"));
+            if(!output_file) {
+                fmt::print(stderr, "karmac: error: failed to open {}\n", *_options.output);
+                return ExitCode::OutputError;
+            }
+            output = output_file.get();
+        }
+
+        auto success = true;
+        uint64_t source_bytes = 0;
+        size_t function_bodies = 0;
+        size_t skipped_bodies = 0;
+        size_t folded_constants = 0;
+        size_t jit_compiled_functions = 0;
+        size_t jit_cached_functions = 0;
+        auto exit_code = static_cast<int>(ExitCode::Success);
+
+        const auto jobs = std::min(_options.jobs, _options.inputs.size());
+        if(jobs <= 1) {
+            for(const auto& input : _options.inputs) {
+                const auto result = compile(input, output);
+                success &= result.success;
+                source_bytes += result.source_bytes;
+                function_bodies += result.function_bodies;
+                skipped_bodies += result.skipped_bodies;
+                folded_constants += result.folded_constants;
+                jit_compiled_functions += result.jit_compiled_functions;
+                jit_cached_functions += result.jit_cached_functions;
+                exit_code = result.exit_code;
+            }
+        } else {
+            for(const auto& result : compile_parallel(jobs)) {
+                std::fwrite(result.output.data(), 1, result.output.size(), output);
+                std::fputs(result.diagnostics.c_str(), stderr);
+
+                success &= result.success;
+                source_bytes += result.source_bytes;
+                function_bodies += result.function_bodies;
+                skipped_bodies += result.skipped_bodies;
+                folded_constants += result.folded_constants;
+            }
+        }
+
+        if(_cache) {
+            KARMAC_TRACE_ZONE("cache trim");
+            KARMAC_ALLOC_PHASE(Cache);
+            _cache->update_size();
+        }
+
+        if(std::fflush(output) != 0 || std::ferror(output)) {
+            fmt::print(stderr, "karmac: error: failed to write the output\n");
+            return ExitCode::OutputError;
+        }
+
+        if(_options.stats) {
+            alloc_stats::print_report(stderr, source_bytes);
+            if(_cache) {
+                const auto statistics = _cache->get_statistics();
+                fmt::print(stderr, "cache: tokens {} hits, {} misses, objects {} hits, {} misses, {} stores, {} evictions\n", statistics.token_hits,
+                           statistics.token_misses, statistics.object_hits, statistics.object_misses, statistics.stores, statistics.evictions);
+            }
+            if(_options.emit != Emit::Tokens) {
+                fmt::print(stderr, "parser: {} function bodies, {} skipped\n", function_bodies, skipped_bodies);
+            }
+            if(_options.emit == Emit::None) {
+                fmt::print(stderr, "checker: {} constant expressions folded\n", folded_constants);
+            }
+            if(_options.run && _options.engine == Engine::Jit) {
+                fmt::print(stderr, "jit: {} functions compiled, {} loaded from the cache\n", jit_compiled_functions, jit_cached_functions);
+            }
+        }
+        if(_options.lex_stats) {
+            tokenize::lex_stats::print_report(stderr, tokenize::lex_stats::collect());
+        }
+        if(_options.time_report) {
+            trace::print_time_report(stderr);
+        }
+        if(_options.trace_path) {
+            trace::write_chrome_trace(*_options.trace_path);
+        }
+
+        if(!success) {
+            return exit_code == ExitCode::RunError ? ExitCode::RunError : ExitCode::CompileError;
+        }
+        //Only set by --run, which takes a single input
+        return exit_code;
+    }
+
+    int run(int argc, const char* const* argv) {
+        Options options;
+        try {
+            options = parse_options(argc, argv);
+        } catch(const std::exception& e) {
+            fmt::print(stderr, "karmac: error: {}\n{}", e.what(), get_usage());
+            return ExitCode::UsageError;
+        }
+
+        if(options.help) {
+            fmt::print("{}", get_usage());
+            return ExitCode::Success;
+        }
+        if(options.version) {
+            fmt::print("karmac {}\n", KARMAC_VERSION);
+            return ExitCode::Success;
+        }
+
+        if(options.inputs.empty()) {
+            fmt::print(stderr, "karmac: error: no input files\n{}", get_usage());
+            return ExitCode::UsageError;
+        }
+
+        if(options.run && (options.inputs.size() != 1 || options.emit != Emit::None)) {
+            fmt::print(stderr, "karmac: error: --run takes a single input and no --emit\n{}", get_usage());
+            return ExitCode::UsageError;
+        }
+
+        if(options.run && options.engine == Engine::Baseline && !codegen::x86::IS_HOST) {
+            fmt::print(stderr, "karmac: error: --run=baseline needs an x86-64 host with the System V calling convention\n");
+            return ExitCode::UsageError;
+        }
+#ifndef KARMAC_LLVM
+        if(options.emit == Emit::Obj && options.codegen == Codegen::Llvm) {
+            fmt::print(stderr, "karmac: error: --codegen=llvm needs a build with -DKARMAC_LLVM=ON\n");
+            return ExitCode::UsageError;
+        }
+        if(options.run && options.engine == Engine::Jit) {
+            fmt::print(stderr, "karmac: error: --run=jit needs a build with -DKARMAC_LLVM=ON\n");
+            return ExitCode::UsageError;
+        }
+        if(options.emit == Emit::Ir) {
+            fmt::print(stderr, "karmac: error: --emit=llvm-ir needs a build with -DKARMAC_LLVM=ON\n");
+            return ExitCode::UsageError;
+        }
+#endif
+        if(options.emit == Emit::Obj && options.output && options.inputs.size() != 1) {
+            fmt::print(stderr, "karmac: error: -o with --emit=obj takes a single input\n{}", get_usage());
+            return ExitCode::UsageError;
+        }
+
+        if(options.time_report || options.trace_path) {
+            trace::enable();
+        }
+
+        try {
+            return Driver(options).run();
+        } catch(const std::exception& e) {
+            fmt::print(stderr, "karmac: error: {}\n", e.what());
+            return ExitCode::OutputError;
+        }
+    }
+}
\ No newline at end of file
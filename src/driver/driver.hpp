@@ -0,0 +1,92 @@
+#pragma once
+
+#include "options.hpp"
+#include "../bytecode/program.hpp"
+#include "../cache/frontend_cache.hpp"
+#include "../check/type_checker.hpp"
+#include "../parse/ast/tree.hpp"
+#include "../source/source_manager.hpp"
+#include "../util/thread/thread_pool.hpp"
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace karmac::driver {
+    enum ExitCode : int {
+        Success = 0,
+        CompileError = 1,
+        UsageError = 2,
+        OutputError = 3,
+        RunError = 4
+    };
+
+    struct CompileResult {
+        bool success = true;
+        uint64_t source_bytes = 0;
+        size_t function_bodies = 0;
+        size_t skipped_bodies = 0;
+        size_t folded_constants = 0;
+        //Functions compiled and loaded from the cache by the JIT
+        size_t jit_compiled_functions = 0;
+        size_t jit_cached_functions = 0;
+        //Exit code of the program for --run, ExitCode::RunError if it trapped
+        int exit_code = ExitCode::Success;
+        //Output and diagnostics of the file when it was compiled on a worker thread
+        std::string output;
+        std::string diagnostics;
+    };
+
+    //Compiles every input on its own, the outputs are written in input order
+    class Driver final {
+    private:
+        const Options& _options;
+        std::optional<FrontendCache> _cache;
+        SourceManager _sources;
+        //Parses the functions of a single input in parallel
+        std::optional<ThreadPool> _pool;
+
+        //Fails the result, the diagnostic is printed right away when the output is written directly
+        static void add_diagnostic(CompileResult& result, std::FILE* output, const std::string_view& where, const std::string_view& message);
+        //Writes directly to `output` if set, otherwise the output is kept in the result
+        [[nodiscard]] CompileResult compile(const std::string& path, std::FILE* output);
+        void compile_source(const SourceFile& file, std::FILE* output, CompileResult& result);
+        void dump_tokens(const SourceFile& file, const std::vector<Token*>& tokens, std::FILE* output, CompileResult& result) const;
+        void dump_ast(const SourceFile& file, const ast::Tree& tree, std::FILE* output, CompileResult& result) const;
+        void dump_bytecode(const bytecode::Program& program, std::FILE* output, CompileResult& result) const;
+        //Writes objects to the -o path or next to the input in the working directory
+        void write_objects(const SourceFile& file, std::span<const std::string> objects, std::FILE* output, CompileResult& result);
+        //Compiles an object with the baseline backend
+        void compile_baseline(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                              std::FILE* output, CompileResult& result);
+#ifdef KARMAC_LLVM
+        //IR is written like the other outputs, objects to their own files
+        void compile_llvm(const SourceFile& file, const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::FILE* output,
+                          CompileResult& result);
+#endif
+        //The main function of the tree, ast::NO_NODE after reporting it if there is none or it takes parameters
+        [[nodiscard]] ast::NodeIndex find_main(const SourceFile& file, const ast::Tree& tree, std::FILE* output, CompileResult& result) const;
+        //The integer result of main becomes the exit code
+        static void set_exit_code(const TypeChecker& checker, ast::NodeIndex main, uint64_t value, CompileResult& result) noexcept;
+        //Interprets the main function
+        void run_main(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                      std::FILE* output, CompileResult& result);
+        //Runs the main function compiled by the baseline backend
+        void run_baseline(const SourceFile& file, const ast::Tree& tree, const TypeChecker& checker, const bytecode::Program& program,
+                          std::FILE* output, CompileResult& result);
+#ifdef KARMAC_LLVM
+        //Runs the main function with the JIT
+        void run_jit(const SourceFile& file, const ast::Tree& tree, const Resolver& resolver, const TypeChecker& checker, std::FILE* output,
+                     CompileResult& result);
+#endif
+
+        [[nodiscard]] std::vector<CompileResult> compile_parallel(size_t jobs);
+    public:
+        explicit Driver(const Options& options);
+
+        //Returns the ExitCode of the whole run
+        [[nodiscard]] int run();
+    };
+
+    [[nodiscard]] int run(int argc, const char* const* argv);
+}
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "options.hpp"
+#include "../util/io/file.hpp"
+
+#include <fmt/format.h>
+#include <charconv>
+#include <stdexcept>
+#include <thread>
+
+namespace karmac::driver {
+    static constexpr size_t _MAX_RESPONSE_FILE_DEPTH = 16;
+
+    std::optional<Emit> parse_emit(const std::string_view& name) noexcept {
+        if(name == "tokens") {
+            return Emit::Tokens;
+        }
+        if(name == "ast") {
+            return Emit::Ast;
+        }
+        if(name == "outline") {
+            return Emit::Outline;
+        }
+        if(name == "bytecode") {
+            return Emit::Bytecode;
+        }
+        if(name == "llvm-ir" || name == "ir") {
+            return Emit::Ir;
+        }
+        if(name == "obj") {
+            return Emit::Obj;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Engine> parse_engine(const std::string_view& name) noexcept {
+        if(name == "interpreter") {
+            return Engine::Interpreter;
+        }
+        if(name == "jit") {
+            return Engine::Jit;
+        }
+        if(name == "baseline") {
+            return Engine::Baseline;
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Codegen> parse_codegen(const std::string_view& name) noexcept {
+        if(name == "llvm") {
+            return Codegen::Llvm;
+        }
+        if(name == "baseline") {
+            return Codegen::Baseline;
+        }
+        return std::nullopt;
+    }
+
+    //Splits a response file at whitespace, single and double quotes group arguments and \ escapes the next char
+    static void split_response_file(const std::string_view& text, std::vector<std::string>& arguments) {
+        std::string argument;
+        auto has_argument = false;
+        char quote = '\0';
+
+        for(size_t i = 0; i < text.size(); i++) {
+            const auto ch = text[i];
+
+            if(ch == '\\' && i + 1 < text.size()) {
+                argument += text[++i];
+                has_argument = true;
+            } else if(quote != '\0') {
+                if(ch == quote) {
+                    quote = '\0';
+                } else {
+                    argument += ch;
+                }
+            } else if(ch == '"' || ch == '\'') {
+                quote = ch;
+                has_argument = true;
+            } else if(ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r') {
+                if(has_argument) {
+                    arguments.push_back(std::move(argument));
+                    argument.clear();
+                    has_argument = false;
+                }
+            } else {
+                argument += ch;
+                has_argument = true;
+            }
+        }
+
+        if(quote != '\0') {
+            throw std::runtime_error("Unterminated quote in response file");
+        }
+        if(has_argument) {
+            arguments.push_back(std::move(argument));
+        }
+    }
+
+    static void expand_argument(const std::string_view& argument, std::vector<std::string>& arguments, size_t depth) {
+        if(!argument.starts_with('@')) {
+            arguments.emplace_back(argument);
+            return;
+        }
+
+        if(depth >= _MAX_RESPONSE_FILE_DEPTH) {
+            throw std::runtime_error(fmt::format("Response files nested too deeply: {}", argument));
+        }
+
+        const auto path = argument.substr(1);
+        std::string text;
+        try {
+            text = io::read_file(path);
+        } catch(const std::exception&) {
+            throw std::runtime_error(fmt::format("Failed to read response file: {}", path));
+        }
+
+        std::vector<std::string> file_arguments;
+        split_response_file(text, file_arguments);
+        for(const auto& file_argument : file_arguments) {
+            expand_argument(file_argument, arguments, depth + 1);
+        }
+    }
+
+    static size_t parse_jobs(const std::string_view& text) {
+        size_t jobs = 0;
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), jobs);
+        if(result.ec != std::errc() || result.ptr != text.data() + text.size()) {
+            throw std::runtime_error(fmt::format("Invalid job count: {}", text));
+        }
+
+        if(jobs == 0) {
+            jobs = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        return jobs;
+    }
+
+    //A size in bytes with an optional K, M or G suffix of powers of 1024
+    static uint64_t parse_size(const std::string_view& text) {
+        uint64_t size = 0;
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), size);
+        const std::string_view suffix(result.ptr, text.data() + text.size());
+
+        auto shift = 0;
+        if(suffix == "K" || suffix == "k") {
+            shift = 10;
+        } else if(suffix == "M" || suffix == "m") {
+            shift = 20;
+        } else if(suffix == "G" || suffix == "g") {
+            shift = 30;
+        } else if(!suffix.empty()) {
+            throw std::runtime_error(fmt::format("Invalid size: {}", text));
+        }
+
+        if(result.ec != std::errc() || size > (UINT64_MAX >> shift)) {
+            throw std::runtime_error(fmt::format("Invalid size: {}", text));
+        }
+        return size << shift;
+    }
+
+    Options parse_options(int argc, const char* const* argv) {
+        std::vector<std::string> arguments;
+        for(auto i = 1; i < argc; i++) {
+            expand_argument(argv[i], arguments, 0);
+        }
+
+        Options options;
+
+        //Returns the value of `-x value` style options
+        size_t i = 0;
+        const auto get_next = [&arguments, &i](const std::string_view& name) -> std::string_view {
+            if(i + 1 >= arguments.size()) {
+                throw std::runtime_error(fmt::format("Missing value for {}", name));
+            }
+            return arguments[++i];
+        };
+
+        auto only_inputs = false;
+        for(; i < arguments.size(); i++) {
+            const std::string_view argument(arguments[i]);
+
+            if(only_inputs || !argument.starts_with('-')) {
+                options.inputs.emplace_back(argument);
+            } else if(argument == "--") {
+                only_inputs = true;
+            } else if(argument == "-h" || argument == "--help") {
+                options.help = true;
+            } else if(argument == "--version") {
+                options.version = true;
+            } else if(argument == "-o") {
+                options.output = get_next(argument);
+            } else if(argument == "-j" || argument == "--jobs") {
+                options.jobs = parse_jobs(get_next(argument));
+            } else if(argument.starts_with("--jobs=")) {
+                options.jobs = parse_jobs(argument.substr(std::string_view("--jobs=").size()));
+            } else if(argument.size() > 2 && argument.starts_with("-j") && argument[2] >= '0' && argument[2] <= '9') {
+                //-j<n>
+                options.jobs = parse_jobs(argument.substr(2));
+            } else if(argument.starts_with("--emit=")) {
+                const auto emit = parse_emit(argument.substr(std::string_view("--emit=").size()));
+                if(!emit) {
+                    throw std::runtime_error(fmt::format("Unknown emit kind: {}", argument));
+                }
+                options.emit = *emit;
+            } else if(argument.starts_with("--codegen=")) {
+                const auto codegen = parse_codegen(argument.substr(std::string_view("--codegen=").size()));
+                if(!codegen) {
+                    throw std::runtime_error(fmt::format("Unknown codegen: {}", argument));
+                }
+                options.codegen = *codegen;
+            } else if(argument == "--dump-tokens") {
+                options.emit = Emit::Tokens;
+            } else if(argument.starts_with("--dump-tokens=")) {
+                const auto format = token_dump::parse_format(argument.substr(std::string_view("--dump-tokens=").size()));
+                if(!format) {
+                    throw std::runtime_error(fmt::format("Unknown token dump format: {}", argument));
+                }
+                options.emit = Emit::Tokens;
+                options.token_format = *format;
+            } else if(argument.starts_with("--cache-dir=")) {
+                options.cache_dir = argument.substr(std::string_view("--cache-dir=").size());
+            } else if(argument.starts_with("--cache-max-size=")) {
+                options.cache_max_size = parse_size(argument.substr(std::string_view("--cache-max-size=").size()));
+            } else if(argument == "--run") {
+                options.run = true;
+            } else if(argument.starts_with("--run=")) {
+                const auto engine = parse_engine(argument.substr(std::string_view("--run=").size()));
+                if(!engine) {
+                    throw std::runtime_error(fmt::format("Unknown engine: {}", argument));
+                }
+                options.run = true;
+                options.engine = *engine;
+            } else if(argument == "--stats") {
+                options.stats = true;
+            } else if(argument == "--lex-stats") {
+                options.lex_stats = true;
+            } else if(argument == "-ftime-report") {
+                options.time_report = true;
+            } else if(argument.starts_with("--trace=")) {
+                options.trace_path = argument.substr(std::string_view("--trace=").size());
+            } else {
+                throw std::runtime_error(fmt::format("Unknown option: {}", argument));
+            }
+        }
+
+        return options;
+    }
+
+    std::string_view get_usage() noexcept {
+        return "usage: karmac [options] <files...>\n"
+               "\n"
+               "  @<file>                read additional arguments from a response file\n"
+               "  -o <path>              write the output to <path> instead of stdout\n"
+               "  -j <n>, --jobs=<n>     compile with n threads, 0 uses all hardware threads. A single input\n"
+               "                         is parsed on n threads\n"
+               "  --emit=<kind>          tokens, ast, outline, bytecode, llvm-ir or obj, only checks the input\n"
+               "                         by default. llvm-ir needs a build with KARMAC_LLVM. obj writes\n"
+               "                         <input>.o or the -o path, split into <name>.<i>.o for -j <n> by llvm\n"
+               "  --codegen=<backend>    what compiles objects, llvm (default with KARMAC_LLVM) or baseline,\n"
+               "                         which emits unoptimized x86-64 code much faster\n"
+               "  --dump-tokens[=<fmt>]  same as --emit=tokens, the format is text (default) or jsonl\n"
+               "  --run[=<engine>]       run the main function of the input, its integer result is the exit\n"
+               "                         code. The engine is jit (default with KARMAC_LLVM), which compiles\n"
+               "                         functions on their first call, interpreter or baseline, which runs\n"
+               "                         the code of --codegen=baseline\n"
+               "  --cache-dir=<dir>      reuse frontend and jit results from the cache directory\n"
+               "  --cache-max-size=<n>   evict the least recently used cache entries above n bytes, K, M and G\n"
+               "                         suffixes are accepted. 1G by default\n"
+               "  --stats                print allocation, cache and parser statistics\n"
+               "  --lex-stats            print lexer statistics\n"
+               "  -ftime-report          print the time spent per phase\n"
+               "  --trace=<file>         write a Chrome trace of the compilation\n"
+               "  -h, --help             print this help\n"
+               "  --version              print the version\n"
+               "\n"
+               "exit codes: 0 success, 1 compilation failed, 2 invalid command line, 3 output failed, 4 the program\n"
+               "            trapped\n";
+    }
+}
\ No newline at end of file
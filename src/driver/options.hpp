@@ -0,0 +1,87 @@
+#pragma once
+
+#include "../tokenize/stream/token_dump.hpp"
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac::driver {
+    enum class Emit {
+        None,
+        Tokens,
+        Ast,
+        //The AST with function bodies skipped
+        Outline,
+        //Disassembled bytecode of the interpreter
+        Bytecode,
+        //Optimized LLVM IR, needs a build with KARMAC_LLVM
+        Ir,
+        //Native objects of the Codegen backend
+        Obj
+    };
+
+    [[nodiscard]] std::optional<Emit> parse_emit(const std::string_view& name) noexcept;
+
+    //What executes the program for --run
+    enum class Engine {
+        //The bytecode interpreter
+        Interpreter,
+        //The lazy LLVM ORC JIT, needs a build with KARMAC_LLVM
+        Jit,
+        //Machine code of the baseline backend, needs an x86-64 System V host
+        Baseline
+    };
+
+    [[nodiscard]] std::optional<Engine> parse_engine(const std::string_view& name) noexcept;
+
+    //What compiles objects for --emit=obj
+    enum class Codegen {
+        //Optimized code of the LLVM backend, needs a build with KARMAC_LLVM
+        Llvm,
+        //Unoptimized x86-64 code of the baseline backend, which compiles much faster
+        Baseline
+    };
+
+    [[nodiscard]] std::optional<Codegen> parse_codegen(const std::string_view& name) noexcept;
+
+    struct Options {
+        std::vector<std::string> inputs;
+        std::optional<std::string> output;
+        size_t jobs = 1;
+
+        Emit emit = Emit::None;
+        token_dump::Format token_format = token_dump::Format::Text;
+#ifdef KARMAC_LLVM
+        Codegen codegen = Codegen::Llvm;
+#else
+        Codegen codegen = Codegen::Baseline;
+#endif
+
+        std::optional<std::string> cache_dir;
+        //Size limit of the cache directory in bytes, the default of FrontendCache if not set
+        std::optional<uint64_t> cache_max_size;
+
+        //Runs the main function of the single input after checking it
+        bool run = false;
+#ifdef KARMAC_LLVM
+        Engine engine = Engine::Jit;
+#else
+        Engine engine = Engine::Interpreter;
+#endif
+
+        bool stats = false;
+        bool lex_stats = false;
+        bool time_report = false;
+        std::optional<std::string> trace_path;
+
+        bool help = false;
+        bool version = false;
+    };
+
+    //Arguments starting with @ are replaced by the whitespace separated arguments of the named response file,
+    //throws std::runtime_error for invalid command lines
+    [[nodiscard]] Options parse_options(int argc, const char* const* argv);
+
+    [[nodiscard]] std::string_view get_usage() noexcept;
+}
\ No newline at end of file
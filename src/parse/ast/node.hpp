@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace karmac::ast {
+    //Nodes are addressed by their index in the Tree, 0 is the module and never a child, so it also stands for no node
+    using NodeIndex = uint32_t;
+    //Index into the token array the tree was parsed from
+    using TokenIndex = uint32_t;
+
+    static constexpr NodeIndex NO_NODE = 0;
+    static constexpr TokenIndex NO_TOKEN = std::numeric_limits<TokenIndex>::max();
+
+    //The main token and the meaning of the lhs and rhs data of each kind. A list is stored as consecutive node
+    //indices in the extra pool, `extra[n]` is the n-th entry of it.
+    enum class NodeKind : uint8_t {
+        //Expressions
+        Identifier,     //name, -, -
+        Literal,        //literal, -, -
+        Unary,          //operator, operand, -
+        Postfix,        //operator, operand, -
+        Binary,         //operator, left, right
+        Assignment,     //operator, target, value
+        Conditional,    //?, condition, extra[rhs] then, extra[rhs + 1] else
+        Call,           //(, callee, extra[rhs] argument count followed by the arguments
+        Index,          //[, base, index
+        Member,         //. or ::, base, name token
+
+        //Statements
+        Block,          //{, list start, list size
+        Declaration,    //name, type token or NO_TOKEN, value. A constant if the name is followed by ::
+        If,             //if, condition, extra[rhs] then block, extra[rhs + 1] else node or NO_NODE
+        While,          //while, condition, body
+        For,            //for followed by the variable, range, body
+        Return,         //return, value or NO_NODE, -
+        Break,          //break, -, -
+        Continue,       //continue, -, -
+        LazyBody,       //{ of a function body that wasn't parsed yet, matching } token, -
+
+        //Declarations
+        Parameter,      //name, type token, -
+        Function,       //fn followed by the name, extra[lhs] parameter list start, size and return type token or NO_TOKEN, body
+        Module          //first token or NO_TOKEN, list start, list size
+    };
+
+    namespace node_kind {
+        static constexpr std::array<std::string_view, static_cast<size_t>(NodeKind::Module) + 1> _NAMES = {
+            "identifier", "literal", "unary", "postfix", "binary", "assignment", "conditional", "call", "index", "member",
+            "block", "declaration", "if", "while", "for", "return", "break", "continue", "lazy_body",
+            "parameter", "function", "module"
+        };
+
+        [[nodiscard]] constexpr std::string_view get_name(NodeKind kind) noexcept {
+            return _NAMES[static_cast<size_t>(kind)];
+        }
+
+        [[nodiscard]] constexpr bool is_expression(NodeKind kind) noexcept {
+            return kind <= NodeKind::Member;
+        }
+    }
+
+    struct NodeData {
+        uint32_t lhs = 0;
+        uint32_t rhs = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "tree.hpp"
+#include <algorithm>
+
+namespace karmac::ast {
+    void Tree::reset(std::span<Token* const> tokens) {
+        reset(tokens, tokens.size());
+    }
+
+    void Tree::reset(std::span<Token* const> tokens, size_t parsed_tokens) {
+        clear();
+        _tokens = tokens;
+
+        const auto nodes = static_cast<size_t>(static_cast<double>(parsed_tokens) * _NODES_PER_TOKEN) + 1;
+        _kinds.reserve(nodes);
+        _main_tokens.reserve(nodes);
+        _data.reserve(nodes);
+        _extra.reserve(static_cast<size_t>(static_cast<double>(parsed_tokens) * _EXTRA_PER_TOKEN));
+
+        add_node(NodeKind::Module, NO_TOKEN);
+    }
+
+    void Tree::clear() noexcept {
+        _tokens = {};
+        _kinds.clear();
+        _main_tokens.clear();
+        _data.clear();
+        _extra.clear();
+    }
+
+    NodeIndex Tree::extend(size_t nodes, size_t extra) {
+        const auto first = static_cast<NodeIndex>(_kinds.size());
+        _kinds.resize(_kinds.size() + nodes);
+        _main_tokens.resize(_main_tokens.size() + nodes);
+        _data.resize(_data.size() + nodes);
+        _extra.resize(_extra.size() + extra);
+        return first;
+    }
+
+    void Tree::copy_part(const Tree& part, const PartRange& range, NodeIndex node, uint32_t extra) noexcept {
+        karmac_assert(part._tokens.data() == _tokens.data());
+        karmac_assert(node + range.get_node_count() <= _kinds.size() && extra + range.get_extra_count() <= _extra.size());
+
+        const auto at = [&range, node](NodeIndex part_node) {
+            return relocate(part_node, range, node);
+        };
+        const auto extra_at = [&range, extra](uint32_t index) {
+            return index - range.first_extra + extra;
+        };
+
+        //Entries that aren't node indices, like the argument count of a call, are copied as they are
+        std::copy(part._extra.begin() + range.first_extra, part._extra.begin() + range.end_extra, _extra.begin() + extra);
+        const auto relocate_extra = [this, &part, &at, &extra_at](uint32_t start, uint32_t size) {
+            for(auto i = start; i < start + size; i++) {
+                _extra[extra_at(i)] = at(part._extra[i]);
+            }
+        };
+
+        for(auto i = range.first_node; i < range.end_node; i++) {
+            const auto kind = part._kinds[i];
+            auto data = part._data[i];
+
+            switch(kind) {
+                case NodeKind::Unary:
+                case NodeKind::Postfix:
+                case NodeKind::Member:
+                case NodeKind::Return:
+                    data.lhs = at(data.lhs);
+                    break;
+                case NodeKind::Binary:
+                case NodeKind::Assignment:
+                case NodeKind::Index:
+                case NodeKind::While:
+                case NodeKind::For:
+                    data.lhs = at(data.lhs);
+                    data.rhs = at(data.rhs);
+                    break;
+                case NodeKind::Declaration:
+                    data.rhs = at(data.rhs);
+                    break;
+                case NodeKind::Conditional:
+                case NodeKind::If:
+                    relocate_extra(data.rhs, 2);
+                    data.lhs = at(data.lhs);
+                    data.rhs = extra_at(data.rhs);
+                    break;
+                case NodeKind::Call:
+                    relocate_extra(data.rhs + 1, part._extra[data.rhs]);
+                    data.lhs = at(data.lhs);
+                    data.rhs = extra_at(data.rhs);
+                    break;
+                case NodeKind::Block:
+                    relocate_extra(data.lhs, data.rhs);
+                    data.lhs = extra_at(data.lhs);
+                    break;
+                case NodeKind::Parameter:
+                case NodeKind::Function:
+                case NodeKind::Module:
+                    karmac_assert(false);
+                    break;
+                default:
+                    break;
+            }
+
+            _kinds[at(i)] = kind;
+            _main_tokens[at(i)] = part._main_tokens[i];
+            _data[at(i)] = data;
+        }
+    }
+
+    size_t Tree::get_memory_usage() const noexcept {
+        return _kinds.size() * (sizeof(NodeKind) + sizeof(TokenIndex) + sizeof(NodeData)) + _extra.size() * sizeof(uint32_t);
+    }
+}
\ No newline at end of file
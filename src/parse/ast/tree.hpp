@@ -0,0 +1,164 @@
+#pragma once
+
+#include "node.hpp"
+#include "../../tokenize/token/token.hpp"
+#include "../../util/assert.hpp"
+#include <span>
+#include <vector>
+
+namespace karmac::ast {
+    struct ConditionalView {
+        NodeIndex condition;
+        NodeIndex then;
+        NodeIndex otherwise;
+    };
+
+    struct CallView {
+        NodeIndex callee;
+        std::span<const NodeIndex> arguments;
+    };
+
+    struct IfView {
+        NodeIndex condition;
+        NodeIndex then;
+        //NO_NODE, a Block or an If for else if chains
+        NodeIndex otherwise;
+    };
+
+    struct FunctionView {
+        TokenIndex name;
+        std::span<const NodeIndex> parameters;
+        //NO_TOKEN if the function returns nothing
+        TokenIndex return_type;
+        //A Block or a LazyBody
+        NodeIndex body;
+    };
+
+    //Nodes and extra entries of a Tree whose nodes only refer to nodes and entries of the same range
+    struct PartRange {
+        NodeIndex first_node;
+        NodeIndex end_node;
+        uint32_t first_extra;
+        uint32_t end_extra;
+
+        [[nodiscard]] inline size_t get_node_count() const noexcept { return end_node - first_node; }
+        [[nodiscard]] inline size_t get_extra_count() const noexcept { return end_extra - first_extra; }
+    };
+
+    //The AST of one file as parallel arrays indexed by NodeIndex, children are referenced by 32-bit indices instead of
+    //pointers. Nodes only refer to the tokens they were parsed from, which have to outlive the tree. All arrays
+    //hold trivial types, so `clear` is O(1) and keeps the capacity for the next file.
+    class Tree final {
+    private:
+        //Measured on generated code, used to reserve the arrays up front
+        static constexpr double _NODES_PER_TOKEN = 0.55;
+        static constexpr double _EXTRA_PER_TOKEN = 0.25;
+
+        std::span<Token* const> _tokens;
+
+        std::vector<NodeKind> _kinds;
+        std::vector<TokenIndex> _main_tokens;
+        std::vector<NodeData> _data;
+        std::vector<uint32_t> _extra;
+
+    public:
+        //Starts a new tree over `tokens`, the root is reserved as node 0. The arrays are reserved for the nodes of
+        //`parsed_tokens` tokens, all tokens by default.
+        void reset(std::span<Token* const> tokens);
+        void reset(std::span<Token* const> tokens, size_t parsed_tokens);
+        void clear() noexcept;
+
+        //Adds room for `nodes` nodes and `extra` extra entries to be filled by `copy_part`, returns the first new node
+        NodeIndex extend(size_t nodes, size_t extra);
+        //Copies `range` of `part`, a tree over the same tokens, to the nodes from `node` on and the extra entries from
+        //`extra` on. The range may only hold statements and expressions. Copies to disjoint ranges can run concurrently.
+        void copy_part(const Tree& part, const PartRange& range, NodeIndex node, uint32_t extra) noexcept;
+
+        //Index of a node of `range` after it was copied to `node`
+        [[nodiscard]] static inline NodeIndex relocate(NodeIndex part_node, const PartRange& range, NodeIndex node) noexcept {
+            return part_node == NO_NODE ? NO_NODE : part_node - range.first_node + node;
+        }
+
+        inline NodeIndex add_node(NodeKind kind, TokenIndex token, NodeData data = {}) {
+            _kinds.push_back(kind);
+            _main_tokens.push_back(token);
+            _data.push_back(data);
+            return static_cast<NodeIndex>(_kinds.size() - 1);
+        }
+
+        inline void set_node(NodeIndex node, NodeKind kind, TokenIndex token, NodeData data) noexcept {
+            _kinds[node] = kind;
+            _main_tokens[node] = token;
+            _data[node] = data;
+        }
+
+        //Returns the index of the first value
+        inline uint32_t add_extra(std::span<const uint32_t> values) {
+            const auto start = static_cast<uint32_t>(_extra.size());
+            _extra.insert(_extra.end(), values.begin(), values.end());
+            return start;
+        }
+
+        [[nodiscard]] inline size_t get_node_count() const noexcept { return _kinds.size(); }
+        [[nodiscard]] inline size_t get_extra_count() const noexcept { return _extra.size(); }
+        [[nodiscard]] inline NodeKind get_kind(NodeIndex node) const noexcept { return _kinds[node]; }
+        [[nodiscard]] inline TokenIndex get_main_token(NodeIndex node) const noexcept { return _main_tokens[node]; }
+        [[nodiscard]] inline const NodeData& get_data(NodeIndex node) const noexcept { return _data[node]; }
+        [[nodiscard]] inline uint32_t get_extra(uint32_t index) const noexcept { return _extra[index]; }
+
+        [[nodiscard]] inline std::span<const uint32_t> get_list(uint32_t start, uint32_t size) const noexcept {
+            return { _extra.data() + start, size };
+        }
+
+        [[nodiscard]] inline const Token& get_token(TokenIndex token) const noexcept {
+            karmac_assert(token < _tokens.size());
+            return *_tokens[token];
+        }
+
+        [[nodiscard]] inline SourceLocation get_location(NodeIndex node) const noexcept {
+            return _main_tokens[node] == NO_TOKEN ? SourceLocation() : get_token(_main_tokens[node]).get_location();
+        }
+
+        //Statements of a Block or functions of the Module
+        [[nodiscard]] inline std::span<const NodeIndex> get_children(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::Block || _kinds[node] == NodeKind::Module);
+            return get_list(_data[node].lhs, _data[node].rhs);
+        }
+
+        [[nodiscard]] inline ConditionalView get_conditional(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::Conditional);
+            return { _data[node].lhs, _extra[_data[node].rhs], _extra[_data[node].rhs + 1] };
+        }
+
+        [[nodiscard]] inline CallView get_call(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::Call);
+            const auto start = _data[node].rhs;
+            return { _data[node].lhs, get_list(start + 1, _extra[start]) };
+        }
+
+        [[nodiscard]] inline IfView get_if(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::If);
+            return { _data[node].lhs, _extra[_data[node].rhs], _extra[_data[node].rhs + 1] };
+        }
+
+        [[nodiscard]] inline FunctionView get_function(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::Function);
+            const auto start = _data[node].lhs;
+            return { _main_tokens[node] + 1, get_list(_extra[start], _extra[start + 1]), _extra[start + 2], _data[node].rhs };
+        }
+
+        //The variable of a For, it follows the keyword
+        [[nodiscard]] inline TokenIndex get_for_variable(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::For);
+            return _main_tokens[node] + 1;
+        }
+
+        [[nodiscard]] inline bool is_constant(NodeIndex node) const noexcept {
+            karmac_assert(_kinds[node] == NodeKind::Declaration);
+            return get_token(_main_tokens[node] + 1).get_type() == TokenType::DoubleColon;
+        }
+
+        //Bytes used by the node arrays and the extra pool
+        [[nodiscard]] size_t get_memory_usage() const noexcept;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,245 @@
+#include "ast_dump.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace karmac::ast_dump {
+    //String literals are printed quoted and escaped so every node stays on one line
+    static void append_quoted(fmt::memory_buffer& buffer, const std::string_view& text) {
+        buffer.push_back('"');
+        for(const auto c : text) {
+            switch(c) {
+                case '"':
+                    buffer.append(std::string_view("\\\""));
+                    break;
+                case '\\':
+                    buffer.append(std::string_view("\\\\"));
+                    break;
+                case '\n':
+                    buffer.append(std::string_view("\\n"));
+                    break;
+                case '\r':
+                    buffer.append(std::string_view("\\r"));
+                    break;
+                case '\t':
+                    buffer.append(std::string_view("\\t"));
+                    break;
+                case '\0':
+                    buffer.append(std::string_view("\\0"));
+                    break;
+                default:
+                    buffer.push_back(c);
+                    break;
+            }
+        }
+        buffer.push_back('"');
+    }
+
+    AstDumper::~AstDumper() {
+        try {
+            flush();
+        } catch(...) {}
+    }
+
+    void AstDumper::begin_line(ast::NodeIndex node, size_t depth) {
+        const auto indent = _buffer.size();
+        _buffer.resize(indent + depth * 2);
+        std::fill(_buffer.data() + indent, _buffer.data() + _buffer.size(), ' ');
+
+        if(_tree->get_main_token(node) != ast::NO_TOKEN) {
+            const auto line_offset = _source.get_line_offset(_tree->get_location(node));
+            fmt::format_to(std::back_inserter(_buffer), "[{}:{}] ", line_offset.line + 1, line_offset.offset + 1);
+        }
+        _buffer.append(ast::node_kind::get_name(_tree->get_kind(node)));
+    }
+
+    void AstDumper::append_token(ast::TokenIndex token) {
+        const auto& value = _tree->get_token(token);
+        if(value.get_type() == TokenType::StringLiteral) {
+            append_quoted(_buffer, value.to_string());
+        } else {
+            _buffer.append(value.to_string());
+        }
+    }
+
+    void AstDumper::dump(const ast::Tree& tree) {
+        _tree = &tree;
+
+        begin_line(ast::NO_NODE, 0);
+        _buffer.push_back('\n');
+
+        for(const auto function : tree.get_children(ast::NO_NODE)) {
+            const auto view = tree.get_function(function);
+
+            begin_line(function, 1);
+            _buffer.push_back(' ');
+            append_token(view.name);
+            if(view.return_type != ast::NO_TOKEN) {
+                _buffer.append(std::string_view(" -> "));
+                append_token(view.return_type);
+            }
+            _buffer.push_back('\n');
+
+            for(const auto parameter : view.parameters) {
+                begin_line(parameter, 2);
+                _buffer.push_back(' ');
+                append_token(tree.get_main_token(parameter));
+                _buffer.append(std::string_view(": "));
+                append_token(tree.get_data(parameter).lhs);
+                _buffer.push_back('\n');
+            }
+            dump(view.body, 2);
+
+            if(_file != nullptr && _buffer.size() >= _FLUSH_SIZE) {
+                flush();
+            }
+        }
+
+        _tree = nullptr;
+    }
+
+    void AstDumper::dump(ast::NodeIndex node, size_t depth) {
+        if(node == ast::NO_NODE) {
+            return;
+        }
+
+        if(ast::node_kind::is_expression(_tree->get_kind(node))) {
+            dump_expression(node, depth);
+        } else {
+            dump_statement(node, depth);
+        }
+    }
+
+    void AstDumper::dump_statement(ast::NodeIndex node, size_t depth) {
+        begin_line(node, depth);
+
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case ast::NodeKind::Block:
+                _buffer.push_back('\n');
+                for(const auto statement : _tree->get_children(node)) {
+                    dump(statement, depth + 1);
+                }
+                break;
+            case ast::NodeKind::Declaration:
+                _buffer.push_back(' ');
+                append_token(_tree->get_main_token(node));
+                if(_tree->is_constant(node)) {
+                    _buffer.append(std::string_view(" ::"));
+                } else if(data.lhs != ast::NO_TOKEN) {
+                    _buffer.append(std::string_view(": "));
+                    append_token(data.lhs);
+                } else {
+                    _buffer.append(std::string_view(" :="));
+                }
+                _buffer.push_back('\n');
+                dump(data.rhs, depth + 1);
+                break;
+            case ast::NodeKind::If: {
+                const auto view = _tree->get_if(node);
+                _buffer.push_back('\n');
+                dump(view.condition, depth + 1);
+                dump(view.then, depth + 1);
+                dump(view.otherwise, depth + 1);
+                break;
+            }
+            case ast::NodeKind::While:
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                dump(data.rhs, depth + 1);
+                break;
+            case ast::NodeKind::For:
+                _buffer.push_back(' ');
+                append_token(_tree->get_for_variable(node));
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                dump(data.rhs, depth + 1);
+                break;
+            case ast::NodeKind::Return:
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                break;
+            case ast::NodeKind::LazyBody:
+                fmt::format_to(std::back_inserter(_buffer), " {} tokens\n", data.lhs - _tree->get_main_token(node) + 1);
+                break;
+            default:
+                _buffer.push_back('\n');
+                break;
+        }
+    }
+
+    void AstDumper::dump_expression(ast::NodeIndex node, size_t depth) {
+        begin_line(node, depth);
+
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case ast::NodeKind::Identifier:
+            case ast::NodeKind::Literal:
+                _buffer.push_back(' ');
+                append_token(_tree->get_main_token(node));
+                _buffer.push_back('\n');
+                break;
+            case ast::NodeKind::Unary:
+            case ast::NodeKind::Postfix:
+                _buffer.push_back(' ');
+                append_token(_tree->get_main_token(node));
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                break;
+            case ast::NodeKind::Binary:
+            case ast::NodeKind::Assignment:
+                _buffer.push_back(' ');
+                append_token(_tree->get_main_token(node));
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                dump(data.rhs, depth + 1);
+                break;
+            case ast::NodeKind::Conditional: {
+                const auto view = _tree->get_conditional(node);
+                _buffer.push_back('\n');
+                dump(view.condition, depth + 1);
+                dump(view.then, depth + 1);
+                dump(view.otherwise, depth + 1);
+                break;
+            }
+            case ast::NodeKind::Call: {
+                const auto view = _tree->get_call(node);
+                _buffer.push_back('\n');
+                dump(view.callee, depth + 1);
+                for(const auto argument : view.arguments) {
+                    dump(argument, depth + 1);
+                }
+                break;
+            }
+            case ast::NodeKind::Index:
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                dump(data.rhs, depth + 1);
+                break;
+            case ast::NodeKind::Member:
+                _buffer.push_back(' ');
+                append_token(_tree->get_main_token(node));
+                append_token(data.rhs);
+                _buffer.push_back('\n');
+                dump(data.lhs, depth + 1);
+                break;
+            default:
+                _buffer.push_back('\n');
+                break;
+        }
+    }
+
+    void AstDumper::flush() {
+        if(_file == nullptr || _buffer.size() == 0) {
+            return;
+        }
+
+        const auto size = _buffer.size();
+        const auto written = std::fwrite(_buffer.data(), 1, size, _file);
+        _buffer.clear();
+
+        if(written != size) {
+            throw std::runtime_error("Failed to write ast dump");
+        }
+    }
+}
\ No newline at end of file
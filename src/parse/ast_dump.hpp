@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ast/tree.hpp"
+#include "../source/source_manager.hpp"
+
+#include <fmt/format.h>
+#include <cstdio>
+#include <string_view>
+
+namespace karmac::ast_dump {
+    //Writes one indented line per node, buffered like the token dump. Without a file the whole dump stays in the buffer.
+    class AstDumper final {
+    private:
+        static constexpr size_t _FLUSH_SIZE = 1024 * 1024;
+
+        std::FILE* _file;
+        const SourceFile& _source;
+        const ast::Tree* _tree = nullptr;
+        fmt::memory_buffer _buffer;
+
+        void begin_line(ast::NodeIndex node, size_t depth);
+        void append_token(ast::TokenIndex token);
+        void dump(ast::NodeIndex node, size_t depth);
+        void dump_statement(ast::NodeIndex node, size_t depth);
+        void dump_expression(ast::NodeIndex node, size_t depth);
+
+    public:
+        AstDumper(std::FILE* file, const SourceFile& source) noexcept : _file(file), _source(source) {}
+        explicit AstDumper(const SourceFile& source) noexcept : _file(nullptr), _source(source) {}
+        AstDumper(const AstDumper&) = delete;
+        ~AstDumper();
+
+        AstDumper& operator =(const AstDumper&) = delete;
+
+        void dump(const ast::Tree& tree);
+
+        void flush();
+
+        [[nodiscard]] inline std::string_view get_buffer() const noexcept {
+            return { _buffer.data(), _buffer.size() };
+        }
+    };
+}
\ No newline at end of file
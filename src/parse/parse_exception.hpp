@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../util/text/source_location.hpp"
+
+#include <fmt/format.h>
+#include <stdexcept>
+#include <utility>
+
+namespace karmac {
+    //The location is resolved to path:line:column by the SourceManager that owns the file
+    class ParseException final : public std::runtime_error {
+    private:
+        SourceLocation _location;
+    public:
+        template<typename... T>
+        ParseException(SourceLocation location, const fmt::format_string<T...> fmt, T&&... args)
+            : std::runtime_error(fmt::format(fmt, std::forward<T&&>(args)...)), _location(location) {}
+
+        [[nodiscard]] inline SourceLocation get_location() const noexcept {
+            return _location;
+        }
+    };
+}
\ No newline at end of file
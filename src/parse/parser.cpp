@@ -0,0 +1,580 @@
+#include "parser.hpp"
+#include "parse_exception.hpp"
+#include "../util/stats/alloc_stats.hpp"
+#include "../util/stats/trace.hpp"
+#include <atomic>
+#include <algorithm>
+
+namespace karmac {
+    using ast::NodeIndex;
+    using ast::NodeKind;
+    using ast::TokenIndex;
+    using token_type::Associativity;
+    using token_type::Precedence;
+
+    //Bodies parsed on a thread are appended to its part tree, which keeps its capacity for the next parallel parse
+    struct PartTree {
+        ast::Tree tree;
+        uint64_t parse = 0;
+    };
+
+    static thread_local PartTree _part_tree;
+    static std::atomic<uint64_t> _parallel_parses = 0;
+
+    uint32_t Parser::pop_list(size_t start) {
+        const auto extra = _tree.add_extra(std::span<const uint32_t>(_list_stack).subspan(start));
+        _list_stack.resize(start);
+        return extra;
+    }
+
+    SourceLocation Parser::get_location() const noexcept {
+        const auto* token = _cursor.get();
+        return token != nullptr ? token->get_location() : _end;
+    }
+
+    ParseException Parser::make_expected(std::string_view expected) const {
+        const auto* token = _cursor.get();
+        if(token == nullptr) {
+            return ParseException(_end, "Expected {}, found {}", expected, token_type::to_string(TokenType::EndOfFile));
+        }
+
+        return ParseException(token->get_location(), "Expected {}, found \"{}\"", expected, token->to_string());
+    }
+
+    void Parser::fail_expected(std::string_view expected) const {
+        throw make_expected(expected);
+    }
+
+    void Parser::report(const ParseException& error) {
+        //All blocks that end at the same missing } report it
+        if(!_errors.empty() && _errors.back().get_location() == error.get_location()) {
+            return;
+        }
+
+        _errors.push_back(error);
+    }
+
+    void Parser::sort_errors() {
+        //A parallel parse finds the errors of the outline and of the bodies in any order
+        std::stable_sort(_errors.begin(), _errors.end(), [](const ParseException& a, const ParseException& b) {
+            return a.get_location().offset < b.get_location().offset;
+        });
+        _errors.erase(std::unique(_errors.begin(), _errors.end(), [](const ParseException& a, const ParseException& b) {
+            return a.get_location() == b.get_location();
+        }), _errors.end());
+    }
+
+    //The closing bracket an opening bracket expects, TokenType::EndOfFile for other tokens
+    static TokenType get_closing_bracket(TokenType type) noexcept {
+        switch(type) {
+            case TokenType::LeftBracket:
+                return TokenType::RightBracket;
+            case TokenType::LeftSquareBracket:
+                return TokenType::RightSquareBracket;
+            case TokenType::LeftCurlyBracket:
+                return TokenType::RightCurlyBracket;
+            default:
+                return TokenType::EndOfFile;
+        }
+    }
+
+    bool Parser::skip_bracket(TokenType type) {
+        const auto closing = get_closing_bracket(type);
+        if(closing != TokenType::EndOfFile) {
+            _skipped_brackets.push_back(closing);
+            return true;
+        }
+        if(!token_type::is_bracket(type)) {
+            return true;
+        }
+
+        //The tokenizer reports mismatched brackets but keeps them, a closing bracket closes the brackets still open
+        //inside of its match like it does there
+        const auto match = std::find(_skipped_brackets.rbegin(), _skipped_brackets.rend(), type);
+        if(match == _skipped_brackets.rend()) {
+            return false;
+        }
+        _skipped_brackets.erase(std::prev(match.base()), _skipped_brackets.end());
+        return true;
+    }
+
+    void Parser::skip_statement(uint32_t start) {
+        //The error may be nested in brackets of the statement, so the brackets are tracked from its start
+        _cursor.seek(start);
+        _skipped_brackets.clear();
+        while(_cursor.has_tokens()) {
+            const auto type = _cursor.peek();
+            //A bracket that doesn't close one of the statement closes the block around it
+            if(!skip_bracket(type)) {
+                return;
+            }
+            if(type == TokenType::Semicolon && _skipped_brackets.empty()) {
+                _cursor.next();
+                return;
+            }
+            _cursor.next();
+        }
+    }
+
+    void Parser::skip_function(uint32_t start) {
+        _cursor.seek(start);
+        _skipped_brackets.clear();
+        while(_cursor.has_tokens()) {
+            const auto type = _cursor.peek();
+            if(type == TokenType::Fn && _skipped_brackets.empty() && _cursor.get_index() != start) {
+                return;
+            }
+
+            (void) skip_bracket(type);
+            _cursor.next();
+        }
+    }
+
+    TokenIndex Parser::expect(TokenType type) {
+        if(!_cursor.is(type)) {
+            fail_expected(fmt::format("\"{}\"", token_type::to_string(type)));
+        }
+
+        return _cursor.next();
+    }
+
+    void Parser::enter() {
+        if(++_depth > _MAX_DEPTH) {
+            throw ParseException(get_location(), "Nesting is deeper than {} levels", _MAX_DEPTH);
+        }
+    }
+
+    void Parser::parse_functions() {
+        while(_cursor.has_tokens()) {
+            const auto start = _cursor.get_index();
+            const auto list_size = _list_stack.size();
+            try {
+                _list_stack.push_back(parse_function());
+            } catch(const ParseException& e) {
+                report(e);
+                _list_stack.resize(list_size);
+                _depth = 0;
+                skip_function(start);
+            }
+        }
+    }
+
+    void Parser::parse() {
+        _tree.reset(_tokens);
+        const auto first = _cursor.has_tokens() ? _cursor.get_index() : ast::NO_TOKEN;
+
+        const auto start = _list_stack.size();
+        parse_functions();
+
+        const auto count = static_cast<uint32_t>(_list_stack.size() - start);
+        _tree.set_node(ast::NO_NODE, NodeKind::Module, first, { pop_list(start), count });
+        sort_errors();
+    }
+
+    void Parser::parse(ThreadPool& pool) {
+        //Without the bracket ranges the bodies aren't known up front
+        if(_blocks.empty()) {
+            parse();
+            return;
+        }
+
+        //The tree only grows once more when the bodies are copied in
+        size_t body_tokens = 0;
+        for(const auto& block : _blocks) {
+            body_tokens += block.close - block.open + 1;
+        }
+        _tree.reset(_tokens, _tokens.size() - body_tokens);
+        const auto first = _cursor.has_tokens() ? _cursor.get_index() : ast::NO_TOKEN;
+
+        parse_functions();
+        const auto function_count = _list_stack.size();
+
+        struct Chunk {
+            std::vector<NodeIndex> functions;
+            size_t tokens = 0;
+            const ast::Tree* part = nullptr;
+            ast::PartRange range = {};
+            std::vector<NodeIndex> bodies;
+            std::vector<ParseException> errors;
+        };
+
+        std::vector<Chunk> chunks;
+        for(const auto function : _list_stack) {
+            const auto body = _tree.get_data(function).rhs;
+            if(_tree.get_kind(body) != NodeKind::LazyBody) {
+                continue;
+            }
+
+            if(chunks.empty() || chunks.back().tokens >= _CHUNK_TOKENS) {
+                chunks.emplace_back();
+            }
+            chunks.back().functions.push_back(function);
+            chunks.back().tokens += _tree.get_data(body).lhs - _tree.get_main_token(body) + 1;
+        }
+
+        const auto parse_id = ++_parallel_parses;
+        pool.run(chunks.size(), [this, &chunks, parse_id](size_t i) {
+            KARMAC_TRACE_ZONE("parse bodies");
+            KARMAC_ALLOC_PHASE(Parse);
+
+            if(_part_tree.parse != parse_id) {
+                _part_tree.tree.reset(_tokens, 0);
+                _part_tree.parse = parse_id;
+            }
+
+            auto& chunk = chunks[i];
+            auto& part = _part_tree.tree;
+            chunk.part = &part;
+            chunk.range.first_node = static_cast<NodeIndex>(part.get_node_count());
+            chunk.range.first_extra = static_cast<uint32_t>(part.get_extra_count());
+
+            //Blocks recover from their errors, so every body yields a node
+            Parser parser(_tokens, part, _end);
+            for(const auto function : chunk.functions) {
+                parser._cursor.seek(_tree.get_main_token(_tree.get_data(function).rhs));
+                chunk.bodies.push_back(parser.parse_block());
+            }
+            chunk.errors = std::move(parser._errors);
+
+            chunk.range.end_node = static_cast<NodeIndex>(part.get_node_count());
+            chunk.range.end_extra = static_cast<uint32_t>(part.get_extra_count());
+        });
+
+        for(const auto& chunk : chunks) {
+            _errors.insert(_errors.end(), chunk.errors.begin(), chunk.errors.end());
+        }
+
+        //Every chunk is copied to its own range, so the copies run in parallel as well
+        size_t nodes = 0;
+        size_t extra = 0;
+        for(const auto& chunk : chunks) {
+            nodes += chunk.range.get_node_count();
+            extra += chunk.range.get_extra_count();
+        }
+        auto node = _tree.extend(nodes, extra);
+        auto extra_start = static_cast<uint32_t>(_tree.get_extra_count() - extra);
+
+        std::vector<std::pair<NodeIndex, uint32_t>> targets;
+        for(const auto& chunk : chunks) {
+            targets.emplace_back(node, extra_start);
+            node += static_cast<NodeIndex>(chunk.range.get_node_count());
+            extra_start += static_cast<uint32_t>(chunk.range.get_extra_count());
+        }
+
+        pool.run(chunks.size(), [this, &chunks, &targets](size_t i) {
+            KARMAC_TRACE_ZONE("merge bodies");
+
+            const auto& chunk = chunks[i];
+            const auto [target, target_extra] = targets[i];
+            _tree.copy_part(*chunk.part, chunk.range, target, target_extra);
+            for(size_t j = 0; j < chunk.functions.size(); j++) {
+                const auto function = chunk.functions[j];
+                _tree.set_node(function, NodeKind::Function, _tree.get_main_token(function),
+                               { _tree.get_data(function).lhs, ast::Tree::relocate(chunk.bodies[j], chunk.range, target) });
+            }
+        });
+        _parsed_bodies = _lazy_bodies;
+
+        _tree.set_node(ast::NO_NODE, NodeKind::Module, first, { pop_list(0), static_cast<uint32_t>(function_count) });
+        sort_errors();
+    }
+
+    NodeIndex Parser::parse_function() {
+        const auto keyword = expect(TokenType::Fn);
+        expect(TokenType::Identifier);
+
+        expect(TokenType::LeftBracket);
+        const auto start = _list_stack.size();
+        if(!_cursor.is(TokenType::RightBracket)) {
+            do {
+                const auto parameter = expect(TokenType::Identifier);
+                expect(TokenType::Colon);
+                const auto type = expect(TokenType::Identifier);
+                _list_stack.push_back(_tree.add_node(NodeKind::Parameter, parameter, { type, 0 }));
+            } while(_cursor.accept(TokenType::Comma));
+        }
+        expect(TokenType::RightBracket);
+        const auto count = static_cast<uint32_t>(_list_stack.size() - start);
+        const auto parameters = pop_list(start);
+
+        auto return_type = ast::NO_TOKEN;
+        if(_cursor.accept(TokenType::Arrow)) {
+            return_type = expect(TokenType::Identifier);
+        }
+
+        const uint32_t signature[] = { parameters, count, return_type };
+        const auto extra = _tree.add_extra(signature);
+
+        auto body = _blocks.empty() ? ast::NO_NODE : skip_body();
+        if(body == ast::NO_NODE) {
+            body = parse_block();
+        }
+        return _tree.add_node(NodeKind::Function, keyword, { extra, body });
+    }
+
+    NodeIndex Parser::skip_body() {
+        //Functions are parsed in token order, so the ranges are visited in order as well
+        const auto open = _cursor.get_index();
+        while(_next_block < _blocks.size() && _blocks[_next_block].open < open) {
+            ++_next_block;
+        }
+        if(_next_block == _blocks.size() || _blocks[_next_block].open != open || !_cursor.is(TokenType::LeftCurlyBracket)) {
+            return ast::NO_NODE;
+        }
+
+        const auto close = _blocks[_next_block++].close;
+        _cursor.seek(close + 1);
+        ++_lazy_bodies;
+        return _tree.add_node(NodeKind::LazyBody, open, { close, 0 });
+    }
+
+    void Parser::parse_body(NodeIndex function) {
+        const auto& data = _tree.get_data(function);
+        if(_tree.get_kind(data.rhs) != NodeKind::LazyBody) {
+            return;
+        }
+
+        _cursor.seek(_tree.get_main_token(data.rhs));
+        const auto errors = _errors.size();
+
+        const auto body = parse_block();
+        _tree.set_node(function, NodeKind::Function, _tree.get_main_token(function), { _tree.get_data(function).lhs, body });
+        ++_parsed_bodies;
+
+        //The errors of the body may lie in front of the ones found so far
+        if(_errors.size() != errors) {
+            sort_errors();
+        }
+    }
+
+    void Parser::parse_bodies() {
+        //Parsing grows the extra pool, so the function list is read by index
+        const auto module = _tree.get_data(ast::NO_NODE);
+        for(uint32_t i = 0; i < module.rhs; i++) {
+            parse_body(_tree.get_extra(module.lhs + i));
+        }
+    }
+
+    NodeIndex Parser::parse_block() {
+        enter();
+        const auto bracket = expect(TokenType::LeftCurlyBracket);
+
+        const auto start = _list_stack.size();
+        while(!_cursor.is(TokenType::RightCurlyBracket)) {
+            if(!_cursor.has_tokens()) {
+                report(make_expected("\"}\""));
+                break;
+            }
+
+            //A statement with an error is left out of the block
+            const auto statement = _cursor.get_index();
+            const auto list_size = _list_stack.size();
+            const auto depth = _depth;
+            try {
+                _list_stack.push_back(parse_statement());
+            } catch(const ParseException& e) {
+                report(e);
+                _list_stack.resize(list_size);
+                _depth = depth;
+                skip_statement(statement);
+            }
+        }
+        if(_cursor.has_tokens()) {
+            _cursor.next();
+        }
+
+        leave();
+        const auto count = static_cast<uint32_t>(_list_stack.size() - start);
+        return _tree.add_node(NodeKind::Block, bracket, { pop_list(start), count });
+    }
+
+    NodeIndex Parser::parse_statement() {
+        switch(_cursor.peek()) {
+            case TokenType::LeftCurlyBracket:
+                return parse_block();
+            case TokenType::If:
+                return parse_if();
+            case TokenType::While: {
+                const auto keyword = _cursor.next();
+                const auto condition = parse_expression();
+                return _tree.add_node(NodeKind::While, keyword, { condition, parse_block() });
+            }
+            case TokenType::For: {
+                const auto keyword = _cursor.next();
+                expect(TokenType::Identifier);
+                expect(TokenType::Colon);
+                const auto range = parse_expression();
+                return _tree.add_node(NodeKind::For, keyword, { range, parse_block() });
+            }
+            case TokenType::Return: {
+                const auto keyword = _cursor.next();
+                const auto value = _cursor.is(TokenType::Semicolon) ? ast::NO_NODE : parse_expression();
+                expect(TokenType::Semicolon);
+                return _tree.add_node(NodeKind::Return, keyword, { value, 0 });
+            }
+            case TokenType::Break: {
+                const auto keyword = _cursor.next();
+                expect(TokenType::Semicolon);
+                return _tree.add_node(NodeKind::Break, keyword);
+            }
+            case TokenType::Continue: {
+                const auto keyword = _cursor.next();
+                expect(TokenType::Semicolon);
+                return _tree.add_node(NodeKind::Continue, keyword);
+            }
+            case TokenType::Identifier:
+                if(_cursor.peek(1) == TokenType::Colon || _cursor.peek(1) == TokenType::DoubleColon) {
+                    return parse_declaration();
+                }
+                break;
+            default:
+                break;
+        }
+
+        const auto expression = parse_expression();
+        expect(TokenType::Semicolon);
+        return expression;
+    }
+
+    NodeIndex Parser::parse_if() {
+        enter();
+        const auto keyword = expect(TokenType::If);
+        const auto condition = parse_expression();
+        const auto then = parse_block();
+
+        auto otherwise = ast::NO_NODE;
+        if(_cursor.accept(TokenType::Else)) {
+            otherwise = _cursor.is(TokenType::If) ? parse_if() : parse_block();
+        }
+
+        leave();
+        const uint32_t branches[] = { then, otherwise };
+        return _tree.add_node(NodeKind::If, keyword, { condition, _tree.add_extra(branches) });
+    }
+
+    NodeIndex Parser::parse_declaration() {
+        const auto name = _cursor.next();
+
+        auto type = ast::NO_TOKEN;
+        if(!_cursor.accept(TokenType::DoubleColon)) {
+            _cursor.next();
+            if(_cursor.is(TokenType::Identifier)) {
+                type = _cursor.next();
+            }
+            expect(TokenType::Assign);
+        }
+
+        const auto value = parse_expression();
+        expect(TokenType::Semicolon);
+        return _tree.add_node(NodeKind::Declaration, name, { type, value });
+    }
+
+    NodeIndex Parser::parse_expression(Precedence min_precedence) {
+        enter();
+        auto left = parse_unary();
+
+        while(true) {
+            const auto type = _cursor.peek();
+            const auto precedence = token_type::get_precedence(type);
+            if(precedence == Precedence::None || precedence < min_precedence) {
+                break;
+            }
+
+            const auto op = _cursor.next();
+            const auto associativity = token_type::get_associativity(type);
+            //Left associative operators only take operands that bind tighter on their right side
+            const auto next_precedence = associativity == Associativity::Right ? precedence : static_cast<Precedence>(static_cast<uint8_t>(precedence) + 1);
+
+            if(type == TokenType::QuestionMark) {
+                const auto then = parse_expression();
+                expect(TokenType::Colon);
+                const uint32_t branches[] = { then, parse_expression(next_precedence) };
+                left = _tree.add_node(NodeKind::Conditional, op, { left, _tree.add_extra(branches) });
+            } else if(token_type::is_assignment(type)) {
+                left = _tree.add_node(NodeKind::Assignment, op, { left, parse_expression(next_precedence) });
+            } else {
+                left = _tree.add_node(NodeKind::Binary, op, { left, parse_expression(next_precedence) });
+
+                if(associativity == Associativity::None && token_type::get_precedence(_cursor.peek()) == precedence) {
+                    throw ParseException(get_location(), "\"{}\" can't be chained", token_type::to_string(type));
+                }
+            }
+        }
+
+        leave();
+        return left;
+    }
+
+    NodeIndex Parser::parse_unary() {
+        const auto type = _cursor.peek();
+        if(token_type::is_operator(type) && token_type::is_prefix(type)) {
+            enter();
+            const auto op = _cursor.next();
+            const auto node = _tree.add_node(NodeKind::Unary, op, { parse_unary(), 0 });
+            leave();
+            return node;
+        }
+
+        return parse_postfix(parse_primary());
+    }
+
+    NodeIndex Parser::parse_postfix(NodeIndex operand) {
+        while(true) {
+            switch(_cursor.peek()) {
+                case TokenType::LeftBracket: {
+                    const auto bracket = _cursor.next();
+                    //The argument count is the first entry of the list
+                    const auto start = _list_stack.size();
+                    _list_stack.push_back(0);
+                    if(!_cursor.is(TokenType::RightBracket)) {
+                        do {
+                            _list_stack.push_back(parse_expression());
+                        } while(_cursor.accept(TokenType::Comma));
+                    }
+                    expect(TokenType::RightBracket);
+                    _list_stack[start] = static_cast<uint32_t>(_list_stack.size() - start - 1);
+                    operand = _tree.add_node(NodeKind::Call, bracket, { operand, pop_list(start) });
+                    break;
+                }
+                case TokenType::LeftSquareBracket: {
+                    const auto bracket = _cursor.next();
+                    const auto index = parse_expression();
+                    expect(TokenType::RightSquareBracket);
+                    operand = _tree.add_node(NodeKind::Index, bracket, { operand, index });
+                    break;
+                }
+                case TokenType::Dot:
+                case TokenType::DoubleColon: {
+                    const auto op = _cursor.next();
+                    operand = _tree.add_node(NodeKind::Member, op, { operand, expect(TokenType::Identifier) });
+                    break;
+                }
+                case TokenType::Increment:
+                case TokenType::Decrement:
+                    operand = _tree.add_node(NodeKind::Postfix, _cursor.next(), { operand, 0 });
+                    break;
+                default:
+                    return operand;
+            }
+        }
+    }
+
+    NodeIndex Parser::parse_primary() {
+        const auto type = _cursor.peek();
+
+        if(type == TokenType::Identifier) {
+            return _tree.add_node(NodeKind::Identifier, _cursor.next());
+        }
+        if(token_type::is_literal(type)) {
+            return _tree.add_node(NodeKind::Literal, _cursor.next());
+        }
+        if(type == TokenType::LeftBracket) {
+            _cursor.next();
+            const auto expression = parse_expression();
+            expect(TokenType::RightBracket);
+            return expression;
+        }
+
+        fail_expected("an expression");
+    }
+}
\ No newline at end of file
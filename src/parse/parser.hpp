@@ -0,0 +1,102 @@
+#pragma once
+
+#include "ast/tree.hpp"
+#include "parse_exception.hpp"
+#include "token_cursor.hpp"
+#include "../tokenize/util/bracket_stack.hpp"
+#include "../util/thread/thread_pool.hpp"
+#include <span>
+#include <vector>
+
+namespace karmac {
+    //Recursive descent parser for declarations and statements, expressions are parsed by precedence climbing
+    //over the binding strengths of the TokenType table. The nodes are appended to an ast::Tree and refer to
+    //the tokens by index, the tokens have to outlive the tree.
+    //Given the outermost bracket ranges of the tokens, function bodies are skipped as LazyBody nodes and only
+    //parsed once they are requested by `parse_body`.
+    //Syntax errors don't stop the parse: a statement with an error is skipped up to the next ; or the end of its
+    //block, a broken function up to the next fn outside of brackets.
+    class Parser final {
+    private:
+        //Bounds the recursion for deeply nested input
+        static constexpr size_t _MAX_DEPTH = 256;
+        //Body tokens per task of a parallel parse, chunks only depend on the input so the tree does as well
+        static constexpr size_t _CHUNK_TOKENS = 16 * 1024;
+
+        const std::vector<Token*>& _tokens;
+        TokenCursor _cursor;
+        ast::Tree& _tree;
+        //Location reported for errors past the last token
+        SourceLocation _end;
+
+        //Empty if all bodies are parsed right away
+        std::span<const tokenize::BracketRange> _blocks;
+        size_t _next_block = 0;
+        size_t _lazy_bodies = 0;
+        size_t _parsed_bodies = 0;
+
+        std::vector<ParseException> _errors;
+
+        //Entries of all lists that are being parsed, each list is moved into the extra pool once it is complete
+        std::vector<uint32_t> _list_stack;
+        size_t _depth = 0;
+        //Closing brackets expected by the tokens skipped after an error
+        std::vector<TokenType> _skipped_brackets;
+
+        //Moves the list entries from `start` on into the extra pool and returns its start
+        [[nodiscard]] uint32_t pop_list(size_t start);
+
+        [[nodiscard]] SourceLocation get_location() const noexcept;
+        [[nodiscard]] ParseException make_expected(std::string_view expected) const;
+        [[noreturn]] void fail_expected(std::string_view expected) const;
+        ast::TokenIndex expect(TokenType type);
+
+        void report(const ParseException& error);
+        void sort_errors();
+        //Tracks the brackets of a skipped token, returns false for a closing bracket without an open match
+        [[nodiscard]] bool skip_bracket(TokenType type);
+        //Moves the cursor behind the statement or function starting at `start` that failed to parse
+        void skip_statement(uint32_t start);
+        void skip_function(uint32_t start);
+
+        void enter();
+        inline void leave() noexcept { --_depth; }
+
+        //Pushes the functions to the list stack
+        void parse_functions();
+        [[nodiscard]] ast::NodeIndex parse_function();
+        //Returns NO_NODE if the body at the cursor can't be skipped
+        [[nodiscard]] ast::NodeIndex skip_body();
+        [[nodiscard]] ast::NodeIndex parse_block();
+        [[nodiscard]] ast::NodeIndex parse_statement();
+        [[nodiscard]] ast::NodeIndex parse_if();
+        [[nodiscard]] ast::NodeIndex parse_declaration();
+
+        [[nodiscard]] ast::NodeIndex parse_expression(token_type::Precedence min_precedence = token_type::Precedence::Assignment);
+        [[nodiscard]] ast::NodeIndex parse_unary();
+        [[nodiscard]] ast::NodeIndex parse_postfix(ast::NodeIndex operand);
+        [[nodiscard]] ast::NodeIndex parse_primary();
+    public:
+        Parser(const std::vector<Token*>& tokens, ast::Tree& tree, SourceLocation end = SourceLocation(),
+               std::span<const tokenize::BracketRange> blocks = {}) noexcept
+            : _tokens(tokens), _cursor(tokens), _tree(tree), _end(end), _blocks(blocks) {}
+
+        //Replaces the content of the tree, the module is node 0. Syntax errors are collected in `get_errors`.
+        void parse();
+        //Same result as `parse` followed by `parse_bodies`, the skipped bodies are parsed in chunks of consecutive
+        //functions on the threads of `pool` and copied into the tree in function order. Bodies follow the outline
+        //instead of their functions. The errors are the same as for `parse`.
+        void parse(ThreadPool& pool);
+
+        //Parses the body of `function` if it was skipped and makes it the function's body, the nodes are appended to
+        //the tree. Its errors are added to `get_errors`.
+        void parse_body(ast::NodeIndex function);
+        void parse_bodies();
+
+        //Ordered by location, at most one per location
+        [[nodiscard]] inline const std::vector<ParseException>& get_errors() const noexcept { return _errors; }
+
+        //Bodies that were skipped and not requested since
+        [[nodiscard]] inline size_t get_skipped_bodies() const noexcept { return _lazy_bodies - _parsed_bodies; }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "../tokenize/token/token.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace karmac {
+    //Forward cursor over the tokens of a tokenizer. The type of the current token is cached, past the last token
+    //it is TokenType::EndOfFile.
+    class TokenCursor final {
+    private:
+        Token* const* _begin;
+        Token* const* _head;
+        Token* const* _end;
+        TokenType _type;
+
+        inline void update_type() noexcept {
+            _type = _head != _end ? (*_head)->get_type() : TokenType::EndOfFile;
+        }
+
+    public:
+        explicit TokenCursor(const std::vector<Token*>& tokens) noexcept : _begin(tokens.data()), _head(tokens.data()), _end(tokens.data() + tokens.size()) {
+            update_type();
+        }
+
+        [[nodiscard]] inline bool has_tokens() const noexcept {
+            return _head != _end;
+        }
+
+        [[nodiscard]] inline TokenType peek() const noexcept {
+            return _type;
+        }
+
+        [[nodiscard]] inline TokenType peek(size_t offset) const noexcept {
+            return offset < static_cast<size_t>(_end - _head) ? _head[offset]->get_type() : TokenType::EndOfFile;
+        }
+
+        [[nodiscard]] inline bool is(TokenType type) const noexcept {
+            return _type == type;
+        }
+
+        [[nodiscard]] inline uint32_t get_index() const noexcept {
+            return static_cast<uint32_t>(_head - _begin);
+        }
+
+        //nullptr past the last token
+        [[nodiscard]] inline const Token* get() const noexcept {
+            return _head != _end ? *_head : nullptr;
+        }
+
+        //Returns the index of the consumed token
+        inline uint32_t next() noexcept {
+            const auto index = get_index();
+            ++_head;
+            update_type();
+            return index;
+        }
+
+        inline void seek(uint32_t index) noexcept {
+            _head = _begin + std::min<ptrdiff_t>(index, _end - _begin);
+            update_type();
+        }
+
+        //Consumes the current token if it has `type`
+        [[nodiscard]] inline bool accept(TokenType type) noexcept {
+            if(_type != type) {
+                return false;
+            }
+
+            next();
+            return true;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,164 @@
+#include "resolver.hpp"
+#include "../tokenize/token/identifier_token.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+
+namespace karmac {
+    using ast::NodeIndex;
+    using ast::NodeKind;
+    using ast::TokenIndex;
+
+    uint32_t Resolver::get_symbol(TokenIndex token) const noexcept {
+        const auto& identifier = _tree->get_token(token);
+        karmac_assert(identifier.get_type() == TokenType::Identifier);
+        return static_cast<const IdentifierToken&>(identifier).get_symbol();
+    }
+
+    void Resolver::leave_scope() noexcept {
+        const auto start = _scopes.back();
+        _scopes.pop_back();
+
+        while(_bindings.size() > start) {
+            const auto& binding = _bindings.back();
+            _innermost[binding.symbol] = binding.previous;
+            _bindings.pop_back();
+        }
+    }
+
+    void Resolver::declare(TokenIndex name, NodeIndex declaration, bool unique) {
+        const auto symbol = get_symbol(name);
+        const auto previous = _innermost[symbol];
+
+        if(unique && previous != _NO_BINDING && previous >= _scopes.back()) {
+            _errors.push_back({ name, true });
+            return;
+        }
+
+        _innermost[symbol] = static_cast<uint32_t>(_bindings.size());
+        _bindings.push_back({ symbol, previous, declaration });
+    }
+
+    void Resolver::resolve(const ast::Tree& tree, size_t symbol_count) {
+        _tree = &tree;
+        _innermost.assign(symbol_count, _NO_BINDING);
+        _bindings.clear();
+        _scopes.clear();
+        _declarations.assign(tree.get_node_count(), ast::NO_NODE);
+        _errors.clear();
+
+        //All functions are visible before their declaration
+        enter_scope();
+        const auto functions = tree.get_children(ast::NO_NODE);
+        for(const auto function : functions) {
+            declare(tree.get_function(function).name, function, true);
+        }
+        for(const auto function : functions) {
+            resolve_function(function);
+        }
+        leave_scope();
+
+        //Declarations report their name after their value
+        std::stable_sort(_errors.begin(), _errors.end(), [](const Error& a, const Error& b) {
+            return a.name < b.name;
+        });
+    }
+
+    std::vector<Diagnostic> Resolver::get_errors() const {
+        std::vector<Diagnostic> errors;
+        errors.reserve(_errors.size());
+        for(const auto& error : _errors) {
+            const auto& token = _tree->get_token(error.name);
+            auto message = error.redeclared ? fmt::format("\"{}\" is already declared", token.to_string()) : fmt::format("\"{}\" is not declared", token.to_string());
+            errors.push_back({ token.get_location(), std::move(message) });
+        }
+        return errors;
+    }
+
+    void Resolver::resolve_function(NodeIndex function) {
+        const auto view = _tree->get_function(function);
+
+        enter_scope();
+        for(const auto parameter : view.parameters) {
+            declare(_tree->get_main_token(parameter), parameter, true);
+        }
+        resolve_node(view.body);
+        leave_scope();
+    }
+
+    void Resolver::resolve_node(NodeIndex node) {
+        if(node == ast::NO_NODE) {
+            return;
+        }
+
+        const auto& data = _tree->get_data(node);
+        switch(_tree->get_kind(node)) {
+            case NodeKind::Identifier: {
+                const auto token = _tree->get_main_token(node);
+                const auto binding = _innermost[get_symbol(token)];
+                if(binding == _NO_BINDING) {
+                    _errors.push_back({ token, false });
+                } else {
+                    _declarations[node] = _bindings[binding].declaration;
+                }
+                break;
+            }
+            case NodeKind::Unary:
+            case NodeKind::Postfix:
+            case NodeKind::Member:
+            case NodeKind::Return:
+                resolve_node(data.lhs);
+                break;
+            case NodeKind::Binary:
+            case NodeKind::Assignment:
+            case NodeKind::Index:
+            case NodeKind::While:
+                resolve_node(data.lhs);
+                resolve_node(data.rhs);
+                break;
+            case NodeKind::Conditional: {
+                const auto view = _tree->get_conditional(node);
+                resolve_node(view.condition);
+                resolve_node(view.then);
+                resolve_node(view.otherwise);
+                break;
+            }
+            case NodeKind::Call: {
+                const auto view = _tree->get_call(node);
+                resolve_node(view.callee);
+                for(const auto argument : view.arguments) {
+                    resolve_node(argument);
+                }
+                break;
+            }
+            case NodeKind::Block:
+                enter_scope();
+                for(const auto statement : _tree->get_children(node)) {
+                    resolve_node(statement);
+                }
+                leave_scope();
+                break;
+            case NodeKind::Declaration:
+                //The value still sees a shadowed name
+                resolve_node(data.rhs);
+                declare(_tree->get_main_token(node), node, false);
+                break;
+            case NodeKind::If: {
+                const auto view = _tree->get_if(node);
+                resolve_node(view.condition);
+                resolve_node(view.then);
+                resolve_node(view.otherwise);
+                break;
+            }
+            case NodeKind::For:
+                resolve_node(data.lhs);
+                enter_scope();
+                declare(_tree->get_for_variable(node), node, false);
+                resolve_node(data.rhs);
+                leave_scope();
+                break;
+            default:
+                break;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "../parse/ast/tree.hpp"
+#include "../source/diagnostic.hpp"
+#include <limits>
+#include <vector>
+
+namespace karmac {
+    //Binds every Identifier expression to the node that declares it: a Function, Parameter, Declaration or For.
+    //Names are compared by the symbols of their tokens only. Every symbol has a chain of its visible bindings, the
+    //innermost one is looked up in O(1) and leaving a scope pops the bindings made in it. Functions are visible in
+    //the whole module, all other names from the end of their declaration to the end of their block. Variables may
+    //shadow any name, functions and parameters must be unique in their scope.
+    //The tree has to outlive the results.
+    class Resolver final {
+    private:
+        static constexpr uint32_t _NO_BINDING = std::numeric_limits<uint32_t>::max();
+
+        struct Error {
+            ast::TokenIndex name;
+            bool redeclared;
+        };
+
+        struct Binding {
+            uint32_t symbol;
+            //Binding of the symbol in an enclosing scope
+            uint32_t previous;
+            ast::NodeIndex declaration;
+        };
+
+        const ast::Tree* _tree = nullptr;
+
+        //Innermost binding of each symbol
+        std::vector<uint32_t> _innermost;
+        std::vector<Binding> _bindings;
+        //Size of the binding stack when each open scope was entered
+        std::vector<uint32_t> _scopes;
+
+        std::vector<ast::NodeIndex> _declarations;
+        //Messages are only formatted on request, generated code can have an error for every few names
+        std::vector<Error> _errors;
+
+        [[nodiscard]] uint32_t get_symbol(ast::TokenIndex token) const noexcept;
+
+        inline void enter_scope() {
+            _scopes.push_back(static_cast<uint32_t>(_bindings.size()));
+        }
+
+        void leave_scope() noexcept;
+        //Unique names report a redeclaration in the same scope
+        void declare(ast::TokenIndex name, ast::NodeIndex declaration, bool unique);
+
+        void resolve_function(ast::NodeIndex function);
+        void resolve_node(ast::NodeIndex node);
+    public:
+        //Replaces the results with the ones of `tree`, the symbols of its identifiers have to be below `symbol_count`.
+        //Unparsed function bodies are skipped.
+        void resolve(const ast::Tree& tree, size_t symbol_count);
+
+        //Indexed by node, the declaration of each resolved Identifier and NO_NODE for all other nodes
+        [[nodiscard]] inline const std::vector<ast::NodeIndex>& get_declarations() const noexcept {
+            return _declarations;
+        }
+
+        [[nodiscard]] inline ast::NodeIndex get_declaration(ast::NodeIndex identifier) const noexcept {
+            return _declarations[identifier];
+        }
+
+        [[nodiscard]] inline size_t get_error_count() const noexcept {
+            return _errors.size();
+        }
+
+        //Undeclared and redeclared names in source order
+        [[nodiscard]] std::vector<Diagnostic> get_errors() const;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../util/text/source_location.hpp"
+#include <string>
+
+namespace karmac {
+    //An error of a pass that keeps going after it, the location is resolved by the SourceManager that owns the file
+    struct Diagnostic {
+        SourceLocation location;
+        std::string message;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "source_manager.hpp"
+#include "../util/io/file.hpp"
+#include "../util/text/text_iterator.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace karmac {
+    const std::vector<uint32_t>& SourceFile::get_line_starts() const {
+        std::call_once(_line_starts_flag, [this] {
+            _line_starts.push_back(0);
+
+            const auto* data = _text.data();
+            const auto* end = data + _text.size();
+            for(auto* p = data; (p = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)))) != nullptr; ++p) {
+                _line_starts.push_back(static_cast<uint32_t>(p - data + 1));
+            }
+        });
+        return _line_starts;
+    }
+
+    LineOffset SourceFile::get_line_offset(SourceLocation location) const {
+        const auto index = get_index(location);
+        const auto& line_starts = get_line_starts();
+
+        const auto line = std::upper_bound(line_starts.begin(), line_starts.end(), index) - line_starts.begin() - 1;
+
+        LineOffset line_offset(static_cast<size_t>(line), 0);
+        TextIterator::advance_line_offset(_text, line_starts[static_cast<size_t>(line)], index, line_offset);
+        return line_offset;
+    }
+
+    LineOffset LineOffsetCursor::get_line_offset(SourceLocation location) {
+        const auto index = _file.get_index(location);
+        if(index < _index) {
+            _index = index;
+            _line_offset = _file.get_line_offset(location);
+            return _line_offset;
+        }
+
+        TextIterator::advance_line_offset(_file.get_text(), _index, index, _line_offset);
+        _index = index;
+        return _line_offset;
+    }
+
+    const SourceFile& SourceManager::add_file(std::string path, std::string text) {
+        const std::unique_lock lock(_mutex);
+
+        //The end of file location is part of the range as well
+        if(_next_offset + text.size() + 1 > UINT32_MAX) {
+            throw std::runtime_error("Source space exhausted, the sources are larger than 4 GiB");
+        }
+
+        const SourceLocation start(static_cast<uint32_t>(_next_offset));
+        _next_offset += text.size() + 1;
+
+        return *_files.emplace_back(std::make_unique<SourceFile>(std::move(path), std::move(text), start));
+    }
+
+    const SourceFile& SourceManager::load_file(const std::filesystem::path& path) {
+        auto text = io::read_file(path);
+        return add_file(path.string(), std::move(text));
+    }
+
+    const SourceFile* SourceManager::find_file(SourceLocation location) const {
+        const std::shared_lock lock(_mutex);
+
+        const auto iterator = std::upper_bound(_files.begin(), _files.end(), location, [](SourceLocation location, const auto& file) {
+            return location < file->get_start();
+        });
+        if(iterator == _files.begin()) {
+            return nullptr;
+        }
+
+        const auto* file = std::prev(iterator)->get();
+        return file->contains(location) ? file : nullptr;
+    }
+
+    std::string SourceManager::to_string(SourceLocation location) const {
+        const auto* file = find_file(location);
+        if(file == nullptr) {
+            return "<unknown>";
+        }
+
+        const auto line_offset = file->get_line_offset(location);
+        return fmt::format("{}:{}:{}", file->get_path(), line_offset.line + 1, line_offset.offset + 1);
+    }
+
+    size_t SourceManager::get_file_count() const {
+        const std::shared_lock lock(_mutex);
+        return _files.size();
+    }
+}
\ No newline at end of file
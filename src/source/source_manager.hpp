@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../util/text/line_offset.hpp"
+#include "../util/text/source_location.hpp"
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac {
+    //A loaded file and its range [start, start + size] in the source space, the last location is its end of file
+    class SourceFile final {
+    private:
+        std::string _path;
+        std::string _text;
+        SourceLocation _start;
+
+        mutable std::once_flag _line_starts_flag;
+        mutable std::vector<uint32_t> _line_starts;
+
+        [[nodiscard]] const std::vector<uint32_t>& get_line_starts() const;
+    public:
+        SourceFile(std::string path, std::string text, SourceLocation start) noexcept
+            : _path(std::move(path)), _text(std::move(text)), _start(start) {}
+
+        [[nodiscard]] inline const std::string& get_path() const noexcept {
+            return _path;
+        }
+
+        //Null terminated like every std::string, as the tokenizer expects
+        [[nodiscard]] inline std::string_view get_text() const noexcept {
+            return _text;
+        }
+
+        [[nodiscard]] inline SourceLocation get_start() const noexcept {
+            return _start;
+        }
+
+        [[nodiscard]] inline SourceLocation get_end() const noexcept {
+            return _start + static_cast<uint32_t>(_text.size());
+        }
+
+        [[nodiscard]] inline bool contains(SourceLocation location) const noexcept {
+            return !(location < _start) && !(get_end() < location);
+        }
+
+        [[nodiscard]] inline uint32_t get_index(SourceLocation location) const noexcept {
+            return location.offset - _start.offset;
+        }
+
+        //Line and column as counted by TextIterator, the line table is built on first use
+        [[nodiscard]] LineOffset get_line_offset(SourceLocation location) const;
+    };
+
+    //Resolves line offsets of increasing locations of one file in amortized constant time
+    class LineOffsetCursor final {
+    private:
+        const SourceFile& _file;
+        uint32_t _index = 0;
+        LineOffset _line_offset;
+
+    public:
+        explicit LineOffsetCursor(const SourceFile& file) noexcept : _file(file) {}
+
+        [[nodiscard]] LineOffset get_line_offset(SourceLocation location);
+    };
+
+    //Owns all loaded files and assigns each a contiguous range of the 32-bit source space. Thread safe.
+    class SourceManager final {
+    private:
+        mutable std::shared_mutex _mutex;
+        std::vector<std::unique_ptr<SourceFile>> _files;
+        uint64_t _next_offset = 0;
+
+    public:
+        const SourceFile& add_file(std::string path, std::string text);
+        const SourceFile& load_file(const std::filesystem::path& path);
+
+        //Returns nullptr if no file contains `location`
+        [[nodiscard]] const SourceFile* find_file(SourceLocation location) const;
+
+        //Formats `location` as path:line:column
+        [[nodiscard]] std::string to_string(SourceLocation location) const;
+
+        [[nodiscard]] size_t get_file_count() const;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "lex_stats.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace karmac::tokenize {
+    LexStatistics& LexStatistics::operator +=(const LexStatistics& other) noexcept {
+        for(size_t i = 0; i < TOKEN_TYPE_COUNT; i++) {
+            tokens[i] += other.tokens[i];
+        }
+
+        source_bytes += other.source_bytes;
+        non_ascii_bytes += other.non_ascii_bytes;
+        comment_bytes += other.comment_bytes;
+        identifier_lookups += other.identifier_lookups;
+        identifier_bytes += other.identifier_bytes;
+        keyword_hits += other.keyword_hits;
+        string_literals += other.string_literals;
+        string_chars += other.string_chars;
+        string_escapes += other.string_escapes;
+        backtracks += other.backtracks;
+        return *this;
+    }
+
+    namespace lex_stats {
+        static std::mutex _statistics_mutex;
+        static std::vector<std::unique_ptr<LexStatistics>> _statistics;
+        static thread_local LexStatistics* _thread_statistics = nullptr;
+
+        LexStatistics& get_thread_statistics() {
+            if(_thread_statistics == nullptr) {
+                const std::lock_guard lock(_statistics_mutex);
+                _thread_statistics = _statistics.emplace_back(std::make_unique<LexStatistics>()).get();
+            }
+            return *_thread_statistics;
+        }
+
+        LexStatistics collect() {
+            const std::lock_guard lock(_statistics_mutex);
+
+            LexStatistics result;
+            for(const auto& statistics : _statistics) {
+                result += *statistics;
+            }
+            return result;
+        }
+
+        void print_report(std::FILE* file, const LexStatistics& statistics) {
+            if constexpr(!is_enabled()) {
+                fmt::print(file, "lexer statistics are not available, build with KARMAC_LEX_STATS=ON\n");
+                return;
+            }
+
+            const auto ratio = [](uint64_t value, uint64_t total) {
+                return total == 0 ? 0.0 : static_cast<double>(value) / static_cast<double>(total);
+            };
+
+            uint64_t total_tokens = 0;
+            for(const auto count : statistics.tokens) {
+                total_tokens += count;
+            }
+
+            fmt::print(file, "tokens: {}\n", total_tokens);
+
+            std::vector<size_t> order(LexStatistics::TOKEN_TYPE_COUNT);
+            for(size_t i = 0; i < order.size(); i++) {
+                order[i] = i;
+            }
+            std::stable_sort(order.begin(), order.end(), [&statistics](size_t a, size_t b) {
+                return statistics.tokens[a] > statistics.tokens[b];
+            });
+
+            for(const auto i : order) {
+                if(statistics.tokens[i] == 0) {
+                    break;
+                }
+                fmt::print(file, "  {:<22} {:>12} {:>6.2f}%\n", token_type::get_name(static_cast<TokenType>(i)), statistics.tokens[i],
+                           100.0 * ratio(statistics.tokens[i], total_tokens));
+            }
+
+            fmt::print(file, "identifiers: {} lookups, {:.2f} bytes on average, {:.2f}% keyword hits\n", statistics.identifier_lookups,
+                       ratio(statistics.identifier_bytes, statistics.identifier_lookups),
+                       100.0 * ratio(statistics.keyword_hits, statistics.identifier_lookups));
+            fmt::print(file, "strings: {} literals, {:.2f} chars on average, {:.2f}% escapes\n", statistics.string_literals,
+                       ratio(statistics.string_chars, statistics.string_literals), 100.0 * ratio(statistics.string_escapes, statistics.string_chars));
+            fmt::print(file, "source: {} bytes, {:.2f}% non-ascii, {:.2f}% comments\n", statistics.source_bytes,
+                       100.0 * ratio(statistics.non_ascii_bytes, statistics.source_bytes), 100.0 * ratio(statistics.comment_bytes, statistics.source_bytes));
+            fmt::print(file, "atom backtracks: {} ({:.2f} per token)\n", statistics.backtracks, ratio(statistics.backtracks, total_tokens));
+        }
+    }
+}
\ No newline at end of file
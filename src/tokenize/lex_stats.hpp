@@ -0,0 +1,57 @@
+#pragma once
+
+#include "token/token_type.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+//Counters of the lexer hot paths. They are only compiled in with KARMAC_LEX_STATS, otherwise
+//KARMAC_LEX_STAT expands to nothing.
+namespace karmac::tokenize {
+    struct LexStatistics {
+        static constexpr size_t TOKEN_TYPE_COUNT = token_type::COUNT;
+
+        std::array<uint64_t, TOKEN_TYPE_COUNT> tokens {};
+
+        uint64_t source_bytes = 0;
+        uint64_t non_ascii_bytes = 0;
+        uint64_t comment_bytes = 0;
+
+        uint64_t identifier_lookups = 0;
+        uint64_t identifier_bytes = 0;
+        uint64_t keyword_hits = 0;
+
+        uint64_t string_literals = 0;
+        uint64_t string_chars = 0;
+        uint64_t string_escapes = 0;
+
+        //Lookahead of tokenize::atom that had to step back again
+        uint64_t backtracks = 0;
+
+        LexStatistics& operator +=(const LexStatistics& other) noexcept;
+    };
+
+    namespace lex_stats {
+        [[nodiscard]] constexpr bool is_enabled() noexcept {
+#ifdef KARMAC_LEX_STATS
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        //Counters of the calling thread
+        [[nodiscard]] LexStatistics& get_thread_statistics();
+
+        //Sum of the counters of all threads that lexed so far
+        [[nodiscard]] LexStatistics collect();
+
+        void print_report(std::FILE* file, const LexStatistics& statistics);
+    }
+}
+
+#ifdef KARMAC_LEX_STATS
+#define KARMAC_LEX_STAT(statement) static_cast<void>(::karmac::tokenize::lex_stats::get_thread_statistics().statement)
+#else
+#define KARMAC_LEX_STAT(statement) static_cast<void>(0)
+#endif
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "token_dump.hpp"
+
+#include <stdexcept>
+
+namespace karmac::token_dump {
+    std::optional<Format> parse_format(const std::string_view& name) noexcept {
+        if(name == "text") {
+            return Format::Text;
+        }
+        if(name == "jsonl") {
+            return Format::JsonLines;
+        }
+        return std::nullopt;
+    }
+
+    TokenDumper::~TokenDumper() {
+        try {
+            flush();
+        } catch(...) {}
+    }
+
+    void TokenDumper::append_json_string(const std::string_view& text) {
+        _buffer.push_back('"');
+
+        auto begin = text.data();
+        for(auto p = text.data(); p != text.data() + text.size(); p++) {
+            const auto ch = static_cast<unsigned char>(*p);
+            if(ch >= 0x20 && ch != '"' && ch != '\\') {
+                continue;
+            }
+
+            _buffer.append(begin, p);
+            switch(ch) {
+                case '"':
+                    _buffer.append(std::string_view("\\\""));
+                    break;
+                case '\\':
+                    _buffer.append(std::string_view("\\\\"));
+                    break;
+                case '\n':
+                    _buffer.append(std::string_view("\\n"));
+                    break;
+                case '\r':
+                    _buffer.append(std::string_view("\\r"));
+                    break;
+                case '\t':
+                    _buffer.append(std::string_view("\\t"));
+                    break;
+                default:
+                    fmt::format_to(std::back_inserter(_buffer), "\\u{:04x}", ch);
+                    break;
+            }
+            begin = p + 1;
+        }
+        _buffer.append(begin, text.data() + text.size());
+
+        _buffer.push_back('"');
+    }
+
+    void TokenDumper::dump(SourceLocation location, TokenType type, const std::string_view& text) {
+        const auto line_offset = _cursor.get_line_offset(location);
+        const auto line = line_offset.line + 1;
+        const auto column = line_offset.offset + 1;
+
+        switch(_format) {
+            case Format::Text:
+                fmt::format_to(std::back_inserter(_buffer), "[{}:{}] {}:", line, column, token_type::get_name(type));
+                _buffer.append(text);
+                _buffer.push_back('\n');
+                break;
+            case Format::JsonLines:
+                fmt::format_to(std::back_inserter(_buffer), R"({{"line":{},"column":{},"index":{},"kind":"{}","text":)", line, column,
+                               _source.get_index(location), token_type::get_name(type));
+                append_json_string(text);
+                _buffer.append(std::string_view("}\n"));
+                break;
+        }
+
+        if(_file != nullptr && _buffer.size() >= _FLUSH_SIZE) {
+            flush();
+        }
+    }
+
+    void TokenDumper::flush() {
+        if(_file == nullptr || _buffer.size() == 0) {
+            return;
+        }
+
+        const auto size = _buffer.size();
+        const auto written = std::fwrite(_buffer.data(), 1, size, _file);
+        _buffer.clear();
+
+        if(written != size) {
+            throw std::runtime_error("Failed to write token dump");
+        }
+    }
+}
\ No newline at end of file
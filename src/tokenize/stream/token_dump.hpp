@@ -0,0 +1,67 @@
+#pragma once
+
+#include "../token/token.hpp"
+#include "token_stream.hpp"
+#include "../../source/source_manager.hpp"
+
+#include <fmt/format.h>
+#include <cstdio>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace karmac::token_dump {
+    enum class Format {
+        Text,
+        JsonLines
+    };
+
+    [[nodiscard]] std::optional<Format> parse_format(const std::string_view& name) noexcept;
+
+    //Formats the tokens of one source file into a memory buffer and writes it in large blocks instead of once per token.
+    //Without a file the whole dump stays in the buffer.
+    class TokenDumper final {
+    private:
+        static constexpr size_t _FLUSH_SIZE = 1024 * 1024;
+
+        std::FILE* _file;
+        Format _format;
+        const SourceFile& _source;
+        LineOffsetCursor _cursor;
+        fmt::memory_buffer _buffer;
+
+        void append_json_string(const std::string_view& text);
+
+    public:
+        TokenDumper(std::FILE* file, Format format, const SourceFile& source) noexcept
+            : _file(file), _format(format), _source(source), _cursor(source) {}
+        TokenDumper(Format format, const SourceFile& source) noexcept : _file(nullptr), _format(format), _source(source), _cursor(source) {}
+        TokenDumper(const TokenDumper&) = delete;
+        ~TokenDumper();
+
+        TokenDumper& operator =(const TokenDumper&) = delete;
+
+        //Tokens are expected in source order, the line offsets are then resolved in amortized constant time
+        void dump(SourceLocation location, TokenType type, const std::string_view& text);
+
+        inline void dump(const Token& token) {
+            dump(token.get_location(), token.get_type(), token.to_string());
+        }
+
+        inline void dump(const token_stream::TokenRecord& record) {
+            dump(record.location, record.type, token_stream::to_string(record));
+        }
+
+        inline void dump(const std::vector<Token*>& tokens) {
+            for(const auto* token : tokens) {
+                dump(*token);
+            }
+        }
+
+        void flush();
+
+        [[nodiscard]] inline std::string_view get_buffer() const noexcept {
+            return { _buffer.data(), _buffer.size() };
+        }
+    };
+}
\ No newline at end of file
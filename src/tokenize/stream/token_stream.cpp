@@ -0,0 +1,229 @@
+#include "token_stream.hpp"
+#include "../token/literal_token.hpp"
+#include "../../util/io/mapped_file.hpp"
+#include "../../util/text/string_interner.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace karmac::token_stream {
+    static uint64_t get_integer_value(const Token* token) {
+        switch(token->get_type()) {
+            case TokenType::U8Literal:
+                return static_cast<const U8LiteralToken*>(token)->get_value();
+            case TokenType::I8Literal:
+                return static_cast<uint64_t>(static_cast<const I8LiteralToken*>(token)->get_value());
+            case TokenType::U16Literal:
+                return static_cast<const U16LiteralToken*>(token)->get_value();
+            case TokenType::I16Literal:
+                return static_cast<uint64_t>(static_cast<const I16LiteralToken*>(token)->get_value());
+            case TokenType::U32Literal:
+                return static_cast<const U32LiteralToken*>(token)->get_value();
+            case TokenType::I32Literal:
+                return static_cast<uint64_t>(static_cast<const I32LiteralToken*>(token)->get_value());
+            case TokenType::U64Literal:
+                return static_cast<const U64LiteralToken*>(token)->get_value();
+            case TokenType::I64Literal:
+                return static_cast<uint64_t>(static_cast<const I64LiteralToken*>(token)->get_value());
+            case TokenType::USizeLiteral:
+                return static_cast<const USizeLiteralToken*>(token)->get_value();
+            case TokenType::ISizeLiteral:
+                return static_cast<uint64_t>(static_cast<const ISizeLiteralToken*>(token)->get_value());
+            case TokenType::IntegerLiteral:
+                return static_cast<const IntegerLiteralToken*>(token)->get_value();
+            default:
+                karmac_unimplemented();
+                return 0;
+        }
+    }
+
+    static double get_float_value(const Token* token) {
+        switch(token->get_type()) {
+            case TokenType::F32Literal:
+                return static_cast<const F32LiteralToken*>(token)->get_value();
+            case TokenType::FloatLiteral:
+                return static_cast<const FloatLiteralToken*>(token)->get_value();
+            default:
+                return static_cast<const F64LiteralToken*>(token)->get_value();
+        }
+    }
+
+    static void align(std::string& buffer, size_t alignment) {
+        buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, '\0');
+    }
+
+    std::string to_string(const TokenRecord& record) {
+        switch(record.type) {
+            case TokenType::Identifier:
+            case TokenType::StringLiteral:
+                return std::string(record.string);
+            case TokenType::U8Literal:
+            case TokenType::U16Literal:
+            case TokenType::U32Literal:
+            case TokenType::U64Literal:
+            case TokenType::USizeLiteral:
+            case TokenType::IntegerLiteral:
+                return std::to_string(record.integer);
+            case TokenType::I8Literal:
+            case TokenType::I16Literal:
+            case TokenType::I32Literal:
+            case TokenType::I64Literal:
+            case TokenType::ISizeLiteral:
+                return std::to_string(static_cast<int64_t>(record.integer));
+            case TokenType::F32Literal:
+                return std::to_string(static_cast<float>(record.floating));
+            case TokenType::F64Literal:
+            case TokenType::FloatLiteral:
+                return std::to_string(record.floating);
+            default:
+                return std::string(token_type::to_string(record.type));
+        }
+    }
+
+    std::string serialize(const std::vector<Token*>& tokens, SourceLocation base, size_t source_size) {
+        Header header;
+        header.token_count = tokens.size();
+        header.source_size = source_size;
+
+        std::string kinds;
+        std::string offsets;
+        std::string values;
+        std::string integers;
+        std::string floats;
+        StringInterner strings;
+
+        kinds.reserve(tokens.size());
+        offsets.reserve(tokens.size() * sizeof(uint32_t));
+        values.reserve(tokens.size() * sizeof(uint32_t));
+
+        for(const auto* token : tokens) {
+            const auto type = token->get_type();
+            kinds += static_cast<char>(type);
+            endian::write_le(offsets, static_cast<uint32_t>(token->get_location().offset - base.offset));
+
+            uint32_t value = 0;
+            if(type == TokenType::Identifier || type == TokenType::StringLiteral) {
+                value = strings.intern(token->to_string());
+            } else if(token_type::is_integer_literal(type)) {
+                value = static_cast<uint32_t>(header.integer_count++);
+                endian::write_le(integers, get_integer_value(token));
+            } else if(token_type::is_float_literal(type)) {
+                value = static_cast<uint32_t>(header.float_count++);
+                endian::write_le(floats, get_float_value(token));
+            }
+            endian::write_le(values, value);
+        }
+
+        std::string buffer(Header::SIZE, '\0');
+
+        header.kinds_offset = buffer.size();
+        buffer += kinds;
+
+        align(buffer, sizeof(uint32_t));
+        header.offsets_offset = buffer.size();
+        buffer += offsets;
+
+        header.values_offset = buffer.size();
+        buffer += values;
+
+        header.string_count = strings.size();
+        header.string_offsets_offset = buffer.size();
+
+        uint32_t string_offset = 0;
+        endian::write_le(buffer, string_offset);
+        for(uint32_t i = 0; i < strings.size(); i++) {
+            string_offset += static_cast<uint32_t>(strings.get(i).size());
+            endian::write_le(buffer, string_offset);
+        }
+
+        header.string_data_offset = buffer.size();
+        header.string_data_size = string_offset;
+        for(uint32_t i = 0; i < strings.size(); i++) {
+            buffer += strings.get(i);
+        }
+
+        align(buffer, sizeof(uint64_t));
+        header.integer_pool_offset = buffer.size();
+        buffer += integers;
+
+        header.float_pool_offset = buffer.size();
+        buffer += floats;
+
+        std::string header_bytes(MAGIC, sizeof(MAGIC));
+        endian::write_le(header_bytes, VERSION);
+        for(const auto field : { header.token_count, header.source_size, header.string_count, header.integer_count, header.float_count,
+                                 header.kinds_offset, header.offsets_offset, header.values_offset, header.string_offsets_offset,
+                                 header.string_data_offset, header.string_data_size, header.integer_pool_offset, header.float_pool_offset }) {
+            endian::write_le(header_bytes, field);
+        }
+        karmac_assert(header_bytes.size() == Header::SIZE);
+        buffer.replace(0, Header::SIZE, header_bytes);
+
+        return buffer;
+    }
+
+    void save(const std::vector<Token*>& tokens, SourceLocation base, size_t source_size, const std::filesystem::path& path) {
+        const auto buffer = serialize(tokens, base, source_size);
+
+        std::ofstream output_stream(path, std::ios_base::binary | std::ios_base::trunc);
+        output_stream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+        if(output_stream.fail()) {
+            throw std::runtime_error("Failed to write token stream");
+        }
+    }
+
+    TokenStreamView load(const MappedFile& file, SourceLocation base) {
+        return TokenStreamView(file.get_data(), base);
+    }
+
+    TokenStreamView::TokenStreamView(const std::string_view& data, SourceLocation base) : _data(data), _base(base) {
+        if(data.size() < Header::SIZE || data.substr(0, sizeof(MAGIC)) != std::string_view(MAGIC, sizeof(MAGIC))) {
+            throw std::runtime_error("Not a token stream");
+        }
+        if(endian::read_le<uint32_t>(data.data() + sizeof(MAGIC)) != VERSION) {
+            throw std::runtime_error("Unsupported token stream version");
+        }
+
+        auto* field = data.data() + sizeof(MAGIC) + sizeof(uint32_t);
+        for(auto* value : { &_header.token_count, &_header.source_size, &_header.string_count, &_header.integer_count, &_header.float_count,
+                            &_header.kinds_offset, &_header.offsets_offset, &_header.values_offset, &_header.string_offsets_offset,
+                            &_header.string_data_offset, &_header.string_data_size, &_header.integer_pool_offset,
+                            &_header.float_pool_offset }) {
+            *value = endian::read_le<uint64_t>(field);
+            field += sizeof(uint64_t);
+        }
+
+        const auto fits = [&data](uint64_t offset, uint64_t count, uint64_t element_size) {
+            return offset <= data.size() && count <= (data.size() - offset) / element_size;
+        };
+
+        if(!fits(_header.kinds_offset, _header.token_count, 1)
+           || !fits(_header.offsets_offset, _header.token_count, sizeof(uint32_t))
+           || !fits(_header.values_offset, _header.token_count, sizeof(uint32_t))
+           || _header.source_size > UINT32_MAX
+           || _header.string_count >= UINT32_MAX
+           || !fits(_header.string_offsets_offset, _header.string_count + 1, sizeof(uint32_t))
+           || !fits(_header.string_data_offset, _header.string_data_size, 1)
+           || !fits(_header.integer_pool_offset, _header.integer_count, sizeof(uint64_t))
+           || !fits(_header.float_pool_offset, _header.float_count, sizeof(double))) {
+            throw std::runtime_error("Corrupted token stream");
+        }
+    }
+
+    TokenRecord TokenStreamView::get_record(size_t index) const {
+        TokenRecord record;
+        record.type = get_type(index);
+        record.location = get_location(index);
+
+        const auto value = get_value(index);
+        if(record.type == TokenType::Identifier || record.type == TokenType::StringLiteral) {
+            record.string = get_string(value);
+        } else if(token_type::is_integer_literal(record.type)) {
+            record.integer = get_integer(value);
+        } else if(token_type::is_float_literal(record.type)) {
+            record.floating = get_float(value);
+        }
+        return record;
+    }
+}
\ No newline at end of file
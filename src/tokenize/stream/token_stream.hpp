@@ -0,0 +1,179 @@
+#pragma once
+
+#include "../token/token.hpp"
+#include "../../util/io/endian.hpp"
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace karmac {
+    class MappedFile;
+}
+
+//Binary token stream format, all integers are little endian. Every per token column has fixed-width entries, so any
+//token can be read without decoding the ones in front of it:
+//  header
+//  kinds           uint8_t per token
+//  offsets         uint32_t per token: offset of the token relative to the start of the file, 4-byte aligned
+//  values          uint32_t per token: string id of identifiers and string literals, pool index of other literals
+//  string offsets  uint32_t[string_count + 1]
+//  string data     interned identifiers and string literals
+//  integer pool    uint64_t per integer literal, 8-byte aligned
+//  float pool      double per float literal, 8-byte aligned
+namespace karmac::token_stream {
+    static constexpr char MAGIC[4] = { 'K', 'T', 'O', 'K' };
+    static constexpr uint32_t VERSION = 4;
+
+    struct Header {
+    public:
+        static constexpr size_t SIZE = sizeof(MAGIC) + sizeof(uint32_t) + 13 * sizeof(uint64_t);
+
+        uint64_t token_count = 0;
+        uint64_t source_size = 0;
+        uint64_t string_count = 0;
+        uint64_t integer_count = 0;
+        uint64_t float_count = 0;
+        uint64_t kinds_offset = 0;
+        uint64_t offsets_offset = 0;
+        uint64_t values_offset = 0;
+        uint64_t string_offsets_offset = 0;
+        uint64_t string_data_offset = 0;
+        uint64_t string_data_size = 0;
+        uint64_t integer_pool_offset = 0;
+        uint64_t float_pool_offset = 0;
+    };
+
+    //A token read from the stream, strings point into the stream's memory
+    struct TokenRecord {
+        TokenType type = TokenType::Identifier;
+        SourceLocation location;
+        std::string_view string;
+        uint64_t integer = 0;
+        double floating = 0.0;
+    };
+
+    //Indexes a serialized token stream in place, strings are views into the underlying memory. The header and the
+    //section bounds are validated up front, the entries of a token when it is read.
+    class TokenStreamView final {
+    private:
+        std::string_view _data;
+        Header _header;
+        SourceLocation _base;
+
+    public:
+        class Iterator final {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using difference_type = std::ptrdiff_t;
+            using value_type = TokenRecord;
+        private:
+            const TokenStreamView* _view = nullptr;
+            size_t _index = 0;
+        public:
+            Iterator() noexcept = default;
+            Iterator(const TokenStreamView* view, size_t index) noexcept : _view(view), _index(index) {}
+
+            [[nodiscard]] inline TokenRecord operator *() const {
+                return _view->get_record(_index);
+            }
+
+            inline Iterator& operator ++() noexcept {
+                ++_index;
+                return *this;
+            }
+
+            [[nodiscard]] inline bool operator ==(const Iterator& other) const noexcept {
+                return _index == other._index;
+            }
+
+            [[nodiscard]] inline bool operator !=(const Iterator& other) const noexcept {
+                return _index != other._index;
+            }
+        };
+
+        //Validates the header and section bounds, throws if `data` isn't a token stream of this version.
+        //Locations of the tokens start at `base`.
+        explicit TokenStreamView(const std::string_view& data, SourceLocation base = SourceLocation());
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return _header.token_count;
+        }
+
+        [[nodiscard]] inline size_t get_source_size() const noexcept {
+            return _header.source_size;
+        }
+
+        [[nodiscard]] inline size_t get_string_count() const noexcept {
+            return _header.string_count;
+        }
+
+        //Throws for kinds that aren't tokens
+        [[nodiscard]] inline TokenType get_type(size_t index) const {
+            const auto type = static_cast<TokenType>(_data[_header.kinds_offset + index]);
+            if(type > TokenType::StringLiteral) {
+                throw std::runtime_error("Invalid token type in token stream");
+            }
+            return type;
+        }
+
+        [[nodiscard]] inline SourceLocation get_location(size_t index) const noexcept {
+            return _base + endian::read_le<uint32_t>(_data.data() + _header.offsets_offset + index * sizeof(uint32_t));
+        }
+
+        //String id or pool index of the token, depending on its type
+        [[nodiscard]] inline uint32_t get_value(size_t index) const noexcept {
+            return endian::read_le<uint32_t>(_data.data() + _header.values_offset + index * sizeof(uint32_t));
+        }
+
+        [[nodiscard]] inline std::string_view get_string(uint64_t id) const {
+            if(id >= _header.string_count) {
+                throw std::runtime_error("Invalid string id in token stream");
+            }
+
+            const auto* offsets = _data.data() + _header.string_offsets_offset;
+            const auto begin = endian::read_le<uint32_t>(offsets + id * sizeof(uint32_t));
+            const auto end = endian::read_le<uint32_t>(offsets + (id + 1) * sizeof(uint32_t));
+            if(begin > end || end > _header.string_data_size) {
+                throw std::runtime_error("Invalid string offset in token stream");
+            }
+
+            return _data.substr(_header.string_data_offset + begin, end - begin);
+        }
+
+        [[nodiscard]] inline uint64_t get_integer(uint64_t index) const {
+            if(index >= _header.integer_count) {
+                throw std::runtime_error("Invalid integer index in token stream");
+            }
+            return endian::read_le<uint64_t>(_data.data() + _header.integer_pool_offset + index * sizeof(uint64_t));
+        }
+
+        [[nodiscard]] inline double get_float(uint64_t index) const {
+            if(index >= _header.float_count) {
+                throw std::runtime_error("Invalid float index in token stream");
+            }
+            return endian::read_le<double>(_data.data() + _header.float_pool_offset + index * sizeof(double));
+        }
+
+        [[nodiscard]] TokenRecord get_record(size_t index) const;
+
+        [[nodiscard]] inline Iterator begin() const noexcept {
+            return { this, 0 };
+        }
+
+        [[nodiscard]] inline Iterator end() const noexcept {
+            return { this, size() };
+        }
+    };
+
+    //Same text as Token::to_string() of the token the record was created from
+    [[nodiscard]] std::string to_string(const TokenRecord& record);
+
+    //Locations are stored relative to `base`, the location of the first char of the source
+    [[nodiscard]] std::string serialize(const std::vector<Token*>& tokens, SourceLocation base, size_t source_size);
+    void save(const std::vector<Token*>& tokens, SourceLocation base, size_t source_size, const std::filesystem::path& path);
+
+    //The returned view borrows the mapping, `file` has to outlive it
+    [[nodiscard]] TokenStreamView load(const MappedFile& file, SourceLocation base = SourceLocation());
+}
\ No newline at end of file
@@ -3,17 +3,21 @@
 #include "token.hpp"
 
 namespace karmac {
+    //The symbol is the id of the identifier in the interner of its tokenizer, equal identifiers have equal symbols
     class IdentifierToken final : public Token {
     private:
-        std::string _identifier;
+        //Declared first, so it fits into the padding behind the location
+        uint32_t _symbol;
+        std::string_view _identifier;
 
     public:
-        IdentifierToken(std::string identifier, LineOffset line_offset) noexcept
-                : _identifier(std::move(identifier)), Token(line_offset) {}
-        IdentifierToken(std::string identifier, const TextIterator& iterator) noexcept
-                : _identifier(std::move(identifier)), Token(iterator) {}
+        IdentifierToken(std::string_view identifier, uint32_t symbol, SourceLocation location) noexcept
+                : Token(location), _symbol(symbol), _identifier(identifier) {}
+        IdentifierToken(std::string_view identifier, uint32_t symbol, const TextIterator& iterator) noexcept
+                : Token(iterator), _symbol(symbol), _identifier(identifier) {}
 
         [[nodiscard]] TokenType get_type() const noexcept final { return TokenType::Identifier; }
         [[nodiscard]] std::string_view to_string() const noexcept final { return _identifier; }
+        [[nodiscard]] inline uint32_t get_symbol() const noexcept { return _symbol; }
     };
 }
\ No newline at end of file
@@ -1,20 +1,35 @@
 #pragma once
 
 #include "token.hpp"
-#include <string>
+#include "../../util/memory/arena.hpp"
+
+#include <fmt/format.h>
+#include <string_view>
 
 namespace karmac {
     template<typename T, TokenType Type>
     class LiteralToken : public Token {
     private:
         T _value;
-        std::string _value_str;
+        std::string_view _value_str;
+
+        //Same text as std::to_string, stored in the arena of the token
+        [[nodiscard]] static std::string_view format_value(T value, Arena& arena) {
+            fmt::memory_buffer buffer;
+            if constexpr(std::is_floating_point_v<T>) {
+                fmt::format_to(std::back_inserter(buffer), "{:f}", static_cast<double>(value));
+            } else {
+                fmt::format_to(std::back_inserter(buffer), "{}", value);
+            }
+            return arena.copy({ buffer.data(), buffer.size() });
+        }
 
     public:
-        LiteralToken(T value, LineOffset line_offset) noexcept : _value(value), _value_str(std::to_string(value)), Token(line_offset) {}
-        LiteralToken(T value, const TextIterator& iterator) noexcept : _value(value), _value_str(std::to_string(value)), Token(iterator) {}
+        LiteralToken(T value, Arena& arena, SourceLocation location) : _value(value), _value_str(format_value(value, arena)), Token(location) {}
+        LiteralToken(T value, Arena& arena, const TextIterator& iterator) : _value(value), _value_str(format_value(value, arena)), Token(iterator) {}
 
         [[nodiscard]] TokenType get_type() const noexcept final { return Type; }
+        [[nodiscard]] inline T get_value() const noexcept { return _value; }
 
         [[nodiscard]] std::string_view to_string() const noexcept final {
             return _value_str;
@@ -33,4 +48,6 @@ namespace karmac {
     using ISizeLiteralToken = LiteralToken<ptrdiff_t, TokenType::ISizeLiteral>;
     using F32LiteralToken = LiteralToken<float, TokenType::F32Literal>;
     using F64LiteralToken = LiteralToken<double, TokenType::F64Literal>;
+    using IntegerLiteralToken = LiteralToken<uint64_t, TokenType::IntegerLiteral>;
+    using FloatLiteralToken = LiteralToken<double, TokenType::FloatLiteral>;
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace karmac {
         TokenType _type;
 
     public:
-        SimpleToken(TokenType type, LineOffset line_offset) noexcept : _type(type), Token(line_offset) {}
+        SimpleToken(TokenType type, SourceLocation location) noexcept : _type(type), Token(location) {}
         SimpleToken(TokenType type, const TextIterator& iterator) noexcept : _type(type), Token(iterator) {}
 
         [[nodiscard]] TokenType get_type() const noexcept final { return _type; }
@@ -4,17 +4,22 @@
 #include "../../util/text/text_iterator.hpp"
 
 namespace karmac {
+    //Tokens live in the arena of their tokenizer and are never destroyed individually,
+    //so they must not own any memory
     class Token {
     protected:
-        LineOffset _line_offset;
+        SourceLocation _location;
+
+        ~Token() = default;
     public:
-        Token(LineOffset line_offset) noexcept : _line_offset(line_offset) {}
-        explicit Token(const TextIterator& iterator) noexcept : _line_offset(iterator.get_line_offset()) {}
-        virtual ~Token() {}
+        Token(SourceLocation location) noexcept : _location(location) {}
+        explicit Token(const TextIterator& iterator) noexcept : _location(iterator.get_location()) {}
 
         [[nodiscard]] virtual TokenType get_type() const noexcept = 0;
         [[nodiscard]] virtual std::string_view to_string() const noexcept = 0;
 
-        [[nodiscard]] inline LineOffset get_line_offset() const noexcept { return _line_offset; }
+        [[nodiscard]] inline SourceLocation get_location() const noexcept { return _location; }
+
+        inline void set_location(SourceLocation location) noexcept { _location = location; }
     };
 }
\ No newline at end of file
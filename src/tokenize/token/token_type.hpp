@@ -1,9 +1,12 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string_view>
 
 namespace karmac {
-    enum class TokenType {
+    enum class TokenType : uint8_t {
         //Brackets
         LeftBracket,
         RightBracket,
@@ -78,11 +81,271 @@ namespace karmac {
         ISizeLiteral,
         F32Literal,
         F64Literal,
-        StringLiteral
+        //Unsuffixed literals, their type is decided by the type checker
+        IntegerLiteral,
+        FloatLiteral,
+        StringLiteral,
+
+        //Never produced by the tokenizer, returned by the parser past the last token
+        EndOfFile
     };
 
     namespace token_type {
-        [[nodiscard]] std::string_view get_name(TokenType type) noexcept;
-        [[nodiscard]] std::string_view to_string(TokenType type) noexcept;
+        static constexpr size_t COUNT = static_cast<size_t>(TokenType::EndOfFile) + 1;
+
+        enum Flags : uint8_t {
+            None = 0,
+            Bracket = 1 << 0,
+            Operator = 1 << 1,
+            Keyword = 1 << 2,
+            Literal = 1 << 3,
+            IntegerLiteral = 1 << 4,
+            FloatLiteral = 1 << 5,
+            //Compound and plain assignments
+            Assignment = 1 << 6,
+            //Can start an expression, operators with this flag are unary prefix operators
+            Prefix = 1 << 7
+        };
+
+        //Binding strength of binary operators, higher binds tighter
+        enum class Precedence : uint8_t {
+            None,
+            Assignment,
+            Conditional,
+            Range,
+            Disjunction,
+            Conjunction,
+            BitwiseOr,
+            BitwiseXor,
+            BitwiseAnd,
+            Equality,
+            Comparison,
+            Shift,
+            Additive,
+            Multiplicative
+        };
+
+        enum class Associativity : uint8_t {
+            None,
+            Left,
+            Right
+        };
+
+        struct TokenInfo {
+            std::string_view name;
+            //Source spelling, the name for tokens without a fixed one
+            std::string_view spelling;
+            uint8_t flags = None;
+            Precedence precedence = Precedence::None;
+            Associativity associativity = Associativity::None;
+        };
+
+        [[nodiscard]] constexpr std::array<TokenInfo, COUNT> make_infos() noexcept {
+            std::array<TokenInfo, COUNT> infos {};
+            const auto set = [&infos](TokenType type, TokenInfo info) {
+                infos[static_cast<size_t>(type)] = info;
+            };
+            const auto binary = [&set](TokenType type, std::string_view name, std::string_view spelling, Precedence precedence, uint8_t flags = None) {
+                const auto associativity = precedence == Precedence::Assignment ? Associativity::Right
+                                         : precedence == Precedence::Range ? Associativity::None : Associativity::Left;
+                set(type, { name, spelling, static_cast<uint8_t>(Operator | flags), precedence, associativity });
+            };
+            const auto assignment = [&set](TokenType type, std::string_view name, std::string_view spelling) {
+                set(type, { name, spelling, Operator | Assignment, Precedence::Assignment, Associativity::Right });
+            };
+
+            set(TokenType::LeftBracket, { "left_bracket", "(", Bracket | Prefix });
+            set(TokenType::RightBracket, { "right_bracket", ")", Bracket });
+            set(TokenType::LeftSquareBracket, { "left_square_bracket", "[", Bracket });
+            set(TokenType::RightSquareBracket, { "right_square_bracket", "]", Bracket });
+            set(TokenType::LeftCurlyBracket, { "left_curly_bracket", "{", Bracket });
+            set(TokenType::RightCurlyBracket, { "right_curly_bracket", "}", Bracket });
+
+            set(TokenType::Dot, { "dot", ".", Operator });
+            binary(TokenType::DoubleDot, "double_dot", "..", Precedence::Range);
+            set(TokenType::Comma, { "comma", ",", Operator });
+            set(TokenType::Colon, { "colon", ":", Operator });
+            set(TokenType::DoubleColon, { "double_colon", "::", Operator });
+            set(TokenType::Semicolon, { "semicolon", ";", Operator });
+            assignment(TokenType::Assign, "assign", "=");
+            set(TokenType::Not, { "not", "!", Operator | Prefix });
+            set(TokenType::Arrow, { "arrow", "->", Operator });
+            set(TokenType::QuestionMark, { "question_mark", "?", Operator, Precedence::Conditional, Associativity::Right });
+            binary(TokenType::Less, "less", "<", Precedence::Comparison);
+            binary(TokenType::LessEquals, "less_equals", "<=", Precedence::Comparison);
+            binary(TokenType::Greater, "greater", ">", Precedence::Comparison);
+            binary(TokenType::GreaterEquals, "greater_equals", ">=", Precedence::Comparison);
+            binary(TokenType::Equals, "equals", "==", Precedence::Equality);
+            binary(TokenType::NotEquals, "not_equals", "!=", Precedence::Equality);
+            binary(TokenType::Conjunction, "conjunction", "&&", Precedence::Conjunction);
+            binary(TokenType::Disjunction, "disjunction", "||", Precedence::Disjunction);
+            binary(TokenType::And, "and", "&", Precedence::BitwiseAnd);
+            assignment(TokenType::AndAssign, "and_assign", "&=");
+            binary(TokenType::Or, "or", "|", Precedence::BitwiseOr);
+            assignment(TokenType::OrAssign, "or_assign", "|=");
+            binary(TokenType::Xor, "xor", "^", Precedence::BitwiseXor);
+            assignment(TokenType::XorAssign, "xor_assign", "^=");
+            binary(TokenType::LeftShift, "left_shift", "<<", Precedence::Shift);
+            assignment(TokenType::LeftShiftAssign, "left_shift_assign", "<<=");
+            binary(TokenType::RightShift, "right_shift", ">>", Precedence::Shift);
+            assignment(TokenType::RightShiftAssign, "right_shift_assign", ">>=");
+            set(TokenType::Increment, { "increment", "++", Operator | Prefix });
+            set(TokenType::Decrement, { "decrement", "--", Operator | Prefix });
+            binary(TokenType::Add, "add", "+", Precedence::Additive, Prefix);
+            assignment(TokenType::AddAssign, "add_assign", "+=");
+            binary(TokenType::Sub, "sub", "-", Precedence::Additive, Prefix);
+            assignment(TokenType::SubAssign, "sub_assign", "-=");
+            binary(TokenType::Mul, "mul", "*", Precedence::Multiplicative);
+            assignment(TokenType::MulAssign, "mul_assign", "*=");
+            binary(TokenType::Div, "div", "/", Precedence::Multiplicative);
+            assignment(TokenType::DivAssign, "div_assign", "/=");
+            binary(TokenType::Mod, "mod", "%", Precedence::Multiplicative);
+            assignment(TokenType::ModAssign, "mod_assign", "%=");
+
+            set(TokenType::Identifier, { "identifier", "identifier", Prefix });
+            set(TokenType::Fn, { "fn", "fn", Keyword });
+            set(TokenType::If, { "if", "if", Keyword });
+            set(TokenType::Else, { "else", "else", Keyword });
+            set(TokenType::For, { "for", "for", Keyword });
+            set(TokenType::While, { "while", "while", Keyword });
+            set(TokenType::Break, { "break", "break", Keyword });
+            set(TokenType::Continue, { "continue", "continue", Keyword });
+            set(TokenType::Return, { "return", "return", Keyword });
+
+            set(TokenType::U8Literal, { "u8_literal", "u8_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::I8Literal, { "i8_literal", "i8_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::U16Literal, { "u16_literal", "u16_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::I16Literal, { "i16_literal", "i16_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::U32Literal, { "u32_literal", "u32_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::I32Literal, { "i32_literal", "i32_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::U64Literal, { "u64_literal", "u64_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::I64Literal, { "i64_literal", "i64_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::USizeLiteral, { "usize_literal", "usize_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::ISizeLiteral, { "isize_literal", "isize_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::F32Literal, { "f32_literal", "f32_literal", Literal | FloatLiteral | Prefix });
+            set(TokenType::F64Literal, { "f64_literal", "f64_literal", Literal | FloatLiteral | Prefix });
+            set(TokenType::IntegerLiteral, { "integer_literal", "integer_literal", Literal | IntegerLiteral | Prefix });
+            set(TokenType::FloatLiteral, { "float_literal", "float_literal", Literal | FloatLiteral | Prefix });
+            set(TokenType::StringLiteral, { "string_literal", "string_literal", Literal | Prefix });
+
+            set(TokenType::EndOfFile, { "end_of_file", "end of file" });
+
+            return infos;
+        }
+
+        inline constexpr auto INFOS = make_infos();
+
+        [[nodiscard]] constexpr bool has_all_infos() noexcept {
+            for(const auto& info : INFOS) {
+                if(info.name.empty() || info.spelling.empty()) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        static_assert(has_all_infos(), "every TokenType needs an entry in make_infos");
+
+        [[nodiscard]] constexpr const TokenInfo& get_info(TokenType type) noexcept {
+            return INFOS[static_cast<size_t>(type)];
+        }
+
+        [[nodiscard]] constexpr std::string_view get_name(TokenType type) noexcept {
+            return get_info(type).name;
+        }
+
+        [[nodiscard]] constexpr std::string_view to_string(TokenType type) noexcept {
+            return get_info(type).spelling;
+        }
+
+        [[nodiscard]] constexpr bool has_flags(TokenType type, uint8_t flags) noexcept {
+            return (get_info(type).flags & flags) == flags;
+        }
+
+        [[nodiscard]] constexpr bool is_bracket(TokenType type) noexcept {
+            return has_flags(type, Bracket);
+        }
+
+        [[nodiscard]] constexpr bool is_operator(TokenType type) noexcept {
+            return has_flags(type, Operator);
+        }
+
+        [[nodiscard]] constexpr bool is_keyword(TokenType type) noexcept {
+            return has_flags(type, Keyword);
+        }
+
+        [[nodiscard]] constexpr bool is_literal(TokenType type) noexcept {
+            return has_flags(type, Literal);
+        }
+
+        [[nodiscard]] constexpr bool is_integer_literal(TokenType type) noexcept {
+            return has_flags(type, IntegerLiteral);
+        }
+
+        [[nodiscard]] constexpr bool is_float_literal(TokenType type) noexcept {
+            return has_flags(type, FloatLiteral);
+        }
+
+        [[nodiscard]] constexpr bool is_assignment(TokenType type) noexcept {
+            return has_flags(type, Assignment);
+        }
+
+        [[nodiscard]] constexpr bool is_prefix(TokenType type) noexcept {
+            return has_flags(type, Prefix);
+        }
+
+        [[nodiscard]] constexpr bool is_comparison(TokenType type) noexcept {
+            return get_info(type).precedence == Precedence::Comparison || get_info(type).precedence == Precedence::Equality;
+        }
+
+        //The binary operator of a compound assignment, TokenType::Assign for the plain one
+        [[nodiscard]] constexpr TokenType get_compound_operator(TokenType type) noexcept {
+            switch(type) {
+                case TokenType::AddAssign:
+                    return TokenType::Add;
+                case TokenType::SubAssign:
+                    return TokenType::Sub;
+                case TokenType::MulAssign:
+                    return TokenType::Mul;
+                case TokenType::DivAssign:
+                    return TokenType::Div;
+                case TokenType::ModAssign:
+                    return TokenType::Mod;
+                case TokenType::AndAssign:
+                    return TokenType::And;
+                case TokenType::OrAssign:
+                    return TokenType::Or;
+                case TokenType::XorAssign:
+                    return TokenType::Xor;
+                case TokenType::LeftShiftAssign:
+                    return TokenType::LeftShift;
+                case TokenType::RightShiftAssign:
+                    return TokenType::RightShift;
+                default:
+                    return TokenType::Assign;
+            }
+        }
+
+        //Precedence::None for tokens that are no binary operators
+        [[nodiscard]] constexpr Precedence get_precedence(TokenType type) noexcept {
+            return get_info(type).precedence;
+        }
+
+        [[nodiscard]] constexpr Associativity get_associativity(TokenType type) noexcept {
+            return get_info(type).associativity;
+        }
+
+        //Keywords are few and short, a length check first rejects almost all identifiers
+        [[nodiscard]] constexpr std::optional<TokenType> find_keyword(std::string_view text) noexcept {
+            for(auto i = static_cast<size_t>(TokenType::Fn); i <= static_cast<size_t>(TokenType::Return); i++) {
+                const auto& spelling = INFOS[i].spelling;
+                if(spelling.size() == text.size() && spelling == text) {
+                    return static_cast<TokenType>(i);
+                }
+            }
+
+            return std::nullopt;
+        }
     }
 }
\ No newline at end of file
@@ -1,7 +0,0 @@
-#include "tokenize_exception.hpp"
-
-namespace karmac {
-    std::string TokenizeException::show() const {
-        return "HI";
-    }
-}
\ No newline at end of file
@@ -1,34 +1,24 @@
 #pragma once
 
-#include "../util/text/text_iterator.hpp"
+#include "../util/text/source_location.hpp"
 
 #include <fmt/format.h>
-#include <exception>
+#include <stdexcept>
 #include <utility>
 
 namespace karmac {
-    class TokenizeException final : public std::exception {
+    //Thrown by the literal parsers at the char they reject, the tokenizer turns it into a diagnostic and recovers.
+    //The location is resolved to path:line:column by the SourceManager that owns the file.
+    class TokenizeException final : public std::runtime_error {
     private:
-        TextIterator _iterator;
-        LineOffset _line_offset;
-        std::string _message;
+        SourceLocation _location;
     public:
         template<typename... T>
-        TokenizeException(TextIterator iterator, const fmt::format_string<T...> fmt, T&&... args)
-                : _iterator(std::move(iterator)), _line_offset(_iterator.get_line_offset()), _message(fmt::format(fmt, std::forward<T&&>(args)...)) {}
+        TokenizeException(SourceLocation location, const fmt::format_string<T...> fmt, T&&... args)
+            : std::runtime_error(fmt::format(fmt, std::forward<T&&>(args)...)), _location(location) {}
 
-        template<typename... T>
-        TokenizeException(TextIterator iterator, const LineOffset& line_offset, const fmt::format_string<T...> fmt, T&&... args)
-            : _iterator(std::move(iterator)), _line_offset(line_offset), _message(fmt::format(fmt, std::forward<T&&>(args)...)) {}
-
-        [[nodiscard]] std::string show() const;
-
-        [[nodiscard]] inline const LineOffset& get_line_offset() const noexcept {
-            return _line_offset;
-        }
-
-        [[nodiscard]] inline const std::string& get_message() const noexcept {
-            return _message;
+        [[nodiscard]] inline SourceLocation get_location() const noexcept {
+            return _location;
         }
     };
 }
\ No newline at end of file
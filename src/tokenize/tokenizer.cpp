@@ -1,4 +1,5 @@
 #include "tokenizer.hpp"
+#include "lex_stats.hpp"
 #include "token/identifier_token.hpp"
 #include "token/literal_token.hpp"
 #include "token/string_literal_token.hpp"
@@ -6,20 +7,9 @@
 #include "util/number_literal.hpp"
 #include "util/string_literal.hpp"
 #include "../util/text/character.hpp"
-#include <unordered_map>
+#include <algorithm>
 
 namespace karmac {
-    static std::unordered_map<std::string_view, TokenType> _keywords = {
-        { "fn", TokenType::Fn },
-        { "if", TokenType::If },
-        { "else", TokenType::Else },
-        { "for", TokenType::For },
-        { "while", TokenType::While },
-        { "break", TokenType::Break },
-        { "continue", TokenType::Continue },
-        { "return", TokenType::Return }
-    };
-
     void Tokenizer::skip_whitespace() {
         while(character::is_whitespace(*_iterator)) {
             ++_iterator;
@@ -27,17 +17,12 @@ namespace karmac {
     }
 
     void Tokenizer::parse_line_comment() {
-        ++_iterator;
-
-        while(_iterator.has_chars()) {
-            if(*_iterator == static_cast<uint64_t>('\n')) {
-                break;
-            }
+        while(_iterator[1] != static_cast<uint64_t>('\n') && _iterator[1] != static_cast<uint64_t>('\0')) {
             ++_iterator;
         }
     }
 
-    void Tokenizer::parse_multiline_comment() {
+    void Tokenizer::parse_multiline_comment(SourceLocation location) {
         ++_iterator;
 
         size_t num_tokens = 1;
@@ -67,77 +52,138 @@ namespace karmac {
             ++_iterator;
         }
 
-        throw std::runtime_error("Expected */"); //TODO:
+        _errors.push_back(TokenizeException(location, "Unterminated comment"));
+        //Stops on the last char like a comment that is closed
+        --_iterator;
     }
 
     void Tokenizer::parse_string_literal() {
+        const auto location = _iterator.get_location();
         ++_iterator;
 
-        const auto line_offset = _iterator.get_line_offset();
-        auto literal = tokenize::string_literal::parse(_iterator);
+        _scratch.clear();
+        auto terminated = false;
+        while(true) {
+            try {
+                terminated = tokenize::string_literal::parse(_iterator, _scratch);
+                break;
+            } catch(const TokenizeException& e) {
+                //The rest of the literal is checked as well
+                _errors.push_back(e);
+                ++_iterator;
+            }
+        }
+
+        if(!terminated) {
+            _errors.push_back(TokenizeException(location, "Unterminated string literal"));
+            --_iterator;
+        }
 
-        _tokens.push_back(new StringLiteralToken(std::move(literal), line_offset));
+        _tokens.push_back(_arena.create<StringLiteralToken>(_arena.copy(_scratch), location));
     }
 
     void Tokenizer::parse_identifier() {
-        std::string identifier;
+        _scratch.clear();
 
-        const auto line_offset = _iterator.get_line_offset();
+        const auto location = _iterator.get_location();
 
         char buffer[7];
         while(character::is_identifier(*_iterator)) {
             utf8::from_unicode(*_iterator, buffer);
-            identifier += buffer;
+            _scratch += buffer;
 
             ++_iterator;
         }
 
-        const auto keyword_iter = _keywords.find(identifier);
-        if(keyword_iter == _keywords.end()) {
-            _tokens.push_back(new IdentifierToken(std::move(identifier), line_offset));
+        KARMAC_LEX_STAT(identifier_lookups++);
+        KARMAC_LEX_STAT(identifier_bytes += _scratch.size());
+
+        const auto keyword = token_type::find_keyword(_scratch);
+        if(!keyword) {
+            const auto symbol = _identifiers.intern(_scratch);
+            _tokens.push_back(_arena.create<IdentifierToken>(_identifiers.get(symbol), symbol, location));
         } else {
-            _tokens.push_back(new SimpleToken(keyword_iter->second, line_offset));
+            KARMAC_LEX_STAT(keyword_hits++);
+            _tokens.push_back(_arena.create<SimpleToken>(*keyword, location));
         }
     }
 
-    bool Tokenizer::try_parse_number() {
-        const auto line_offset = _iterator.get_line_offset();
+    void Tokenizer::parse_number() {
+        const auto location = _iterator.get_location();
 
-        auto unicode = *_iterator;
-        if(unicode == static_cast<uint64_t>('0')) {
-            if(_iterator.has_chars()) {
-                unicode = *++_iterator;
+        try {
+            _tokens.push_back(tokenize_number(location));
+        } catch(const TokenizeException& e) {
+            _errors.push_back(e);
 
-                switch(unicode) {
-                    case static_cast<uint64_t>('b'):
-                    case static_cast<uint64_t>('B'): {
-                        ++_iterator;
-                        const auto literal = tokenize::number_literal::parse_bin(_iterator);
-                    }
-                        break;
-                    case static_cast<uint64_t>('f'):
-                    case static_cast<uint64_t>('F'): {
-                        ++_iterator;
-                        const auto literal = tokenize::number_literal::parse_hex(_iterator);
-                    }
-                        break;
-                    case static_cast<uint64_t>('o'):
-                    case static_cast<uint64_t>('O'): {
-                        ++_iterator;
-                        const auto literal = tokenize::number_literal::parse_oct(_iterator);
-                    }
-                        break;
-                    default:
-                        karmac_unimplemented();
-                        break;
+            //The rest of the literal is skipped, the parser sees a zero in its place
+            while(character::is_identifier(*_iterator)) {
+                ++_iterator;
+            }
+            _tokens.push_back(tokenize::number_literal::create_token(_arena, TokenType::IntegerLiteral, 0, 0.0, false, location));
+        }
+    }
+
+    Token* Tokenizer::tokenize_number(SourceLocation location) {
+        uint64_t integer = 0;
+        double floating = 0.0;
+        auto is_float = false;
+
+        if(*_iterator == static_cast<uint64_t>('0')) {
+            switch(_iterator[1]) {
+                case static_cast<uint64_t>('b'):
+                case static_cast<uint64_t>('B'):
+                    _iterator += 2;
+                    integer = tokenize::number_literal::parse_bin(_iterator);
+                    break;
+                case static_cast<uint64_t>('o'):
+                case static_cast<uint64_t>('O'):
+                    _iterator += 2;
+                    integer = tokenize::number_literal::parse_oct(_iterator);
+                    break;
+                case static_cast<uint64_t>('x'):
+                case static_cast<uint64_t>('X'):
+                    _iterator += 2;
+                    integer = tokenize::number_literal::parse_hex(_iterator);
+                    break;
+                default:
+                    is_float = tokenize::number_literal::parse_dec(_iterator, integer, floating);
+                    break;
+            }
+        } else {
+            is_float = tokenize::number_literal::parse_dec(_iterator, integer, floating);
+        }
+
+        //The suffix is kept in the token type, unsuffixed literals keep their full value for the type checker
+        auto type = is_float ? TokenType::FloatLiteral : TokenType::IntegerLiteral;
+        if(character::is_identifier(*_iterator)) {
+            const auto suffix = _iterator.get_location();
+            const auto suffix_start = _iterator.get_head();
+            if(!tokenize::number_literal::parse_type(_iterator, type) || character::is_identifier(*_iterator)) {
+                while(character::is_identifier(*_iterator)) {
+                    ++_iterator;
                 }
-            } else {
-                _tokens.push_back(new I32LiteralToken(0, line_offset));
-                return true;
+                throw TokenizeException(suffix, "Invalid number literal suffix \"{}\"", std::string_view(suffix_start, _iterator.get_head()));
             }
         }
 
-        return false;
+        return tokenize::number_literal::create_token(_arena, type, integer, floating, is_float, location);
+    }
+
+    void Tokenizer::close_bracket(TokenType closing_type) {
+        const auto location = _iterator.get_location();
+
+        //A bracket that closes nothing is dropped, so that the parser doesn't report it again
+        if(!_pending_tokens.can_close(closing_type)) {
+            _errors.push_back(TokenizeException(location, "Unmatched \"{}\"", token_type::to_string(closing_type)));
+            return;
+        }
+
+        const auto expected = _pending_tokens.pop(closing_type, static_cast<uint32_t>(_tokens.size()));
+        if(expected != closing_type) {
+            _errors.push_back(TokenizeException(location, "Expected \"{}\", found \"{}\"", token_type::to_string(expected), token_type::to_string(closing_type)));
+        }
+        _tokens.push_back(_arena.create<SimpleToken>(closing_type, location));
     }
 
     bool Tokenizer::try_parse_atom() {
@@ -146,98 +192,101 @@ namespace karmac {
 
         switch(unicode) {
             case static_cast<uint64_t>('!'):
-                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Not, TokenType::NotEquals>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Not, TokenType::NotEquals>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('"'):
                 parse_string_literal();
                 break;
             case static_cast<uint64_t>('%'):
-                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Mod, TokenType::ModAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Mod, TokenType::ModAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('&'):
-                tokenize::atom::branch_1_or_2_len_2_char<'&', '=', TokenType::And, TokenType::Conjunction, TokenType::AndAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_2_char<'&', '=', TokenType::And, TokenType::Conjunction, TokenType::AndAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('('):
-                tokenize::atom::open_bracket<TokenType::LeftBracket, TokenType::RightBracket>(_iterator, _tokens, _pending_tokens);
+                tokenize::atom::open_bracket<TokenType::LeftBracket, TokenType::RightBracket>(_iterator, _tokens, _arena, _pending_tokens);
                 break;
             case static_cast<uint64_t>(')'):
-                tokenize::atom::close_bracket<TokenType::LeftBracket, TokenType::RightBracket>(_iterator, _tokens, _pending_tokens);
+                close_bracket(TokenType::RightBracket);
                 break;
             case static_cast<uint64_t>('*'):
-                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Mul, TokenType::MulAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Mul, TokenType::MulAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('+'):
-                tokenize::atom::branch_1_or_2_len_2_char<'+', '=', TokenType::Add, TokenType::Increment, TokenType::AddAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_2_char<'+', '=', TokenType::Add, TokenType::Increment, TokenType::AddAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>(','):
-                _tokens.push_back(new SimpleToken(TokenType::Comma, _iterator));
+                _tokens.push_back(_arena.create<SimpleToken>(TokenType::Comma, _iterator));
                 break;
             case static_cast<uint64_t>('-'):
-                tokenize::atom::branch_1_or_2_len_3_char<'-', '=', '>', TokenType::Sub, TokenType::Decrement, TokenType::SubAssign, TokenType::Arrow>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_3_char<'-', '=', '>', TokenType::Sub, TokenType::Decrement, TokenType::SubAssign, TokenType::Arrow>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('.'):
-                tokenize::atom::branch_1_or_2_len_char<'.', TokenType::Dot, TokenType::DoubleDot>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'.', TokenType::Dot, TokenType::DoubleDot>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('/'):
                 if(_iterator.has_chars()) {
-                    const auto line_offset = _iterator.get_line_offset();
+                    const auto location = _iterator.get_location();
 
                     unicode = *++_iterator;
 
                     switch(unicode) {
                         case static_cast<uint64_t>('*'):
-                            parse_multiline_comment();
+                            parse_multiline_comment(location);
+                            KARMAC_LEX_STAT(comment_bytes += _iterator.get_location().offset - location.offset + 1);
                             break;
                         case static_cast<uint64_t>('/'):
                             parse_line_comment();
+                            KARMAC_LEX_STAT(comment_bytes += _iterator.get_location().offset - location.offset + 1);
                             break;
                         case static_cast<uint64_t>('='):
-                            _tokens.push_back(new SimpleToken(TokenType::DivAssign, line_offset));
+                            _tokens.push_back(_arena.create<SimpleToken>(TokenType::DivAssign, location));
                             break;
                         default:
+                            KARMAC_LEX_STAT(backtracks++);
                             --_iterator;
-                            _tokens.push_back(new SimpleToken(TokenType::Div, line_offset));
+                            _tokens.push_back(_arena.create<SimpleToken>(TokenType::Div, location));
                             break;
                     }
                 } else {
-                    _tokens.push_back(new SimpleToken(TokenType::Div, _iterator));
+                    _tokens.push_back(_arena.create<SimpleToken>(TokenType::Div, _iterator));
                 }
                 break;
             case static_cast<uint64_t>(':'):
-                tokenize::atom::branch_1_or_2_len_char<':', TokenType::Colon, TokenType::DoubleColon>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<':', TokenType::Colon, TokenType::DoubleColon>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>(';'):
-                _tokens.push_back(new SimpleToken(TokenType::Semicolon, _iterator));
+                _tokens.push_back(_arena.create<SimpleToken>(TokenType::Semicolon, _iterator));
                 break;
             case static_cast<uint64_t>('<'):
-                tokenize::atom::branch_1_or_2_len_2_1_char<'<', '=', '=', TokenType::Less, TokenType::LeftShift, TokenType::LeftShiftAssign, TokenType::LessEquals>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_2_1_char<'<', '=', '=', TokenType::Less, TokenType::LeftShift, TokenType::LeftShiftAssign, TokenType::LessEquals>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('='):
-                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Assign, TokenType::Equals>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Assign, TokenType::Equals>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('>'):
-                tokenize::atom::branch_1_or_2_len_2_1_char<'>', '=', '=', TokenType::Greater, TokenType::RightShift, TokenType::RightShiftAssign, TokenType::GreaterEquals>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_2_1_char<'>', '=', '=', TokenType::Greater, TokenType::RightShift, TokenType::RightShiftAssign, TokenType::GreaterEquals>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('?'):
-                _tokens.push_back(new SimpleToken(TokenType::QuestionMark, _iterator));
+                _tokens.push_back(_arena.create<SimpleToken>(TokenType::QuestionMark, _iterator));
                 break;
             case static_cast<uint64_t>('['):
-                tokenize::atom::open_bracket<TokenType::LeftSquareBracket, TokenType::RightSquareBracket>(_iterator, _tokens, _pending_tokens);
+                tokenize::atom::open_bracket<TokenType::LeftSquareBracket, TokenType::RightSquareBracket>(_iterator, _tokens, _arena, _pending_tokens);
                 break;
             case static_cast<uint64_t>(']'):
-                tokenize::atom::close_bracket<TokenType::LeftSquareBracket, TokenType::RightSquareBracket>(_iterator, _tokens, _pending_tokens);
+                close_bracket(TokenType::RightSquareBracket);
                 break;
             case static_cast<uint64_t>('^'):
-                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Xor, TokenType::XorAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_char<'=', TokenType::Xor, TokenType::XorAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('{'):
-                tokenize::atom::open_bracket<TokenType::LeftCurlyBracket, TokenType::RightCurlyBracket>(_iterator, _tokens, _pending_tokens);
+                tokenize::atom::open_bracket<TokenType::LeftCurlyBracket, TokenType::RightCurlyBracket>(_iterator, _tokens, _arena, _pending_tokens);
                 break;
             case static_cast<uint64_t>('|'):
-                tokenize::atom::branch_1_or_2_len_2_char<'|', '=', TokenType::Or, TokenType::Disjunction, TokenType::OrAssign>(_iterator, _tokens);
+                tokenize::atom::branch_1_or_2_len_2_char<'|', '=', TokenType::Or, TokenType::Disjunction, TokenType::OrAssign>(_iterator, _tokens, _arena);
                 break;
             case static_cast<uint64_t>('}'):
-                tokenize::atom::close_bracket<TokenType::LeftCurlyBracket, TokenType::RightCurlyBracket>(_iterator, _tokens, _pending_tokens);
+                close_bracket(TokenType::RightCurlyBracket);
                 break;
             default:
                 result = false;
@@ -247,34 +296,325 @@ namespace karmac {
         return result;
     }
 
-    Tokenizer::Tokenizer(const std::string_view& source) : _iterator(source.data()) {
-        while(_iterator.has_chars()) {
-            skip_whitespace();
+    bool Tokenizer::tokenize_next() {
+        skip_whitespace();
 
-            auto unicode = *_iterator;
+        if(!_iterator.has_chars()) {
+            return false;
+        }
 
-            if(character::is_identifier_start(unicode)) {
-                parse_identifier();
-                continue;
-            }
+#ifdef KARMAC_LEX_STATS
+        const auto num_tokens = _tokens.size();
+#endif
 
-            auto result = try_parse_atom();
-            if(!result && character::is_number_start(unicode)) {
-                result = try_parse_number();
-            }
+        const auto unicode = *_iterator;
 
-            if(!result) {
-                throw std::runtime_error("Invalid token"); //TODO:
+        if(character::is_identifier_start(unicode)) {
+            parse_identifier();
+        } else if(character::is_dec_digit(unicode)) {
+            parse_number();
+        } else {
+            if(!try_parse_atom()) {
+                char buffer[7];
+                utf8::from_unicode(unicode, buffer);
+                _errors.push_back(TokenizeException(_iterator.get_location(), "Unexpected character \"{}\"", buffer));
             }
 
             ++_iterator;
         }
+
+#ifdef KARMAC_LEX_STATS
+        if(_tokens.size() != num_tokens) {
+            KARMAC_LEX_STAT(tokens[static_cast<size_t>(_tokens.back()->get_type())]++);
+        }
+#endif
+        return true;
+    }
+
+    //Replays the brackets of tokens that weren't checked by the tokenizer, throws at the first one that doesn't match
+    static void replay_bracket(tokenize::BracketStack& pending_tokens, const Token* token, uint32_t index) {
+        const auto type = token->get_type();
+        if(type != TokenType::RightBracket && type != TokenType::RightSquareBracket && type != TokenType::RightCurlyBracket) {
+            pending_tokens.apply(type, index);
+            return;
+        }
+
+        if(!pending_tokens.can_close(type)) {
+            throw TokenizeException(token->get_location(), "Unmatched \"{}\"", token_type::to_string(type));
+        }
+        const auto expected = pending_tokens.pop(type, index);
+        if(expected != type) {
+            throw TokenizeException(token->get_location(), "Expected \"{}\", found \"{}\"", token_type::to_string(expected), token_type::to_string(type));
+        }
+    }
+
+    bool Tokenizer::check_brackets(const std::vector<Token*>& tokens, size_t resync) const {
+        //The brackets of the replaced region have to leave the same brackets open and closed as the new region,
+        //otherwise the whole token stream has to be validated again
+        tokenize::BracketStack old_pending_tokens(true);
+        for(size_t i = 0; i < std::min(resync + 1, tokens.size()); i++) {
+            old_pending_tokens.apply(tokens[i]->get_type(), static_cast<uint32_t>(i));
+        }
+
+        if(old_pending_tokens == _pending_tokens) {
+            return true;
+        }
+
+        tokenize::BracketStack pending_tokens;
+        for(size_t i = 0; i < _tokens.size(); i++) {
+            replay_bracket(pending_tokens, _tokens[i], static_cast<uint32_t>(i));
+        }
+        for(size_t i = resync + 1; i < tokens.size(); i++) {
+            replay_bracket(pending_tokens, tokens[i], static_cast<uint32_t>(_tokens.size() + i - resync - 1));
+        }
+        return false;
     }
 
-    Tokenizer::~Tokenizer() {
-        for(const auto* token : _tokens) {
-            delete token;
+    void Tokenizer::record_blocks() {
+        _pending_tokens.reset(false);
+        for(size_t i = 0; i < _tokens.size(); i++) {
+            _pending_tokens.apply(_tokens[i]->get_type(), static_cast<uint32_t>(i));
         }
+        _blocks.assign(_pending_tokens.get_blocks().begin(), _pending_tokens.get_blocks().end());
+    }
+
+    void Tokenizer::update_blocks(const RelexResult& result) {
+        const auto old_end = result.first_token + result.removed_tokens;
+        const auto shift = static_cast<int64_t>(result.inserted_tokens) - static_cast<int64_t>(result.removed_tokens);
+
+        //Blocks that close in front of the region or open behind it keep their brackets
+        const auto first = std::lower_bound(_blocks.begin(), _blocks.end(), result.first_token, [](const tokenize::BracketRange& block, size_t index) {
+            return block.close < index;
+        });
+        const auto last = std::lower_bound(first, _blocks.end(), old_end, [](const tokenize::BracketRange& block, size_t index) {
+            return block.open < index;
+        });
+
+        //No bracket is open right behind a block or at the start of one, so the replay starts and ends balanced
+        const size_t start = first == _blocks.begin() ? 0 : std::prev(first)->close + size_t(1);
+        const auto end = last == _blocks.end() ? _tokens.size() : static_cast<size_t>(last->open + shift);
+        _pending_tokens.reset(false);
+        for(auto i = start; i < end; i++) {
+            _pending_tokens.apply(_tokens[i]->get_type(), static_cast<uint32_t>(i));
+        }
+
+        for(auto block = last; block != _blocks.end(); ++block) {
+            block->open = static_cast<uint32_t>(block->open + shift);
+            block->close = static_cast<uint32_t>(block->close + shift);
+        }
+        const auto& replayed = _pending_tokens.get_blocks();
+        const auto position = _blocks.erase(first, last);
+        _blocks.insert(position, replayed.begin(), replayed.end());
+    }
+
+    Tokenizer::Tokenizer() noexcept : _iterator("") {}
+
+    Tokenizer::Tokenizer(const std::string_view& source, SourceLocation base) : Tokenizer() {
+        reset(source, base);
+    }
+
+    void Tokenizer::clear() noexcept {
         _tokens.clear();
+        _arena.reset();
+        _identifiers.clear();
+        _pending_tokens.reset(false);
+        _blocks.clear();
+        _errors.clear();
+    }
+
+    void Tokenizer::reset(const std::string_view& source, SourceLocation base) {
+        clear();
+
+        //A few percent above the observed ratio avoids growing the array for slightly denser sources
+        const auto expected_tokens = static_cast<size_t>(static_cast<double>(source.size()) * get_tokens_per_byte() * 1.05) + 16;
+        _tokens.reserve(expected_tokens);
+
+        _base = base;
+        _iterator = TextIterator(source.data(), base);
+
+#ifdef KARMAC_LEX_STATS
+        auto& statistics = tokenize::lex_stats::get_thread_statistics();
+        statistics.source_bytes += source.size();
+        statistics.non_ascii_bytes += static_cast<uint64_t>(std::count_if(source.begin(), source.end(), [](char ch) {
+            return static_cast<unsigned char>(ch) >= 0x80;
+        }));
+#endif
+
+        while(tokenize_next()) {}
+        _blocks.assign(_pending_tokens.get_blocks().begin(), _pending_tokens.get_blocks().end());
+
+        _tokenized_bytes += source.size();
+        _tokenized_tokens += _tokens.size();
+    }
+
+    //Literal tokens of the value of a token stream record, which is stored sign-extended for signed types
+    static Token* create_literal(Arena& arena, const token_stream::TokenRecord& record) {
+        switch(record.type) {
+            case TokenType::U8Literal:
+                return arena.create<U8LiteralToken>(static_cast<uint8_t>(record.integer), arena, record.location);
+            case TokenType::I8Literal:
+                return arena.create<I8LiteralToken>(static_cast<int8_t>(record.integer), arena, record.location);
+            case TokenType::U16Literal:
+                return arena.create<U16LiteralToken>(static_cast<uint16_t>(record.integer), arena, record.location);
+            case TokenType::I16Literal:
+                return arena.create<I16LiteralToken>(static_cast<int16_t>(record.integer), arena, record.location);
+            case TokenType::U32Literal:
+                return arena.create<U32LiteralToken>(static_cast<uint32_t>(record.integer), arena, record.location);
+            case TokenType::I32Literal:
+                return arena.create<I32LiteralToken>(static_cast<int32_t>(record.integer), arena, record.location);
+            case TokenType::U64Literal:
+                return arena.create<U64LiteralToken>(record.integer, arena, record.location);
+            case TokenType::I64Literal:
+                return arena.create<I64LiteralToken>(static_cast<int64_t>(record.integer), arena, record.location);
+            case TokenType::USizeLiteral:
+                return arena.create<USizeLiteralToken>(static_cast<size_t>(record.integer), arena, record.location);
+            case TokenType::ISizeLiteral:
+                return arena.create<ISizeLiteralToken>(static_cast<ptrdiff_t>(record.integer), arena, record.location);
+            case TokenType::F32Literal:
+                return arena.create<F32LiteralToken>(static_cast<float>(record.floating), arena, record.location);
+            case TokenType::F64Literal:
+                return arena.create<F64LiteralToken>(record.floating, arena, record.location);
+            case TokenType::IntegerLiteral:
+                return arena.create<IntegerLiteralToken>(record.integer, arena, record.location);
+            case TokenType::FloatLiteral:
+                return arena.create<FloatLiteralToken>(record.floating, arena, record.location);
+            default:
+                karmac_unimplemented();
+                return nullptr;
+        }
+    }
+
+    void Tokenizer::load(const token_stream::TokenStreamView& stream) {
+        clear();
+        _tokens.reserve(stream.size());
+        //Every distinct identifier of the stream is interned once
+        _stream_symbols.assign(stream.get_string_count(), _NO_SYMBOL);
+
+        for(size_t i = 0; i < stream.size(); i++) {
+            const auto type = stream.get_type(i);
+            Token* token;
+            if(type == TokenType::Identifier) {
+                const auto id = stream.get_value(i);
+                if(id >= _stream_symbols.size()) {
+                    throw std::runtime_error("Invalid string id in token stream");
+                }
+                if(_stream_symbols[id] == _NO_SYMBOL) {
+                    _stream_symbols[id] = _identifiers.intern(stream.get_string(id));
+                }
+                const auto symbol = _stream_symbols[id];
+                token = _arena.create<IdentifierToken>(_identifiers.get(symbol), symbol, stream.get_location(i));
+            } else if(type == TokenType::StringLiteral) {
+                token = _arena.create<StringLiteralToken>(_arena.copy(stream.get_string(stream.get_value(i))), stream.get_location(i));
+            } else if(token_type::is_integer_literal(type) || token_type::is_float_literal(type)) {
+                token = create_literal(_arena, stream.get_record(i));
+            } else {
+                token = _arena.create<SimpleToken>(type, stream.get_location(i));
+            }
+
+            replay_bracket(_pending_tokens, token, static_cast<uint32_t>(_tokens.size()));
+            _tokens.push_back(token);
+        }
+        _blocks.assign(_pending_tokens.get_blocks().begin(), _pending_tokens.get_blocks().end());
+    }
+
+    RelexResult Tokenizer::relex(const std::string_view& source, const TextEdit& edit) {
+        //Tokens recovered from errors don't only depend on the text that follows them
+        if(!_errors.empty()) {
+            const auto removed_tokens = _tokens.size();
+            reset(source, _base);
+            return { 0, removed_tokens, _tokens.size() };
+        }
+
+        //The token in front of the edit may continue into the edited text and tokens are parsed with a lookahead,
+        //so tokenizing restarts one token before it
+        const auto get_index = [this](const Token* token) {
+            return static_cast<size_t>(token->get_location().offset - _base.offset);
+        };
+
+        const auto edit_token = std::lower_bound(_tokens.begin(), _tokens.end(), edit.offset, [&get_index](const Token* token, size_t offset) {
+            return get_index(token) < offset;
+        });
+
+        auto first = static_cast<size_t>(edit_token - _tokens.begin());
+        first = first >= 2 ? first - 2 : 0;
+
+        const auto restart_index = first == 0 ? 0 : get_index(_tokens[first]);
+
+        const auto delta = edit.get_delta();
+        const auto shift = [delta, &get_index](const Token* token) {
+            return static_cast<size_t>(static_cast<ptrdiff_t>(get_index(token)) + delta);
+        };
+
+        std::vector<Token*> old_tokens(_tokens.begin() + static_cast<ptrdiff_t>(first), _tokens.end());
+        _tokens.resize(first);
+
+        size_t resync = 0;
+        while(resync < old_tokens.size() && get_index(old_tokens[resync]) < edit.get_old_end()) {
+            ++resync;
+        }
+
+        _iterator = TextIterator(source.data(), restart_index, _base);
+        _pending_tokens = tokenize::BracketStack(true);
+
+        auto balanced = true;
+        try {
+            auto num_tokens = _tokens.size();
+            auto synchronized = false;
+
+            while(tokenize_next()) {
+                if(_tokens.size() == num_tokens) {
+                    continue;
+                }
+                num_tokens = _tokens.size();
+
+                //Tokenizing only depends on the text following the token start, so once a token starts where
+                //an old token behind the edit started, all following tokens are the same as before
+                const auto index = get_index(_tokens.back());
+                while(resync < old_tokens.size() && shift(old_tokens[resync]) < index) {
+                    ++resync;
+                }
+
+                if(resync < old_tokens.size() && shift(old_tokens[resync]) == index) {
+                    synchronized = true;
+                    break;
+                }
+            }
+
+            if(!synchronized) {
+                resync = old_tokens.size();
+            }
+
+            if(!_errors.empty()) {
+                const auto error = _errors.front();
+                _errors.clear();
+                throw error;
+            }
+
+            balanced = check_brackets(old_tokens, resync);
+        } catch(...) {
+            //The blocks weren't touched yet
+            _tokens.resize(first);
+            _tokens.insert(_tokens.end(), old_tokens.begin(), old_tokens.end());
+            throw;
+        }
+
+        if(resync < old_tokens.size()) {
+            for(auto i = resync; i < old_tokens.size(); i++) {
+                old_tokens[i]->set_location(_base + static_cast<uint32_t>(shift(old_tokens[i])));
+            }
+
+            _tokens.pop_back();
+        }
+
+        //Replaced tokens stay in the arena until the next reset
+        const RelexResult result = { first, resync, _tokens.size() - first };
+        _tokens.insert(_tokens.end(), old_tokens.begin() + static_cast<ptrdiff_t>(resync), old_tokens.end());
+
+        if(balanced) {
+            update_blocks(result);
+        } else {
+            record_blocks();
+        }
+        return result;
     }
 }
\ No newline at end of file
@@ -1,32 +1,128 @@
 #pragma once
 
+#include "tokenize_exception.hpp"
+#include "stream/token_stream.hpp"
 #include "token/token.hpp"
-#include <stack>
+#include "util/bracket_stack.hpp"
+#include "../util/memory/arena.hpp"
+#include "../util/text/text_edit.hpp"
+#include "../util/text/string_interner.hpp"
+#include "../util/text/text_iterator.hpp"
+#include <string>
 #include <vector>
 
 namespace karmac {
-    class TextIterator;
+    //Tokens [first_token, first_token + removed_tokens) of the previous token store were replaced
+    //by tokens [first_token, first_token + inserted_tokens) of the current one
+    struct RelexResult {
+        size_t first_token;
+        size_t removed_tokens;
+        size_t inserted_tokens;
+    };
+
+    //A tokenizer can be reused for many sources, `reset` keeps the capacity of all buffers at their high-water mark
     class Tokenizer final {
     private:
-        std::stack<TokenType> _pending_tokens;
+        //Initial estimate, measured on generated code
+        static constexpr double _DEFAULT_TOKENS_PER_BYTE = 0.2;
+        static constexpr uint32_t _NO_SYMBOL = UINT32_MAX;
+
+        tokenize::BracketStack _pending_tokens;
         std::vector<Token*> _tokens;
+        //Token ranges of the outermost curly brackets of the token store
+        std::vector<tokenize::BracketRange> _blocks;
+        std::vector<TokenizeException> _errors;
+        Arena _arena;
+        //Text and symbol of every distinct identifier
+        StringInterner _identifiers;
+        //Text of the current identifier or string literal before it is copied into the arena
+        std::string _scratch;
+        //Symbol of each string id of the token stream being loaded
+        std::vector<uint32_t> _stream_symbols;
 
         TextIterator _iterator;
+        //Location of the first char of the source
+        SourceLocation _base;
+
+        uint64_t _tokenized_bytes = 0;
+        uint64_t _tokenized_tokens = 0;
 
         void skip_whitespace();
         void parse_line_comment();
-        void parse_multiline_comment();
+        //`location` is the start of the comment
+        void parse_multiline_comment(SourceLocation location);
         void parse_string_literal();
 
         void parse_identifier();
-        [[nodiscard]] bool try_parse_number();
+        //Replaces a number literal that can't be parsed by a zero
+        void parse_number();
+        [[nodiscard]] Token* tokenize_number(SourceLocation location);
+        //Brackets that close the wrong bracket close it anyway, brackets that close none are dropped
+        void close_bracket(TokenType closing_type);
         [[nodiscard]] bool try_parse_atom();
+        [[nodiscard]] bool tokenize_next();
+
+        //Returns false if the replaced region changed which brackets are open, then the whole stream was validated
+        [[nodiscard]] bool check_brackets(const std::vector<Token*>& tokens, size_t resync) const;
+        //Replays the brackets of the whole token stream, which has to be valid
+        void record_blocks();
+        //Replays the brackets from the end of the last block in front of the relexed region to the start of the first
+        //block behind it, the blocks behind it only move
+        void update_blocks(const RelexResult& result);
     public:
-        explicit Tokenizer(const std::string_view& source);
-        ~Tokenizer();
+        Tokenizer() noexcept;
+        explicit Tokenizer(const std::string_view& source, SourceLocation base = SourceLocation());
+        Tokenizer(const Tokenizer&) = delete;
+        Tokenizer(Tokenizer&&) noexcept = default;
+
+        Tokenizer& operator =(const Tokenizer&) = delete;
+        Tokenizer& operator =(Tokenizer&&) noexcept = default;
+
+        //Tokenizes `source` from scratch, the tokens of the previous source are destroyed. Token locations start
+        //at `base`, usually the start of the file in the SourceManager.
+        //The token array is reserved from the tokens per byte observed so far.
+        void reset(const std::string_view& source, SourceLocation base = SourceLocation());
+
+        //Replaces the tokens with the ones of a stream serialized from a source without errors, identifiers are
+        //interned and blocks recorded as if the source was tokenized. Throws if the brackets of the stream don't match.
+        //The parser works on tokens, so one is still created per record, but nothing has to be decoded and every
+        //distinct identifier is only interned once.
+        void load(const token_stream::TokenStreamView& stream);
+
+        //Drops all tokens but keeps the buffers and the arena chunks
+        void clear() noexcept;
+
+        [[nodiscard]] inline double get_tokens_per_byte() const noexcept {
+            return _tokenized_bytes == 0 ? _DEFAULT_TOKENS_PER_BYTE : static_cast<double>(_tokenized_tokens) / static_cast<double>(_tokenized_bytes);
+        }
+
+        //Updates the token store after `edit` was applied to the text, `source` is the text after the edit.
+        //Only the region between the last token in front of the edit and the first token that lines up with
+        //the previous token stream again is tokenized, all following tokens are moved in place.
+        //If the edited text has errors, the first one is thrown and the token store is left untouched. A store that
+        //already has errors is tokenized again from scratch. Replaced tokens keep their arena memory until the next
+        //`reset`. Locations behind the edit are moved by its delta, a file registered with a SourceManager has to be
+        //registered again once it grows.
+        RelexResult relex(const std::string_view& source, const TextEdit& edit);
 
         [[nodiscard]] inline const std::vector<Token*>& get_tokens() const noexcept {
             return _tokens;
         }
+
+        //Symbols of the identifier tokens are dense ids into it
+        [[nodiscard]] inline const StringInterner& get_identifiers() const noexcept {
+            return _identifiers;
+        }
+
+        //Errors in source order. Tokenizing goes on behind them, unexpected chars and unmatched closing brackets are
+        //skipped and invalid literals are still turned into a token.
+        [[nodiscard]] inline const std::vector<TokenizeException>& get_errors() const noexcept {
+            return _errors;
+        }
+
+        //Token ranges of the outermost curly brackets, which are the function bodies of valid input
+        [[nodiscard]] inline const std::vector<tokenize::BracketRange>& get_blocks() const noexcept {
+            return _blocks;
+        }
     };
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include "tokenizer_pool.hpp"
+
+namespace karmac {
+    static thread_local std::vector<std::unique_ptr<Tokenizer>> _idle_tokenizers;
+
+    TokenizerPool::Lease::~Lease() {
+        if(!_tokenizer) {
+            return;
+        }
+
+        _tokenizer->clear();
+        try {
+            _idle_tokenizers.push_back(std::move(_tokenizer));
+        } catch(...) {}
+    }
+
+    TokenizerPool::Lease TokenizerPool::acquire() {
+        if(_idle_tokenizers.empty()) {
+            return Lease(std::make_unique<Tokenizer>());
+        }
+
+        auto tokenizer = std::move(_idle_tokenizers.back());
+        _idle_tokenizers.pop_back();
+        return Lease(std::move(tokenizer));
+    }
+
+    void TokenizerPool::trim() noexcept {
+        _idle_tokenizers.clear();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "tokenizer.hpp"
+#include <memory>
+#include <vector>
+
+namespace karmac {
+    //Per-thread free list of tokenizers, so long-running processes tokenize every file with warm buffers
+    class TokenizerPool final {
+    public:
+        //Returns the tokenizer to the pool of the acquiring thread when destroyed, its tokens are destroyed then
+        class Lease final {
+        private:
+            std::unique_ptr<Tokenizer> _tokenizer;
+
+        public:
+            explicit Lease(std::unique_ptr<Tokenizer> tokenizer) noexcept : _tokenizer(std::move(tokenizer)) {}
+            Lease(Lease&&) noexcept = default;
+            Lease(const Lease&) = delete;
+            ~Lease();
+
+            Lease& operator =(Lease&&) noexcept = default;
+            Lease& operator =(const Lease&) = delete;
+
+            [[nodiscard]] inline Tokenizer& operator *() const noexcept {
+                return *_tokenizer;
+            }
+
+            [[nodiscard]] inline Tokenizer* operator ->() const noexcept {
+                return _tokenizer.get();
+            }
+        };
+
+        [[nodiscard]] static Lease acquire();
+
+        //Frees the idle tokenizers of the calling thread
+        static void trim() noexcept;
+    };
+}
\ No newline at end of file
@@ -1,123 +1,112 @@
 #pragma once
 
+#include "../lex_stats.hpp"
 #include "../token/simple_token.hpp"
-#include "../tokenize_exception.hpp"
-#include <stack>
+#include "../../util/memory/arena.hpp"
+#include "../../util/text/text_iterator.hpp"
+#include "bracket_stack.hpp"
 #include <vector>
 
 namespace karmac::tokenize::atom {
     template<char Char, TokenType FirstType, TokenType SecondType>
-    static void branch_1_or_2_len_char(TextIterator& iterator, std::vector<Token*>& tokens) {
+    static void branch_1_or_2_len_char(TextIterator& iterator, std::vector<Token*>& tokens, Arena& arena) {
         if(iterator.has_chars() && iterator[1] == static_cast<uint64_t>(Char)) {
-            tokens.push_back(new SimpleToken(SecondType, iterator));
+            tokens.push_back(arena.create<SimpleToken>(SecondType, iterator));
             ++iterator;
         } else {
-            tokens.push_back(new SimpleToken(FirstType, iterator));
+            tokens.push_back(arena.create<SimpleToken>(FirstType, iterator));
         }
     }
 
     template<char FirstChar, char SecondChar, TokenType FirstType, TokenType SecondType, TokenType ThirdType>
-    static void branch_1_or_2_len_2_char(TextIterator& iterator, std::vector<Token*>& tokens) {
+    static void branch_1_or_2_len_2_char(TextIterator& iterator, std::vector<Token*>& tokens, Arena& arena) {
         if(iterator.has_chars()) {
-            const auto line_offset = iterator.get_line_offset();
+            const auto location = iterator.get_location();
 
             auto unicode = *++iterator;
 
             switch(unicode) {
                 case static_cast<uint64_t>(FirstChar):
-                    tokens.push_back(new SimpleToken(SecondType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(SecondType, location));
                     break;
                 case static_cast<uint64_t>(SecondChar):
-                    tokens.push_back(new SimpleToken(ThirdType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(ThirdType, location));
                     break;
                 default:
+                    KARMAC_LEX_STAT(backtracks++);
                     --iterator;
-                    tokens.push_back(new SimpleToken(FirstType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(FirstType, location));
                     break;
             }
 
         } else {
-            tokens.push_back(new SimpleToken(FirstType, iterator));
+            tokens.push_back(arena.create<SimpleToken>(FirstType, iterator));
         }
     }
 
     template<char FirstChar, char SecondChar, char ThirdChar, TokenType FirstType, TokenType SecondType, TokenType ThirdType, TokenType FourthType>
-    static void branch_1_or_2_len_3_char(TextIterator& iterator, std::vector<Token*>& tokens) {
+    static void branch_1_or_2_len_3_char(TextIterator& iterator, std::vector<Token*>& tokens, Arena& arena) {
         if(iterator.has_chars()) {
-            const auto line_offset = iterator.get_line_offset();
+            const auto location = iterator.get_location();
 
             auto unicode = *++iterator;
 
             switch(unicode) {
                 case static_cast<uint64_t>(FirstChar):
-                    tokens.push_back(new SimpleToken(SecondType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(SecondType, location));
                     break;
                 case static_cast<uint64_t>(SecondChar):
-                    tokens.push_back(new SimpleToken(ThirdType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(ThirdType, location));
                     break;
                 case static_cast<uint64_t>(ThirdChar):
-                    tokens.push_back(new SimpleToken(FourthType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(FourthType, location));
                     break;
                 default:
+                    KARMAC_LEX_STAT(backtracks++);
                     --iterator;
-                    tokens.push_back(new SimpleToken(FirstType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(FirstType, location));
                     break;
             }
 
         } else {
-            tokens.push_back(new SimpleToken(FirstType, iterator));
+            tokens.push_back(arena.create<SimpleToken>(FirstType, iterator));
         }
     }
 
     template<char FirstChar, char SecondChar, char ThirdChar, TokenType FirstType, TokenType SecondType, TokenType ThirdType, TokenType FourthType>
-    static void branch_1_or_2_len_2_1_char(TextIterator& iterator, std::vector<Token*>& tokens) {
+    static void branch_1_or_2_len_2_1_char(TextIterator& iterator, std::vector<Token*>& tokens, Arena& arena) {
         if(iterator.has_chars()) {
-            const auto line_offset = iterator.get_line_offset();
+            const auto location = iterator.get_location();
 
             auto unicode = *++iterator;
 
             switch(unicode) {
                 case static_cast<uint64_t>(FirstChar):
                     if(iterator.has_chars() && iterator[1] == static_cast<uint64_t>(SecondChar)) {
-                        tokens.push_back(new SimpleToken(ThirdType, line_offset));
+                        tokens.push_back(arena.create<SimpleToken>(ThirdType, location));
                         ++iterator;
                     } else {
-                        tokens.push_back(new SimpleToken(SecondType, line_offset));
+                        tokens.push_back(arena.create<SimpleToken>(SecondType, location));
                     }
                     break;
                 case static_cast<uint64_t>(ThirdChar):
-                    tokens.push_back(new SimpleToken(FourthType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(FourthType, location));
                     break;
                 default:
+                    KARMAC_LEX_STAT(backtracks++);
                     --iterator;
-                    tokens.push_back(new SimpleToken(FirstType, line_offset));
+                    tokens.push_back(arena.create<SimpleToken>(FirstType, location));
                     break;
             }
 
         } else {
-            tokens.push_back(new SimpleToken(FirstType, iterator));
+            tokens.push_back(arena.create<SimpleToken>(FirstType, iterator));
         }
     }
 
     template<TokenType OpeningType, TokenType ClosingType>
-    static void open_bracket(TextIterator& iterator, std::vector<Token*>& tokens, std::stack<TokenType>& pending_tokens) {
-        pending_tokens.push(ClosingType);
-        tokens.push_back(new SimpleToken(OpeningType, iterator));
-    }
-
-    template<TokenType OpeningType, TokenType ClosingType>
-    static void close_bracket(TextIterator& iterator, std::vector<Token*>& tokens, std::stack<TokenType>& pending_tokens) {
-        if(pending_tokens.empty()) {
-            throw std::runtime_error("TODO"); //TODO:
-        }
-
-        const auto last_token = pending_tokens.top();
-        pending_tokens.pop();
-
-        if(last_token != ClosingType) {
-            throw std::runtime_error("TODO"); //TODO:
-        }
-
-        tokens.push_back(new SimpleToken(ClosingType, iterator));
+    static void open_bracket(TextIterator& iterator, std::vector<Token*>& tokens, Arena& arena, BracketStack& pending_tokens) {
+        pending_tokens.push(ClosingType, static_cast<uint32_t>(tokens.size()));
+        tokens.push_back(arena.create<SimpleToken>(OpeningType, iterator));
     }
 }
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../token/token_type.hpp"
+#include "../../util/assert.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace karmac::tokenize {
+    //Token indices of a matching pair of brackets
+    struct BracketRange {
+        uint32_t open;
+        uint32_t close;
+    };
+
+    //Tracks the closing brackets that are still expected. When tokenizing a region in isolation,
+    //closing brackets without an opening counterpart in that region are recorded instead of rejected,
+    //so the region's bracket signature can be compared against the one it replaces.
+    //Outside of isolation, the ranges of the outermost curly brackets are recorded as they close
+    class BracketStack final {
+    private:
+        std::vector<TokenType> _pending;
+        //Token index of the opening bracket of each pending entry
+        std::vector<uint32_t> _openings;
+        std::vector<TokenType> _unmatched;
+        std::vector<BracketRange> _blocks;
+        bool _isolated = false;
+
+    public:
+        BracketStack() noexcept = default;
+        explicit BracketStack(bool isolated) noexcept : _isolated(isolated) {}
+
+        inline void push(TokenType closing_type, uint32_t index) {
+            _pending.push_back(closing_type);
+            _openings.push_back(index);
+        }
+
+        //Whether a closing bracket of `closing_type` closes an open bracket, in isolation one in front of the region
+        //as well
+        [[nodiscard]] inline bool can_close(TokenType closing_type) const noexcept {
+            return (_isolated && _pending.empty()) || std::find(_pending.begin(), _pending.end(), closing_type) != _pending.end();
+        }
+
+        //Closes the innermost open bracket of `closing_type` together with the brackets still open inside of it,
+        //`can_close` has to hold. Returns the closing type the innermost open bracket expected, which only differs
+        //from `closing_type` for mismatched brackets
+        inline TokenType pop(TokenType closing_type, uint32_t index) {
+            karmac_assert(can_close(closing_type));
+            if(_pending.empty()) {
+                _unmatched.push_back(closing_type);
+                return closing_type;
+            }
+
+            const auto expected = _pending.back();
+            auto opening = _openings.back();
+            while(_pending.back() != closing_type) {
+                _pending.pop_back();
+                _openings.pop_back();
+                opening = _openings.back();
+            }
+            _pending.pop_back();
+            _openings.pop_back();
+
+            if(closing_type == TokenType::RightCurlyBracket && _pending.empty() && !_isolated) {
+                _blocks.push_back({ opening, index });
+            }
+            return expected;
+        }
+
+        //Replays the effect of an already tokenized token, its closing brackets have to match
+        inline void apply(TokenType type, uint32_t index) {
+            switch(type) {
+                case TokenType::LeftBracket:
+                    push(TokenType::RightBracket, index);
+                    break;
+                case TokenType::LeftSquareBracket:
+                    push(TokenType::RightSquareBracket, index);
+                    break;
+                case TokenType::LeftCurlyBracket:
+                    push(TokenType::RightCurlyBracket, index);
+                    break;
+                case TokenType::RightBracket:
+                case TokenType::RightSquareBracket:
+                case TokenType::RightCurlyBracket:
+                    pop(type, index);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        inline void clear() noexcept {
+            _pending.clear();
+            _openings.clear();
+            _unmatched.clear();
+            _blocks.clear();
+        }
+
+        //Clears the stack but keeps the capacity of its buffers
+        inline void reset(bool isolated) noexcept {
+            clear();
+            _isolated = isolated;
+        }
+
+        [[nodiscard]] inline bool empty() const noexcept {
+            return _pending.empty() && _unmatched.empty();
+        }
+
+        //Matching curly brackets that are not nested in any other bracket, in token order
+        [[nodiscard]] inline const std::vector<BracketRange>& get_blocks() const noexcept {
+            return _blocks;
+        }
+
+        [[nodiscard]] inline bool operator ==(const BracketStack& other) const noexcept {
+            return _pending == other._pending && _unmatched == other._unmatched;
+        }
+
+        [[nodiscard]] inline bool operator !=(const BracketStack& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+}
\ No newline at end of file
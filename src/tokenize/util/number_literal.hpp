@@ -1,67 +1,137 @@
 #pragma once
 
+#include "../token/literal_token.hpp"
 #include "../tokenize_exception.hpp"
 #include "../../util/text/character.hpp"
 #include "../../util/text/text_iterator.hpp"
+#include <charconv>
+#include <limits>
 #include <string>
 
 namespace karmac::tokenize::number_literal {
-    [[nodiscard]] inline uint64_t parse_bin(TextIterator& iterator) {
+    [[nodiscard]] inline uint64_t get_digit(uint64_t unicode) noexcept {
+        if(unicode >= static_cast<uint64_t>('0') && unicode <= static_cast<uint64_t>('9')) {
+            return unicode - static_cast<uint64_t>('0');
+        }
+        if(unicode >= static_cast<uint64_t>('a') && unicode <= static_cast<uint64_t>('f')) {
+            return unicode - static_cast<uint64_t>('a') + 10;
+        }
+        if(unicode >= static_cast<uint64_t>('A') && unicode <= static_cast<uint64_t>('F')) {
+            return unicode - static_cast<uint64_t>('A') + 10;
+        }
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    //Parses digits of the given radix, '_' can be used as separator
+    template<uint64_t Radix>
+    [[nodiscard]] inline uint64_t parse_integer(TextIterator& iterator) {
+        const auto start = iterator.get_location();
         auto unicode = *iterator;
 
         uint64_t literal = 0;
+        auto has_digits = false;
+
+        while(unicode == static_cast<uint64_t>('_') || get_digit(unicode) < Radix) {
+            if(unicode != static_cast<uint64_t>('_')) {
+                const auto digit = get_digit(unicode);
+                has_digits = true;
 
-        while(character::is_bin_digit(unicode) || unicode == static_cast<uint64_t>('_')) {
-            if(unicode != static_cast<uint64_t>('_')) { //TODO: overflow check
-                literal = (literal << 1) | (unicode - static_cast<uint64_t>('0'));
+                if(literal > (std::numeric_limits<uint64_t>::max() - digit) / Radix) {
+                    throw TokenizeException(start, "Integer literal doesn't fit 64 bits");
+                }
+                literal = literal * Radix + digit;
             }
 
             unicode = *++iterator;
         }
 
+        if(!has_digits) {
+            throw TokenizeException(iterator.get_location(), "Expected a digit");
+        }
+
         return literal;
     }
 
+    [[nodiscard]] inline uint64_t parse_bin(TextIterator& iterator) {
+        return parse_integer<2>(iterator);
+    }
+
     [[nodiscard]] inline uint64_t parse_oct(TextIterator& iterator) {
-        auto unicode = *iterator;
+        return parse_integer<8>(iterator);
+    }
 
-        uint64_t literal = 0;
+    [[nodiscard]] inline uint64_t parse_hex(TextIterator& iterator) {
+        return parse_integer<16>(iterator);
+    }
 
-        while(character::is_oct_digit(unicode)) {
-            if(unicode != static_cast<uint64_t>('_')) { //TODO: overflow check
-                literal = (literal << 3) | (unicode - static_cast<uint64_t>('7'));
-            }
+    //Parses a decimal integer or float literal without suffix, returns true if it is a float literal
+    [[nodiscard]] inline bool parse_dec(TextIterator& iterator, uint64_t& integer, double& floating) {
+        const auto start = iterator.get_location();
+        std::string digits;
+        auto is_float = false;
+        auto is_overflow = false;
 
-            unicode = *++iterator;
-        }
+        integer = 0;
 
-        return literal;
-    }
+        const auto append_digits = [&](bool is_integer_part) {
+            auto unicode = *iterator;
+            while(unicode == static_cast<uint64_t>('_') || character::is_dec_digit(unicode)) {
+                if(unicode != static_cast<uint64_t>('_')) {
+                    digits += static_cast<char>(unicode);
 
-    [[nodiscard]] inline uint64_t parse_hex(TextIterator& iterator) {
-        auto unicode = *iterator;
+                    if(is_integer_part) {
+                        const auto digit = unicode - static_cast<uint64_t>('0');
+                        if(integer > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+                            is_overflow = true;
+                        }
+                        integer = integer * 10 + digit;
+                    }
+                }
 
-        uint64_t literal = 0;
+                unicode = *++iterator;
+            }
+        };
+
+        append_digits(true);
+
+        //A dot that isn't followed by a digit belongs to the next token, e.g. the range 0..10
+        if(*iterator == static_cast<uint64_t>('.') && character::is_dec_digit(iterator[1])) {
+            is_float = true;
+            digits += '.';
+            ++iterator;
+            append_digits(false);
+        }
+
+        if(*iterator == static_cast<uint64_t>('e') || *iterator == static_cast<uint64_t>('E')) {
+            const auto sign = iterator[1];
+            const auto has_sign = sign == static_cast<uint64_t>('+') || sign == static_cast<uint64_t>('-');
 
-        while(character::is_hex_digit(unicode)) {
-            if(unicode != static_cast<uint64_t>('_')) { //TODO: overflow check
-                uint64_t digit = 0;
+            if(character::is_dec_digit(iterator[has_sign ? 2 : 1])) {
+                is_float = true;
+                digits += 'e';
+                ++iterator;
 
-                if(unicode >= static_cast<uint64_t>('0') && unicode <= static_cast<uint64_t>('9')) {
-                    digit = unicode - static_cast<uint64_t>('0');
-                } else if(unicode >= static_cast<uint64_t>('a') && unicode <= static_cast<uint64_t>('f')) {
-                    digit = unicode - static_cast<uint64_t>('a') + 10;
-                } else if(unicode >= static_cast<uint64_t>('A') && unicode <= static_cast<uint64_t>('F')) {
-                    digit = unicode - static_cast<uint64_t>('A') + 10;
+                if(has_sign) {
+                    digits += static_cast<char>(sign);
+                    ++iterator;
                 }
+                append_digits(false);
+            }
+        }
 
-                literal = (literal << 4) | digit;
+        if(is_float) {
+            const auto result = std::from_chars(digits.data(), digits.data() + digits.size(), floating);
+            if(result.ec == std::errc::result_out_of_range) {
+                throw TokenizeException(start, "Float literal is out of range");
             }
+            return true;
+        }
 
-            unicode = *++iterator;
+        if(is_overflow) {
+            throw TokenizeException(start, "Integer literal doesn't fit 64 bits");
         }
 
-        return literal;
+        return false;
     }
 
     [[nodiscard]] inline bool parse_type(TextIterator& iterator, TokenType& type) {
@@ -161,5 +231,62 @@ namespace karmac::tokenize::number_literal {
                 return false;
                 break;
         }
+
+        return false;
+    }
+
+    template<typename T>
+    [[nodiscard]] inline T to_integer(uint64_t value, TokenType type, SourceLocation location) {
+        //The magnitude of the minimum of signed types is accepted, so that it can be negated
+        constexpr auto max = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (std::is_signed_v<T> ? 1 : 0);
+
+        if(value > max) {
+            const auto name = token_type::get_name(type);
+            throw TokenizeException(location, "Integer literal doesn't fit {}", name.substr(0, name.find('_')));
+        }
+
+        return static_cast<T>(value);
+    }
+
+    [[nodiscard]] inline Token* create_token(Arena& arena, TokenType type, uint64_t integer, double floating, bool is_float, SourceLocation location) {
+        if(is_float && token_type::is_integer_literal(type)) {
+            throw TokenizeException(location, "Float literal with an integer suffix");
+        }
+
+        const auto value = is_float ? floating : static_cast<double>(integer);
+
+        switch(type) {
+            case TokenType::U8Literal:
+                return arena.create<U8LiteralToken>(to_integer<uint8_t>(integer, type, location), arena, location);
+            case TokenType::I8Literal:
+                return arena.create<I8LiteralToken>(to_integer<int8_t>(integer, type, location), arena, location);
+            case TokenType::U16Literal:
+                return arena.create<U16LiteralToken>(to_integer<uint16_t>(integer, type, location), arena, location);
+            case TokenType::I16Literal:
+                return arena.create<I16LiteralToken>(to_integer<int16_t>(integer, type, location), arena, location);
+            case TokenType::U32Literal:
+                return arena.create<U32LiteralToken>(to_integer<uint32_t>(integer, type, location), arena, location);
+            case TokenType::I32Literal:
+                return arena.create<I32LiteralToken>(to_integer<int32_t>(integer, type, location), arena, location);
+            case TokenType::U64Literal:
+                return arena.create<U64LiteralToken>(to_integer<uint64_t>(integer, type, location), arena, location);
+            case TokenType::I64Literal:
+                return arena.create<I64LiteralToken>(to_integer<int64_t>(integer, type, location), arena, location);
+            case TokenType::USizeLiteral:
+                return arena.create<USizeLiteralToken>(to_integer<size_t>(integer, type, location), arena, location);
+            case TokenType::ISizeLiteral:
+                return arena.create<ISizeLiteralToken>(to_integer<ptrdiff_t>(integer, type, location), arena, location);
+            case TokenType::F32Literal:
+                return arena.create<F32LiteralToken>(static_cast<float>(value), arena, location);
+            case TokenType::F64Literal:
+                return arena.create<F64LiteralToken>(value, arena, location);
+            case TokenType::IntegerLiteral:
+                return arena.create<IntegerLiteralToken>(integer, arena, location);
+            case TokenType::FloatLiteral:
+                return arena.create<FloatLiteralToken>(floating, arena, location);
+            default:
+                karmac_unimplemented();
+                return nullptr;
+        }
     }
 }
\ No newline at end of file
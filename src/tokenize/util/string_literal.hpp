@@ -1,26 +1,31 @@
 #pragma once
 
 #include "../../util/text/text_iterator.hpp"
+#include "../lex_stats.hpp"
 #include "../tokenize_exception.hpp"
 #include <string>
 
 namespace karmac::tokenize::string_literal {
-    [[nodiscard]] inline std::string parse(TextIterator& iterator) {
-        std::string literal;
+    //Appends the unescaped literal to `literal` and stops at the closing quote, returns false if the source ends
+    //before it. Invalid escapes are thrown at their char.
+    [[nodiscard]] inline bool parse(TextIterator& iterator, std::string& literal) {
         char buffer[7];
 
+        KARMAC_LEX_STAT(string_literals++);
+
         while (iterator.has_chars()) {
             auto current = *iterator;
             switch (current) {
                 case static_cast<uint64_t>('"'):
-                    ++iterator;
-                    return literal;
+                    return true;
                 case static_cast<uint64_t>('\\'): {
+                    KARMAC_LEX_STAT(string_escapes++);
+
+                    current = *++iterator;
                     if (!iterator.has_chars()) {
-                        throw std::runtime_error("Invalid token: \\");
+                        return false;
                     }
 
-                    current = *++iterator;
                     switch (current) {
                         case static_cast<uint64_t>('"'):
                             literal += '"';
@@ -47,8 +52,7 @@ namespace karmac::tokenize::string_literal {
                             literal += '\t';
                             break;
                         case static_cast<uint64_t>('u'):
-                            karmac_unimplemented();
-                            break;
+                            throw TokenizeException(iterator.get_location(), "Unicode escapes aren't supported yet");
                         case static_cast<uint64_t>('v'):
                             literal += '\v';
                             break;
@@ -56,7 +60,8 @@ namespace karmac::tokenize::string_literal {
                             literal += '\\';
                             break;
                         default:
-                            throw std::runtime_error("Invalid token: TODO");
+                            utf8::from_unicode(current, buffer);
+                            throw TokenizeException(iterator.get_location(), "Invalid escape sequence \"\\{}\"", buffer);
                     }
                 }
                     break;
@@ -66,10 +71,11 @@ namespace karmac::tokenize::string_literal {
                     break;
             }
 
+            KARMAC_LEX_STAT(string_chars++);
             ++iterator;
 
         }
 
-        throw std::runtime_error("Invalid token, expected \"");
+        return false;
     }
 }
\ No newline at end of file
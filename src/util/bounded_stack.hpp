@@ -0,0 +1,68 @@
+#pragma once
+
+#include "assert.hpp"
+#include <array>
+#include <cstddef>
+
+namespace karmac {
+    //Stack that only remembers its last `Capacity` elements, older ones are overwritten. Iterators only ever
+    //step back a few chars, so their history doesn't have to grow with the text.
+    template<typename T, size_t Capacity>
+    class BoundedStack final {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+    private:
+        std::array<T, Capacity> _elements {};
+        size_t _head = 0;
+        size_t _size = 0;
+
+    public:
+        inline void push(const T& value) noexcept {
+            _elements[_head] = value;
+            _head = (_head + 1) & (Capacity - 1);
+            if(_size < Capacity) {
+                ++_size;
+            }
+        }
+
+        inline void pop() noexcept {
+            karmac_assert(_size > 0);
+            _head = (_head - 1) & (Capacity - 1);
+            --_size;
+        }
+
+        [[nodiscard]] inline const T& top() const noexcept {
+            karmac_assert(_size > 0);
+            return _elements[(_head - 1) & (Capacity - 1)];
+        }
+
+        inline void clear() noexcept {
+            _head = 0;
+            _size = 0;
+        }
+
+        [[nodiscard]] inline bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] inline bool operator ==(const BoundedStack& other) const noexcept {
+            if(_size != other._size) {
+                return false;
+            }
+
+            for(size_t i = 1; i <= _size; i++) {
+                if(_elements[(_head - i) & (Capacity - 1)] != other._elements[(other._head - i) & (Capacity - 1)]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        [[nodiscard]] inline bool operator !=(const BoundedStack& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Based on https://github.com/wangyi-fudan/wyhash (final version 4)
+namespace karmac::hash {
+    static constexpr uint64_t _SECRET[4] = { 0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull };
+
+    inline void multiply(uint64_t& a, uint64_t& b) noexcept {
+#ifdef _MSC_VER
+        a = _umul128(a, b, &b);
+#else
+        const auto result = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(result);
+        b = static_cast<uint64_t>(result >> 64);
+#endif
+    }
+
+    [[nodiscard]] inline uint64_t mix(uint64_t a, uint64_t b) noexcept {
+        multiply(a, b);
+        return a ^ b;
+    }
+
+    [[nodiscard]] inline uint64_t read_8(const uint8_t* p) noexcept {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] inline uint64_t read_4(const uint8_t* p) noexcept {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] inline uint64_t read_3(const uint8_t* p, size_t len) noexcept {
+        return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+    }
+
+    [[nodiscard]] inline uint64_t hash64(const std::string_view& data, uint64_t seed = 0) noexcept {
+        const auto* p = reinterpret_cast<const uint8_t*>(data.data());
+        const auto len = data.size();
+
+        seed ^= mix(seed ^ _SECRET[0], _SECRET[1]);
+
+        uint64_t a;
+        uint64_t b;
+        if(len <= 16) {
+            if(len >= 4) {
+                a = (read_4(p) << 32) | read_4(p + ((len >> 3) << 2));
+                b = (read_4(p + len - 4) << 32) | read_4(p + len - 4 - ((len >> 3) << 2));
+            } else if(len > 0) {
+                a = read_3(p, len);
+                b = 0;
+            } else {
+                a = 0;
+                b = 0;
+            }
+        } else {
+            auto remaining = len;
+            if(remaining > 48) {
+                auto seed_1 = seed;
+                auto seed_2 = seed;
+                do {
+                    seed = mix(read_8(p) ^ _SECRET[1], read_8(p + 8) ^ seed);
+                    seed_1 = mix(read_8(p + 16) ^ _SECRET[2], read_8(p + 24) ^ seed_1);
+                    seed_2 = mix(read_8(p + 32) ^ _SECRET[3], read_8(p + 40) ^ seed_2);
+                    p += 48;
+                    remaining -= 48;
+                } while(remaining > 48);
+                seed ^= seed_1 ^ seed_2;
+            }
+            while(remaining > 16) {
+                seed = mix(read_8(p) ^ _SECRET[1], read_8(p + 8) ^ seed);
+                remaining -= 16;
+                p += 16;
+            }
+            a = read_8(p + remaining - 16);
+            b = read_8(p + remaining - 8);
+        }
+
+        a ^= _SECRET[1];
+        b ^= seed;
+        multiply(a, b);
+
+        return mix(a ^ _SECRET[0] ^ len, b ^ _SECRET[1]);
+    }
+}
\ No newline at end of file
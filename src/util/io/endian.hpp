@@ -0,0 +1,41 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace karmac::endian {
+    template<typename T>
+    [[nodiscard]] inline T read_le(const char* p) noexcept {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+
+        if constexpr(std::endian::native == std::endian::big && sizeof(T) > 1) {
+            if constexpr(std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+                return std::bit_cast<T>(std::byteswap(std::bit_cast<Bits>(value)));
+            } else {
+                return std::byteswap(value);
+            }
+        }
+
+        return value;
+    }
+
+    template<typename T>
+    inline void write_le(std::string& buffer, T value) {
+        if constexpr(std::endian::native == std::endian::big && sizeof(T) > 1) {
+            if constexpr(std::is_floating_point_v<T>) {
+                using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+                value = std::bit_cast<T>(std::byteswap(std::bit_cast<Bits>(value)));
+            } else {
+                value = std::byteswap(value);
+            }
+        }
+
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        buffer.append(bytes, sizeof(T));
+    }
+}
\ No newline at end of file
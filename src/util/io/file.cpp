@@ -0,0 +1,33 @@
+#include "file.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace karmac::io {
+    std::string read_file(const std::filesystem::path& path) {
+        std::ifstream input_stream(path, std::ios_base::binary | std::ios_base::ate);
+        if(input_stream.fail()) {
+            throw std::runtime_error("Failed to open file");
+        }
+
+        const auto size = static_cast<size_t>(input_stream.tellg());
+        input_stream.seekg(0);
+
+        std::string text(size, '\0');
+        if(!input_stream.read(text.data(), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Failed to read file");
+        }
+
+        return text;
+    }
+
+    void write_file(const std::filesystem::path& path, std::string_view data) {
+        std::ofstream output_stream(path, std::ios_base::binary | std::ios_base::trunc);
+        if(output_stream.fail()) {
+            throw std::runtime_error("Failed to open file");
+        }
+        if(!output_stream.write(data.data(), static_cast<std::streamsize>(data.size()))) {
+            throw std::runtime_error("Failed to write file");
+        }
+    }
+}
\ No newline at end of file
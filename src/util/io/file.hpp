@@ -0,0 +1,13 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace karmac::io {
+    //Reads the whole file, the returned string is null terminated like every std::string
+    [[nodiscard]] std::string read_file(const std::filesystem::path& path);
+
+    //Replaces the file with `data`
+    void write_file(const std::filesystem::path& path, std::string_view data);
+}
\ No newline at end of file
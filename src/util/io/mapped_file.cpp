@@ -0,0 +1,118 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace karmac {
+    MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef WIN32
+        _file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(_file_handle == INVALID_HANDLE_VALUE) {
+            _file_handle = nullptr;
+            throw std::runtime_error("Failed to open file");
+        }
+
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(_file_handle, &size)) {
+            unmap();
+            throw std::runtime_error("Failed to query file size");
+        }
+        _size = static_cast<size_t>(size.QuadPart);
+
+        if(_size == 0) {
+            return;
+        }
+
+        _mapping_handle = CreateFileMappingW(_file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(_mapping_handle == nullptr) {
+            unmap();
+            throw std::runtime_error("Failed to map file");
+        }
+
+        _data = static_cast<const char*>(MapViewOfFile(_mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if(_data == nullptr) {
+            unmap();
+            throw std::runtime_error("Failed to map file");
+        }
+#else
+        const auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(fd == -1) {
+            throw std::runtime_error("Failed to open file");
+        }
+
+        struct stat status {};
+        if(fstat(fd, &status) != 0) {
+            close(fd);
+            throw std::runtime_error("Failed to query file size");
+        }
+        _size = static_cast<size_t>(status.st_size);
+
+        if(_size != 0) {
+            auto* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("Failed to map file");
+            }
+            _data = static_cast<const char*>(data);
+        }
+
+        close(fd);
+#endif
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : _data(std::exchange(other._data, nullptr)), _size(std::exchange(other._size, 0))
+#ifdef WIN32
+        , _file_handle(std::exchange(other._file_handle, nullptr)), _mapping_handle(std::exchange(other._mapping_handle, nullptr))
+#endif
+    {}
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile& MappedFile::operator =(MappedFile&& other) noexcept {
+        if(this != &other) {
+            unmap();
+
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+#ifdef WIN32
+            _file_handle = std::exchange(other._file_handle, nullptr);
+            _mapping_handle = std::exchange(other._mapping_handle, nullptr);
+#endif
+        }
+
+        return *this;
+    }
+
+    void MappedFile::unmap() noexcept {
+#ifdef WIN32
+        if(_data != nullptr) {
+            UnmapViewOfFile(_data);
+        }
+        if(_mapping_handle != nullptr) {
+            CloseHandle(_mapping_handle);
+        }
+        if(_file_handle != nullptr) {
+            CloseHandle(_file_handle);
+        }
+        _file_handle = nullptr;
+        _mapping_handle = nullptr;
+#else
+        if(_data != nullptr) {
+            munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+}
\ No newline at end of file
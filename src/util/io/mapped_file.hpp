@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace karmac {
+    //Read-only memory mapping of a whole file
+    class MappedFile final {
+    private:
+        const char* _data = nullptr;
+        size_t _size = 0;
+#ifdef WIN32
+        void* _file_handle = nullptr;
+        void* _mapping_handle = nullptr;
+#endif
+
+        void unmap() noexcept;
+    public:
+        explicit MappedFile(const std::filesystem::path& path);
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile(const MappedFile&) = delete;
+        ~MappedFile();
+
+        MappedFile& operator =(MappedFile&& other) noexcept;
+        MappedFile& operator =(const MappedFile&) = delete;
+
+        [[nodiscard]] inline std::string_view get_data() const noexcept {
+            return { _data, _size };
+        }
+
+        [[nodiscard]] inline size_t get_size() const noexcept {
+            return _size;
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "arena.hpp"
+
+#include <algorithm>
+
+namespace karmac {
+    Arena::Arena(Arena&& other) noexcept
+        : _chunks(std::move(other._chunks)), _chunk_index(other._chunk_index), _head(other._head), _end(other._end),
+          _next_chunk_size(other._next_chunk_size), _allocated_bytes(other._allocated_bytes) {
+        other._chunks.clear();
+        other._chunk_index = 0;
+        other._head = nullptr;
+        other._end = nullptr;
+        other._allocated_bytes = 0;
+    }
+
+    Arena& Arena::operator =(Arena&& other) noexcept {
+        if(this != &other) {
+            _chunks = std::move(other._chunks);
+            _chunk_index = other._chunk_index;
+            _head = other._head;
+            _end = other._end;
+            _next_chunk_size = other._next_chunk_size;
+            _allocated_bytes = other._allocated_bytes;
+
+            other._chunks.clear();
+            other._chunk_index = 0;
+            other._head = nullptr;
+            other._end = nullptr;
+            other._allocated_bytes = 0;
+        }
+        return *this;
+    }
+
+    void* Arena::allocate_slow(size_t size, size_t alignment) {
+        const auto required = size + alignment - 1;
+
+        //Chunks kept by reset() are reused in order, chunks that are too small for this allocation are skipped
+        auto index = _head == nullptr ? 0 : _chunk_index + 1;
+        while(index < _chunks.size() && _chunks[index].size < required) {
+            ++index;
+        }
+
+        if(index >= _chunks.size()) {
+            const auto chunk_size = std::max(_next_chunk_size, required);
+            _next_chunk_size = std::min(_next_chunk_size * 2, _MAX_CHUNK_SIZE);
+
+            _chunks.push_back({ std::make_unique_for_overwrite<std::byte[]>(chunk_size), chunk_size });
+            index = _chunks.size() - 1;
+        }
+
+        _chunk_index = index;
+        _head = _chunks[index].data.get();
+        _end = _head + _chunks[index].size;
+
+        return allocate(size, alignment);
+    }
+
+    void Arena::reset() noexcept {
+        _chunk_index = 0;
+        _head = nullptr;
+        _end = nullptr;
+        _allocated_bytes = 0;
+    }
+
+    void Arena::release() noexcept {
+        _chunks.clear();
+        reset();
+    }
+
+    size_t Arena::get_capacity() const noexcept {
+        size_t capacity = 0;
+        for(const auto& chunk : _chunks) {
+            capacity += chunk.size;
+        }
+        return capacity;
+    }
+}
\ No newline at end of file
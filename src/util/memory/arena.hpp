@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace karmac {
+    //Bump pointer allocator for objects that share one lifetime, e.g. all tokens of a file. Objects are never
+    //destroyed individually, `reset` rewinds to the first chunk and keeps all chunks for the next use,
+    //`release` frees them. Both cost O(number of chunks).
+    class Arena final {
+    private:
+        struct Chunk {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        static constexpr size_t _MAX_CHUNK_SIZE = 4 * 1024 * 1024;
+
+        std::vector<Chunk> _chunks;
+        size_t _chunk_index = 0;
+        std::byte* _head = nullptr;
+        std::byte* _end = nullptr;
+
+        size_t _next_chunk_size;
+        size_t _allocated_bytes = 0;
+
+        [[nodiscard]] void* allocate_slow(size_t size, size_t alignment);
+    public:
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+        explicit Arena(size_t chunk_size = DEFAULT_CHUNK_SIZE) noexcept : _next_chunk_size(chunk_size) {}
+        Arena(Arena&& other) noexcept;
+        Arena(const Arena&) = delete;
+
+        Arena& operator =(Arena&& other) noexcept;
+        Arena& operator =(const Arena&) = delete;
+
+        [[nodiscard]] inline void* allocate(size_t size, size_t alignment) {
+            auto* p = reinterpret_cast<std::byte*>((reinterpret_cast<uintptr_t>(_head) + alignment - 1) & ~(alignment - 1));
+            if(_head != nullptr && p + size <= _end) {
+                _head = p + size;
+                _allocated_bytes += size;
+                return p;
+            }
+
+            return allocate_slow(size, alignment);
+        }
+
+        //The destructor of T is never called
+        template<typename T, typename... Args>
+        [[nodiscard]] inline T* create(Args&&... args) {
+            static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+            return new(allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] inline std::string_view copy(const std::string_view& string) {
+            if(string.empty()) {
+                return {};
+            }
+
+            auto* data = static_cast<char*>(allocate(string.size(), 1));
+            std::memcpy(data, string.data(), string.size());
+            return { data, string.size() };
+        }
+
+        void reset() noexcept;
+        void release() noexcept;
+
+        [[nodiscard]] inline size_t get_allocated_bytes() const noexcept {
+            return _allocated_bytes;
+        }
+
+        [[nodiscard]] size_t get_capacity() const noexcept;
+
+        [[nodiscard]] inline size_t get_chunk_count() const noexcept {
+            return _chunks.size();
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "executable_memory.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#ifdef WIN32
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace karmac {
+    ExecutableMemory::ExecutableMemory(std::string_view code) : _size(code.empty() ? 1 : code.size()) {
+        //The pages are only made executable after the code is written
+#ifdef WIN32
+        _data = VirtualAlloc(nullptr, _size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if(_data == nullptr) {
+            throw std::runtime_error("Failed to allocate executable memory");
+        }
+        std::memcpy(_data, code.data(), code.size());
+
+        DWORD old_protection;
+        if(!VirtualProtect(_data, _size, PAGE_EXECUTE_READ, &old_protection)) {
+            release();
+            throw std::runtime_error("Failed to protect executable memory");
+        }
+        FlushInstructionCache(GetCurrentProcess(), _data, _size);
+#else
+        auto* data = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(data == MAP_FAILED) {
+            throw std::runtime_error("Failed to allocate executable memory");
+        }
+        _data = data;
+        std::memcpy(_data, code.data(), code.size());
+
+        if(mprotect(_data, _size, PROT_READ | PROT_EXEC) != 0) {
+            release();
+            throw std::runtime_error("Failed to protect executable memory");
+        }
+#endif
+    }
+
+    ExecutableMemory::~ExecutableMemory() {
+        release();
+    }
+
+    void ExecutableMemory::release() noexcept {
+        if(_data == nullptr) {
+            return;
+        }
+#ifdef WIN32
+        VirtualFree(_data, 0, MEM_RELEASE);
+#else
+        munmap(_data, _size);
+#endif
+        _data = nullptr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace karmac {
+    //A copy of machine code in pages that are executable but not writable
+    class ExecutableMemory final {
+    private:
+        void* _data = nullptr;
+        size_t _size = 0;
+
+        void release() noexcept;
+    public:
+        //Throws std::runtime_error if the pages can't be mapped or protected
+        explicit ExecutableMemory(std::string_view code);
+        ExecutableMemory(const ExecutableMemory&) = delete;
+        ~ExecutableMemory();
+
+        ExecutableMemory& operator =(const ExecutableMemory&) = delete;
+
+        [[nodiscard]] inline uintptr_t get_address(size_t offset = 0) const noexcept {
+            return reinterpret_cast<uintptr_t>(_data) + offset;
+        }
+    };
+}
\ No newline at end of file
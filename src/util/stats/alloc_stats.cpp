@@ -0,0 +1,196 @@
+#include "alloc_stats.hpp"
+#include "memory.hpp"
+
+#include <fmt/format.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace karmac::alloc_stats {
+    struct AtomicPhaseStatistics {
+        std::atomic<uint64_t> allocations = 0;
+        std::atomic<uint64_t> frees = 0;
+        std::atomic<uint64_t> bytes = 0;
+        std::atomic<uint64_t> live_bytes = 0;
+        std::atomic<uint64_t> peak_live_bytes = 0;
+    };
+
+    static AtomicPhaseStatistics _phases[static_cast<size_t>(Phase::Count)];
+    static AtomicPhaseStatistics _total;
+    static thread_local Phase _current_phase = Phase::Other;
+
+    std::string_view get_name(Phase phase) noexcept {
+        using namespace std::string_view_literals;
+
+        switch (phase) {
+            case Phase::Other:
+                return "other"sv;
+            case Phase::Load:
+                return "load"sv;
+            case Phase::Lex:
+                return "lex"sv;
+            case Phase::Parse:
+                return "parse"sv;
+            case Phase::Resolve:
+                return "resolve"sv;
+            case Phase::Check:
+                return "check"sv;
+            case Phase::Codegen:
+                return "codegen"sv;
+            case Phase::Run:
+                return "run"sv;
+            case Phase::Cache:
+                return "cache"sv;
+            case Phase::Output:
+                return "output"sv;
+            default:
+                return "[unknown]"sv;
+        }
+    }
+
+    static PhaseStatistics load(const AtomicPhaseStatistics& statistics) noexcept {
+        return {
+            statistics.allocations.load(std::memory_order_relaxed),
+            statistics.frees.load(std::memory_order_relaxed),
+            statistics.bytes.load(std::memory_order_relaxed),
+            statistics.live_bytes.load(std::memory_order_relaxed),
+            statistics.peak_live_bytes.load(std::memory_order_relaxed)
+        };
+    }
+
+    PhaseStatistics get_statistics(Phase phase) noexcept {
+        return load(_phases[static_cast<size_t>(phase)]);
+    }
+
+    PhaseStatistics get_total_statistics() noexcept {
+        return load(_total);
+    }
+
+    void print_report(std::FILE* file, uint64_t source_bytes) {
+        const auto per_source_byte = [source_bytes](uint64_t bytes) {
+            return source_bytes == 0 ? 0.0 : static_cast<double>(bytes) / static_cast<double>(source_bytes);
+        };
+
+        if constexpr(is_enabled()) {
+            fmt::print(file, "{:<8} {:>12} {:>12} {:>14} {:>14} {:>12}\n", "phase", "allocs", "frees", "bytes", "peak live", "bytes/src");
+
+            for(size_t i = 0; i < static_cast<size_t>(Phase::Count); i++) {
+                const auto statistics = get_statistics(static_cast<Phase>(i));
+                if(statistics.allocations == 0) {
+                    continue;
+                }
+
+                fmt::print(file, "{:<8} {:>12} {:>12} {:>14} {:>14} {:>12.2f}\n", get_name(static_cast<Phase>(i)), statistics.allocations,
+                           statistics.frees, statistics.bytes, statistics.peak_live_bytes, per_source_byte(statistics.bytes));
+            }
+
+            const auto total = get_total_statistics();
+            fmt::print(file, "{:<8} {:>12} {:>12} {:>14} {:>14} {:>12.2f}\n", "total", total.allocations, total.frees, total.bytes,
+                       total.peak_live_bytes, per_source_byte(total.bytes));
+        } else {
+            fmt::print(file, "allocation statistics are not available, build with KARMAC_ALLOC_STATS=ON\n");
+        }
+
+        fmt::print(file, "source bytes: {}, peak rss: {} bytes\n", source_bytes, stats::get_peak_rss());
+    }
+
+    PhaseScope::PhaseScope(Phase phase) noexcept : _previous(_current_phase) {
+        _current_phase = phase;
+    }
+
+    PhaseScope::~PhaseScope() {
+        _current_phase = _previous;
+    }
+
+#ifdef KARMAC_ALLOC_STATS
+    //Every allocation is prefixed with its size and phase, keeping the alignment guaranteed by malloc
+    struct alignas(alignof(std::max_align_t)) AllocationHeader {
+        uint64_t size;
+        Phase phase;
+    };
+
+    static void update_peak(std::atomic<uint64_t>& peak, uint64_t value) noexcept {
+        auto current = peak.load(std::memory_order_relaxed);
+        while(value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+
+    static void record_allocation(AtomicPhaseStatistics& statistics, uint64_t size) noexcept {
+        statistics.allocations.fetch_add(1, std::memory_order_relaxed);
+        statistics.bytes.fetch_add(size, std::memory_order_relaxed);
+        update_peak(statistics.peak_live_bytes, statistics.live_bytes.fetch_add(size, std::memory_order_relaxed) + size);
+    }
+
+    static void record_free(AtomicPhaseStatistics& statistics, uint64_t size) noexcept {
+        statistics.frees.fetch_add(1, std::memory_order_relaxed);
+        statistics.live_bytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    void* allocate(size_t size) noexcept {
+        auto* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+        if(header == nullptr) {
+            return nullptr;
+        }
+
+        header->size = size;
+        header->phase = _current_phase;
+
+        record_allocation(_phases[static_cast<size_t>(header->phase)], size);
+        record_allocation(_total, size);
+
+        return header + 1;
+    }
+
+    void deallocate(void* p) noexcept {
+        if(p == nullptr) {
+            return;
+        }
+
+        auto* header = static_cast<AllocationHeader*>(p) - 1;
+
+        record_free(_phases[static_cast<size_t>(header->phase)], header->size);
+        record_free(_total, header->size);
+
+        std::free(header);
+    }
+#endif
+}
+
+#ifdef KARMAC_ALLOC_STATS
+void* operator new(size_t size) {
+    if(auto* p = karmac::alloc_stats::allocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if(auto* p = karmac::alloc_stats::allocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return karmac::alloc_stats::allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return karmac::alloc_stats::allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    karmac::alloc_stats::deallocate(p);
+}
+
+void operator delete[](void* p) noexcept {
+    karmac::alloc_stats::deallocate(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    karmac::alloc_stats::deallocate(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    karmac::alloc_stats::deallocate(p);
+}
+#endif
\ No newline at end of file
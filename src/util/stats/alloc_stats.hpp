@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+//Allocation statistics per compiler phase. The global operator new is only replaced when karmac is built
+//with KARMAC_ALLOC_STATS, otherwise the phase markers compile to nothing.
+namespace karmac::alloc_stats {
+    enum class Phase : uint8_t {
+        Other,
+        Load,
+        Lex,
+        Parse,
+        Resolve,
+        Check,
+        Codegen,
+        Run,
+        Cache,
+        Output,
+        Count
+    };
+
+    struct PhaseStatistics {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        uint64_t bytes = 0;
+        uint64_t live_bytes = 0;
+        uint64_t peak_live_bytes = 0;
+    };
+
+    [[nodiscard]] std::string_view get_name(Phase phase) noexcept;
+
+    [[nodiscard]] constexpr bool is_enabled() noexcept {
+#ifdef KARMAC_ALLOC_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    [[nodiscard]] PhaseStatistics get_statistics(Phase phase) noexcept;
+    [[nodiscard]] PhaseStatistics get_total_statistics() noexcept;
+
+    //Prints the statistics of all phases, `source_bytes` is used to report the memory per byte of source code
+    void print_report(std::FILE* file, uint64_t source_bytes);
+
+    //Attributes all allocations of the current thread to a phase while alive
+    class PhaseScope final {
+    private:
+        Phase _previous;
+
+    public:
+        explicit PhaseScope(Phase phase) noexcept;
+        PhaseScope(const PhaseScope&) = delete;
+        ~PhaseScope();
+
+        PhaseScope& operator =(const PhaseScope&) = delete;
+    };
+}
+
+#ifdef KARMAC_ALLOC_STATS
+#define KARMAC_ALLOC_PHASE_CONCAT_IMPL(x, y) x##y
+#define KARMAC_ALLOC_PHASE_CONCAT(x, y) KARMAC_ALLOC_PHASE_CONCAT_IMPL(x, y)
+#define KARMAC_ALLOC_PHASE(phase) const ::karmac::alloc_stats::PhaseScope KARMAC_ALLOC_PHASE_CONCAT(_alloc_phase_, __LINE__)(::karmac::alloc_stats::Phase::phase)
+#else
+#define KARMAC_ALLOC_PHASE(phase) static_cast<void>(0)
+#endif
\ No newline at end of file
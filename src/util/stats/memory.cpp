@@ -0,0 +1,97 @@
+#include "memory.hpp"
+
+#ifdef WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+#include <cstdio>
+#include <cstring>
+
+namespace karmac::stats {
+#ifdef __linux__
+    //Reads a "<key>: <value> kB" line of /proc/self/status, the high-water mark VmHWM can be reset unlike ru_maxrss
+    static uint64_t read_status_bytes(const char* key) noexcept {
+        auto* file = std::fopen("/proc/self/status", "r");
+        if(file == nullptr) {
+            return 0;
+        }
+
+        const auto key_size = std::strlen(key);
+        uint64_t bytes = 0;
+        char line[256];
+        while(std::fgets(line, sizeof(line), file) != nullptr) {
+            unsigned long long kilobytes;
+            if(std::strncmp(line, key, key_size) == 0 && line[key_size] == ':' && std::sscanf(line + key_size + 1, "%llu", &kilobytes) == 1) {
+                bytes = static_cast<uint64_t>(kilobytes) * 1024;
+                break;
+            }
+        }
+
+        std::fclose(file);
+        return bytes;
+    }
+#endif
+
+    uint64_t get_peak_rss() noexcept {
+#ifdef WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+#ifdef __linux__
+        if(const auto bytes = read_status_bytes("VmHWM"); bytes != 0) {
+            return bytes;
+        }
+#endif
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<uint64_t>(usage.ru_maxrss);
+#else
+        return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    uint64_t get_current_rss() noexcept {
+#ifdef WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return counters.WorkingSetSize;
+        }
+        return 0;
+#elif defined(__APPLE__)
+        mach_task_basic_info info {};
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+            return info.resident_size;
+        }
+        return 0;
+#elif defined(__linux__)
+        return read_status_bytes("VmRSS");
+#else
+        return 0;
+#endif
+    }
+
+    bool reset_peak_rss() noexcept {
+#ifdef __linux__
+        auto* file = std::fopen("/proc/self/clear_refs", "w");
+        if(file == nullptr) {
+            return false;
+        }
+
+        const auto written = std::fputs("5", file) >= 0;
+        return std::fclose(file) == 0 && written;
+#else
+        return false;
+#endif
+    }
+}
\ No newline at end of file
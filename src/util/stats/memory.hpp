@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstdint>
+
+namespace karmac::stats {
+    //Peak resident set size of the process in bytes, since the start or the last `reset_peak_rss`
+    [[nodiscard]] uint64_t get_peak_rss() noexcept;
+
+    //Resident set size of the process in bytes, 0 where it can't be queried
+    [[nodiscard]] uint64_t get_current_rss() noexcept;
+
+    //Restarts the peak at the current resident set size, returns false where the peak can't be reset (only Linux
+    //supports it)
+    bool reset_peak_rss() noexcept;
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "trace.hpp"
+
+#include <fmt/format.h>
+#include <fmt/os.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace karmac::trace {
+    struct ThreadBuffer {
+        uint32_t thread_id;
+        uint32_t depth = 0;
+        std::vector<Event> events;
+    };
+
+    static const auto _epoch = std::chrono::steady_clock::now();
+    static std::atomic<bool> _enabled = false;
+    static std::atomic<uint64_t> _enable_time = 0;
+
+    static std::mutex _buffers_mutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+    static thread_local ThreadBuffer* _buffer = nullptr;
+
+    static ThreadBuffer& get_buffer() {
+        if(_buffer == nullptr) {
+            const std::lock_guard lock(_buffers_mutex);
+
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->thread_id = static_cast<uint32_t>(_buffers.size());
+            buffer->events.reserve(1024);
+
+            _buffer = buffer.get();
+            _buffers.push_back(std::move(buffer));
+        }
+        return *_buffer;
+    }
+
+    uint64_t now() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _epoch).count());
+    }
+
+    void enable() noexcept {
+        _enable_time.store(now(), std::memory_order_relaxed);
+        _enabled.store(true, std::memory_order_relaxed);
+    }
+
+    bool is_enabled() noexcept {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    Zone::Zone(const char* name) : _name(name), _start(0), _active(is_enabled()) {
+        if(_active) {
+            _start = now();
+            get_buffer().depth++;
+        }
+    }
+
+    Zone::~Zone() {
+        if(!_active) {
+            return;
+        }
+
+        auto& buffer = get_buffer();
+        buffer.depth--;
+        buffer.events.push_back({ _name, _start, now() - _start, buffer.depth });
+    }
+
+    void print_time_report(std::FILE* file) {
+        struct ZoneSummary {
+            uint64_t count = 0;
+            uint64_t total = 0;
+            uint32_t depth = 0;
+        };
+
+        const std::lock_guard lock(_buffers_mutex);
+        const auto wall_time = now() - _enable_time.load(std::memory_order_relaxed);
+
+        //Zones are keyed by their literal, identical names from different translation units are merged by content
+        std::map<std::string_view, ZoneSummary> zones;
+        uint64_t busy_time = 0;
+        for(const auto& buffer : _buffers) {
+            for(const auto& event : buffer->events) {
+                auto& zone = zones[event.name];
+                zone.count++;
+                zone.total += event.duration;
+                zone.depth = zone.count == 1 ? event.depth : std::min(zone.depth, event.depth);
+
+                if(event.depth == 0) {
+                    busy_time += event.duration;
+                }
+            }
+        }
+
+        std::vector<std::pair<std::string_view, ZoneSummary>> sorted(zones.begin(), zones.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            return a.second.total > b.second.total;
+        });
+
+        const auto to_ms = [](uint64_t nanoseconds) {
+            return static_cast<double>(nanoseconds) / 1e6;
+        };
+
+        fmt::print(file, "===-------------------------------------------------------------------------===\n");
+        fmt::print(file, "                            karmac time report\n");
+        fmt::print(file, "===-------------------------------------------------------------------------===\n");
+        fmt::print(file, "  {:>12} {:>7} {:>10} {:>12}  {}\n", "wall (ms)", "%", "calls", "avg (us)", "zone");
+        for(const auto& [name, zone] : sorted) {
+            const auto percent = wall_time == 0 ? 0.0 : 100.0 * static_cast<double>(zone.total) / static_cast<double>(wall_time);
+            fmt::print(file, "  {:>12.3f} {:>6.1f}% {:>10} {:>12.3f}  {:>{}}{}\n", to_ms(zone.total), percent, zone.count,
+                       static_cast<double>(zone.total) / static_cast<double>(zone.count) / 1e3, "", zone.depth * 2, name);
+        }
+
+        const auto threads = _buffers.size();
+        const auto utilization = wall_time == 0 || threads == 0 ? 0.0
+                : 100.0 * static_cast<double>(busy_time) / (static_cast<double>(wall_time) * static_cast<double>(threads));
+        fmt::print(file, "  {:>12.3f}  total wall time, {} thread(s), {:.1f}% utilization\n", to_ms(wall_time), threads, utilization);
+    }
+
+    static std::string escape_json(const std::string_view& text) {
+        std::string result;
+        result.reserve(text.size());
+        for(const auto ch : text) {
+            if(ch == '"' || ch == '\\') {
+                result.push_back('\\');
+            }
+            result.push_back(ch);
+        }
+        return result;
+    }
+
+    void write_chrome_trace(const std::string_view& path) {
+        const std::lock_guard lock(_buffers_mutex);
+
+        auto output = fmt::output_file(std::string(path));
+        output.print("{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        auto first = true;
+        for(const auto& buffer : _buffers) {
+            output.print("{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                         first ? "" : ",\n", buffer->thread_id, fmt::format("thread {}", buffer->thread_id));
+            first = false;
+
+            for(const auto& event : buffer->events) {
+                output.print(",\n{{\"name\":\"{}\",\"cat\":\"karmac\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                             escape_json(event.name), buffer->thread_id, static_cast<double>(event.start) / 1e3,
+                             static_cast<double>(event.duration) / 1e3);
+            }
+        }
+
+        output.print("\n]}}\n");
+    }
+}
\ No newline at end of file
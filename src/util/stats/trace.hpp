@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string_view>
+
+//Scoped timing zones. Every thread records into its own buffer, collection is disabled until `enable` is called
+//so an unused zone costs a single relaxed load.
+namespace karmac::trace {
+    struct Event {
+        const char* name;
+        uint64_t start;
+        uint64_t duration;
+        uint32_t depth;
+    };
+
+    //Nanoseconds of a monotonic clock since program start
+    [[nodiscard]] uint64_t now() noexcept;
+
+    void enable() noexcept;
+    [[nodiscard]] bool is_enabled() noexcept;
+
+    //Summary of the inclusive time per zone and the thread utilization, similar to -ftime-report
+    void print_time_report(std::FILE* file);
+
+    //Writes all recorded events in the Chrome trace event format (chrome://tracing, Perfetto)
+    void write_chrome_trace(const std::string_view& path);
+
+    class Zone final {
+    private:
+        const char* _name;
+        uint64_t _start;
+        bool _active;
+
+    public:
+        //`name` has to outlive the trace, in practice it is a string literal
+        explicit Zone(const char* name);
+        Zone(const Zone&) = delete;
+        ~Zone();
+
+        Zone& operator =(const Zone&) = delete;
+    };
+}
+
+#define KARMAC_TRACE_CONCAT_IMPL(x, y) x##y
+#define KARMAC_TRACE_CONCAT(x, y) KARMAC_TRACE_CONCAT_IMPL(x, y)
+#define KARMAC_TRACE_ZONE(name) const ::karmac::trace::Zone KARMAC_TRACE_CONCAT(_trace_zone_, __LINE__)(name)
\ No newline at end of file
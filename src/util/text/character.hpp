@@ -45,8 +45,9 @@ namespace karmac::character {
             || (ch >= static_cast<uint64_t>('A') && ch <= static_cast<uint64_t>('Z'));
     }
 
+    //Every non-ASCII character may be part of an identifier
     [[nodiscard]] inline bool is_identifier_start(uint64_t ch) noexcept {
-        return is_letter(ch) || ch == static_cast<uint64_t>('_');
+        return is_letter(ch) || ch == static_cast<uint64_t>('_') || ch > 0x7f;
     }
 
     [[nodiscard]] inline bool is_identifier(uint64_t ch) noexcept {
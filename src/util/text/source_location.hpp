@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+namespace karmac {
+    //Offset into the 32-bit source space of a SourceManager, every loaded file owns a contiguous range of it.
+    //File, line and column are recovered from the SourceManager when needed.
+    struct SourceLocation {
+    public:
+        uint32_t offset;
+
+    public:
+        constexpr SourceLocation() noexcept : offset(0) {}
+        constexpr explicit SourceLocation(uint32_t offset) noexcept : offset(offset) {}
+
+        [[nodiscard]] constexpr SourceLocation operator +(uint32_t count) const noexcept {
+            return SourceLocation(offset + count);
+        }
+
+        [[nodiscard]] constexpr bool operator ==(const SourceLocation& other) const noexcept {
+            return offset == other.offset;
+        }
+
+        [[nodiscard]] constexpr bool operator !=(const SourceLocation& other) const noexcept {
+            return offset != other.offset;
+        }
+
+        [[nodiscard]] constexpr bool operator <(const SourceLocation& other) const noexcept {
+            return offset < other.offset;
+        }
+    };
+}
\ No newline at end of file
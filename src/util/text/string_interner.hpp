@@ -0,0 +1,119 @@
+#pragma once
+
+#include "../hash/hash.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace karmac {
+    //Maps strings to dense ids, every distinct string is stored once. The ids are found in an open addressing
+    //table that keeps part of the hash of each string, so probes rarely compare strings.
+    //`clear` keeps the table and the string blocks for the next use.
+    class StringInterner final {
+    private:
+        struct Slot {
+            uint32_t id;
+            uint32_t hash;
+        };
+
+        struct Block {
+            std::unique_ptr<char[]> data;
+            size_t size;
+        };
+
+        static constexpr size_t _BLOCK_SIZE = 16 * 1024;
+        static constexpr size_t _MIN_SLOTS = 256;
+        static constexpr uint32_t _EMPTY = std::numeric_limits<uint32_t>::max();
+
+        //Power of two size, at most half full
+        std::vector<Slot> _slots;
+        std::vector<std::string_view> _strings;
+        std::vector<Block> _blocks;
+        size_t _block_index = 0;
+        char* _block_head = nullptr;
+        size_t _block_remaining = 0;
+
+        [[nodiscard]] inline std::string_view store(const std::string_view& string) {
+            if(string.size() > _block_remaining) {
+                while(_block_index < _blocks.size() && _blocks[_block_index].size < string.size()) {
+                    ++_block_index;
+                }
+                if(_block_index == _blocks.size()) {
+                    const auto block_size = std::max(_BLOCK_SIZE, string.size());
+                    _blocks.push_back({ std::make_unique<char[]>(block_size), block_size });
+                }
+
+                _block_head = _blocks[_block_index].data.get();
+                _block_remaining = _blocks[_block_index].size;
+                ++_block_index;
+            }
+
+            auto* data = _block_head;
+            std::memcpy(data, string.data(), string.size());
+            _block_head += string.size();
+            _block_remaining -= string.size();
+
+            return { data, string.size() };
+        }
+
+        void grow() {
+            std::vector<Slot> slots(std::max(_MIN_SLOTS, _slots.size() * 2), Slot{ _EMPTY, 0 });
+            const auto mask = slots.size() - 1;
+            for(const auto& slot : _slots) {
+                if(slot.id == _EMPTY) {
+                    continue;
+                }
+
+                auto index = slot.hash & mask;
+                while(slots[index].id != _EMPTY) {
+                    index = (index + 1) & mask;
+                }
+                slots[index] = slot;
+            }
+            _slots = std::move(slots);
+        }
+    public:
+        [[nodiscard]] inline uint32_t intern(const std::string_view& string) {
+            if((_strings.size() + 1) * 2 > _slots.size()) {
+                grow();
+            }
+
+            const auto hash = static_cast<uint32_t>(hash::hash64(string));
+            const auto mask = _slots.size() - 1;
+            auto index = hash & mask;
+            while(_slots[index].id != _EMPTY) {
+                const auto& slot = _slots[index];
+                if(slot.hash == hash && _strings[slot.id] == string) {
+                    return slot.id;
+                }
+                index = (index + 1) & mask;
+            }
+
+            const auto id = static_cast<uint32_t>(_strings.size());
+            _strings.push_back(store(string));
+            _slots[index] = { id, hash };
+
+            return id;
+        }
+
+        [[nodiscard]] inline std::string_view get(uint32_t id) const noexcept {
+            return _strings[id];
+        }
+
+        [[nodiscard]] inline size_t size() const noexcept {
+            return _strings.size();
+        }
+
+        inline void clear() noexcept {
+            std::fill(_slots.begin(), _slots.end(), Slot{ _EMPTY, 0 });
+            _strings.clear();
+            _block_index = 0;
+            _block_head = nullptr;
+            _block_remaining = 0;
+        }
+    };
+}
\ No newline at end of file
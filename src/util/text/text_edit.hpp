@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+
+namespace karmac {
+    //Describes a replacement of the byte range [offset, offset + removed_length) of the old text
+    //with inserted_length bytes of new text
+    struct TextEdit {
+    public:
+        size_t offset;
+        size_t removed_length;
+        size_t inserted_length;
+
+    public:
+        TextEdit() noexcept : offset(0), removed_length(0), inserted_length(0) {}
+        TextEdit(size_t offset, size_t removed_length, size_t inserted_length) noexcept
+            : offset(offset), removed_length(removed_length), inserted_length(inserted_length) {}
+
+        [[nodiscard]] inline size_t get_old_end() const noexcept {
+            return offset + removed_length;
+        }
+
+        [[nodiscard]] inline size_t get_new_end() const noexcept {
+            return offset + inserted_length;
+        }
+
+        [[nodiscard]] inline ptrdiff_t get_delta() const noexcept {
+            return static_cast<ptrdiff_t>(inserted_length) - static_cast<ptrdiff_t>(removed_length);
+        }
+    };
+}
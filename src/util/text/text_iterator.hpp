@@ -1,7 +1,9 @@
 #pragma once
 
 #include "utf8/utf8_bi_iterator.hpp"
+#include "source_location.hpp"
 #include "line_offset.hpp"
+#include <string_view>
 
 namespace karmac {
     class TextIterator final {
@@ -13,11 +15,14 @@ namespace karmac {
         static const size_t _TAB_SIZE = 4;
 
         Utf8BiIterator _delegate;
-        std::stack<size_t> _last_line_offsets;
-        LineOffset _line_offset;
+        SourceLocation _base;
 
     public:
-        explicit TextIterator(const char* p) noexcept : _delegate(p) {}
+        //`base` is the location of `start` in the source space
+        explicit TextIterator(const char* p, SourceLocation base = SourceLocation()) noexcept : _delegate(p), _base(base) {}
+        //Starts at `index`, lines are only counted by the SourceManager that owns the text
+        TextIterator(const char* start, size_t index, SourceLocation base = SourceLocation()) noexcept
+            : _delegate(start, start + index), _base(base) {}
 
         inline void reset() noexcept {
             _delegate.reset();
@@ -43,8 +48,35 @@ namespace karmac {
             return _delegate.get_head();
         }
 
-        [[nodiscard]] inline LineOffset get_line_offset() const noexcept {
-            return _line_offset;
+        [[nodiscard]] inline size_t get_index() const noexcept {
+            return static_cast<size_t>(_delegate._head - _delegate._start);
+        }
+
+        //Advances `line_offset` over the chars of `text` in [from, to), a tab is _TAB_SIZE columns wide
+        static inline void advance_line_offset(const std::string_view& text, size_t from, size_t to, LineOffset& line_offset) {
+            while(from < to && from < text.size()) {
+                switch(text[from]) {
+                    case '\t':
+                        line_offset.offset += _TAB_SIZE;
+                        break;
+                    case '\r':
+                        line_offset.offset = 0;
+                        break;
+                    case '\n':
+                        line_offset.offset = 0;
+                        ++line_offset.line;
+                        break;
+                    default:
+                        ++line_offset.offset;
+                        break;
+                }
+
+                from += (static_cast<unsigned char>(text[from]) & 0x80) == 0 ? 1 : utf8::num_chars(text.data() + from);
+            }
+        }
+
+        [[nodiscard]] inline SourceLocation get_location() const noexcept {
+            return _base + static_cast<uint32_t>(get_index());
         }
 
         //Operators
@@ -53,65 +85,12 @@ namespace karmac {
         }
 
         inline TextIterator& operator ++() {
-            size_t len;
-            const auto current = utf8::to_unicode(_delegate._head, len);
-
-            switch(current) {
-                case static_cast<uint64_t>('\t'):
-                    _line_offset.offset += _TAB_SIZE;
-                    break;
-                case static_cast<uint64_t>('\b'):
-                    karmac_unimplemented();
-                    break;
-                case static_cast<uint64_t>('\r'):
-                    _last_line_offsets.push(_line_offset.offset);
-                    _line_offset.offset = 0;
-                    break;
-                case static_cast<uint64_t>('\n'):
-                    _last_line_offsets.push(_line_offset.offset);
-                    _line_offset.offset = 0;
-                    ++_line_offset.line;
-                    break;
-                default:
-                    ++_line_offset.offset;
-                    break;
-            }
-
-            _delegate._last_offsets.push(len);
-            _delegate._head += len;
-
+            ++_delegate;
             return *this;
         }
 
         inline TextIterator& operator --() {
-            karmac_assert(!_delegate._last_offsets.empty());
-            const auto len = _delegate._last_offsets.top();
-            _delegate._last_offsets.pop();
-
-            _delegate._head -= len;
-
-            const auto current = *_delegate;
-            switch(current) {
-                case static_cast<uint64_t>('\t'):
-                    _line_offset.offset -= _TAB_SIZE;
-                    break;
-                case static_cast<uint64_t>('\b'):
-                    karmac_unimplemented();
-                    break;
-                case static_cast<uint64_t>('\r'):
-                    _line_offset.offset = _last_line_offsets.top();
-                    _last_line_offsets.pop();
-                    break;
-                case static_cast<uint64_t>('\n'):
-                    _line_offset.offset = _last_line_offsets.top();
-                    _last_line_offsets.pop();
-                    --_line_offset.line;
-                    break;
-                default:
-                    --_line_offset.offset;
-                    break;
-            }
-
+            --_delegate;
             return *this;
         }
 
@@ -148,11 +127,11 @@ namespace karmac {
         }
 
         [[nodiscard]] inline bool operator ==(const TextIterator& other) const noexcept {
-            return _delegate == other._delegate && _last_line_offsets == other._last_line_offsets && _line_offset == other._line_offset;
+            return _delegate == other._delegate;
         }
 
         [[nodiscard]] inline bool operator !=(const TextIterator& other) const noexcept {
-            return _delegate != other._delegate || _last_line_offsets != other._last_line_offsets || _line_offset != other._line_offset;
+            return _delegate != other._delegate;
         }
     };
 }
\ No newline at end of file
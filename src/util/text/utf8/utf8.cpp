@@ -1,5 +1,6 @@
 #include "utf8.hpp"
 
+#include <cstring>
 #include <stdexcept>
 
 namespace karmac::utf8 {
@@ -135,4 +136,70 @@ namespace karmac::utf8 {
                 break;
         }
     }
+
+    bool validate(const std::string_view& text, size_t& error_index) noexcept {
+        const auto* data = reinterpret_cast<const unsigned char*>(text.data());
+        const auto size = text.size();
+
+        size_t i = 0;
+        while(i < size) {
+            //Skip ASCII eight bytes at a time
+            if(i + 8 <= size) {
+                uint64_t block;
+                std::memcpy(&block, data + i, sizeof(block));
+                if((block & 0x8080808080808080) == 0) {
+                    i += 8;
+                    continue;
+                }
+            }
+
+            const auto ch = data[i];
+            if(ch < 0x80) {
+                i++;
+                continue;
+            }
+
+            size_t len;
+            uint32_t unicode;
+            uint32_t min;
+            if((ch & 0xe0) == 0xc0) {
+                len = 2;
+                unicode = ch & 0x1f;
+                min = 0x80;
+            } else if((ch & 0xf0) == 0xe0) {
+                len = 3;
+                unicode = ch & 0xf;
+                min = 0x800;
+            } else if((ch & 0xf8) == 0xf0) {
+                len = 4;
+                unicode = ch & 0x7;
+                min = 0x10000;
+            } else {
+                error_index = i;
+                return false;
+            }
+
+            if(i + len > size) {
+                error_index = i;
+                return false;
+            }
+
+            for(size_t j = 1; j < len; j++) {
+                if((data[i + j] & 0xc0) != 0x80) {
+                    error_index = i;
+                    return false;
+                }
+                unicode = (unicode << 6) | (data[i + j] & 0x3f);
+            }
+
+            if(unicode < min || unicode > 0x10ffff || (unicode >= 0xd800 && unicode <= 0xdfff)) {
+                error_index = i;
+                return false;
+            }
+
+            i += len;
+        }
+
+        return true;
+    }
 }
\ No newline at end of file
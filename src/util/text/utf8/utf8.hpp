@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <string_view>
 
 namespace karmac::utf8 {
     [[nodiscard]] size_t num_chars(const char* p);
@@ -17,4 +19,8 @@ namespace karmac::utf8 {
         size_t len;
         from_unicode(unicode, buffer, len);
     }
+
+    //Checks that `text` is well-formed UTF-8 (RFC 3629: no overlong forms, surrogates or code points above U+10FFFF),
+    //`error_index` receives the index of the first invalid byte
+    [[nodiscard]] bool validate(const std::string_view& text, size_t& error_index) noexcept;
 }
\ No newline at end of file
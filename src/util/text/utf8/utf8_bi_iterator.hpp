@@ -1,7 +1,7 @@
 #pragma once
 
 #include "utf8_iterator.hpp"
-#include <stack>
+#include "../../bounded_stack.hpp"
 
 namespace karmac {
     class TextIterator;
@@ -12,17 +12,23 @@ namespace karmac {
         using difference_type = std::ptrdiff_t;
         using value_type = uint64_t;
     private:
+        static constexpr size_t _HISTORY_SIZE = 8;
+
         const char* _start;
         const char* _head;
-        std::stack<size_t> _last_offsets;
+        //Lengths of the last chars, the iterator can step back at most _HISTORY_SIZE chars
+        BoundedStack<uint8_t, _HISTORY_SIZE> _last_offsets;
     public:
         explicit Utf8BiIterator(const char* p) noexcept : _start(p), _head(p) {
             karmac_assert(p);
         }
+        Utf8BiIterator(const char* start, const char* head) noexcept : _start(start), _head(head) {
+            karmac_assert(start && head >= start);
+        }
 
         inline void reset() noexcept {
             _head = _start;
-            _last_offsets = std::stack<size_t>();
+            _last_offsets.clear();
         }
 
         [[nodiscard]] inline bool has_chars() const {
@@ -78,7 +84,7 @@ namespace karmac {
 
         inline Utf8BiIterator& operator ++() {
             const auto len = utf8::num_chars(_head);
-            _last_offsets.push(len);
+            _last_offsets.push(static_cast<uint8_t>(len));
             _head += len;
 
             return *this;
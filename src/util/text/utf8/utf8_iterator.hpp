@@ -24,7 +24,7 @@ namespace karmac {
         }
 
         [[nodiscard]] inline bool has_chars() const {
-            return *(*this) != static_cast<uint64_t>('0');
+            return *(*this) != static_cast<uint64_t>('\0');
         }
 
         [[nodiscard]] inline bool has_chars(size_t count) const {
@@ -0,0 +1,86 @@
+#include "thread_pool.hpp"
+
+namespace karmac {
+    ThreadPool::ThreadPool(size_t threads) {
+        for(size_t i = 1; i < threads; i++) {
+            _threads.emplace_back(&ThreadPool::work, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+
+        for(auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::run_tasks() {
+        for(auto i = _next++; i < _count; i = _next++) {
+            try {
+                (*_task)(i);
+            } catch(...) {
+                std::lock_guard lock(_mutex);
+                if(!_error) {
+                    _error = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::work() {
+        uint64_t generation = 0;
+        while(true) {
+            {
+                std::unique_lock lock(_mutex);
+                _wake.wait(lock, [this, generation] { return _stopping || _generation != generation; });
+                if(_stopping) {
+                    return;
+                }
+                generation = _generation;
+            }
+
+            run_tasks();
+
+            std::lock_guard lock(_mutex);
+            if(--_busy_workers == 0) {
+                _done.notify_one();
+            }
+        }
+    }
+
+    void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+        if(count == 0) {
+            return;
+        }
+
+        {
+            std::lock_guard lock(_mutex);
+            _task = &task;
+            _count = count;
+            _next = 0;
+            _error = nullptr;
+            _busy_workers = _threads.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        run_tasks();
+
+        std::exception_ptr error;
+        {
+            std::unique_lock lock(_mutex);
+            _done.wait(lock, [this] { return _busy_workers == 0; });
+            _task = nullptr;
+            error = _error;
+        }
+
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace karmac {
+    //Fixed set of worker threads that run index based loops together with the calling thread
+    class ThreadPool final {
+    private:
+        std::vector<std::thread> _threads;
+
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::condition_variable _done;
+
+        //The current loop, only written while no worker runs it
+        const std::function<void(size_t)>* _task = nullptr;
+        size_t _count = 0;
+        std::atomic<size_t> _next = 0;
+
+        uint64_t _generation = 0;
+        size_t _busy_workers = 0;
+        bool _stopping = false;
+        //First exception thrown by a task of the current loop
+        std::exception_ptr _error;
+
+        void work();
+        void run_tasks();
+    public:
+        //`threads` includes the thread calling `run`, so 1 starts no worker
+        explicit ThreadPool(size_t threads);
+        ThreadPool(const ThreadPool&) = delete;
+        ~ThreadPool();
+
+        ThreadPool& operator =(const ThreadPool&) = delete;
+
+        [[nodiscard]] inline size_t get_thread_count() const noexcept {
+            return _threads.size() + 1;
+        }
+
+        //Calls `task` for every index below `count` and returns once all calls returned, in no particular order.
+        //The first exception of a task is rethrown after the loop. Must not be called from a task.
+        void run(size_t count, const std::function<void(size_t)>& task);
+    };
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#Runs one program of the baseline corpus three ways. The interpreter is the reference and has to give the result the
+#first line of the program expects, "//expect: exit <code>" or "//expect: trap <message>". --run=baseline has to report
+#the same result, the object of --emit=obj --codegen=baseline linked with cc has to exit with the same code or stop
+#at its trap instruction.
+#Takes KARMAC, CC, SOURCE and WORK_DIR.
+
+get_filename_component(NAME ${SOURCE} NAME_WE)
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+#The result of a --run as "exit <code>" or "trap <message>"
+function(describe_run CODE ERROR OUT)
+    if(ERROR MATCHES "runtime error: ([^\n]*)")
+        set(${OUT} "trap ${CMAKE_MATCH_1}" PARENT_SCOPE)
+    elseif(ERROR STREQUAL "")
+        set(${OUT} "exit ${CODE}" PARENT_SCOPE)
+    else()
+        message(FATAL_ERROR "${SOURCE} failed to compile:\n${ERROR}")
+    endif()
+endfunction()
+
+file(STRINGS ${SOURCE} EXPECTED LIMIT_COUNT 1 REGEX "^//expect: ")
+string(REGEX REPLACE "^//expect: " "" EXPECTED "${EXPECTED}")
+if(EXPECTED STREQUAL "")
+    message(FATAL_ERROR "${SOURCE} has no //expect: line")
+endif()
+
+execute_process(COMMAND ${KARMAC} --run=interpreter ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+describe_run("${CODE}" "${ERROR}" INTERPRETED)
+if(NOT INTERPRETED STREQUAL EXPECTED)
+    message(FATAL_ERROR "--run=interpreter: expected \"${EXPECTED}\", got \"${INTERPRETED}\"")
+endif()
+
+execute_process(COMMAND ${KARMAC} --run=baseline ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+describe_run("${CODE}" "${ERROR}" BASELINE)
+if(NOT BASELINE STREQUAL EXPECTED)
+    message(FATAL_ERROR "--run=baseline: expected \"${EXPECTED}\", got \"${BASELINE}\"")
+endif()
+
+set(OBJECT ${WORK_DIR}/${NAME}.o)
+set(PROGRAM ${WORK_DIR}/${NAME})
+execute_process(COMMAND ${KARMAC} --emit=obj --codegen=baseline -o ${OBJECT} ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+if(NOT CODE EQUAL 0)
+    message(FATAL_ERROR "--emit=obj failed:\n${ERROR}")
+endif()
+execute_process(COMMAND ${CC} -o ${PROGRAM} ${OBJECT} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+if(NOT CODE EQUAL 0)
+    message(FATAL_ERROR "linking ${OBJECT} failed:\n${ERROR}")
+endif()
+
+#Objects trap with ud2, the process is killed by SIGILL and the result is the name of the signal instead of a code
+execute_process(COMMAND ${PROGRAM} RESULT_VARIABLE CODE)
+if(EXPECTED MATCHES "^trap ")
+    if(NOT CODE STREQUAL "Illegal instruction")
+        message(FATAL_ERROR "object: expected \"${EXPECTED}\", got \"${CODE}\"")
+    endif()
+elseif(NOT "exit ${CODE}" STREQUAL EXPECTED)
+    message(FATAL_ERROR "object: expected \"${EXPECTED}\", got \"exit ${CODE}\"")
+endif()
\ No newline at end of file
@@ -0,0 +1,187 @@
+//Checks the frontend cache in a temporary directory: hits and misses of token streams and objects, corrupted and
+//other-version entries counting as misses, the least recently used entries being evicted by `trim`, stale temporary
+//files being removed and the size index that decides when `update_size` trims.
+//Exits with 1 after printing every failed check.
+
+#include <cache/frontend_cache.hpp>
+#include <common/tokens.hpp>
+#include <corpus/generator.hpp>
+#include <tokenize/tokenizer.hpp>
+#include <fmt/format.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+using namespace karmac;
+
+static size_t _failures = 0;
+
+static void expect(bool condition, const std::string_view& what) {
+    if(!condition) {
+        fmt::print(stderr, "failed: {}\n", what);
+        ++_failures;
+    }
+}
+
+static bool operator ==(const CacheStatistics& first, const CacheStatistics& second) {
+    return first.token_hits == second.token_hits && first.token_misses == second.token_misses && first.object_hits == second.object_hits
+           && first.object_misses == second.object_misses && first.stores == second.stores && first.evictions == second.evictions;
+}
+
+//Same layout as FrontendCache::get_path
+static std::filesystem::path get_entry_path(const std::filesystem::path& directory, uint64_t key, const std::string_view& kind) {
+    const auto name = fmt::format("{:016x}", key);
+    return directory / name.substr(0, 2) / fmt::format("{}.{}", name, kind);
+}
+
+static std::string read_file(const std::filesystem::path& path) {
+    std::ifstream input_stream(path, std::ios_base::binary);
+    return { std::istreambuf_iterator<char>(input_stream), std::istreambuf_iterator<char>() };
+}
+
+static void write_file(const std::filesystem::path& path, const std::string_view& data) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream output_stream(path, std::ios_base::binary | std::ios_base::trunc);
+    output_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+//Makes `path` look like it was last used `age` ago
+static void set_age(const std::filesystem::path& path, std::chrono::minutes age) {
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now() - age);
+}
+
+static void test_tokens(const std::filesystem::path& directory) {
+    corpus::GeneratorOptions options;
+    options.typed = true;
+    const auto source = corpus::Generator(options).generate(4 * 1024);
+    const auto other_source = source + " ";
+    const SourceLocation base(100);
+
+    FrontendCache cache(directory);
+    expect(!cache.find_tokens(source, base), "token stream found before it was stored");
+
+    const Tokenizer expected(source, base);
+    cache.store_tokens(source, base, expected.get_tokens());
+
+    auto cached = cache.find_tokens(source, base);
+    expect(cached.has_value(), "stored token stream not found");
+    if(cached) {
+        Tokenizer loaded;
+        loaded.load(cached->tokens);
+        const auto difference = test::compare(loaded, expected);
+        expect(difference.empty(), fmt::format("loaded tokens differ: {}", difference));
+    }
+
+    //Entries don't depend on where the source is loaded
+    const SourceLocation other_base(5000);
+    cached = cache.find_tokens(source, other_base);
+    expect(cached && cached->tokens.size() > 0 && cached->tokens.get_location(0) == expected.get_tokens()[0]->get_location() + 4900,
+           "token stream found at another base has wrong locations");
+    cached.reset();
+
+    expect(!cache.find_tokens(other_source, base), "token stream found for another source");
+    expect(cache.get_statistics() == CacheStatistics { 2, 2, 0, 0, 1, 0 }, "token hits and misses aren't counted");
+
+    const auto path = get_entry_path(directory, FrontendCache::get_key(source), "tokens");
+    const auto data = read_file(path);
+
+    auto other_version = data;
+    other_version[sizeof(token_stream::MAGIC)] ^= 1;
+    write_file(path, other_version);
+    expect(!cache.find_tokens(source, base), "token stream of another version was accepted");
+
+    write_file(path, data.substr(0, data.size() / 2));
+    expect(!cache.find_tokens(source, base), "truncated token stream was accepted");
+
+    //A stream of another source that collides with the key
+    const Tokenizer other_tokenizer(other_source, base);
+    write_file(path, token_stream::serialize(other_tokenizer.get_tokens(), base, other_source.size()));
+    expect(!cache.find_tokens(source, base), "token stream of a source with another size was accepted");
+    expect(cache.get_statistics() == CacheStatistics { 2, 5, 0, 0, 1, 0 }, "rejected entries aren't counted as misses");
+
+    cache.store_tokens(source, base, expected.get_tokens());
+    expect(cache.find_tokens(source, base).has_value(), "rejected entry wasn't replaced");
+}
+
+static void test_objects(const std::filesystem::path& directory) {
+    FrontendCache cache(directory);
+    expect(!cache.find_object(42), "object found before it was stored");
+
+    cache.store_object(42, "object");
+    const auto object = cache.find_object(42);
+    expect(object && object->get_data() == "object", "stored object not found");
+    expect(!cache.find_object(43), "object found for another key");
+    expect(cache.get_statistics() == CacheStatistics { 0, 0, 1, 2, 1, 0 }, "object hits and misses aren't counted");
+}
+
+static void test_trim(const std::filesystem::path& directory) {
+    const std::string object(100, 'o');
+    FrontendCache cache(directory, 250);
+    for(uint64_t key = 1; key <= 4; key++) {
+        cache.store_object(key, object);
+        set_age(get_entry_path(directory, key, "o"), std::chrono::minutes(60 - key));
+    }
+
+    //A lookup makes the oldest entry the most recently used one
+    expect(cache.find_object(1).has_value(), "object to touch not found");
+
+    const auto stale_temp = directory / "00" / ".tmp-stale";
+    const auto fresh_temp = directory / "00" / ".tmp-fresh";
+    write_file(stale_temp, object);
+    write_file(fresh_temp, object);
+    set_age(stale_temp, std::chrono::minutes(120));
+
+    cache.trim();
+    expect(std::filesystem::exists(get_entry_path(directory, 1, "o")), "recently used entry was evicted");
+    expect(!std::filesystem::exists(get_entry_path(directory, 2, "o")), "least recently used entry wasn't evicted");
+    expect(!std::filesystem::exists(get_entry_path(directory, 3, "o")), "second least recently used entry wasn't evicted");
+    expect(std::filesystem::exists(get_entry_path(directory, 4, "o")), "newest entry was evicted");
+    expect(cache.get_statistics().evictions == 2, "evictions aren't counted");
+    expect(read_file(directory / "size") == "200", "trim didn't write the size of the remaining entries");
+
+    expect(!std::filesystem::exists(stale_temp), "stale temporary file wasn't removed");
+    expect(std::filesystem::exists(fresh_temp), "temporary file of a running store was removed");
+}
+
+static void test_update_size(const std::filesystem::path& directory) {
+    const std::string object(100, 'o');
+    {
+        //Without an index the cache is walked once
+        FrontendCache cache(directory, 250);
+        cache.store_object(1, object);
+        cache.update_size();
+        expect(read_file(directory / "size") == "100", "missing index wasn't rebuilt");
+    }
+    {
+        //Stores below the limit only update the index
+        FrontendCache cache(directory, 250);
+        cache.store_object(2, object);
+        cache.update_size();
+        expect(read_file(directory / "size") == "200", "index wasn't updated");
+        expect(cache.get_statistics().evictions == 0, "entries below the limit were evicted");
+    }
+    {
+        FrontendCache cache(directory, 250);
+        set_age(get_entry_path(directory, 1, "o"), std::chrono::minutes(10));
+        cache.store_object(3, object);
+        cache.update_size();
+        expect(!std::filesystem::exists(get_entry_path(directory, 1, "o")), "store over the limit didn't trim the cache");
+        expect(cache.get_statistics().evictions == 1, "trim evicted more than needed");
+        expect(read_file(directory / "size") == "200", "trim didn't update the index");
+    }
+}
+
+int main() {
+    const auto root = std::filesystem::temp_directory_path() / fmt::format("karmac_cache_test_{}", std::chrono::steady_clock::now().time_since_epoch().count());
+
+    test_tokens(root / "tokens");
+    test_objects(root / "objects");
+    test_trim(root / "trim");
+    test_update_size(root / "update_size");
+
+    std::filesystem::remove_all(root);
+    return _failures == 0 ? 0 : 1;
+}
\ No newline at end of file
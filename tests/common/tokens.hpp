@@ -0,0 +1,48 @@
+#pragma once
+
+#include <tokenize/tokenizer.hpp>
+#include <fmt/format.h>
+#include <string>
+#include <string_view>
+
+namespace karmac::test {
+    //Compares tokens, locations, blocks and errors, empty if both match and the first difference otherwise
+    inline std::string compare(const Tokenizer& tokenizer, const Tokenizer& expected) {
+        const auto& tokens = tokenizer.get_tokens();
+        const auto& expected_tokens = expected.get_tokens();
+        if(tokens.size() != expected_tokens.size()) {
+            return fmt::format("{} tokens instead of {}", tokens.size(), expected_tokens.size());
+        }
+        for(size_t i = 0; i < tokens.size(); i++) {
+            if(tokens[i]->get_type() != expected_tokens[i]->get_type() || tokens[i]->get_location() != expected_tokens[i]->get_location()
+               || tokens[i]->to_string() != expected_tokens[i]->to_string()) {
+                return fmt::format("token {} is \"{}\" at {} instead of \"{}\" at {}", i, tokens[i]->to_string(), tokens[i]->get_location().offset,
+                                   expected_tokens[i]->to_string(), expected_tokens[i]->get_location().offset);
+            }
+        }
+
+        const auto& blocks = tokenizer.get_blocks();
+        const auto& expected_blocks = expected.get_blocks();
+        if(blocks.size() != expected_blocks.size()) {
+            return fmt::format("{} blocks instead of {}", blocks.size(), expected_blocks.size());
+        }
+        for(size_t i = 0; i < blocks.size(); i++) {
+            if(blocks[i].open != expected_blocks[i].open || blocks[i].close != expected_blocks[i].close) {
+                return fmt::format("block {} is {}..{} instead of {}..{}", i, blocks[i].open, blocks[i].close, expected_blocks[i].open,
+                                   expected_blocks[i].close);
+            }
+        }
+
+        const auto& errors = tokenizer.get_errors();
+        const auto& expected_errors = expected.get_errors();
+        if(errors.size() != expected_errors.size()) {
+            return fmt::format("{} errors instead of {}", errors.size(), expected_errors.size());
+        }
+        for(size_t i = 0; i < errors.size(); i++) {
+            if(std::string_view(errors[i].what()) != expected_errors[i].what() || errors[i].get_location() != expected_errors[i].get_location()) {
+                return fmt::format("error {} is \"{}\" instead of \"{}\"", i, errors[i].what(), expected_errors[i].what());
+            }
+        }
+        return {};
+    }
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#Checks the diagnostics of one erroneous program against the ones listed in <name>.expected next to it, without the
+#path of the program. The program is compiled on one thread and on several, which parses the bodies in parallel, both
+#have to report the same diagnostics.
+#Takes KARMAC and SOURCE.
+
+string(REGEX REPLACE "\\.karma$" ".expected" EXPECTED_PATH ${SOURCE})
+file(READ ${EXPECTED_PATH} EXPECTED)
+string(STRIP "${EXPECTED}" EXPECTED)
+
+foreach(JOBS 1 4)
+    execute_process(COMMAND ${KARMAC} -j ${JOBS} ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+    if(NOT CODE EQUAL 1)
+        message(FATAL_ERROR "-j ${JOBS}: expected exit code 1, got ${CODE}:\n${ERROR}")
+    endif()
+
+    string(REPLACE "${SOURCE}:" "" ERROR "${ERROR}")
+    string(STRIP "${ERROR}" ERROR)
+    if(NOT ERROR STREQUAL EXPECTED)
+        message(FATAL_ERROR "-j ${JOBS}: expected\n${EXPECTED}\ngot\n${ERROR}")
+    endif()
+endforeach()
\ No newline at end of file
@@ -0,0 +1,20 @@
+#Checks that options only match their exact spelling or the attached values they document, anything else that starts
+#with the same letters has to be reported as an unknown option.
+#Takes KARMAC, SOURCE and WORK_DIR.
+
+file(MAKE_DIRECTORY ${WORK_DIR})
+
+foreach(ARGUMENTS "-j 2" "-j2" "--jobs 2" "--jobs=2" "-o ${WORK_DIR}/main.txt")
+    separate_arguments(ARGUMENT_LIST UNIX_COMMAND "${ARGUMENTS}")
+    execute_process(COMMAND ${KARMAC} ${ARGUMENT_LIST} ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+    if(NOT CODE EQUAL 0)
+        message(FATAL_ERROR "${ARGUMENTS}: expected exit code 0, got ${CODE}:\n${ERROR}")
+    endif()
+endforeach()
+
+foreach(ARGUMENT "-ofoo" "-o=foo" "-jx" "-jobs" "--jobsx" "--jobs2")
+    execute_process(COMMAND ${KARMAC} ${ARGUMENT} ${SOURCE} RESULT_VARIABLE CODE ERROR_VARIABLE ERROR)
+    if(CODE EQUAL 0 OR NOT ERROR MATCHES "Unknown option: ${ARGUMENT}")
+        message(FATAL_ERROR "${ARGUMENT}: expected an unknown option error, got ${CODE}:\n${ERROR}")
+    endif()
+endforeach()
\ No newline at end of file
@@ -0,0 +1,132 @@
+//Applies random edits to generated code and checks that relexing them gives the tokens, blocks and errors of
+//tokenizing the edited text from scratch. Edits that introduce errors have to be rejected without touching the token
+//store, some of them are taken over with a reset and undone by the next edit, which starts from a store with errors.
+//Exits with 1 and prints the failing edit on the first mismatch.
+
+#include <corpus/generator.hpp>
+#include <common/tokens.hpp>
+#include <tokenize/tokenizer.hpp>
+#include <fmt/format.h>
+#include <array>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+using namespace karmac;
+
+static constexpr size_t _TEXT_SIZE = 2 * 1024;
+static constexpr size_t _EDITS_PER_SEED = 2000;
+static constexpr std::array<std::string_view, 24> _PIECES = {
+    "a", "x1", " ", "\n", "\t", "(", ")", "{", "}", "[", "]", "<", "=", "-", ">", ";", "/*", "*/", "//", "\"", "0x",
+    "1.5e", "fn ", "\xce\xbb"
+};
+
+//Moves `index` back to the start of the UTF-8 sequence it points into, the tokenizer rejects broken sequences
+static size_t to_char_start(const std::string& text, size_t index) noexcept {
+    while(index > 0 && index < text.size() && (static_cast<uint8_t>(text[index]) & 0xc0) == 0x80) {
+        --index;
+    }
+    return index;
+}
+
+static bool run(uint64_t seed) {
+    corpus::GeneratorOptions options;
+    options.seed = seed;
+    options.typed = true;
+    auto text = corpus::Generator(options).generate(_TEXT_SIZE);
+
+    corpus::Random random(seed);
+    Tokenizer tokenizer(text);
+    size_t relexed = 0;
+    size_t rejected = 0;
+    size_t recovered = 0;
+    //Inverse of the last edit
+    size_t undo_offset = 0;
+    size_t undo_removed = 0;
+    std::string undo_inserted;
+
+    for(size_t i = 0; i < _EDITS_PER_SEED; i++) {
+        const auto had_errors = !tokenizer.get_errors().empty();
+        size_t offset;
+        size_t removed;
+        std::string inserted;
+        if(had_errors) {
+            //Takes the store with errors back to the valid text before them
+            offset = undo_offset;
+            removed = undo_removed;
+            inserted = undo_inserted;
+        } else {
+            //Pieces of karma and of the text itself, removals are short so the text keeps its size
+            offset = to_char_start(text, random.next(text.size() + 1));
+            removed = to_char_start(text, std::min<size_t>(offset + (random.chance(30) ? random.next(8) : 0), text.size())) - offset;
+            if(random.chance(20) && !text.empty()) {
+                const auto start = to_char_start(text, random.next(text.size()));
+                const auto end = to_char_start(text, std::min<size_t>(start + random.next(16), text.size()));
+                inserted = text.substr(start, end - start);
+            } else if(random.chance(90)) {
+                inserted = _PIECES[random.next(_PIECES.size())];
+            }
+        }
+
+        auto edited = text;
+        edited.replace(offset, removed, inserted);
+        const TextEdit edit(offset, removed, inserted.size());
+        const auto describe = [&] {
+            return fmt::format("seed {}, edit {}: {} bytes at {} replaced by \"{}\"", seed, i, removed, offset, inserted);
+        };
+
+        const Tokenizer expected(edited);
+        auto threw = false;
+        try {
+            tokenizer.relex(edited, edit);
+        } catch(const TokenizeException&) {
+            threw = true;
+        }
+
+        if(threw) {
+            if(had_errors || expected.get_errors().empty()) {
+                fmt::print(stderr, "{}: rejected, but tokenizing from scratch succeeds\n", describe());
+                return false;
+            }
+            //The store has to be untouched
+            const auto difference = test::compare(tokenizer, Tokenizer(text));
+            if(!difference.empty()) {
+                fmt::print(stderr, "{}: rejected, but the store changed: {}\n", describe(), difference);
+                return false;
+            }
+            ++rejected;
+            if(!random.chance(25)) {
+                continue;
+            }
+            tokenizer.reset(edited);
+            undo_offset = offset;
+            undo_removed = inserted.size();
+            undo_inserted = text.substr(offset, removed);
+        } else {
+            if(!had_errors && !expected.get_errors().empty()) {
+                fmt::print(stderr, "{}: accepted, but tokenizing from scratch reports \"{}\"\n", describe(), expected.get_errors().front().what());
+                return false;
+            }
+            ++(had_errors ? recovered : relexed);
+        }
+
+        const auto difference = test::compare(tokenizer, expected);
+        if(!difference.empty()) {
+            fmt::print(stderr, "{}: {}\n", describe(), difference);
+            return false;
+        }
+        text = std::move(edited);
+    }
+
+    fmt::print("seed {}: {} edits relexed, {} rejected, {} relexed from a store with errors\n", seed, relexed, rejected, recovered);
+    return true;
+}
+
+int main() {
+    for(uint64_t seed = 1; seed <= 3; seed++) {
+        if(!run(seed)) {
+            return 1;
+        }
+    }
+    return 0;
+}
\ No newline at end of file
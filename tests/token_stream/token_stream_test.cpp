@@ -0,0 +1,157 @@
+//Serializes the tokens of generated code and checks that the records of the view and the tokens loaded from it match
+//the tokens of the tokenizer. Streams of other versions, with a wrong magic or truncated have to be rejected, streams
+//with random bytes flipped have to load or throw without crashing.
+//Exits with 1 and prints the failing case on the first mismatch.
+
+#include <corpus/generator.hpp>
+#include <common/tokens.hpp>
+#include <tokenize/stream/token_stream.hpp>
+#include <tokenize/tokenizer.hpp>
+#include <fmt/format.h>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+using namespace karmac;
+
+static constexpr size_t _TEXT_SIZE = 16 * 1024;
+static constexpr size_t _FLIPS_PER_SEED = 2000;
+static constexpr SourceLocation _BASE(1000);
+
+//Compares the records of the view with the tokens they were serialized from, empty if all match
+static std::string compare(const token_stream::TokenStreamView& view, const Tokenizer& expected, size_t source_size) {
+    const auto& tokens = expected.get_tokens();
+    if(view.size() != tokens.size() || view.get_source_size() != source_size) {
+        return fmt::format("{} tokens of {} bytes instead of {} of {} bytes", view.size(), view.get_source_size(), tokens.size(), source_size);
+    }
+
+    size_t index = 0;
+    for(const auto& record : view) {
+        const auto* token = tokens[index];
+        if(record.type != token->get_type() || record.location != token->get_location() || token_stream::to_string(record) != token->to_string()) {
+            return fmt::format("record {} is \"{}\" at {} instead of \"{}\" at {}", index, token_stream::to_string(record), record.location.offset,
+                               token->to_string(), token->get_location().offset);
+        }
+        ++index;
+    }
+    return {};
+}
+
+static bool run_round_trip(const corpus::GeneratorOptions& options, const std::string_view& name) {
+    const auto text = corpus::Generator(options).generate(_TEXT_SIZE);
+    const Tokenizer expected(text, _BASE);
+    if(!expected.get_errors().empty()) {
+        fmt::print(stderr, "{} corpus, seed {}: unexpected error \"{}\"\n", name, options.seed, expected.get_errors().front().what());
+        return false;
+    }
+
+    const auto data = token_stream::serialize(expected.get_tokens(), _BASE, text.size());
+    const token_stream::TokenStreamView view(data, _BASE);
+
+    auto difference = compare(view, expected, text.size());
+    if(difference.empty()) {
+        Tokenizer loaded;
+        loaded.load(view);
+        difference = test::compare(loaded, expected);
+    }
+    if(!difference.empty()) {
+        fmt::print(stderr, "{} corpus, seed {}: {}\n", name, options.seed, difference);
+        return false;
+    }
+    return true;
+}
+
+//True if the view rejects `data`
+static bool is_rejected(const std::string& data) {
+    try {
+        (void) token_stream::TokenStreamView(data);
+    } catch(const std::runtime_error&) {
+        return true;
+    }
+    return false;
+}
+
+static bool run_rejection(const std::string& data) {
+    auto other_magic = data;
+    other_magic[0] = 'X';
+    if(!is_rejected(other_magic)) {
+        fmt::print(stderr, "stream with a wrong magic was accepted\n");
+        return false;
+    }
+
+    for(const auto version : { token_stream::VERSION - 1, token_stream::VERSION + 1 }) {
+        std::string version_bytes;
+        endian::write_le(version_bytes, version);
+        auto other_version = data;
+        other_version.replace(sizeof(token_stream::MAGIC), version_bytes.size(), version_bytes);
+        if(!is_rejected(other_version)) {
+            fmt::print(stderr, "stream of version {} was accepted\n", version);
+            return false;
+        }
+    }
+
+    //The pools end the stream, any shorter prefix cuts off a section
+    for(size_t size = 0; size < data.size(); size++) {
+        if(!is_rejected(data.substr(0, size))) {
+            fmt::print(stderr, "stream truncated to {} of {} bytes was accepted\n", size, data.size());
+            return false;
+        }
+    }
+    return true;
+}
+
+static void run_flips(const std::string& data, uint64_t seed) {
+    corpus::Random random(seed);
+    size_t loaded = 0;
+    size_t rejected = 0;
+
+    for(size_t i = 0; i < _FLIPS_PER_SEED; i++) {
+        auto corrupted = data;
+        const auto flips = 1 + random.next(4);
+        for(size_t j = 0; j < flips; j++) {
+            corrupted[random.next(corrupted.size())] ^= static_cast<char>(1 + random.next(255));
+        }
+
+        try {
+            const token_stream::TokenStreamView view(corrupted);
+            for(const auto& record : view) {
+                (void) token_stream::to_string(record);
+            }
+            Tokenizer tokenizer;
+            tokenizer.load(view);
+            ++loaded;
+        } catch(const std::exception&) {
+            ++rejected;
+        }
+    }
+
+    fmt::print("seed {}: {} corrupted streams loaded, {} rejected\n", seed, loaded, rejected);
+}
+
+int main() {
+    for(uint64_t seed = 1; seed <= 3; seed++) {
+        corpus::GeneratorOptions options;
+        options.seed = seed;
+        if(!run_round_trip(options, "default")) {
+            return 1;
+        }
+        options.typed = true;
+        if(!run_round_trip(options, "typed")) {
+            return 1;
+        }
+    }
+
+    corpus::GeneratorOptions options;
+    options.typed = true;
+    const auto text = corpus::Generator(options).generate(1024);
+    const Tokenizer tokenizer(text);
+    const auto data = token_stream::serialize(tokenizer.get_tokens(), SourceLocation(), text.size());
+    if(!run_rejection(data)) {
+        return 1;
+    }
+
+    for(uint64_t seed = 1; seed <= 3; seed++) {
+        run_flips(data, seed);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,912 @@
+#include "generator.hpp"
+
+#include <fmt/format.h>
+#include <algorithm>
+#include <array>
+#include <string_view>
+
+namespace karmac::corpus {
+    enum Category : uint32_t {
+        Identifiers,
+        Keywords,
+        Numbers,
+        Strings,
+        Operators,
+        Comments,
+        Whitespace,
+        CategoryCount
+    };
+
+    static constexpr std::array<std::string_view, 24> _WORDS = {
+        "count", "value", "index", "buffer", "node", "sum", "len", "tmp", "acc", "item", "left", "right",
+        "total", "offset", "delta", "state", "mask", "bits", "limit", "step", "head", "tail", "key", "hash"
+    };
+    static constexpr std::array<std::string_view, 8> _NON_ASCII_WORDS = {
+        "gr\xc3\xb6\xc3\x9f" "e", "\xce\xbb", "\xe6\x95\xb0\xe6\x8d\xae", "na\xc3\xafve", "\xcf\x80", "\xd0\xb7\xd0\xbd\xd0\xb0\xd1\x87", "\xc3\xa9t\xc3\xa9", "\xce\xb1\xce\xb2"
+    };
+    static constexpr std::array<std::string_view, 8> _KEYWORDS = { "fn", "if", "else", "for", "while", "break", "continue", "return" };
+    static constexpr std::array<std::string_view, 12> _TYPES = { "u8", "i8", "u16", "i16", "u32", "i32", "u64", "i64", "usize", "isize", "f32", "f64" };
+    static constexpr std::array<std::string_view, 18> _BINARY_OPERATORS = {
+        "+", "-", "*", "/", "%", "<<", ">>", "&", "|", "^", "<", "<=", ">", ">=", "==", "!=", "&&", "||"
+    };
+    static constexpr std::array<std::string_view, 6> _COMPARISON_OPERATORS = { "<", "<=", ">", ">=", "==", "!=" };
+    static constexpr std::array<std::string_view, 4> _ARITHMETIC_OPERATORS = { "+", "-", "*", "/" };
+    static constexpr std::array<std::string_view, 4> _INTEGER_OPERATORS = { "%", "&", "|", "^" };
+    static constexpr std::array<std::string_view, 11> _ASSIGN_OPERATORS = { "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>=" };
+    static constexpr std::array<std::string_view, 46> _SOUP_OPERATORS = {
+        "()", "[]", "{}", ".", "..", ",", ":", "::", ";", "=", "!", "->", "?", "<", "<=", ">", ">=", "==", "!=", "&&", "||",
+        "&", "&=", "|", "|=", "^", "^=", "<<", "<<=", ">>", ">>=", "++", "--", "+", "+=", "-", "-=", "*", "*=", "/", "/=",
+        "%", "%=", "( )", "[ ]", "{ }"
+    };
+    static constexpr std::array<std::string_view, 10> _STRING_PIECES = { "hello", " world", "value: ", "\\n", "\\t", "\\\\", "\\\"quoted\\\"", "\\0", "\\r", "%d" };
+    static constexpr std::array<std::string_view, 6> _NON_ASCII_STRING_PIECES = {
+        "gr\xc3\xbc\xc3\x9f" "e", " \xe2\x86\x92 ", "\xf0\x9f\x98\x80", "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e", "\xc3\xa0 bient\xc3\xb4t", "\xe2\x88\x91"
+    };
+
+    template<typename T, size_t N>
+    static const T& pick(Random& random, const std::array<T, N>& values) noexcept {
+        return values[random.next(N)];
+    }
+
+    static void append_indent(std::string& text, size_t indent) {
+        text.append(indent * 4, ' ');
+    }
+
+    //Operators and conditionals are put in brackets, so an operand never changes how the expression around it groups
+    static void append_operand(std::string& text, const std::string_view& operand) {
+        if(operand.find(' ') == std::string_view::npos) {
+            text += operand;
+        } else {
+            text += fmt::format("({})", operand);
+        }
+    }
+
+    uint32_t Generator::pick_category(bool soup) {
+        const auto& mix = _options.mix;
+        const std::array<uint32_t, CategoryCount> weights = {
+            mix.identifiers, mix.keywords, mix.numbers, mix.strings, mix.operators, mix.comments, mix.whitespace
+        };
+
+        uint64_t total = 0;
+        for(const auto weight : weights) {
+            total += weight;
+        }
+        if(total == 0) {
+            return soup ? Identifiers : Operators;
+        }
+
+        auto value = _random.next(total);
+        for(uint32_t category = 0; category < CategoryCount; category++) {
+            if(value < weights[category]) {
+                return category;
+            }
+            value -= weights[category];
+        }
+
+        return Identifiers;
+    }
+
+    void Generator::append_identifier(std::string& text) {
+        if(_random.chance(_options.non_ascii)) {
+            if(_random.chance(50)) {
+                text += pick(_random, _NON_ASCII_WORDS);
+                text += '_';
+                text += pick(_random, _WORDS);
+            } else {
+                text += pick(_random, _WORDS);
+                text += '_';
+                text += pick(_random, _NON_ASCII_WORDS);
+            }
+            return;
+        }
+
+        text += pick(_random, _WORDS);
+        if(_random.chance(40)) {
+            text += fmt::format("_{}", _random.next(100));
+        }
+    }
+
+    void Generator::append_number(std::string& text) {
+        switch(_random.next(8)) {
+            case 0:
+                text += fmt::format("0x{:x}", _random.next(1 << 16));
+                break;
+            case 1:
+                text += fmt::format("0b{:b}", _random.next(256));
+                break;
+            case 2:
+                text += fmt::format("0o{:o}", _random.next(4096));
+                break;
+            case 3:
+                text += fmt::format("{}.{}", _random.next(1000), _random.next(1000));
+                if(_random.chance(50)) {
+                    text += _random.chance(50) ? "f32" : "f64";
+                }
+                break;
+            case 4:
+                text += fmt::format("{}.{}e{}{}", 1 + _random.next(9), _random.next(100), _random.chance(50) ? "-" : "", _random.next(20));
+                break;
+            case 5: {
+                const auto& type = _TYPES[_random.next(_TYPES.size() - 2)];
+                const auto bound = type.ends_with('8') ? 128 : type.ends_with("16") ? 32768 : 1'000'000;
+                text += fmt::format("{}{}", _random.next(bound), type);
+            }
+                break;
+            case 6:
+                text += fmt::format("{}_{:03}", 1 + _random.next(999), _random.next(1000));
+                break;
+            default:
+                text += fmt::format("{}", _random.next(100));
+                break;
+        }
+    }
+
+    void Generator::append_string(std::string& text) {
+        const auto non_ascii = _random.chance(_options.non_ascii);
+
+        text += '"';
+        const auto count = 1 + _random.next(5);
+        for(uint64_t i = 0; i < count; i++) {
+            text += non_ascii && _random.chance(50) ? pick(_random, _NON_ASCII_STRING_PIECES) : pick(_random, _STRING_PIECES);
+        }
+        text += '"';
+    }
+
+    void Generator::append_comment(std::string& text, size_t indent) {
+        append_indent(text, indent);
+
+        if(_random.chance(60)) {
+            text += "// ";
+            append_identifier(text);
+            text += " is ";
+            append_identifier(text);
+            text += '\n';
+        } else {
+            text += "/* ";
+            append_identifier(text);
+            text += " /* nested ";
+            append_number(text);
+            text += " */ ";
+            append_identifier(text);
+            text += " */\n";
+        }
+    }
+
+    void Generator::append_type(std::string& text) {
+        text += pick(_random, _TYPES);
+    }
+
+    void Generator::append_expression(std::string& text, uint32_t depth) {
+        const auto& mix = _options.mix;
+        const auto leaf_weight = static_cast<uint64_t>(mix.identifiers) + mix.numbers + mix.strings;
+        const auto composite_weight = depth >= 3 ? 0 : static_cast<uint64_t>(mix.operators);
+
+        if(leaf_weight + composite_weight == 0 || _random.next(leaf_weight + composite_weight) < leaf_weight) {
+            auto value = leaf_weight == 0 ? 0 : _random.next(leaf_weight);
+            if(value < mix.identifiers || leaf_weight == 0) {
+                append_identifier(text);
+            } else if((value -= mix.identifiers) < mix.numbers) {
+                append_number(text);
+            } else {
+                append_string(text);
+            }
+            return;
+        }
+
+        switch(_random.next(12)) {
+            case 0:
+                text += '(';
+                append_expression(text, depth + 1);
+                text += ')';
+                break;
+            case 1:
+                text += _random.chance(50) ? "!" : "-";
+                append_expression(text, depth + 1);
+                break;
+            case 2:
+                append_expression(text, depth + 1);
+                text += " ? ";
+                append_expression(text, depth + 1);
+                text += " : ";
+                append_expression(text, depth + 1);
+                break;
+            case 3: {
+                append_identifier(text);
+                text += '(';
+                const auto count = _random.next(4);
+                for(uint64_t i = 0; i < count; i++) {
+                    if(i != 0) {
+                        text += ", ";
+                    }
+                    append_expression(text, depth + 1);
+                }
+                text += ')';
+            }
+                break;
+            case 4:
+                append_identifier(text);
+                text += '[';
+                append_expression(text, depth + 1);
+                text += ']';
+                break;
+            case 5:
+                append_identifier(text);
+                text += '.';
+                append_identifier(text);
+                break;
+            default:
+                append_expression(text, depth + 1);
+                text += ' ';
+                text += pick(_random, _BINARY_OPERATORS);
+                text += ' ';
+                append_expression(text, depth + 1);
+                break;
+        }
+    }
+
+    void Generator::append_block(std::string& text, size_t indent, uint32_t depth, bool in_loop) {
+        text += "{\n";
+
+        const auto count = 1 + _random.next(depth == 0 ? 8 : 4);
+        for(uint64_t i = 0; i < count; i++) {
+            append_statement(text, indent + 1, depth + 1, in_loop);
+        }
+
+        append_indent(text, indent);
+        text += '}';
+    }
+
+    void Generator::append_statement(std::string& text, size_t indent, uint32_t depth, bool in_loop) {
+        const auto category = pick_category(false);
+
+        if(category == Comments) {
+            append_comment(text, indent);
+            return;
+        }
+        if(category == Whitespace) {
+            text += '\n';
+        }
+
+        append_indent(text, indent);
+
+        //Control flow is only nested up to a fixed depth so functions stay finite
+        if(category == Keywords && depth < 4) {
+            switch(_random.next(in_loop ? 6 : 4)) {
+                case 0:
+                    text += "if ";
+                    append_expression(text, 1);
+                    text += ' ';
+                    append_block(text, indent, depth, in_loop);
+                    if(_random.chance(50)) {
+                        text += " else ";
+                        if(_random.chance(30)) {
+                            text += "if ";
+                            append_expression(text, 1);
+                            text += ' ';
+                            append_block(text, indent, depth, in_loop);
+                            text += " else ";
+                        }
+                        append_block(text, indent, depth, in_loop);
+                    }
+                    text += '\n';
+                    return;
+                case 1:
+                    text += "while ";
+                    append_expression(text, 1);
+                    text += ' ';
+                    append_block(text, indent, depth, true);
+                    text += '\n';
+                    return;
+                case 2:
+                    text += "for ";
+                    append_identifier(text);
+                    text += " : ";
+                    append_expression(text, 2);
+                    text += "..";
+                    append_expression(text, 2);
+                    text += ' ';
+                    append_block(text, indent, depth, true);
+                    text += '\n';
+                    return;
+                case 3:
+                    text += "return ";
+                    append_expression(text, 0);
+                    text += ";\n";
+                    return;
+                case 4:
+                    text += "break;\n";
+                    return;
+                default:
+                    text += "continue;\n";
+                    return;
+            }
+        }
+
+        switch(_random.next(6)) {
+            case 0:
+                append_identifier(text);
+                text += " := ";
+                break;
+            case 1:
+                append_identifier(text);
+                text += ": ";
+                append_type(text);
+                text += " = ";
+                break;
+            case 2:
+                append_identifier(text);
+                text += " :: ";
+                break;
+            case 3:
+                append_identifier(text);
+                text += _random.chance(50) ? "++;\n" : "--;\n";
+                return;
+            default:
+                append_identifier(text);
+                text += ' ';
+                text += pick(_random, _ASSIGN_OPERATORS);
+                text += ' ';
+                break;
+        }
+
+        append_expression(text, 0);
+        text += ";\n";
+    }
+
+    void Generator::append_function(std::string& text) {
+        if(_random.chance(_options.mix.comments * 4)) {
+            append_comment(text, 0);
+        }
+
+        text += "fn ";
+        append_identifier(text);
+        text += fmt::format("_{}(", _function_count++);
+
+        const auto parameters = _random.next(4);
+        for(uint64_t i = 0; i < parameters; i++) {
+            if(i != 0) {
+                text += ", ";
+            }
+            append_identifier(text);
+            text += ": ";
+            append_type(text);
+        }
+        text += ')';
+
+        if(_random.chance(70)) {
+            text += " -> ";
+            append_type(text);
+        }
+
+        text += ' ';
+        append_block(text, 0, 0, false);
+        text += "\n\n";
+    }
+
+    void Generator::append_soup(std::string& text) {
+        const auto count = 4 + _random.next(12);
+
+        for(uint64_t i = 0; i < count; i++) {
+            switch(pick_category(true)) {
+                case Identifiers:
+                    append_identifier(text);
+                    break;
+                case Keywords:
+                    text += pick(_random, _KEYWORDS);
+                    break;
+                case Numbers:
+                    append_number(text);
+                    break;
+                case Strings:
+                    append_string(text);
+                    break;
+                case Operators:
+                    text += pick(_random, _SOUP_OPERATORS);
+                    break;
+                case Comments:
+                    append_comment(text, 0);
+                    break;
+                default:
+                    append_indent(text, 1 + _random.next(8));
+                    text += _random.chance(50) ? "\n" : "\t\r\n";
+                    break;
+            }
+            text += ' ';
+        }
+
+        text += '\n';
+    }
+
+    Type Generator::pick_type() {
+        const auto value = _random.next(100);
+        if(value < 10) {
+            return Type::Bool;
+        }
+        if(value < 10 + _options.mix.strings) {
+            return Type::String;
+        }
+        return pick_numeric_type();
+    }
+
+    Type Generator::pick_numeric_type() {
+        return *type::from_name(pick(_random, _TYPES));
+    }
+
+    const Generator::Variable* Generator::pick_variable(Type type, bool assignable) {
+        const auto matches = [type, assignable](const Variable& variable) {
+            return variable.type == type && !variable.hidden && !(assignable && variable.constant);
+        };
+
+        const auto count = std::count_if(_variables.begin(), _variables.end(), matches);
+        if(count == 0) {
+            return nullptr;
+        }
+
+        auto index = _random.next(static_cast<uint64_t>(count));
+        for(const auto& variable : _variables) {
+            if(matches(variable) && index-- == 0) {
+                return &variable;
+            }
+        }
+        return nullptr;
+    }
+
+    const Generator::Signature* Generator::pick_function(Type type) {
+        //Only the last functions are considered, so calls stay local and picking one is cheap
+        static constexpr size_t RECENT_FUNCTIONS = 64;
+
+        const auto start = _functions.size() - std::min(_functions.size(), RECENT_FUNCTIONS);
+        const auto offset = _random.next(RECENT_FUNCTIONS);
+        for(size_t i = 0; i < _functions.size() - start; i++) {
+            const auto& function = _functions[start + (offset + i) % (_functions.size() - start)];
+            if(function.result == type) {
+                return &function;
+            }
+        }
+        return nullptr;
+    }
+
+    void Generator::declare(std::string name, Type type, bool constant) {
+        auto hides = _NO_VARIABLE;
+        for(size_t i = 0; i < _variables.size(); i++) {
+            if(!_variables[i].hidden && _variables[i].name == name) {
+                _variables[i].hidden = true;
+                hides = static_cast<uint32_t>(i);
+            }
+        }
+
+        _variables.push_back({ std::move(name), type, constant, false, hides });
+    }
+
+    void Generator::leave_scope(size_t size) noexcept {
+        while(_variables.size() > size) {
+            if(_variables.back().hides != _NO_VARIABLE) {
+                _variables[_variables.back().hides].hidden = false;
+            }
+            _variables.pop_back();
+        }
+    }
+
+    void Generator::append_local_name(std::string& text) {
+        if(_random.chance(_options.non_ascii)) {
+            text += pick(_random, _WORDS);
+            text += '_';
+            text += pick(_random, _NON_ASCII_WORDS);
+            return;
+        }
+
+        text += pick(_random, _WORDS);
+    }
+
+    void Generator::append_literal(std::string& text, Type type, bool suffix) {
+        if(type == Type::String) {
+            append_string(text);
+            return;
+        }
+
+        if(type::is_float(type)) {
+            text += fmt::format("{}.{}", _random.next(100), _random.next(10));
+        } else {
+            //Nonzero and small enough for every integer type, so it can be a divisor or a shift amount
+            text += fmt::format("{}", 1 + _random.next(type::get_bits(type) > 8 ? 100 : 7));
+        }
+        if(suffix) {
+            text += type::get_name(type);
+        }
+    }
+
+    void Generator::append_call(std::string& text, const Signature& function, uint32_t depth) {
+        text += function.name;
+        text += '(';
+        for(size_t i = 0; i < function.parameters.size(); i++) {
+            if(i != 0) {
+                text += ", ";
+            }
+            append_typed_expression(text, function.parameters[i], depth + 1);
+        }
+        text += ')';
+    }
+
+    bool Generator::append_typed_leaf(std::string& text, Type type) {
+        //Bools only come from comparisons
+        if(type == Type::Bool) {
+            const auto* variable = pick_variable(type, false);
+            if(variable == nullptr) {
+                const auto operand = pick_numeric_type();
+                append_literal(text, operand, false);
+                text += ' ';
+                text += pick(_random, _COMPARISON_OPERATORS);
+                text += ' ';
+                append_literal(text, operand, false);
+                return true;
+            }
+            text += variable->name;
+            return variable->constant;
+        }
+
+        const auto& mix = _options.mix;
+        if(_random.next(static_cast<uint64_t>(mix.identifiers) + mix.numbers + 1) < mix.identifiers) {
+            const auto* variable = pick_variable(type, false);
+            if(variable != nullptr) {
+                text += variable->name;
+                return variable->constant;
+            }
+        }
+
+        append_literal(text, type, _random.chance(20));
+        return type != Type::String;
+    }
+
+    bool Generator::append_typed_expression(std::string& text, Type type, uint32_t depth) {
+        const auto& mix = _options.mix;
+        const auto leaf_weight = static_cast<uint64_t>(mix.identifiers) + mix.numbers + mix.strings;
+        const auto composite_weight = depth >= 3 ? 0 : static_cast<uint64_t>(mix.operators);
+        if(leaf_weight + composite_weight == 0 || _random.next(leaf_weight + composite_weight) < leaf_weight) {
+            return append_typed_leaf(text, type);
+        }
+
+        std::string lhs;
+        std::string rhs;
+        switch(_random.next(type == Type::Bool ? 5 : 8)) {
+            case 0: {
+                text += '(';
+                const auto constant = append_typed_expression(text, type, depth + 1);
+                text += ')';
+                return constant;
+            }
+            case 1: {
+                const auto* function = pick_function(type);
+                if(function == nullptr) {
+                    return append_typed_leaf(text, type);
+                }
+                append_call(text, *function, depth);
+                return false;
+            }
+            case 2: {
+                std::string condition;
+                const auto condition_constant = append_typed_expression(condition, Type::Bool, depth + 1);
+                const auto then_constant = append_typed_expression(lhs, type, depth + 1);
+                const auto otherwise_constant = append_typed_expression(rhs, type, depth + 1);
+                //Two constants would leave an untyped value that isn't a constant
+                if(then_constant && otherwise_constant) {
+                    text += lhs;
+                    return true;
+                }
+                append_operand(text, condition);
+                text += " ? ";
+                append_operand(text, lhs);
+                text += " : ";
+                append_operand(text, rhs);
+                return condition_constant;
+            }
+            default:
+                break;
+        }
+
+        if(type == Type::String) {
+            return append_typed_leaf(text, type);
+        }
+
+        if(type == Type::Bool) {
+            if(_random.chance(30)) {
+                text += '!';
+                const auto constant = append_typed_leaf(lhs, type);
+                append_operand(text, lhs);
+                return constant;
+            }
+
+            std::string_view op;
+            auto lhs_constant = false;
+            auto rhs_constant = false;
+            if(_random.chance(30)) {
+                op = _random.chance(50) ? "&&" : "||";
+                lhs_constant = append_typed_expression(lhs, Type::Bool, depth + 1);
+                rhs_constant = append_typed_expression(rhs, Type::Bool, depth + 1);
+                //The right operand doesn't matter if the left one decides
+                rhs_constant = true;
+            } else {
+                const auto operand = _random.chance(10) ? Type::Bool : pick_numeric_type();
+                op = operand == Type::Bool ? (_random.chance(50) ? "==" : "!=") : pick(_random, _COMPARISON_OPERATORS);
+                lhs_constant = append_typed_expression(lhs, operand, depth + 1);
+                rhs_constant = append_typed_expression(rhs, operand, depth + 1);
+            }
+            append_operand(text, lhs);
+            text += fmt::format(" {} ", op);
+            append_operand(text, rhs);
+            return lhs_constant && rhs_constant;
+        }
+
+        const auto value = _random.next(10);
+        if(value < 2 && (type::is_signed(type) || type::is_float(type))) {
+            text += '-';
+            return append_typed_leaf(text, type);
+        }
+
+        //Folding two constants could overflow or divide by zero, only the left one is kept
+        const auto lhs_constant = append_typed_expression(lhs, type, depth + 1);
+        if(value < 4 && type::is_integer(type)) {
+            append_literal(rhs, Type::U8, false);
+            if(lhs_constant) {
+                text += lhs;
+                return true;
+            }
+            append_operand(text, lhs);
+            text += _random.chance(50) ? " << " : " >> ";
+            text += rhs;
+            return false;
+        }
+
+        const auto rhs_constant = append_typed_expression(rhs, type, depth + 1);
+        if(lhs_constant && rhs_constant) {
+            text += lhs;
+            return true;
+        }
+        const auto op = value < 6 && type::is_integer(type) ? pick(_random, _INTEGER_OPERATORS) : pick(_random, _ARITHMETIC_OPERATORS);
+        append_operand(text, lhs);
+        text += fmt::format(" {} ", op);
+        append_operand(text, rhs);
+        return false;
+    }
+
+    void Generator::append_typed_block(std::string& text, size_t indent, uint32_t depth, bool in_loop) {
+        const auto scope = _variables.size();
+        text += "{\n";
+
+        const auto count = 1 + _random.next(depth == 0 ? 8 : 4);
+        for(uint64_t i = 0; i < count; i++) {
+            append_typed_statement(text, indent + 1, depth + 1, in_loop);
+        }
+
+        append_indent(text, indent);
+        text += '}';
+        leave_scope(scope);
+    }
+
+    void Generator::append_typed_statement(std::string& text, size_t indent, uint32_t depth, bool in_loop) {
+        const auto category = pick_category(false);
+
+        if(category == Comments) {
+            append_comment(text, indent);
+            return;
+        }
+        if(category == Whitespace) {
+            text += '\n';
+        }
+
+        append_indent(text, indent);
+
+        //Control flow is only nested up to a fixed depth so functions stay finite
+        if(category == Keywords && depth < 4) {
+            switch(_random.next(in_loop ? 6 : 4)) {
+                case 0:
+                    text += "if ";
+                    append_typed_expression(text, Type::Bool, 1);
+                    text += ' ';
+                    append_typed_block(text, indent, depth, in_loop);
+                    if(_random.chance(50)) {
+                        text += " else ";
+                        if(_random.chance(30)) {
+                            text += "if ";
+                            append_typed_expression(text, Type::Bool, 1);
+                            text += ' ';
+                            append_typed_block(text, indent, depth, in_loop);
+                            text += " else ";
+                        }
+                        append_typed_block(text, indent, depth, in_loop);
+                    }
+                    text += '\n';
+                    return;
+                case 1:
+                    text += "while ";
+                    append_typed_expression(text, Type::Bool, 1);
+                    text += ' ';
+                    append_typed_block(text, indent, depth, true);
+                    text += '\n';
+                    return;
+                case 2: {
+                    //The suffix of the lower bound gives the range the type of the variable
+                    auto type = pick_numeric_type();
+                    while(!type::is_integer(type)) {
+                        type = pick_numeric_type();
+                    }
+
+                    std::string name;
+                    append_local_name(name);
+                    text += fmt::format("for {} : ", name);
+                    append_literal(text, type, true);
+                    text += "..";
+                    std::string end;
+                    append_typed_expression(end, type, 2);
+                    append_operand(text, end);
+                    text += ' ';
+
+                    const auto scope = _variables.size();
+                    declare(std::move(name), type, true);
+                    append_typed_block(text, indent, depth, true);
+                    leave_scope(scope);
+                    text += '\n';
+                    return;
+                }
+                case 3:
+                    if(_return_type == Type::Void) {
+                        text += "return;\n";
+                        return;
+                    }
+                    text += "return ";
+                    append_typed_expression(text, _return_type, 0);
+                    text += ";\n";
+                    return;
+                case 4:
+                    text += "break;\n";
+                    return;
+                default:
+                    text += "continue;\n";
+                    return;
+            }
+        }
+
+        const auto value = _random.next(6);
+        if(value == 2 && !_functions.empty()) {
+            append_call(text, _functions[_functions.size() - 1 - _random.next(std::min<size_t>(_functions.size(), 64))], 0);
+            text += ";\n";
+            return;
+        }
+
+        const auto type = pick_type();
+        const auto* variable = value >= 3 ? pick_variable(type, true) : nullptr;
+        if(variable != nullptr && value == 3 && type::is_numeric(type)) {
+            text += variable->name;
+            text += _random.chance(50) ? "++;\n" : "--;\n";
+            return;
+        }
+        if(variable != nullptr) {
+            text += variable->name;
+            if(!type::is_numeric(type) || _random.chance(30)) {
+                text += " = ";
+                append_typed_expression(text, type, 0);
+            } else if(type::is_integer(type) && _random.chance(20)) {
+                text += _random.chance(50) ? " <<= " : " >>= ";
+                append_literal(text, Type::U8, false);
+            } else {
+                text += ' ';
+                text += type::is_integer(type) && _random.chance(40) ? pick(_random, _INTEGER_OPERATORS) : pick(_random, _ARITHMETIC_OPERATORS);
+                text += "= ";
+                append_typed_expression(text, type, 0);
+            }
+            text += ";\n";
+            return;
+        }
+
+        std::string name;
+        append_local_name(name);
+        std::string initializer;
+        const auto constant = append_typed_expression(initializer, type, 0);
+
+        //Constants without a type may be untyped, a variable of them would get the default type instead
+        const auto declares_constant = constant && _random.chance(50);
+        if(declares_constant) {
+            text += fmt::format("{} :: {};\n", name, initializer);
+        } else if(constant || value == 1) {
+            text += fmt::format("{}: {} = {};\n", name, type::get_name(type), initializer);
+        } else {
+            text += fmt::format("{} := {};\n", name, initializer);
+        }
+        declare(std::move(name), type, declares_constant);
+    }
+
+    void Generator::append_typed_function(std::string& text) {
+        if(_random.chance(_options.mix.comments * 4)) {
+            append_comment(text, 0);
+        }
+
+        Signature signature;
+        append_identifier(signature.name);
+        signature.name += fmt::format("_{}", _function_count++);
+        text += fmt::format("fn {}(", signature.name);
+
+        _variables.clear();
+        const auto parameters = _random.next(4);
+        for(uint64_t i = 0; i < parameters; i++) {
+            if(i != 0) {
+                text += ", ";
+            }
+
+            //Parameters must be unique
+            std::string name;
+            append_local_name(name);
+            while(std::any_of(_variables.begin(), _variables.end(), [&name](const Variable& parameter) { return parameter.name == name; })) {
+                name += '_';
+                name += pick(_random, _WORDS);
+            }
+            const auto type = pick_type();
+            text += fmt::format("{}: {}", name, type::get_name(type));
+            signature.parameters.push_back(type);
+            declare(std::move(name), type, false);
+        }
+        text += ')';
+
+        _return_type = Type::Void;
+        if(_random.chance(70)) {
+            _return_type = pick_type();
+            text += fmt::format(" -> {}", type::get_name(_return_type));
+        }
+        signature.result = _return_type;
+
+        text += " {\n";
+        const auto count = 1 + _random.next(8);
+        for(uint64_t i = 0; i < count; i++) {
+            append_typed_statement(text, 1, 1, false);
+        }
+        if(_return_type != Type::Void) {
+            append_indent(text, 1);
+            text += "return ";
+            append_typed_expression(text, _return_type, 0);
+            text += ";\n";
+        }
+        text += "}\n\n";
+
+        _functions.push_back(std::move(signature));
+    }
+
+    void Generator::next(std::string& text) {
+        if(_options.soup) {
+            append_soup(text);
+        } else if(_options.typed) {
+            append_typed_function(text);
+        } else {
+            append_function(text);
+        }
+    }
+
+    std::string Generator::generate(uint64_t size) {
+        std::string text;
+        text.reserve(size + 4096);
+
+        while(text.size() < size) {
+            next(text);
+        }
+
+        return text;
+    }
+
+    void Generator::write(std::FILE* file, uint64_t size) {
+        static constexpr size_t FLUSH_SIZE = 1024 * 1024;
+
+        std::string buffer;
+        buffer.reserve(FLUSH_SIZE + 64 * 1024);
+
+        uint64_t written = 0;
+        while(written < size) {
+            buffer.clear();
+
+            while(buffer.size() < FLUSH_SIZE && written + buffer.size() < size) {
+                next(buffer);
+            }
+
+            if(std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) {
+                throw std::runtime_error("Failed to write corpus");
+            }
+            written += buffer.size();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <check/type.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace karmac::corpus {
+    //Relative weights of the token categories. In structured code the weights pick statement and expression shapes,
+    //in token soup they pick the category of every emitted token
+    struct TokenMix {
+        uint32_t identifiers = 30;
+        uint32_t keywords = 10;
+        uint32_t numbers = 15;
+        uint32_t strings = 5;
+        uint32_t operators = 30;
+        uint32_t comments = 5;
+        uint32_t whitespace = 5;
+    };
+
+    struct GeneratorOptions {
+        uint64_t seed = 1;
+        TokenMix mix;
+        //Percentage of identifiers and strings containing non-ASCII characters
+        uint32_t non_ascii = 5;
+        //Emit unstructured streams of tokens instead of functions
+        bool soup = false;
+        //Emit functions that resolve and type check without errors: names are only used where they are declared and
+        //expressions have the type their context requires. Constant expressions stay small, so folding them never
+        //overflows or divides by zero
+        bool typed = false;
+    };
+
+    //https://prng.di.unimi.it/splitmix64.c
+    class Random final {
+    private:
+        uint64_t _state;
+
+    public:
+        explicit Random(uint64_t seed) noexcept : _state(seed) {}
+
+        inline uint64_t next() noexcept {
+            auto z = (_state += 0x9e3779b97f4a7c15ull);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        }
+
+        inline uint64_t next(uint64_t bound) noexcept {
+            return next() % bound;
+        }
+
+        inline bool chance(uint32_t percent) noexcept {
+            return next(100) < percent;
+        }
+    };
+
+    //Generates karma source deterministically: the same options always produce the same text,
+    //independent of how the output is split into chunks
+    class Generator final {
+    private:
+        static constexpr uint32_t _NO_VARIABLE = UINT32_MAX;
+
+        //A name visible in the typed function being generated
+        struct Variable {
+            std::string name;
+            Type type;
+            //Declared with ::, or a for variable
+            bool constant;
+            //Inner variable of the same name, the variable is visible again once it goes out of scope
+            bool hidden = false;
+            //The outer variable this one hides
+            uint32_t hides = _NO_VARIABLE;
+        };
+
+        struct Signature {
+            std::string name;
+            Type result;
+            std::vector<Type> parameters;
+        };
+
+        GeneratorOptions _options;
+        Random _random;
+        uint64_t _function_count = 0;
+
+        std::vector<Variable> _variables;
+        std::vector<Signature> _functions;
+        Type _return_type = Type::Void;
+
+        [[nodiscard]] uint32_t pick_category(bool soup);
+
+        void append_identifier(std::string& text);
+        void append_number(std::string& text);
+        void append_string(std::string& text);
+        void append_comment(std::string& text, size_t indent);
+        void append_type(std::string& text);
+
+        void append_expression(std::string& text, uint32_t depth);
+        void append_statement(std::string& text, size_t indent, uint32_t depth, bool in_loop);
+        void append_block(std::string& text, size_t indent, uint32_t depth, bool in_loop);
+        void append_function(std::string& text);
+        void append_soup(std::string& text);
+
+        //Values of type bool, str or a numeric type
+        [[nodiscard]] Type pick_type();
+        [[nodiscard]] Type pick_numeric_type();
+        //A random visible variable of `type` that can be assigned if `assignable` is set, nullptr if there is none
+        [[nodiscard]] const Variable* pick_variable(Type type, bool assignable);
+        //A recently generated function returning `type`, nullptr if there is none
+        [[nodiscard]] const Signature* pick_function(Type type);
+        void declare(std::string name, Type type, bool constant);
+        void leave_scope(size_t size) noexcept;
+
+        //Identifiers without digits, they never collide with the names of functions
+        void append_local_name(std::string& text);
+        void append_literal(std::string& text, Type type, bool suffix);
+        void append_call(std::string& text, const Signature& function, uint32_t depth);
+        //Appends an expression of `type`, returns whether the checker may fold it to a constant. Operators are only
+        //applied to constants by comparisons and logical operators, which can't overflow
+        bool append_typed_expression(std::string& text, Type type, uint32_t depth);
+        bool append_typed_leaf(std::string& text, Type type);
+        void append_typed_statement(std::string& text, size_t indent, uint32_t depth, bool in_loop);
+        void append_typed_block(std::string& text, size_t indent, uint32_t depth, bool in_loop);
+        void append_typed_function(std::string& text);
+    public:
+        explicit Generator(const GeneratorOptions& options) noexcept : _options(options), _random(options.seed) {}
+
+        //Appends the next top level item (a function or a line of token soup). Typed functions only call the functions
+        //generated before them
+        void next(std::string& text);
+
+        [[nodiscard]] std::string generate(uint64_t size);
+        void write(std::FILE* file, uint64_t size);
+    };
+}
\ No newline at end of file
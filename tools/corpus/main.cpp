@@ -0,0 +1,138 @@
+#include "generator.hpp"
+
+#include <fmt/format.h>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+using namespace karmac::corpus;
+
+static uint64_t parse_number(const std::string_view& text) {
+    uint64_t value = 0;
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if(result.ec != std::errc()) {
+        throw std::runtime_error(fmt::format("Invalid number: {}", text));
+    }
+
+    return value;
+}
+
+//Sizes accept the suffixes K, M and G (powers of 1024)
+static uint64_t parse_size(std::string_view text) {
+    uint64_t multiplier = 1;
+
+    if(!text.empty()) {
+        switch(text.back()) {
+            case 'k':
+            case 'K':
+                multiplier = 1024;
+                break;
+            case 'm':
+            case 'M':
+                multiplier = 1024 * 1024;
+                break;
+            case 'g':
+            case 'G':
+                multiplier = 1024 * 1024 * 1024;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if(multiplier != 1) {
+        text.remove_suffix(1);
+    }
+
+    return parse_number(text) * multiplier;
+}
+
+static void parse_mix(std::string_view text, TokenMix& mix) {
+    while(!text.empty()) {
+        const auto end = text.find(',');
+        const auto entry = text.substr(0, end);
+        text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+
+        const auto separator = entry.find(':');
+        if(separator == std::string_view::npos) {
+            throw std::runtime_error(fmt::format("Invalid mix entry: {}", entry));
+        }
+
+        const auto name = entry.substr(0, separator);
+        const auto weight = static_cast<uint32_t>(parse_number(entry.substr(separator + 1)));
+
+        if(name == "identifiers") {
+            mix.identifiers = weight;
+        } else if(name == "keywords") {
+            mix.keywords = weight;
+        } else if(name == "numbers") {
+            mix.numbers = weight;
+        } else if(name == "strings") {
+            mix.strings = weight;
+        } else if(name == "operators") {
+            mix.operators = weight;
+        } else if(name == "comments") {
+            mix.comments = weight;
+        } else if(name == "whitespace") {
+            mix.whitespace = weight;
+        } else {
+            throw std::runtime_error(fmt::format("Unknown mix category: {}", name));
+        }
+    }
+}
+
+static void print_usage() {
+    fmt::print("usage: karmac_corpus [--size=<bytes>[K|M|G]] [--seed=<n>] [--mix=<category>:<weight>,...] [--non-ascii=<percent>] [--soup | --typed] [-o <file>]\n"
+               "categories: identifiers, keywords, numbers, strings, operators, comments, whitespace\n"
+               "--typed emits code that resolves and type checks without errors\n");
+}
+
+int main(int argc, char** argv) {
+    GeneratorOptions options;
+    uint64_t size = 1024 * 1024;
+    std::string output_path;
+
+    try {
+        for(auto i = 1; i < argc; i++) {
+            const std::string_view argument(argv[i]);
+
+            if(argument.starts_with("--size=")) {
+                size = parse_size(argument.substr(std::string_view("--size=").size()));
+            } else if(argument.starts_with("--seed=")) {
+                options.seed = parse_number(argument.substr(std::string_view("--seed=").size()));
+            } else if(argument.starts_with("--mix=")) {
+                parse_mix(argument.substr(std::string_view("--mix=").size()), options.mix);
+            } else if(argument.starts_with("--non-ascii=")) {
+                options.non_ascii = static_cast<uint32_t>(parse_number(argument.substr(std::string_view("--non-ascii=").size())));
+            } else if(argument == "--soup") {
+                options.soup = true;
+            } else if(argument == "--typed") {
+                options.typed = true;
+            } else if(argument == "-o" && i + 1 < argc) {
+                output_path = argv[++i];
+            } else {
+                print_usage();
+                return argument == "--help" ? 0 : 2;
+            }
+        }
+
+        auto* file = output_path.empty() ? stdout : std::fopen(output_path.c_str(), "wb");
+        if(file == nullptr) {
+            throw std::runtime_error(fmt::format("Failed to open {}", output_path));
+        }
+
+        Generator generator(options);
+        generator.write(file, size);
+
+        if(file != stdout) {
+            std::fclose(file);
+        }
+    } catch(const std::exception& e) {
+        fmt::print(stderr, "{}\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file